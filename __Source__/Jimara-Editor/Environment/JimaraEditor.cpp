@@ -716,7 +716,8 @@ namespace Jimara {
 				createArgs.physicsInstance = physics;
 				createArgs.audioDevice = audio;
 				createArgs.assetDirectory = args.assetDirectory.empty() ? OS::Path("Assets/") : args.assetDirectory;
-				createArgs.previousImportDataCache = OS::Path("JimaraDatabaseCache.json");
+				createArgs.previousImportDataCache = OS::Path("JimaraDatabaseCache.bin");
+				createArgs.cookedAssetCacheDirectory = OS::Path("JimaraCookedAssets/");
 				auto reportProgress = [&](size_t processed, size_t total) {
 					static thread_local Stopwatch stopwatch;
 					if (stopwatch.Elapsed() > 0.5f) {
@@ -1,11 +1,14 @@
 #include "NavMesh.h"
 #include <Jimara/Core/Stopwatch.h>
+#include <Jimara/Core/Collections/BVH.h>
 #include <Jimara/Math/Primitives/Sphere.h>
 #include <Jimara/Data/Geometry/MeshAnalysis.h>
 #include <Jimara/Data/Geometry/MeshModifiers.h>
 #include <Jimara/Data/Serialization/Attributes/EnumAttribute.h>
 #include <Jimara/Data/Serialization/Helpers/SerializerMacros.h>
 #include <Jimara/Math/Algorithms/Pathfinding.h>
+#include <unordered_map>
+#include <future>
 #include <tuple>
 
 
@@ -71,6 +74,128 @@ namespace Jimara {
 			// Establish neighboring-face information:
 			bakedData->triNeighbors = GetMeshFaceNeighborIndices(mesh, false);
 
+			// Precompute face normals and shared edges, so that the pathfinding does not have to rediscover them for each request:
+			{
+				const std::vector<Stacktor<uint32_t, 3u>>& triNeighbors = bakedData->triNeighbors;
+				const uint32_t triangleCount = static_cast<uint32_t>(Math::Min(triNeighbors.size(), bakedData->octree.Size()));
+				bakedData->triNormals.resize(bakedData->octree.Size());
+				for (size_t i = 0u; i < bakedData->octree.Size(); i++) {
+					const Triangle3& tri = bakedData->octree[i];
+					bakedData->triNormals[i] = Math::Normalize(Math::Cross(tri[2u] - tri[0u], tri[1u] - tri[0u]));
+				}
+				bakedData->triPortals.resize(triNeighbors.size());
+				auto areNeighbors = [&](uint32_t triA, uint32_t triB) {
+					const Stacktor<uint32_t, 3u>& neighbors = triNeighbors[triA];
+					for (size_t i = 0u; i < neighbors.Size(); i++)
+						if (neighbors[i] == triB)
+							return true;
+					return false;
+				};
+				for (uint32_t triA = 0u; triA < triangleCount; triA++) {
+					const Stacktor<uint32_t, 3u>& neighbors = triNeighbors[triA];
+					for (size_t nId = 0u; nId < neighbors.Size(); nId++) {
+						const uint32_t triB = neighbors[nId];
+						if (triB == triA || triB >= triangleCount || (triB < triA && areNeighbors(triB, triA)))
+							continue;
+						const Triangle3& tri0 = bakedData->octree[Math::Min(triA, triB)];
+						const Triangle3& tri1 = bakedData->octree[Math::Max(triA, triB)];
+						auto addIfEdgesMatch = [&](uint32_t eI0, uint32_t eI1) {
+							const Vector3& a0 = tri0[eI0];
+							const Vector3& b0 = tri0[(eI0 + 1u) % 3u];
+							const Vector3& a1 = tri1[eI1];
+							const Vector3& b1 = tri1[(eI1 + 1u) % 3u];
+							const float distanceThresh = 0.01f * Math::Magnitude(a0 - b0);
+							auto areCloseEnough = [&](const Vector3& a, const Vector3& b) {
+								return Math::Magnitude(a - b) <= distanceThresh;
+							};
+							if ((!areCloseEnough(a0, b1)) || (!areCloseEnough(b0, a1)))
+								return false;
+							BakedSurfaceData::Portal portal = {};
+							portal.triangles = Size2(Math::Min(triA, triB), Math::Max(triA, triB));
+							portal.edges = Size2(eI0, eI1);
+							portal.midpoint = (a0 + b0) * 0.5f;
+							portal.offset = (b0 - a0);
+							portal.width = Math::Magnitude(portal.offset);
+							const uint32_t portalId = static_cast<uint32_t>(bakedData->portals.size());
+							bakedData->portals.push_back(portal);
+							bakedData->triPortals[portal.triangles.x].Push(portalId);
+							bakedData->triPortals[portal.triangles.y].Push(portalId);
+							return true;
+						};
+						bool found = false;
+						for (uint32_t eI1 = 0u; eI1 < 3u && (!found); eI1++)
+							for (uint32_t eI0 = 0u; eI0 < 3u && (!found); eI0++)
+								found = addIfEdgesMatch(eI0, eI1);
+					}
+				}
+			}
+
+			// Group faces into clusters for the hierarchical search (small surfaces are searched directly):
+			{
+				static const constexpr uint32_t CLUSTER_SIZE = 64u;
+				static const constexpr uint32_t MIN_CLUSTER_COUNT = 4u;
+				static const constexpr uint32_t NO_CLUSTER = ~uint32_t(0u);
+				const uint32_t triangleCount = static_cast<uint32_t>(Math::Min(bakedData->triPortals.size(), bakedData->octree.Size()));
+				if (triangleCount > (CLUSTER_SIZE * MIN_CLUSTER_COUNT)) {
+					std::vector<uint32_t>& triClusters = bakedData->triClusters;
+					std::vector<BakedSurfaceData::Cluster>& clusters = bakedData->clusters;
+					triClusters.resize(triangleCount, NO_CLUSTER);
+
+					// Clusters are grown breadth-first from the first unassigned face, which keeps them reasonably compact:
+					std::vector<uint32_t> clusterFaces;
+					for (uint32_t seed = 0u; seed < triangleCount; seed++) {
+						if (triClusters[seed] != NO_CLUSTER)
+							continue;
+						const uint32_t clusterId = static_cast<uint32_t>(clusters.size());
+						clusterFaces.clear();
+						clusterFaces.push_back(seed);
+						triClusters[seed] = clusterId;
+						for (size_t i = 0u; i < clusterFaces.size() && clusterFaces.size() < CLUSTER_SIZE; i++) {
+							const Stacktor<uint32_t, 3u>& portalIds = bakedData->triPortals[clusterFaces[i]];
+							for (size_t pId = 0u; pId < portalIds.Size() && clusterFaces.size() < CLUSTER_SIZE; pId++) {
+								const BakedSurfaceData::Portal& portal = bakedData->portals[portalIds[pId]];
+								const uint32_t neighborId = (portal.triangles.x == clusterFaces[i]) ? portal.triangles.y : portal.triangles.x;
+								if (neighborId >= triangleCount || triClusters[neighborId] != NO_CLUSTER)
+									continue;
+								triClusters[neighborId] = clusterId;
+								clusterFaces.push_back(neighborId);
+							}
+						}
+						BakedSurfaceData::Cluster cluster = {};
+						for (size_t i = 0u; i < clusterFaces.size(); i++) {
+							const Triangle3& tri = bakedData->octree[clusterFaces[i]];
+							cluster.center += (tri[0u] + tri[1u] + tri[2u]) / 3.0f;
+						}
+						cluster.triangleCount = static_cast<uint32_t>(clusterFaces.size());
+						cluster.center /= static_cast<float>(cluster.triangleCount);
+						clusters.push_back(cluster);
+					}
+
+					// Each pair of neighboring clusters is linked through the widest portal in-between:
+					auto addLink = [&](uint32_t clusterId, uint32_t neighborId, uint32_t portalId) {
+						Stacktor<Size2, 4u>& links = clusters[clusterId].links;
+						for (size_t i = 0u; i < links.Size(); i++) {
+							Size2& link = links[i];
+							if (link.x != neighborId)
+								continue;
+							if (bakedData->portals[link.y].width < bakedData->portals[portalId].width)
+								link.y = portalId;
+							return;
+						}
+						links.Push(Size2(neighborId, portalId));
+					};
+					for (uint32_t portalId = 0u; portalId < bakedData->portals.size(); portalId++) {
+						const BakedSurfaceData::Portal& portal = bakedData->portals[portalId];
+						const uint32_t clusterA = triClusters[portal.triangles.x];
+						const uint32_t clusterB = triClusters[portal.triangles.y];
+						if (clusterA == clusterB)
+							continue;
+						addLink(clusterA, clusterB, portalId);
+						addLink(clusterB, clusterA, portalId);
+					}
+				}
+			}
+
 			// Update mesh data:
 			{
 				std::unique_lock<SpinLock> fieldLock(self->fieldLock);
@@ -279,20 +404,88 @@ namespace Jimara {
 			Reference<const BakedSurfaceData> bakedData;
 		};
 
+		struct SurfaceEdgeNode;
+		using EdgeSequence = std::shared_ptr<const std::vector<SurfaceEdgeNode>>;
+
+		struct PathCache {
+			struct Key {
+				size_t instanceId = ~size_t(0u);
+				size_t startTriangleId = ~size_t(0u);
+				size_t endTriangleId = ~size_t(0u);
+				AgentFlags flags = AgentFlags::NONE;
+				float radius = 0.0f;
+				float maxTiltAngle = 0.0f;
+				Vector3 agentUp = Vector3(0.0f);
+				size_t group = 0u;
+
+				inline bool operator==(const Key& other)const {
+					return
+						instanceId == other.instanceId &&
+						startTriangleId == other.startTriangleId &&
+						endTriangleId == other.endTriangleId &&
+						flags == other.flags &&
+						radius == other.radius &&
+						maxTiltAngle == other.maxTiltAngle &&
+						agentUp == other.agentUp &&
+						group == other.group;
+				}
+
+				struct Hash {
+					inline size_t operator()(const Key& key)const {
+						size_t hash = std::hash<size_t>()(key.instanceId);
+						auto combine = [&](size_t value) { hash ^= value + 0x9e3779b9u + (hash << 6u) + (hash >> 2u); };
+						combine(std::hash<size_t>()(key.startTriangleId));
+						combine(std::hash<size_t>()(key.endTriangleId));
+						combine(std::hash<std::underlying_type_t<AgentFlags>>()(static_cast<std::underlying_type_t<AgentFlags>>(key.flags)));
+						combine(std::hash<float>()(key.radius));
+						combine(std::hash<float>()(key.maxTiltAngle));
+						combine(std::hash<float>()(key.agentUp.x));
+						combine(std::hash<float>()(key.agentUp.y));
+						combine(std::hash<float>()(key.agentUp.z));
+						combine(std::hash<size_t>()(key.group));
+						return hash;
+					}
+				};
+			};
+
+			// Cache is simply flushed once it grows too large (rebuilding the entries is cheap compared to bookkeeping on each access)
+			static const constexpr size_t MAX_ENTRY_COUNT = 4096u;
+
+			std::mutex lock;
+			std::unordered_map<Key, std::shared_future<EdgeSequence>, Key::Hash> entries;
+			std::atomic<size_t> hitCount = 0u;
+			std::atomic<size_t> mergedCount = 0u;
+			std::atomic<size_t> missCount = 0u;
+
+			inline void Clear() {
+				std::unique_lock<std::mutex> cacheLock(lock);
+				entries.clear();
+			}
+		};
+
 		struct NavMeshData : public virtual Object {
 			const Reference<SceneContext> context;
 			mutable std::shared_mutex stateLock;
-			VoxelGrid<PosedOctree<Triangle3>> surfaceGeometry;
+			std::vector<PosedOctree<Triangle3>> surfaceGeometry;
 			std::vector<SurfaceInstanceInfo> surfaces;
 
+			// Surface BVH is updated lazily by the queries (refit, if only the poses have changed since the last update; rebuilt otherwise):
+			enum class SurfaceBVHState : uint8_t {
+				CLEAN = 0u,
+				REFIT = 1u,
+				REBUILD = 2u
+			};
+			mutable std::mutex surfaceBVHLock;
+			mutable BVH<PosedOctree<Triangle3>> surfaceBVH;
+			mutable SurfaceBVHState surfaceBVHState = SurfaceBVHState::CLEAN;
+			mutable PathCache pathCache;
+
 			EventInstance<float> onUpdate;
 			const Reference<UpdateContext> updateContext;
 
 			void OnUpdaterUpdate(float deltaTime)const { onUpdate(deltaTime); }
 
 			inline NavMeshData(SceneContext* ctx) : context(ctx), updateContext(UpdateContext::GetFor(ctx)) {
-				surfaceGeometry.BoundingBox() = AABB(Vector3(0.0f), Vector3(0.0f));
-				surfaceGeometry.GridSize() = Size3(1u);
 				Reference<Updater> updater = updateContext->GetUpdater();
 				if (updater != nullptr)
 					updater->onUpdate.operator Jimara::Event<float>& () += Callback<float>(&NavMeshData::OnUpdaterUpdate, this);
@@ -319,33 +512,24 @@ namespace Jimara {
 			else return data->stateLock;
 		}
 
-		static void RebuildNavMeshGeometry(Helpers::NavMeshData* navMeshData, const std::unique_lock<std::shared_mutex>& lock) {
-			if (navMeshData->surfaceGeometry.Size() <= 0u)
-				return;
-			AABB bounds = AABB(Vector3(0.0f), Vector3(0.0f));
-			Vector3 averageSize = Vector3(1.0f);
-			size_t numValidEntries = 0u;
-			for (size_t i = 0u; i < navMeshData->surfaceGeometry.Size(); i++) {
-				const Jimara::PosedOctree<Jimara::Triangle3>& octree = navMeshData->surfaceGeometry[i];
-				if (octree.octree.Size() <= 0u)
-					continue;
-				const AABB bnd = octree.BoundingBox();
-				if (numValidEntries > 0u) {
-					bounds = AABB(
-						Vector3(Math::Min(bounds.start.x, bnd.start.x), Math::Min(bounds.start.y, bnd.start.y), Math::Min(bounds.start.z, bnd.start.z)),
-						Vector3(Math::Max(bounds.end.x, bnd.end.x), Math::Max(bounds.end.y, bnd.end.y), Math::Max(bounds.end.z, bnd.end.z)));
-				}
-				else bounds = bnd;
-				numValidEntries++;
-				averageSize = Math::Lerp(averageSize, bnd.end - bnd.start, 1.0f / static_cast<float>(numValidEntries));
-			}
-			const Vector3 totalSize = (bounds.end - bounds.start);
-			navMeshData->surfaceGeometry.BoundingBox() = AABB(bounds.start - totalSize, bounds.start - totalSize);
-			navMeshData->surfaceGeometry.GridSize() = static_cast<Size3>(Vector3(
-				Math::Max(4.0f, Math::Min(totalSize.x * 4.0f / Math::Max(averageSize.x, std::numeric_limits<float>::epsilon()), 100.0f)),
-				Math::Max(4.0f, Math::Min(totalSize.y * 4.0f / Math::Max(averageSize.y, std::numeric_limits<float>::epsilon()), 100.0f)),
-				Math::Max(4.0f, Math::Min(totalSize.z * 4.0f / Math::Max(averageSize.z, std::numeric_limits<float>::epsilon()), 100.0f))));
-			navMeshData->surfaceGeometry.BoundingBox() = bounds;
+		// Note: stateLock has to be locked (queries hold a shared lock, so the surfaces can not change while the BVH gets updated)
+		static BVH<PosedOctree<Triangle3>> SurfaceBVH(const NavMeshData* navMeshData) {
+			std::unique_lock<std::mutex> lock(navMeshData->surfaceBVHLock);
+			if (navMeshData->surfaceBVHState == NavMeshData::SurfaceBVHState::REFIT)
+				navMeshData->surfaceBVH = navMeshData->surfaceBVH.Refit(navMeshData->surfaceGeometry.begin(), navMeshData->surfaceGeometry.end());
+			else if (navMeshData->surfaceBVHState == NavMeshData::SurfaceBVHState::REBUILD)
+				navMeshData->surfaceBVH = BVH<PosedOctree<Triangle3>>::Build(navMeshData->surfaceGeometry.begin(), navMeshData->surfaceGeometry.end());
+			navMeshData->surfaceBVHState = NavMeshData::SurfaceBVHState::CLEAN;
+			return navMeshData->surfaceBVH;
+		}
+
+		// Note: stateLock has to be locked exclusively
+		static void InvalidateSurfaceBVH(NavMeshData* navMeshData, bool topologyChanged) {
+			std::unique_lock<std::mutex> lock(navMeshData->surfaceBVHLock);
+			if (topologyChanged)
+				navMeshData->surfaceBVHState = NavMeshData::SurfaceBVHState::REBUILD;
+			else if (navMeshData->surfaceBVHState == NavMeshData::SurfaceBVHState::CLEAN)
+				navMeshData->surfaceBVHState = NavMeshData::SurfaceBVHState::REFIT;
 		}
 
 		static void SurfaceInstanceDirty(const SurfaceInstance* instance, Helpers::NavMeshData* navMeshData, const std::unique_lock<std::shared_mutex>& lock) {
@@ -356,29 +540,23 @@ namespace Jimara {
 			const Surface* const surface = instance->m_shape;
 			assert(index < navMeshData->surfaces.size());
 			assert(navMeshData->surfaces[index].instance == instance);
-			assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.Size());
+			assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.size());
+			navMeshData->pathCache.Clear();
 
 			Reference<const BakedSurfaceData> bakedData;
 			if (surface != nullptr) 
 				bakedData = surface->Data();
+			
+			// Pose changes only need a refit; Refit keeps the BVH topology, so the geometry changes require a rebuild:
+			const bool topologyChanged = (navMeshData->surfaces[index].bakedData != bakedData);
 			navMeshData->surfaces[index].bakedData = bakedData;
 			PosedOctree<Triangle3> instanceShape;
-			bool geometryNeedsRebuild = false;
 			if (bakedData != nullptr) {
 				instanceShape.octree = bakedData->octree;
 				instanceShape.pose = instance->m_transform;
-
-				const AABB shapeBBox = instanceShape.BoundingBox();
-				const AABB worldBBox = navMeshData->surfaceGeometry.BoundingBox();
-				geometryNeedsRebuild = (
-					shapeBBox.start.x < worldBBox.start.x || shapeBBox.end.x > worldBBox.end.x ||
-					shapeBBox.start.y < worldBBox.start.y || shapeBBox.end.y > worldBBox.end.y ||
-					shapeBBox.start.z < worldBBox.start.z || shapeBBox.end.z > worldBBox.end.z);
 			}
 			navMeshData->surfaceGeometry[index] = instanceShape;
-			
-			if (geometryNeedsRebuild)
-				RebuildNavMeshGeometry(navMeshData, lock);
+			InvalidateSurfaceBVH(navMeshData, topologyChanged);
 		}
 
 		static void OnSurfaceInstanceDirty(const SurfaceInstance* instance) {
@@ -389,11 +567,52 @@ namespace Jimara {
 			SurfaceInstanceDirty(instance, navMeshData, lock);
 		}
 
-		struct SurfaceEdgeNode;
+		// Raises a thread-local 'in-use' flag for the lifetime of the scope (resets it, even if the guarded code throws):
+		struct InUseFlagGuard {
+			bool& flag;
+			inline InUseFlagGuard(bool& inUse) : flag(inUse) { flag = true; }
+			inline ~InUseFlagGuard() { flag = false; }
+			InUseFlagGuard(const InUseFlagGuard&) = delete;
+			InUseFlagGuard& operator=(const InUseFlagGuard&) = delete;
+		};
+
+		// Cost multiplier for the steps onto the faces outside the cluster corridor during the hierarchical search:
+		static const constexpr float CORRIDOR_EXIT_PENALTY = 4.0f;
+
+		// Search state is reused per-thread to avoid reallocating node storage for each request 
+		// (additionalPathWeight callbacks might, in theory, request paths themselves, so nested calls get a temporary context):
+		template<typename ContextType, typename SearchFn>
+		inline static void SearchWithSharedContext(const SearchFn& search) {
+			static thread_local ContextType sharedContext;
+			static thread_local bool sharedContextInUse = false;
+			if (sharedContextInUse) {
+				ContextType context;
+				search(context);
+			}
+			else {
+				InUseFlagGuard inUse(sharedContextInUse);
+				search(sharedContext);
+			}
+		}
+
 		static std::vector<SurfaceEdgeNode> CalculateEdgeSequence(
 			const NavMeshData* data, 
 			Vector3 start, Vector3 end, 
 			Vector3 agentUp, const AgentOptions& agentOptions);
+		static std::vector<SurfaceEdgeNode> SearchEdgeSequence(
+			const NavMeshData* data,
+			const SurfaceEdgeNode& startEdge, const SurfaceEdgeNode& endEdge,
+			Vector3 agentUp, const AgentOptions& agentOptions);
+
+		// World-space normal of a surface instance face (cached local normals are used, if the baked data is available):
+		inline static Vector3 WorldTriangleNormal(const NavMeshData* data, size_t instanceId, size_t triangleId) {
+			const PosedOctree<Triangle3>& instance = data->surfaceGeometry[instanceId];
+			const BakedSurfaceData* const bakedData = data->surfaces[instanceId].bakedData;
+			if (bakedData != nullptr && triangleId < bakedData->triNormals.size())
+				return Math::Normalize(Vector3(instance.pose * Vector4(bakedData->triNormals[triangleId], 0.0f)));
+			const Triangle3& tri = instance.octree[triangleId];
+			return Math::Normalize(Vector3(instance.pose * Vector4(Math::Cross(tri[2u] - tri[0u], tri[1u] - tri[0u]), 0.0f)));
+		}
 
 		struct EdgePortal;
 		static void GetPortals(const NavMeshData* data, const SurfaceEdgeNode* path, size_t pathSize, std::vector<EdgePortal>& portals);
@@ -473,8 +692,9 @@ namespace Jimara {
 				else if (value) {
 					self->m_activeIndex = navMeshData->surfaces.size();
 					navMeshData->surfaces.push_back({ self, nullptr });
-					navMeshData->surfaceGeometry.Push(PosedOctree<Triangle3>());
-					assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.Size());
+					navMeshData->surfaceGeometry.push_back(PosedOctree<Triangle3>());
+					assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.size());
+					Helpers::InvalidateSurfaceBVH(navMeshData, true);
 					Helpers::SurfaceInstanceDirty(self, navMeshData, lock);
 				}
 				else {
@@ -485,12 +705,13 @@ namespace Jimara {
 						navMeshData->surfaces.pop_back();
 					}
 					{
-						const PosedOctree<Triangle3> last = navMeshData->surfaceGeometry[navMeshData->surfaceGeometry.Size() - 1u];
-						navMeshData->surfaceGeometry[index] = last;
-						navMeshData->surfaceGeometry.Pop();
+						std::swap(navMeshData->surfaceGeometry.back(), navMeshData->surfaceGeometry[index]);
+						navMeshData->surfaceGeometry.pop_back();
 					}
+					Helpers::InvalidateSurfaceBVH(navMeshData, true);
+					navMeshData->pathCache.Clear();
 					self->m_activeIndex = std::optional<size_t>();
-					assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.Size());
+					assert(navMeshData->surfaces.size() == navMeshData->surfaceGeometry.size());
 					assert(!self->m_activeIndex.has_value());
 				}
 			}, this);
@@ -554,29 +775,36 @@ namespace Jimara {
 				(triangleId == other.triangleId) &&
 				(edgeId.x == other.edgeId.x);
 		}
+
+		struct Hash {
+			inline size_t operator()(const SurfaceEdgeNode& node)const {
+				return std::hash<size_t>()((((node.instanceId * 31u) + node.triangleId) << 2u) ^ static_cast<size_t>(node.edgeId.x));
+			}
+		};
 	};
 
 	std::vector<NavMesh::Helpers::SurfaceEdgeNode> NavMesh::Helpers::CalculateEdgeSequence(
 		const NavMeshData* data, Vector3 start, Vector3 end, Vector3 agentUp, const AgentOptions& agentOptions) {
+		const BVH<PosedOctree<Triangle3>> surfaceBVH = SurfaceBVH(data);
 		auto findHitSurface = [&](const Vector3& point) -> std::tuple<size_t, size_t, Vector3> {
 			const Vector3 origin = point + Math::Normalize(agentUp) * 
 				Math::Max(agentOptions.surfaceSearchRadius * 1.05f, std::numeric_limits<float>::epsilon() * 16.0f);
 			const Vector3 direction = -Math::Normalize(agentUp);
-			auto rayHit = data->surfaceGeometry.Raycast(origin, direction, 2.0f * agentOptions.surfaceSearchRadius);
+			auto rayHit = surfaceBVH.Raycast(origin, direction);
 			size_t instanceId;
 			size_t triangleId;
 			Vector3 hitPoint;
-			if (rayHit) {
-				instanceId = data->surfaceGeometry.IndexOf(rayHit.target);
-				triangleId = data->surfaceGeometry[instanceId].octree.IndexOf(rayHit.hit.target);
+			if (rayHit && rayHit.totalDistance <= (2.0f * agentOptions.surfaceSearchRadius)) {
+				instanceId = surfaceBVH.IndexOf(rayHit.target);
+				triangleId = surfaceBVH[instanceId].octree.IndexOf(rayHit.hit.target);
 				hitPoint = static_cast<Math::SweepHitPoint>(rayHit);
 			}
 			else {
-				auto sphereHit = data->surfaceGeometry.Sweep(Sphere(agentOptions.surfaceSearchRadius), origin, direction);
+				auto sphereHit = surfaceBVH.Sweep(Sphere(agentOptions.surfaceSearchRadius), origin, direction);
 				if (!sphereHit)
 					return { ~size_t(0u), ~size_t(0u), Vector3(0.0f) };
-				instanceId = data->surfaceGeometry.IndexOf(sphereHit.target);
-				triangleId = data->surfaceGeometry[instanceId].octree.IndexOf(sphereHit.hit.target);
+				instanceId = surfaceBVH.IndexOf(sphereHit.target);
+				triangleId = surfaceBVH[instanceId].octree.IndexOf(sphereHit.hit.target);
 				hitPoint = static_cast<Math::SweepHitPoint>(sphereHit);
 			}
 			return { instanceId, triangleId, hitPoint };
@@ -595,103 +823,159 @@ namespace Jimara {
 		const SurfaceEdgeNode startEdge(startHitPoint, startInstanceId, startTriangleId, startTriangleId, Size2(4u));
 		const SurfaceEdgeNode endEdge(endHitPoint, endInstanceId, endTriangleId, endTriangleId, Size2(5u));
 
-		const float normalThreshold = std::cos(Math::Radians(agentOptions.maxTiltAngle));
-
 		if (startEdge.triangleId == endEdge.triangleId)
 			return { startEdge, endEdge };
 
+		// Nested requests from additionalPathWeight bypass the cache, since they could end up waiting for themselves otherwise:
+		static thread_local bool cachedSearchInProgress = false;
+		if (agentOptions.pathCacheGroup == 0u || cachedSearchInProgress)
+			return SearchEdgeSequence(data, startEdge, endEdge, agentUp, agentOptions);
+
+		PathCache::Key key = {};
+		{
+			key.instanceId = startEdge.instanceId;
+			key.startTriangleId = startEdge.triangleId;
+			key.endTriangleId = endEdge.triangleId;
+			key.flags = agentOptions.flags;
+			key.radius = agentOptions.radius;
+			key.maxTiltAngle = agentOptions.maxTiltAngle;
+			key.agentUp = ((agentOptions.flags & AgentFlags::FIXED_UP_DIRECTION) != AgentFlags::NONE) ? agentUp : Vector3(0.0f);
+			key.group = agentOptions.pathCacheGroup;
+		}
+
+		// Find existing entry or register a new one, so that the concurrent matching requests can wait for this search:
+		PathCache& cache = data->pathCache;
+		std::shared_future<EdgeSequence> cachedSequence;
+		std::promise<EdgeSequence> searchResult;
+		bool searchNeeded = false;
+		{
+			std::unique_lock<std::mutex> lock(cache.lock);
+			const auto it = cache.entries.find(key);
+			if (it != cache.entries.end())
+				cachedSequence = it->second;
+			else {
+				if (cache.entries.size() >= PathCache::MAX_ENTRY_COUNT)
+					cache.entries.clear();
+				cachedSequence = searchResult.get_future().share();
+				cache.entries.insert(std::make_pair(key, cachedSequence));
+				searchNeeded = true;
+			}
+		}
+
+		if (searchNeeded) {
+			cache.missCount++;
+			std::vector<SurfaceEdgeNode> nodes;
+			try {
+				InUseFlagGuard searchInProgress(cachedSearchInProgress);
+				nodes = SearchEdgeSequence(data, startEdge, endEdge, agentUp, agentOptions);
+			}
+			catch (...) {
+				// Failed search should neither stay cached, nor leave the merged requests with a broken promise:
+				{
+					std::unique_lock<std::mutex> lock(cache.lock);
+					cache.entries.erase(key);
+				}
+				searchResult.set_exception(std::current_exception());
+				throw;
+			}
+			searchResult.set_value(std::make_shared<const std::vector<SurfaceEdgeNode>>(nodes));
+			return nodes;
+		}
+
+		if (cachedSequence.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			cache.hitCount++;
+		else cache.mergedCount++;
+		const EdgeSequence sequence = cachedSequence.get();
+		if (sequence == nullptr || sequence->size() < 2u)
+			return {};
+
+		// Cached sequence only shares start and end faces with the request, so the exact hit points have to be replaced:
+		std::vector<SurfaceEdgeNode> nodes = *sequence;
+		nodes.front() = startEdge;
+		nodes.back() = endEdge;
+		return nodes;
+	}
+
+	std::vector<NavMesh::Helpers::SurfaceEdgeNode> NavMesh::Helpers::SearchEdgeSequence(
+		const NavMeshData* data, const SurfaceEdgeNode& startEdge, const SurfaceEdgeNode& endEdge, Vector3 agentUp, const AgentOptions& agentOptions) {
+		const float normalThreshold = std::cos(Math::Radians(agentOptions.maxTiltAngle));
+
 		auto heuristic = [&](const SurfaceEdgeNode& node) {
 			return Math::Magnitude(endEdge.worldPosition - node.worldPosition);
 		};
 
-		const auto calculateUnnormalizedLocalNormal = [](const Triangle3& tri) {
-			return Math::Cross(tri[2u] - tri[0u], tri[1u] - tri[0u]);
-		};
-
 		auto calculateNormal = [&](const SurfaceEdgeNode& node) {
-			const PosedOctree<Triangle3>& instance = data->surfaceGeometry[node.instanceId];
-			Vector3 localNormal = Math::Normalize(calculateUnnormalizedLocalNormal(instance.octree[node.triangleId]));
+			Vector3 normal = WorldTriangleNormal(data, node.instanceId, node.triangleId);
 			if (node.edgeId.x < 3u)
-				localNormal += Math::Normalize(calculateUnnormalizedLocalNormal(instance.octree[node.otherTriangleId]));
-			return Math::Normalize(instance.pose * Vector4(localNormal, 0.0f));
+				normal += WorldTriangleNormal(data, node.instanceId, node.otherTriangleId);
+			return Math::Normalize(normal);
 		};
 
+		// If set, steps onto the faces outside the clusters, marked by this mask, will cost more (see CORRIDOR_EXIT_PENALTY):
+		const std::vector<bool>* corridor = nullptr;
+
 		auto getNeighbors = [&](const SurfaceEdgeNode& node, auto reportNeighbor) {
 			const PosedOctree<Triangle3>& instance = data->surfaceGeometry[node.instanceId];
-			const Helpers::SurfaceInstanceInfo& instanceInfo = data->surfaces[node.instanceId];
-			const std::vector<Stacktor<uint32_t, 3u>>& triNeighbors = instanceInfo.bakedData->triNeighbors;
+			const BakedSurfaceData* const bakedData = data->surfaces[node.instanceId].bakedData;
+			if (bakedData == nullptr)
+				return;
 
-			auto report = [&](const SurfaceEdgeNode& neighbor) {
+			auto report = [&](const SurfaceEdgeNode& neighbor, float costMultiplier) {
 				const float distance = Math::Magnitude(neighbor.worldPosition - node.worldPosition);
 				const PathNode nodeA = PathNode{ node.worldPosition, calculateNormal(node) };
 				const PathNode nodeB = PathNode{ neighbor.worldPosition, calculateNormal(neighbor) };
 				const float additionalWeight = Math::Max(agentOptions.additionalPathWeight(nodeA, nodeB), 0.0f);
-				reportNeighbor(neighbor, distance + additionalWeight);
+				reportNeighbor(neighbor, (distance + additionalWeight) * costMultiplier);
+			};
+
+			auto worldNormal = [&](size_t triId) {
+				return WorldTriangleNormal(data, node.instanceId, triId);
+			};
+
+			// Under uniform scale, the baked portal widths can be compared against the radius without transforming the edge offsets:
+			const Vector3 poseScale(
+				Math::Magnitude((Vector3)instance.pose[0]),
+				Math::Magnitude((Vector3)instance.pose[1]),
+				Math::Magnitude((Vector3)instance.pose[2]));
+			const float maxPoseScale = Math::Max(poseScale.x, Math::Max(poseScale.y, poseScale.z));
+			const float minPoseScale = Math::Min(poseScale.x, Math::Min(poseScale.y, poseScale.z));
+			const bool uniformPoseScale = ((maxPoseScale - minPoseScale) <= (maxPoseScale * 0.0001f));
+			auto portalWidth = [&](const BakedSurfaceData::Portal& portal) {
+				return uniformPoseScale
+					? (portal.width * maxPoseScale)
+					: Math::Magnitude(Vector3(instance.pose * Vector4(portal.offset, 0.0f)));
 			};
 
 			auto reportTriangleEdges = [&](size_t triId, uint32_t edgeId) {
-				if (triId >= triNeighbors.size())
+				if (triId >= bakedData->triPortals.size())
 					return;
 
 				if (node.instanceId == endEdge.instanceId &&
 					triId == endEdge.triangleId &&
 					node.edgeId.x != endEdge.edgeId.x) {
-					report(endEdge);
+					report(endEdge, 1.0f);
 				}
 
-				const Stacktor<uint32_t, 3u>& neighbors = triNeighbors[triId];
-				auto calculateNormal = [&](const Triangle3& tri) {
-					return Math::Normalize(Vector3(instance.pose * Vector4(calculateUnnormalizedLocalNormal(tri), 0.0f)));
-				};
-				const Triangle3 tri0 = instance.octree[triId];
 				const Vector3 normal0 =
 					((agentOptions.flags & AgentFlags::FIXED_UP_DIRECTION) != AgentFlags::NONE)
-					? agentUp : calculateNormal(tri0);
-				for (size_t nId = 0u; nId < neighbors.Size(); nId++) {
-					const size_t neighborId = neighbors[nId];
-					if (neighborId == node.triangleId || neighborId == node.otherTriangleId)
+					? agentUp : worldNormal(triId);
+				const Stacktor<uint32_t, 3u>& portalIds = bakedData->triPortals[triId];
+				for (size_t pId = 0u; pId < portalIds.Size(); pId++) {
+					const BakedSurfaceData::Portal& portal = bakedData->portals[portalIds[pId]];
+					const bool isFirst = (portal.triangles.x == triId);
+					const size_t neighborId = isFirst ? portal.triangles.y : portal.triangles.x;
+					const uint32_t eI0 = isFirst ? portal.edges.x : portal.edges.y;
+					const uint32_t eI1 = isFirst ? portal.edges.y : portal.edges.x;
+					if (neighborId == node.triangleId || neighborId == node.otherTriangleId || eI0 == edgeId)
 						continue;
-					const Triangle3 tri1 = instance.octree[neighborId];
-					const Vector3 normal1 = calculateNormal(tri1);
-					if (Math::Dot(normal1, normal0) < normalThreshold)
+					const float costMultiplier = (corridor != nullptr && (!(*corridor)[bakedData->triClusters[neighborId]]))
+						? CORRIDOR_EXIT_PENALTY : 1.0f;
+					if (Math::Dot(worldNormal(neighborId), normal0) < normalThreshold)
 						continue;
-					auto reportIfNodesMatch = [&](uint32_t eI0, uint32_t eI1) {
-						const Vector3& a0 = tri0[eI0];
-						const Vector3& b0 = tri0[(eI0 + 1u) % 3u];
-						const Vector3& a1 = tri1[eI1];
-						const Vector3& b1 = tri1[(eI1 + 1u) % 3u];
-						const float distanceThresh = 0.01f * Math::Magnitude(a0 - b0);
-						auto areCloseEnough = [&](const Vector3& a, const Vector3& b) {
-							return Math::Magnitude(a - b) <= distanceThresh;
-						};
-						if ((!areCloseEnough(a0, b1)) || (!areCloseEnough(b0, a1)))
-						//if (a0 != b1 || b0 != a1)
-							return false;
-						const Vector3 localMidpoint = (a0 + b0) * 0.5f;
-						const Vector3 worldMidpoint = instance.pose * Vector4(localMidpoint, 1.0f);
-						//*
-						const Vector3 worldOffset = instance.pose * Vector4(b0 - a0, 0.0f);
-						//if (edgeId >= 3u) {
-							if ((Math::Magnitude(worldOffset) * 0.5f) < agentOptions.radius)
-								return false;
-						//}
-						//else {
-						//	const Vector3 dir = Math::Normalize(worldMidpoint - node.worldPosition);
-						//	const Vector3 axisOffset = worldOffset - dir * Math::Dot(worldOffset, dir);
-						//	if ((Math::Magnitude(axisOffset) * 0.5f) < agentOptions.radius)
-						//		return false;
-						//}
-						//*/
-						report(SurfaceEdgeNode(worldMidpoint, node.instanceId, triId, neighborId, Size2(eI0, eI1)));
-						return true;
-					};
-					for (uint32_t eI1 = 0u; eI1 < 3u; eI1++)
-						for (uint32_t eI0 = 0u; eI0 < 3u; eI0++)
-							if (eI0 != edgeId)
-								if (reportIfNodesMatch(eI0, eI1)) {
-									eI1 = 8u;
-									break;
-								}
+					if ((portalWidth(portal) * 0.5f) < agentOptions.radius)
+						continue;
+					const Vector3 worldMidpoint = instance.pose * Vector4(portal.midpoint, 1.0f);
+					report(SurfaceEdgeNode(worldMidpoint, node.instanceId, triId, neighborId, Size2(eI0, eI1)), costMultiplier);
 				}
 			};
 
@@ -700,7 +984,65 @@ namespace Jimara {
 				reportTriangleEdges(node.otherTriangleId, node.edgeId.y);
 		};
 
-		const std::vector<SurfaceEdgeNode> nodes = Algorithms::AStar(startEdge, endEdge, heuristic, getNeighbors);
+		// On large surfaces, we first find a corridor of clusters and steer the face-level search towards it:
+		std::vector<bool> clusterCorridor;
+		if ((agentOptions.flags & AgentFlags::DISABLE_HIERARCHICAL_SEARCH) == AgentFlags::NONE) {
+			const BakedSurfaceData* const bakedData = data->surfaces[startEdge.instanceId].bakedData;
+			if (bakedData != nullptr && bakedData->clusters.size() > 1u &&
+				startEdge.triangleId < bakedData->triClusters.size() && endEdge.triangleId < bakedData->triClusters.size()) {
+				const PosedOctree<Triangle3>& instance = data->surfaceGeometry[startEdge.instanceId];
+				const std::vector<BakedSurfaceData::Cluster>& clusters = bakedData->clusters;
+				auto clusterCenter = [&](uint32_t clusterId) {
+					return Vector3(instance.pose * Vector4(clusters[clusterId].center, 1.0f));
+				};
+				// Cluster-level steps go from center to portal midpoint to center, so the distance between the centers never overestimates the remaining cost:
+				const Vector3 endClusterCenter = clusterCenter(bakedData->triClusters[endEdge.triangleId]);
+				auto clusterHeuristic = [&](uint32_t clusterId) {
+					return Math::Magnitude(endClusterCenter - clusterCenter(clusterId));
+				};
+				auto getClusterNeighbors = [&](uint32_t clusterId, auto reportNeighbor) {
+					const Vector3 center = clusterCenter(clusterId);
+					const Stacktor<Size2, 4u>& links = clusters[clusterId].links;
+					for (size_t i = 0u; i < links.Size(); i++) {
+						const BakedSurfaceData::Portal& portal = bakedData->portals[links[i].y];
+						const Vector3 worldOffset = instance.pose * Vector4(portal.offset, 0.0f);
+						if ((Math::Magnitude(worldOffset) * 0.5f) < agentOptions.radius)
+							continue;
+						const Vector3 worldMidpoint = instance.pose * Vector4(portal.midpoint, 1.0f);
+						reportNeighbor(links[i].x,
+							Math::Magnitude(worldMidpoint - center) + Math::Magnitude(clusterCenter(links[i].x) - worldMidpoint));
+					}
+				};
+				std::vector<uint32_t> clusterPath;
+				Algorithms::PathfindingStatus status = Algorithms::PathfindingStatus::NOT_FOUND;
+				SearchWithSharedContext<Algorithms::PathfindingContext<uint32_t, float>>([&](auto& context) {
+					status = context.FindPath(
+						bakedData->triClusters[startEdge.triangleId], bakedData->triClusters[endEdge.triangleId],
+						clusterHeuristic, getClusterNeighbors, clusterPath);
+					});
+
+				// Cluster links are only filtered by width, so if there's no cluster-level path, there can not be a face-level one either:
+				if (status != Algorithms::PathfindingStatus::FOUND)
+					return {};
+				// Optimal face-level paths rarely follow cluster centers, so the corridor is widened by the clusters, adjacent to the cluster path:
+				clusterCorridor.resize(clusters.size(), false);
+				for (size_t i = 0u; i < clusterPath.size(); i++) {
+					clusterCorridor[clusterPath[i]] = true;
+					const Stacktor<Size2, 4u>& links = clusters[clusterPath[i]].links;
+					for (size_t j = 0u; j < links.Size(); j++)
+						clusterCorridor[links[j].x] = true;
+				}
+			}
+		}
+
+		// Leaving the corridor is penalized rather than forbidden, so slope limitations (or unfortunate cluster shapes)
+		// do not make the search fail and the single search is enough to find the path, if there is one:
+		std::vector<SurfaceEdgeNode> nodes;
+		if (!clusterCorridor.empty())
+			corridor = &clusterCorridor;
+		SearchWithSharedContext<Algorithms::PathfindingContext<SurfaceEdgeNode, float, SurfaceEdgeNode::Hash>>([&](auto& context) {
+			context.FindPath(startEdge, endEdge, heuristic, getNeighbors, nodes);
+			});
 		return nodes;
 	}
 
@@ -724,9 +1066,8 @@ namespace Jimara {
 			EdgePortal portal = {};
 
 			const PosedOctree<Triangle3>& geometry = data->surfaceGeometry[node.instanceId];
-			auto normal = [&](const Triangle3& tri) {
-				return Math::Normalize(Vector3(geometry.pose * Vector4(
-					Math::Normalize(Math::Cross(tri[2u] - tri[0u], tri[1u] - tri[0u])), 0.0f)));
+			auto normal = [&](size_t triId) {
+				return WorldTriangleNormal(data, node.instanceId, triId);
 			};
 			const Triangle3& face = geometry.octree[node.triangleId];
 
@@ -738,12 +1079,12 @@ namespace Jimara {
 				portal.b = portal.a;
 				portal.length = 0.0f;
 				portal.direction = Vector3(0.0f);
-				portal.normal = normal(face);
+				portal.normal = normal(node.triangleId);
 			}
 			else {
 				portal.a = Vector3(geometry.pose * Vector4(face[node.edgeId.x], 1.0f));
 				portal.b = Vector3(geometry.pose * Vector4(face[(node.edgeId.x + 1u) % 3u], 1.0f));
-				portal.normal = Math::Normalize(normal(face) + normal(geometry.octree[node.otherTriangleId]));
+				portal.normal = Math::Normalize(normal(node.triangleId) + normal(node.otherTriangleId));
 				const Vector3 prevPos = path[i - 1u].worldPosition;
 				if (Math::Dot(portal.normal, Math::Cross(portal.a - prevPos, portal.b - prevPos)) < 0.0f)
 					std::swap(portal.a, portal.b);
@@ -893,6 +1234,16 @@ namespace Jimara {
 		return result;
 	}
 
+	NavMesh::PathCacheStatistics NavMesh::CacheStatistics()const {
+		const Helpers::NavMeshData* data = Helpers::GetData(this);
+		assert(data != nullptr);
+		PathCacheStatistics statistics = {};
+		statistics.hitCount = data->pathCache.hitCount.load();
+		statistics.mergedCount = data->pathCache.mergedCount.load();
+		statistics.missCount = data->pathCache.missCount.load();
+		return statistics;
+	}
+
 	Event<float>& NavMesh::OnUpdate()const {
 		Helpers::NavMeshData* data = Helpers::GetData(this);
 		assert(data != nullptr);
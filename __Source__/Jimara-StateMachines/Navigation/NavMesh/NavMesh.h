@@ -34,7 +34,13 @@ namespace Jimara {
 			/// If this flag is not set, the NavMesh assumes the agent can "walk on walls" and 
 			/// maxTiltAngle only matters when it comes to neighboring surface normals
 			/// </summary>
-			FIXED_UP_DIRECTION = (1u << 0u)
+			FIXED_UP_DIRECTION = (1u << 0u),
+
+			/// <summary>
+			/// If set, large surfaces will be searched face-by-face, without the cluster-level corridor
+			/// (slower for long paths, but the resulting face sequence is the shortest one)
+			/// </summary>
+			DISABLE_HIERARCHICAL_SEARCH = (1u << 1u)
 		};
 
 		/// <summary> General information about an agent </summary>
@@ -61,6 +67,29 @@ namespace Jimara {
 			/// </summary>
 			Function<float, const PathNode&, const PathNode&> additionalPathWeight =
 				Function<float, const PathNode&, const PathNode&>([](const PathNode&, const PathNode&) -> float { return 0.0f; });
+
+			/// <summary>
+			/// Path cache group
+			/// <para/> If nonzero, face sequences between the same start and end faces will be shared between the requests 
+			/// with matching flags, radius, maxTiltAngle, up-direction and pathCacheGroup 
+			/// (additionalPathWeight is expected to behave identically for all requests within the group, 
+			/// so the group has to identify the weighting parameters exactly; a hash of those is not enough);
+			/// <para/> Identical requests, running concurrently, will wait for a single search instead of repeating it;
+			/// <para/> Cached results are discarded each time surface instances get added, removed, moved or reshaped.
+			/// </summary>
+			size_t pathCacheGroup = 0u;
+		};
+
+		/// <summary> Path cache usage counters </summary>
+		struct JIMARA_STATE_MACHINES_API PathCacheStatistics {
+			/// <summary> Number of requests, served from the cache </summary>
+			size_t hitCount = 0u;
+
+			/// <summary> Number of requests, that waited for a matching search in progress </summary>
+			size_t mergedCount = 0u;
+
+			/// <summary> Number of cacheable requests, that had to run the search </summary>
+			size_t missCount = 0u;
 		};
 		
 		/// <summary> Flags for navigation mesh surfaces </summary>
@@ -110,6 +139,55 @@ namespace Jimara {
 
 			/// <summary> For each triangle, a list of neighboring face indices </summary>
 			std::vector<Stacktor<uint32_t, 3u>> triNeighbors;
+
+			/// <summary> Edge, shared by two neighboring faces (all values are in surface-local space) </summary>
+			struct Portal {
+				/// <summary> Indices of the faces, sharing the edge (triangles.x is always smaller than triangles.y) </summary>
+				Size2 triangles = Size2(~uint32_t(0u));
+
+				/// <summary> Index of the shared edge within each face ('Edge index i' means face[i] to face[(i + 1u) % 3u]) </summary>
+				Size2 edges = Size2(~uint32_t(0u));
+
+				/// <summary> Edge midpoint </summary>
+				Vector3 midpoint = Vector3(0.0f);
+
+				/// <summary> Edge end minus edge start (as seen from triangles.x) </summary>
+				Vector3 offset = Vector3(0.0f);
+
+				/// <summary> Edge length (ei portal width) </summary>
+				float width = 0.0f;
+			};
+
+			/// <summary> For each triangle, normalized face normal (surface-local space) </summary>
+			std::vector<Vector3> triNormals;
+
+			/// <summary> Edges, shared by the neighboring faces </summary>
+			std::vector<Portal> portals;
+
+			/// <summary> For each triangle, a list of indices of the portals it is a part of </summary>
+			std::vector<Stacktor<uint32_t, 3u>> triPortals;
+
+			/// <summary>
+			/// Group of connected neighboring faces
+			/// <para/> On large surfaces, paths are first searched for on the cluster graph
+			/// and then refined on the faces of the clusters along the found corridor.
+			/// </summary>
+			struct Cluster {
+				/// <summary> Average of the face centers (surface-local space) </summary>
+				Vector3 center = Vector3(0.0f);
+
+				/// <summary> Number of faces within the cluster </summary>
+				uint32_t triangleCount = 0u;
+
+				/// <summary> Neighboring clusters (x is the neighbor cluster index, y is the index of the widest portal between the two) </summary>
+				Stacktor<Size2, 4u> links;
+			};
+
+			/// <summary> For each triangle, index of the cluster it belongs to </summary>
+			std::vector<uint32_t> triClusters;
+
+			/// <summary> Face clusters (only generated if the surface has enough faces for the hierarchical search to make sense) </summary>
+			std::vector<Cluster> clusters;
 		};
 
 		/// <summary> Navigation mesh surface </summary>
@@ -224,6 +302,9 @@ namespace Jimara {
 		/// <returns> Path between start and end points for the given agent </returns>
 		std::vector<PathNode> CalculatePath(Vector3 start, Vector3 end, Vector3 agentUp, const AgentOptions& agentOptions)const;
 
+		/// <summary> Total path cache usage counters (see AgentOptions::pathCacheGroup) </summary>
+		PathCacheStatistics CacheStatistics()const;
+
 		/// <summary>
 		/// Navigation meshes run an external update loop, independent of the main render/update loop 
 		/// to let the users have large, potentially time consuming calculations runnning in the background without causing the game to stutter.
@@ -2,16 +2,56 @@
 #include <Jimara/Data/Serialization/Helpers/SerializerMacros.h>
 #include <Jimara/Environment/LogicSimulation/SimulationThreadBlock.h>
 #include <Jimara/Math/Random.h>
+#include <Jimara/Core/Stopwatch.h>
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <shared_mutex>
 
 namespace Jimara {
 	struct NavMeshAgent::Helpers {
 		struct RequestSnapshot {
 			Reference<NavMesh> navMesh;
 			AgentOptions agentOptions = {};
+			size_t pathCacheGroup = 0u;
 
 			std::shared_ptr<AgentState> agentState;
 		};
 
+		// Agents can only share cached paths if their slope weight curves are identical, so each distinct set of curve parameters 
+		// (keyframe times, values, handles and interpolation flags, compared bitwise) gets a unique path cache group:
+		static size_t PathCacheGroup(const AgentOptions& options) {
+			std::vector<uint32_t> parameters;
+			auto addParameter = [&](float value) {
+				uint32_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				parameters.push_back(bits);
+			};
+			for (auto it = options.slopeWeight.begin(); it != options.slopeWeight.end(); ++it) {
+				const BezierNode<float>& node = it->second;
+				addParameter(it->first);
+				addParameter(node.Value());
+				addParameter(node.PrevHandle());
+				addParameter(node.NextHandle());
+				parameters.push_back(
+					(node.IndependentHandles() ? 1u : 0u) |
+					(node.InterpolateConstant().active ? 2u : 0u) |
+					(node.InterpolateConstant().next ? 4u : 0u));
+			}
+
+			static std::shared_mutex groupLock;
+			static std::map<std::vector<uint32_t>, size_t> groups;
+			{
+				std::shared_lock<std::shared_mutex> lock(groupLock);
+				const auto it = groups.find(parameters);
+				if (it != groups.end())
+					return it->second;
+			}
+			std::unique_lock<std::shared_mutex> lock(groupLock);
+			const size_t newGroup = groups.size() + 1u;
+			return groups.insert(std::make_pair(std::move(parameters), newGroup)).first->second;
+		}
+
 		static bool UpdateLastKnownPositionAndUpDirection(NavMeshAgent* self) {
 			std::optional<Vector3> agentPosition = InputProvider<Vector3>::GetInput(self->m_agentPositionOverride);
 			std::optional<Vector3> agentUp = InputProvider<Vector3>::GetInput(self->m_agentUpDirectionOverride);
@@ -40,6 +80,7 @@ namespace Jimara {
 			RequestSnapshot snapshot;
 			snapshot.navMesh = self->m_navMesh;
 			snapshot.agentOptions = self->m_agentOptions;
+			snapshot.pathCacheGroup = PathCacheGroup(snapshot.agentOptions);
 			snapshot.agentState = self->m_state;
 			return snapshot;
 		}
@@ -50,6 +91,7 @@ namespace Jimara {
 			options.surfaceSearchRadius = snapshot.agentOptions.surfaceSearchRadius;
 			options.maxTiltAngle = snapshot.agentOptions.angleThreshold;
 			options.flags = snapshot.agentOptions.agentFlags;
+			options.pathCacheGroup = snapshot.pathCacheGroup;
 			
 			Vector3 agentPosition;
 			Vector3 agentUp;
@@ -89,61 +131,50 @@ namespace Jimara {
 			}
 		}
 
-		struct RequestList : public virtual Object, public virtual std::vector<RequestSnapshot> {};
-
 		struct RequestFlusher : public virtual Object {
 			ThreadBlock threadBlock;
+			std::atomic<size_t> maxThreadCount = 1u;
+
+			// Queued requests are only modified by the Updater while no flush is pending and get picked up by the flush job as soon as it starts:
 			SpinLock requestLock;
-			std::unique_ptr<std::vector<Reference<RequestList>>> requests;
-		};
+			bool flushPending = false;
+			std::vector<RequestSnapshot> requests;
 
-		static void FlushRequests(Object* listPtr, float) {
-			RequestFlusher& flusher = *dynamic_cast<RequestFlusher*>(listPtr);
+			// Requests, being processed by the flush job (NavMesh update queue is serial, so only one flush can access these at a time):
+			std::vector<RequestSnapshot> inFlight;
 
-			struct Data {
-				SpinLock jobLock;
-				size_t bucketId = 0u;
-				size_t elemId = 0u;
-				std::unique_ptr<std::vector<Reference<RequestList>>> requests;
-			};
-			Data data;
+			SpinLock statisticsLock;
+			PathRequestStatistics statistics;
+		};
+
+		static void FlushRequests(Object* flusherPtr, float) {
+			RequestFlusher& flusher = *dynamic_cast<RequestFlusher*>(flusherPtr);
+			std::vector<RequestSnapshot>& requests = flusher.inFlight;
 			{
 				std::unique_lock<decltype(flusher.requestLock)> lock(flusher.requestLock);
-				std::swap(flusher.requests, data.requests);
-				assert(flusher.requests == nullptr);
+				assert(requests.empty());
+				std::swap(flusher.requests, requests);
+				flusher.flushPending = false;
 			}
-			if (data.requests == nullptr)
-				return;
-
-			typedef void(*UpdateFn)(ThreadBlock::ThreadInfo, void*);
-			static const UpdateFn updateFn = [](ThreadBlock::ThreadInfo, void* procPtr) {
-				Data* const proc = reinterpret_cast<Data*>(procPtr);
-				while (true) {
-					const RequestSnapshot* snapshot;
-					{
-						std::unique_lock<decltype(proc->jobLock)> lock(proc->jobLock);
-						if (proc->bucketId >= proc->requests->size())
-							break;
-						const RequestList& requests = *proc->requests->operator[](proc->bucketId);
-						if (proc->elemId >= requests.size()) {
-							proc->elemId = 0u;
-							proc->bucketId++;
-						}
-						snapshot = &requests[proc->elemId];
-						proc->elemId++;
-					}
-					CalculatePath(*snapshot);
-				}
-			};
-
-			size_t totalRequestCount = 0u;
-			for (size_t i = 0u; i < data.requests->size(); i++)
-				totalRequestCount += data.requests->operator[](i)->size();
-			if (totalRequestCount <= 1u)
-				updateFn({}, reinterpret_cast<void*>(&data));
-			else flusher.threadBlock.Execute(
-				Math::Min(size_t(std::thread::hardware_concurrency()) / 2u, totalRequestCount / 2u) + 1u,
-				reinterpret_cast<void*>(&data), Callback<ThreadBlock::ThreadInfo, void*>(updateFn));
+			if (!requests.empty()) {
+				const NavMesh* navMesh = requests.front().navMesh;
+				const NavMesh::PathCacheStatistics initialCacheStatistics = navMesh->CacheStatistics();
+				Stopwatch stopwatch;
+
+				// Path calculation times vary greatly, so threads claim small chunks of the flattened request list:
+				ParallelFor(flusher.threadBlock, flusher.maxThreadCount.load(), 0u, requests.size(), 1u, [&](size_t index) {
+					CalculatePath(requests[index]);
+					});
+
+				const float pathfindingTime = stopwatch.Elapsed();
+				const NavMesh::PathCacheStatistics cacheStatistics = navMesh->CacheStatistics();
+				std::unique_lock<decltype(flusher.statisticsLock)> lock(flusher.statisticsLock);
+				flusher.statistics.requestCount = requests.size();
+				flusher.statistics.cacheHitCount = (cacheStatistics.hitCount - initialCacheStatistics.hitCount);
+				flusher.statistics.mergedRequestCount = (cacheStatistics.mergedCount - initialCacheStatistics.mergedCount);
+				flusher.statistics.pathfindingTime = pathfindingTime;
+			}
+			requests.clear();
 		}
 
 		class Updater : public virtual ObjectCache<Reference<const Object>>::StoredObject {
@@ -153,7 +184,15 @@ namespace Jimara {
 			std::mutex m_lock;
 			std::set<NavMeshAgent*> m_agents;
 			std::vector<NavMeshAgent*> m_agentList;
+			std::vector<std::optional<RequestSnapshot>> m_requestSlots;
+			std::vector<uint8_t> m_dueFlags;
+			std::vector<size_t> m_dueAgents;
+			std::vector<RequestSnapshot> m_requestBuffer;
 			const Reference<RequestFlusher> m_requestFlusher = Object::Instantiate<RequestFlusher>();
+			std::atomic<size_t> m_requestBudget = 256u;
+			std::atomic<size_t> m_deferredRequestCount = 0u;
+			std::atomic<size_t> m_agentCount = 0u;
+			std::atomic<float> m_agentUpdateTime = 0.0f;
 
 			void Update() {
 				std::unique_lock<std::mutex> lock(m_lock);
@@ -163,68 +202,93 @@ namespace Jimara {
 				if (m_agentList.empty())
 					return;
 
+				// While the previous batch is waiting to be picked up by the flush job, agent states still get updated, but new requests are postponed
+				// (once the flush starts, the next batch can be queued, so that the path computation does not add a frame of latency):
+				bool canRequest;
 				{
 					std::unique_lock<decltype(m_requestFlusher->requestLock)> flusherLock(m_requestFlusher->requestLock);
-					if (m_requestFlusher->requests != nullptr)
+					canRequest = !m_requestFlusher->flushPending;
+				}
+
+				// Agent states are updated in parallel; agents, that need a new path are only marked as due:
+				Stopwatch stopwatch;
+				m_requestSlots.resize(m_agentList.size());
+				m_dueFlags.resize(m_agentList.size());
+				static const constexpr size_t AGENT_GRAIN_SIZE = 16u;
+				m_threadBlock->ParallelFor(0u, m_agentList.size(), AGENT_GRAIN_SIZE, [&](size_t index) {
+					m_requestSlots[index] = std::nullopt;
+					m_dueFlags[index] = 0u;
+					NavMeshAgent* agent = m_agentList[index];
+					if (!UpdateLastKnownPositionAndUpDirection(agent))
+						return;
+					TrimPath(agent);
+					const uint64_t frameId = agent->Context()->FrameIndex();
+					if (frameId < agent->m_updateFrame &&
+						(agent->m_updateFrame - frameId) <= agent->m_updateInterval)
 						return;
+					m_dueFlags[index] = 1u;
+					});
+
+				m_agentCount = m_agentList.size();
+
+				// While a flush is pending, due agents are not deferred by the budget; they simply wait for the flush job to pick up the queued batch (deferred count keeps the last real value):
+				if (!canRequest) {
+					m_agentUpdateTime = stopwatch.Elapsed();
+					return;
 				}
 
-				struct UpdateProcess {
-					std::atomic<size_t> index = 0u;
-					NavMeshAgent* const* agents = nullptr;
-					size_t agentCount = 0u;
-					SpinLock requestLock;
-					std::unique_ptr<std::vector<Reference<RequestList>>> requests =
-						std::make_unique<std::vector<Reference<RequestList>>>();
-				};
-				UpdateProcess process = {};
-				{
-					process.index = 0u;
-					process.agents = m_agentList.data();
-					process.agentCount = m_agentList.size();
+				// If there are more due agents than the budget allows, the ones that have waited the longest since their last request go first.
+				// Deferred agents keep their update frame and last request frame, so they get precedence on the following frames:
+				m_dueAgents.clear();
+				for (size_t i = 0u; i < m_dueFlags.size(); i++)
+					if (m_dueFlags[i] != 0u)
+						m_dueAgents.push_back(i);
+				const size_t requestBudget = Math::Max(m_requestBudget.load(), size_t(1u));
+				const size_t requestCount = Math::Min(m_dueAgents.size(), requestBudget);
+				const size_t deferredRequestCount = (m_dueAgents.size() - requestCount);
+				if (deferredRequestCount > 0u)
+					std::nth_element(m_dueAgents.begin(), m_dueAgents.begin() + requestCount, m_dueAgents.end(), [&](size_t a, size_t b) {
+						return m_agentList[a]->m_lastRequestFrame < m_agentList[b]->m_lastRequestFrame;
+						});
+
+				// Each selected agent writes its request into a dedicated slot, so that the threads do not have to synchronize:
+				m_threadBlock->ParallelFor(0u, requestCount, AGENT_GRAIN_SIZE, [&](size_t dueIndex) {
+					const size_t index = m_dueAgents[dueIndex];
+					NavMeshAgent* agent = m_agentList[index];
+					std::optional<RequestSnapshot>& slot = m_requestSlots[index];
+					slot = CreateRequest(agent);
+					if (!slot.has_value())
+						return;
+					const uint64_t frameId = agent->Context()->FrameIndex();
+					agent->m_lastRequestFrame = frameId;
+					agent->m_updateFrame = frameId + uint64_t(Random::Uint()) % (uint64_t(agent->m_updateInterval) + 1u) + 1u;
+					});
+				m_deferredRequestCount = deferredRequestCount;
+				m_agentUpdateTime = stopwatch.Elapsed();
+
+				// Flatten the requests:
+				m_requestBuffer.clear();
+				for (size_t i = 0u; i < m_requestSlots.size(); i++) {
+					std::optional<RequestSnapshot>& slot = m_requestSlots[i];
+					if (!slot.has_value())
+						continue;
+					m_requestBuffer.emplace_back(std::move(slot.value()));
+					slot = std::nullopt;
 				}
-				typedef void(*UpdateFn)(ThreadBlock::ThreadInfo, void*);
-				static const UpdateFn updateFn = [](ThreadBlock::ThreadInfo, void* procPtr) {
-					UpdateProcess* proc = reinterpret_cast<UpdateProcess*>(procPtr);
-					const Reference<RequestList> requestList = Object::Instantiate<RequestList>();
-					while (true) {
-						const size_t index = proc->index.fetch_add(1u);
-						if (index >= proc->agentCount)
-							break;
-						NavMeshAgent* agent = proc->agents[index];
-						if (!UpdateLastKnownPositionAndUpDirection(agent))
-							continue;
-						TrimPath(agent);
-						const uint64_t frameId = agent->Context()->FrameIndex();
-						if (frameId < agent->m_updateFrame &&
-							(agent->m_updateFrame - frameId) <= agent->m_updateInterval)
-							continue;
-						std::optional<RequestSnapshot> snapshot = CreateRequest(agent);
-						if (!snapshot.has_value())
-							continue;
-						agent->m_updateFrame = frameId + uint64_t(Random::Uint()) % (uint64_t(agent->m_updateInterval) + 1u) + 1u;
-						requestList->emplace_back(std::move(snapshot.value()));
-					}
-					if (!requestList->empty()) {
-						std::unique_lock<decltype(proc->requestLock)> lock(proc->requestLock);
-						proc->requests->push_back(requestList);
-					}
-				};
-				if (process.agentCount < 32u)
-					updateFn({}, reinterpret_cast<void*>(&process));
-				else m_threadBlock->Execute(Math::Min(m_threadBlock->DefaultThreadCount(), process.agentCount / 16u + 1u),
-					reinterpret_cast<void*>(&process), Callback<ThreadBlock::ThreadInfo, void*>(updateFn));
-				
-				if (!process.requests->empty()) {
-					const Reference<NavMesh> navMesh = process.requests->begin()->operator->()->begin()->navMesh;
-					assert(navMesh != nullptr);
-					{
-						std::unique_lock<decltype(m_requestFlusher->requestLock)> flusherLock(m_requestFlusher->requestLock);
-						std::swap(m_requestFlusher->requests, process.requests);
-					}
-					navMesh->EnqueueAsynchronousAction(
-						Callback<Object*, float>(Helpers::FlushRequests), m_requestFlusher);
+				if (m_requestBuffer.empty())
+					return;
+
+				const Reference<NavMesh> navMesh = m_requestBuffer.front().navMesh;
+				assert(navMesh != nullptr);
+				m_requestFlusher->maxThreadCount = m_threadBlock->DefaultThreadCount();
+				{
+					std::unique_lock<decltype(m_requestFlusher->requestLock)> flusherLock(m_requestFlusher->requestLock);
+					assert(m_requestFlusher->requests.empty());
+					std::swap(m_requestFlusher->requests, m_requestBuffer);
+					m_requestFlusher->flushPending = true;
 				}
+				navMesh->EnqueueAsynchronousAction(
+					Callback<Object*, float>(Helpers::FlushRequests), m_requestFlusher);
 			}
 
 		public:
@@ -259,6 +323,22 @@ namespace Jimara {
 				m_agents.erase(agent);
 				m_agentList.clear();
 			}
+
+			inline PathRequestStatistics Statistics()const {
+				PathRequestStatistics statistics;
+				{
+					std::unique_lock<decltype(m_requestFlusher->statisticsLock)> lock(m_requestFlusher->statisticsLock);
+					statistics = m_requestFlusher->statistics;
+				}
+				statistics.deferredRequestCount = m_deferredRequestCount.load();
+				statistics.agentCount = m_agentCount.load();
+				statistics.agentUpdateTime = m_agentUpdateTime.load();
+				return statistics;
+			}
+
+			inline size_t RequestBudget()const { return m_requestBudget.load(); }
+
+			inline void SetRequestBudget(size_t budget) { m_requestBudget = Math::Max(budget, size_t(1u)); }
 		};
 
 		static void RandomizeNextUpdate(NavMeshAgent* self) {
@@ -359,6 +439,22 @@ namespace Jimara {
 		return path;
 	}
 
+	NavMeshAgent::PathRequestStatistics NavMeshAgent::RequestStatistics(SceneContext* context) {
+		const Reference<Helpers::Updater> updater = Helpers::Updater::GetFor(context);
+		return (updater == nullptr) ? PathRequestStatistics() : updater->Statistics();
+	}
+
+	size_t NavMeshAgent::PathRequestBudget(SceneContext* context) {
+		const Reference<Helpers::Updater> updater = Helpers::Updater::GetFor(context);
+		return (updater == nullptr) ? size_t(0u) : updater->RequestBudget();
+	}
+
+	void NavMeshAgent::SetPathRequestBudget(SceneContext* context, size_t budget) {
+		const Reference<Helpers::Updater> updater = Helpers::Updater::GetFor(context);
+		if (updater != nullptr)
+			updater->SetRequestBudget(budget);
+	}
+
 	std::optional<Vector3> NavMeshAgent::EvaluateInput() {
 		const std::shared_ptr<const std::vector<NavMesh::PathNode>> path = Path();
 		if (path == nullptr || path->size() < 2u)
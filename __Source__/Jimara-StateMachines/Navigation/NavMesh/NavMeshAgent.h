@@ -110,6 +110,55 @@ namespace Jimara {
 		/// <param name="interval"> Idle frame count </param>
 		inline void SetUpdateInterval(uint32_t interval) { m_updateInterval = interval; }
 
+		/// <summary> Path request statistics of all agents within a scene context (useful for tuning crowd settings) </summary>
+		struct JIMARA_STATE_MACHINES_API PathRequestStatistics {
+			/// <summary> Number of path requests, processed during the last flush </summary>
+			size_t requestCount = 0u;
+
+			/// <summary> Number of requests from the last flush, served from the NavMesh path cache </summary>
+			size_t cacheHitCount = 0u;
+
+			/// <summary> Number of requests from the last flush, that waited for a matching search instead of running their own </summary>
+			size_t mergedRequestCount = 0u;
+
+			/// <summary> Number of agents, whose path updates got postponed because of the per-frame budget (frames, blocked by a pending flush are not counted) </summary>
+			size_t deferredRequestCount = 0u;
+
+			/// <summary> Time (in seconds), spent on calculating paths during the last flush </summary>
+			float pathfindingTime = 0.0f;
+
+			/// <summary> Number of active agents, updated during the last frame </summary>
+			size_t agentCount = 0u;
+
+			/// <summary> 
+			/// Time (in seconds), spent on the last per-frame agent update pass (state updates and request creation) 
+			/// <para/> agentCount / (agentUpdateTime * 1000) gives the crowd throughput in agents per millisecond.
+			/// </summary>
+			float agentUpdateTime = 0.0f;
+		};
+
+		/// <summary>
+		/// Path request statistics for given scene context
+		/// </summary>
+		/// <param name="context"> Scene context </param>
+		/// <returns> Statistics from the last frame/flush </returns>
+		static PathRequestStatistics RequestStatistics(SceneContext* context);
+
+		/// <summary>
+		/// Maximal number of path requests, issued per frame (agents over the budget will be updated on the following frames)
+		/// </summary>
+		/// <param name="context"> Scene context </param>
+		/// <returns> Path request budget </returns>
+		static size_t PathRequestBudget(SceneContext* context);
+
+		/// <summary>
+		/// Sets per-frame path request budget
+		/// <para/> Note: The budget is stored alongside the shared agent updater, so it is only retained while there are NavMeshAgents within the context.
+		/// </summary>
+		/// <param name="context"> Scene context </param>
+		/// <param name="budget"> Maximal number of path requests per frame (0 will be treated as 1) </param>
+		static void SetPathRequestBudget(SceneContext* context, size_t budget);
+
 		/// <summary>
 		/// Provides the direction to go towards
 		/// </summary>
@@ -158,6 +207,7 @@ namespace Jimara {
 		
 		uint32_t m_updateInterval = 8u;
 		std::atomic<uint64_t> m_updateFrame = 0u;
+		uint64_t m_lastRequestFrame = 0u;
 
 		struct AgentState {
 			SpinLock positionLock;
@@ -0,0 +1,152 @@
+#include "../../GtestHeaders.h"
+#include "Components/Animation/Animator.h"
+#include "Components/Transform.h"
+#include "Environment/Scene/Scene.h"
+#include "Environment/LogicSimulation/SimulationThreadBlock.h"
+#include "Core/Stopwatch.h"
+#include "OS/Logging/StreamLogger.h"
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	namespace {
+		inline static Reference<Scene> AnimatorTest_CreateScene() {
+			Scene::CreateArgs args;
+			args.createMode = Scene::CreateArgs::CreateMode::CREATE_DEFAULT_FIELDS_AND_SUPRESS_WARNINGS;
+			return Scene::Create(args);
+		}
+
+		// Creates a bezier curve with random keyframes
+		inline static Reference<TimelineCurve<float, BezierNode<float>>> AnimatorTest_RandomCurve(float duration, std::mt19937& rng) {
+			Reference<TimelineCurve<float, BezierNode<float>>> curve = Object::Instantiate<TimelineCurve<float, BezierNode<float>>>();
+			std::uniform_real_distribution<float> dis(-1.0f, 1.0f);
+			for (float time = 0.0f; time < (duration + 0.5f); time += 0.5f)
+				(*curve)[Math::Min(time, duration)] = BezierNode<float>(dis(rng));
+			return curve;
+		}
+
+		// Creates a clip, animating positions of the bones, named "Bone_0", "Bone_1" and so on
+		inline static Reference<AnimationClip> AnimatorTest_BoneClip(size_t boneCount, float duration, std::mt19937& rng) {
+			Reference<AnimationClip> clip = Object::Instantiate<AnimationClip>("BoneClip");
+			AnimationClip::Writer writer(clip);
+			writer.SetDuration(duration);
+			for (size_t i = 0u; i < boneCount; i++) {
+				writer.AddTrack<AnimationClip::TripleFloatCombine>(
+					AnimatorTest_RandomCurve(duration, rng), AnimatorTest_RandomCurve(duration, rng), AnimatorTest_RandomCurve(duration, rng));
+				writer.AddTrackBinding<Transform>(i, "Bone_" + std::to_string(i));
+				writer.SetTrackTargetField(i, "Position");
+			}
+			return clip;
+		}
+
+		// Creates a rig with an Animator and given number of bones
+		inline static Reference<Animator> AnimatorTest_CreateRig(Component* parent, size_t boneCount, std::vector<Reference<Transform>>& bones) {
+			const Reference<Transform> root = Object::Instantiate<Transform>(parent, "Rig");
+			const Reference<Animator> animator = Object::Instantiate<Animator>(root, "Animator");
+			for (size_t i = 0u; i < boneCount; i++)
+				bones.push_back(Object::Instantiate<Transform>(root, "Bone_" + std::to_string(i)));
+			return animator;
+		}
+
+		inline static Vector3 AnimatorTest_TrackValue(const AnimationClip* clip, size_t trackId, float time) {
+			return dynamic_cast<const ParametricCurve<Vector3, float>*>(clip->GetTrack(trackId))->Value(time);
+		}
+	}
+
+	// Batched animator evaluation has to apply the same blended values the individual curves produce
+	TEST(AnimatorTest, BatchedPlayback) {
+		const Reference<Scene> scene = AnimatorTest_CreateScene();
+		ASSERT_NE(scene, nullptr);
+		std::mt19937 rng;
+
+		static const constexpr size_t RIG_COUNT = 64u;
+		static const constexpr size_t BONE_COUNT = 8u;
+		const Reference<AnimationClip> clipA = AnimatorTest_BoneClip(BONE_COUNT, 2.0f, rng);
+		const Reference<AnimationClip> clipB = AnimatorTest_BoneClip(BONE_COUNT, 3.0f, rng);
+
+		std::unique_lock<std::recursive_mutex> lock(scene->Context()->UpdateLock());
+		std::vector<Reference<Animator>> animators;
+		std::vector<std::vector<Reference<Transform>>> bones(RIG_COUNT);
+		for (size_t i = 0u; i < RIG_COUNT; i++) {
+			const Reference<Animator> animator = AnimatorTest_CreateRig(scene->Context()->RootObject(), BONE_COUNT, bones[i]);
+			Animator::AnimationChannel channelA = animator->Channel(0u);
+			channelA.SetClip(clipA);
+			channelA.SetLooping(true);
+			channelA.SetBlendWeight(1.0f);
+			channelA.SetSpeed(1.0f + 0.01f * static_cast<float>(i));
+			channelA.Play();
+			if ((i % 2u) == 1u) {
+				Animator::AnimationChannel channelB = animator->Channel(1u);
+				channelB.SetClip(clipB);
+				channelB.SetLooping(true);
+				channelB.SetBlendWeight(0.5f);
+				channelB.Play();
+			}
+			animators.push_back(animator);
+		}
+
+		// Every fourth rig is disabled and should not be animated:
+		for (size_t i = 0u; i < RIG_COUNT; i += 4u)
+			animators[i]->SetEnabled(false);
+
+		// Note: Animators sample baked clips, which may deviate slightly from the source curves in-between samples.
+		static const constexpr float TOLERANCE = 0.01f;
+		for (size_t frame = 0u; frame < 32u; frame++) {
+			std::vector<float> timesA(RIG_COUNT), timesB(RIG_COUNT);
+			for (size_t i = 0u; i < RIG_COUNT; i++) {
+				timesA[i] = animators[i]->Channel(0u).Time();
+				timesB[i] = (animators[i]->ChannelCount() > 1u) ? animators[i]->Channel(1u).Time() : 0.0f;
+				for (size_t j = 0u; j < BONE_COUNT; j++)
+					bones[i][j]->SetLocalPosition(Vector3(1000.0f));
+			}
+			scene->Update(0.01f);
+			for (size_t i = 0u; i < RIG_COUNT; i++)
+				for (size_t j = 0u; j < BONE_COUNT; j++) {
+					const Vector3 position = bones[i][j]->LocalPosition();
+					if ((i % 4u) == 0u) {
+						EXPECT_EQ(position, Vector3(1000.0f));
+						continue;
+					}
+					const Vector3 expected = ((i % 2u) == 1u)
+						? ((AnimatorTest_TrackValue(clipA, j, timesA[i]) + AnimatorTest_TrackValue(clipB, j, timesB[i]) * 0.5f) / 1.5f)
+						: AnimatorTest_TrackValue(clipA, j, timesA[i]);
+					EXPECT_LE(Math::Magnitude(position - expected), TOLERANCE);
+				}
+		}
+	}
+
+	// Logs update time of a large number of animated rigs (batch sampling should scale with the simulation thread count)
+	TEST(AnimatorTest, BatchedPlaybackPerformance) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		const Reference<Scene> scene = AnimatorTest_CreateScene();
+		ASSERT_NE(scene, nullptr);
+		std::mt19937 rng;
+
+		static const constexpr size_t RIG_COUNT = 1000u;
+		static const constexpr size_t BONE_COUNT = 32u;
+		static const constexpr size_t FRAME_COUNT = 64u;
+		const Reference<AnimationClip> clip = AnimatorTest_BoneClip(BONE_COUNT, 4.0f, rng);
+
+		std::unique_lock<std::recursive_mutex> lock(scene->Context()->UpdateLock());
+		std::vector<Reference<Transform>> bones;
+		for (size_t i = 0u; i < RIG_COUNT; i++) {
+			const Reference<Animator> animator = AnimatorTest_CreateRig(scene->Context()->RootObject(), BONE_COUNT, bones);
+			Animator::AnimationChannel channel = animator->Channel(0u);
+			channel.SetClip(clip);
+			channel.SetLooping(true);
+			channel.SetTime(std::uniform_real_distribution<float>(0.0f, clip->Duration())(rng));
+			channel.Play();
+		}
+		scene->Update(0.01f);
+
+		Stopwatch stopwatch;
+		for (size_t frame = 0u; frame < FRAME_COUNT; frame++)
+			scene->Update(0.01f);
+		const float elapsed = stopwatch.Elapsed();
+		logger->Info(std::fixed, std::setprecision(3),
+			"AnimatorTest::BatchedPlaybackPerformance - ", RIG_COUNT, " rigs x ", BONE_COUNT, " bones; ",
+			(elapsed * 1000.0f / static_cast<float>(FRAME_COUNT)), " ms per frame (",
+			SimulationThreadBlock::GetFor(scene->Context())->DefaultThreadCount(), " simulation threads)");
+	}
+}
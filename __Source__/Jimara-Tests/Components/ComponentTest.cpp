@@ -0,0 +1,240 @@
+#include "../GtestHeaders.h"
+#include "Components/Component.h"
+#include "Environment/Scene/Scene.h"
+#include "Core/Stopwatch.h"
+#include "OS/Logging/StreamLogger.h"
+#include <algorithm>
+#include <map>
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	namespace {
+		inline static Reference<Scene> CreateScene() {
+			Scene::CreateArgs args;
+			args.createMode = Scene::CreateArgs::CreateMode::CREATE_DEFAULT_FIELDS_AND_SUPRESS_WARNINGS;
+			return Scene::Create(args);
+		}
+
+		// Reference implementation of Component::ActiveInHierarchy() (walks the whole parent chain)
+		inline static bool ActiveInHierarchyReference(const Component* component) {
+			if (component->Destroyed()) return false;
+			const Reference<Component> sceneRootObject = component->Context()->RootObject();
+			while (component != nullptr && component != sceneRootObject) {
+				if (!component->Enabled()) return false;
+				component = component->Parent();
+			}
+			return true;
+		}
+	}
+
+	// Cached ActiveInHierarchy() state has to match the parent chain after random enable/disable/reparent/destroy operations
+	TEST(ComponentTest, ActiveInHierarchy) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+
+		std::mt19937 rng;
+		std::vector<Reference<Component>> components;
+		auto randomComponent = [&]() { return components[std::uniform_int_distribution<size_t>(0u, components.size() - 1u)(rng)]; };
+		auto addComponent = [&]() {
+			Component* parent = components.empty() ? scene->RootObject().operator->() : randomComponent().operator->();
+			components.push_back(Object::Instantiate<Component>(parent, "Component"));
+		};
+		for (size_t i = 0; i < 256; i++)
+			addComponent();
+
+		auto checkStates = [&]() {
+			for (size_t i = 0; i < components.size(); i++)
+				EXPECT_EQ(components[i]->ActiveInHierarchy(), ActiveInHierarchyReference(components[i]));
+		};
+		checkStates();
+
+		for (size_t iteration = 0; iteration < 1024; iteration++) {
+			const Reference<Component> component = randomComponent();
+			switch (std::uniform_int_distribution<size_t>(0u, 7u)(rng)) {
+			case 0:
+			case 1:
+			case 2: component->SetEnabled(!component->Enabled()); break;
+			case 3:
+			case 4: component->SetParent(randomComponent()); break;
+			case 5: scene->RootObject()->SetEnabled(!scene->RootObject()->Enabled()); break;
+			case 6: addComponent(); break;
+			default:
+				if (components.size() > 64u && !component->Destroyed()) component->Destroy();
+				break;
+			}
+			components.erase(std::remove_if(components.begin(), components.end(),
+				[](const Reference<Component>& c) { return c->Destroyed(); }), components.end());
+			checkStates();
+			if ((iteration % 64u) == 0u)
+				scene->Update(0.01f);
+		}
+	}
+
+	// Compares cached ActiveInHierarchy() queries with the parent chain walk for deep hierarchies
+	TEST(ComponentTest, ActiveInHierarchyPerformance) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+
+		static const constexpr size_t DEPTH = 256u;
+		static const constexpr size_t LEAF_COUNT = 1024u;
+		static const constexpr size_t QUERY_ROUNDS = 16u;
+		Component* parent = scene->RootObject();
+		for (size_t i = 0; i < DEPTH; i++)
+			parent = Object::Instantiate<Component>(parent, "Link");
+		std::vector<Reference<Component>> leaves;
+		for (size_t i = 0; i < LEAF_COUNT; i++)
+			leaves.push_back(Object::Instantiate<Component>(parent, "Leaf"));
+		scene->Update(0.01f);
+
+		Stopwatch stopwatch;
+		size_t referenceActiveCount = 0u;
+		for (size_t round = 0; round < QUERY_ROUNDS; round++)
+			for (size_t i = 0; i < leaves.size(); i++)
+				if (ActiveInHierarchyReference(leaves[i])) referenceActiveCount++;
+		const float referenceTime = stopwatch.Reset();
+		size_t cachedActiveCount = 0u;
+		for (size_t round = 0; round < QUERY_ROUNDS; round++)
+			for (size_t i = 0; i < leaves.size(); i++)
+				if (leaves[i]->ActiveInHierarchy()) cachedActiveCount++;
+		const float cachedTime = stopwatch.Reset();
+		EXPECT_EQ(referenceActiveCount, cachedActiveCount);
+		EXPECT_EQ(cachedActiveCount, QUERY_ROUNDS * LEAF_COUNT);
+
+		logger->Info(std::fixed, std::setprecision(3),
+			"ComponentTest.ActiveInHierarchyPerformance - Depth: ", DEPTH, "; Queries: ", (QUERY_ROUNDS * LEAF_COUNT),
+			"; Parent chain walk: ", referenceTime * 1000.0f, "ms; Cached: ", cachedTime * 1000.0f, "ms");
+	}
+
+
+	namespace {
+		// Records update 'ticks' and optionally spawns a child through ExecuteDeferred() on each update
+		class PhaseRecorder : public virtual Scene::LogicContext::UpdatingComponent {
+		public:
+			const int order;
+			const bool parallel;
+			const bool spawnChildren;
+			std::atomic<size_t>* const clock;
+			size_t lastTick = 0u;
+			size_t updateCount = 0u;
+
+			inline PhaseRecorder(Component* parent, int updateOrder, bool parallelSafe, bool spawn, std::atomic<size_t>* updateClock)
+				: Component(parent, "PhaseRecorder"), order(updateOrder), parallel(parallelSafe), spawnChildren(spawn), clock(updateClock) {}
+
+		protected:
+			inline virtual void Update()override {
+				lastTick = clock->fetch_add(1u);
+				updateCount++;
+				if (!spawnChildren) return;
+				typedef void(*SpawnFn)(Object*);
+				static const SpawnFn spawn = [](Object* self) { Object::Instantiate<Component>(dynamic_cast<Component*>(self), "Spawned"); };
+				Context()->ExecuteDeferred(Callback<Object*>(spawn), this);
+			}
+
+			inline virtual bool ParallelUpdateSafe()const override { return parallel; }
+
+			inline virtual int UpdateOrder()const override { return order; }
+		};
+	}
+
+	// Parallel-safe updating components have to run in their own phases, ordered by UpdateOrder(), with deferred structural changes applied after each phase
+	TEST(ComponentTest, ParallelUpdatePhases) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+
+		std::atomic<size_t> clock = 0u;
+		std::mt19937 rng;
+		std::vector<Reference<PhaseRecorder>> recorders;
+		for (size_t i = 0; i < 1024; i++) {
+			const int order = std::uniform_int_distribution<int>(-2, 2)(rng);
+			const bool parallel = (std::uniform_int_distribution<int>(0, 3)(rng) != 0);
+			const bool spawn = ((i % 16u) == 0u);
+			recorders.push_back(Object::Instantiate<PhaseRecorder>(scene->RootObject(), order, parallel, spawn, &clock));
+		}
+
+		static const constexpr size_t FRAME_COUNT = 4u;
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			scene->Update(0.01f);
+			
+			// Phase (order, parallel) tick ranges should not overlap and have to go in the right order:
+			std::map<std::pair<int, bool>, std::pair<size_t, size_t>> phaseTicks;
+			for (size_t i = 0; i < recorders.size(); i++) {
+				const PhaseRecorder* recorder = recorders[i];
+				const std::pair<int, bool> key(recorder->order, recorder->parallel);
+				auto it = phaseTicks.find(key);
+				if (it == phaseTicks.end()) phaseTicks[key] = std::make_pair(recorder->lastTick, recorder->lastTick);
+				else {
+					it->second.first = std::min(it->second.first, recorder->lastTick);
+					it->second.second = std::max(it->second.second, recorder->lastTick);
+				}
+			}
+			const std::pair<size_t, size_t>* lastRange = nullptr;
+			for (auto it = phaseTicks.begin(); it != phaseTicks.end(); ++it) {
+				if (lastRange != nullptr)
+					EXPECT_LT(lastRange->second, it->second.first);
+				lastRange = &it->second;
+			}
+		}
+
+		// Each component should have been updated once per frame and deferred children should be created:
+		for (size_t i = 0; i < recorders.size(); i++) {
+			EXPECT_EQ(recorders[i]->updateCount, FRAME_COUNT);
+			EXPECT_EQ(recorders[i]->ChildCount(), recorders[i]->spawnChildren ? FRAME_COUNT : size_t(0u));
+		}
+	}
+
+	namespace {
+		// Creates and destroys children directly from a parallel-safe update (both changes should get deferred till the end of the phase)
+		class DirectSpawner : public virtual Scene::LogicContext::UpdatingComponent {
+		public:
+			std::atomic<bool> hierarchyChangedDuringUpdate = false;
+
+			inline DirectSpawner(Component* parent) : Component(parent, "DirectSpawner") {}
+
+		protected:
+			inline virtual void Update()override {
+				const size_t childCount = ChildCount();
+				Object::Instantiate<Component>(this, "Spawned");
+				if (childCount >= 2u) {
+					Component* oldest = GetChild(0u);
+					oldest->Destroy();
+					if (oldest->Destroyed()) hierarchyChangedDuringUpdate = true;
+				}
+				if (ChildCount() != childCount) hierarchyChangedDuringUpdate = true;
+			}
+
+			inline virtual bool ParallelUpdateSafe()const override { return true; }
+		};
+	}
+
+	// Reparenting and destruction from within parallel updates should be applied at the end of the phase
+	TEST(ComponentTest, ParallelUpdateHierarchyChanges) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+
+		std::vector<Reference<DirectSpawner>> spawners;
+		for (size_t i = 0; i < 256; i++)
+			spawners.push_back(Object::Instantiate<DirectSpawner>(scene->RootObject()));
+		const size_t rootChildCount = scene->RootObject()->ChildCount();
+
+		// Frame 0 and 1 add a child each; after that, each frame adds one and destroys the oldest one:
+		static const constexpr size_t FRAME_COUNT = 4u;
+		for (size_t frame = 0; frame < FRAME_COUNT; frame++) {
+			scene->Update(0.01f);
+			for (size_t i = 0; i < spawners.size(); i++) {
+				const DirectSpawner* spawner = spawners[i];
+				EXPECT_FALSE(spawner->hierarchyChangedDuringUpdate.load());
+				ASSERT_EQ(spawner->ChildCount(), std::min(frame + 1u, size_t(2u)));
+				for (size_t childId = 0u; childId < spawner->ChildCount(); childId++) {
+					const Component* child = spawner->GetChild(childId);
+					EXPECT_EQ(child->Parent(), spawner);
+					EXPECT_EQ(child->IndexInParent(), childId);
+					EXPECT_FALSE(child->Destroyed());
+				}
+			}
+			EXPECT_EQ(scene->RootObject()->ChildCount(), rootChildCount);
+		}
+	}
+}
@@ -540,4 +540,80 @@ namespace Jimara {
 			EXPECT_TRUE(VectorsMatch(childTransform->LocalToWorldPosition(Vector3(0.0f, 0.0f, 0.0f)), point));
 		}
 	}
+
+	// Cached world matrices have to stay correct after random modifications & hierarchy changes (with and without scene-wide batch updates)
+	TEST(TransformTest, CachedWorldMatrices) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+
+		std::mt19937 rng;
+		std::uniform_real_distribution<float> dis(-180.0f, 180.0f);
+		std::uniform_real_distribution<float> scaleDis(0.5f, 2.0f);
+
+		// Create a random hierarchy (some of the transforms are separated by regular components):
+		std::vector<Component*> components;
+		std::vector<Transform*> transforms;
+		for (size_t i = 0; i < 256; i++) {
+			Component* parent = components.empty() ? scene->RootObject() : components[std::uniform_int_distribution<size_t>(0u, components.size() - 1u)(rng)];
+			if ((i % 5u) == 4u) components.push_back(Object::Instantiate<Component>(parent, "Component"));
+			else {
+				Transform* transform = Object::Instantiate<Transform>(parent, "Transform",
+					Vector3(dis(rng), dis(rng), dis(rng)), Vector3(dis(rng), dis(rng), dis(rng)), Vector3(scaleDis(rng), scaleDis(rng), scaleDis(rng)));
+				components.push_back(transform);
+				transforms.push_back(transform);
+			}
+		}
+
+		auto expectedWorldMatrix = [](const Transform* transform) {
+			Matrix4 result = Math::Identity();
+			while (transform != nullptr) {
+				const Matrix4 rotation = Math::MatrixFromEulerAngles(transform->LocalEulerAngles());
+				const Vector3 scale = transform->LocalScale();
+				Matrix4 local = rotation;
+				local[0u] *= scale.x;
+				local[1u] *= scale.y;
+				local[2u] *= scale.z;
+				local[3u] = Vector4(transform->LocalPosition(), 1.0f);
+				result = local * result;
+				transform = transform->GetComponentInParents<Transform>(false);
+			}
+			return result;
+		};
+
+		auto matricesMatch = [](const Matrix4& a, const Matrix4& b) {
+			for (size_t i = 0; i < 4u; i++) for (size_t j = 0; j < 4u; j++)
+				if (std::abs(a[i][j] - b[i][j]) > (0.001f * std::max(1.0f, std::abs(b[i][j])))) return false;
+			return true;
+		};
+
+		auto checkMatrices = [&]() {
+			for (size_t i = 0; i < transforms.size(); i++) {
+				const Matrix4 expected = expectedWorldMatrix(transforms[i]);
+				const Matrix4 actual = transforms[i]->WorldMatrix();
+				EXPECT_TRUE(matricesMatch(actual, expected)) 
+					<< MatrixToString(actual, "Actual") << std::endl << MatrixToString(expected, "Expected");
+			}
+		};
+		checkMatrices();
+
+		for (size_t iteration = 0; iteration < 64; iteration++) {
+			for (size_t i = 0; i < 16; i++) {
+				Transform* transform = transforms[std::uniform_int_distribution<size_t>(0u, transforms.size() - 1u)(rng)];
+				switch (std::uniform_int_distribution<size_t>(0u, 3u)(rng)) {
+				case 0: transform->SetLocalPosition(Vector3(dis(rng), dis(rng), dis(rng))); break;
+				case 1: transform->SetLocalEulerAngles(Vector3(dis(rng), dis(rng), dis(rng))); break;
+				case 2: transform->SetLocalScale(Vector3(scaleDis(rng), scaleDis(rng), scaleDis(rng))); break;
+				default: transform->SetParent(components[std::uniform_int_distribution<size_t>(0u, components.size() - 1u)(rng)]); break;
+				}
+			}
+			if ((iteration % 2u) == 0u)
+				scene->Update(0.01f);
+			checkMatrices();
+		}
+
+		// Frame-cached matrix should match the world matrix after update:
+		scene->Update(0.01f);
+		for (size_t i = 0; i < transforms.size(); i++)
+			EXPECT_TRUE(matricesMatch(transforms[i]->FrameCachedWorldMatrix(), transforms[i]->WorldMatrix()));
+	}
 }
@@ -0,0 +1,264 @@
+#include "../GtestHeaders.h"
+#include <Core/Stopwatch.h>
+#include <Core/Collections/BVH.h>
+#include <Math/Primitives/Triangle.h>
+#include <Math/Primitives/Sphere.h>
+#include <Data/Formats/WavefrontOBJ.h>
+#include <Data/Formats/FBX/FBXData.h>
+#include <OS/Logging/StreamLogger.h>
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	namespace {
+		inline static void BVHTest_AddMeshTriangles(const TriMesh* mesh, std::vector<Triangle3>& tris) {
+			TriMesh::Reader reader(mesh);
+			for (uint32_t tId = 0u; tId < reader.FaceCount(); tId++) {
+				const TriangleFace face = reader.Face(tId);
+				tris.push_back(Triangle3(
+					reader.Vert(face.a).position,
+					reader.Vert(face.b).position,
+					reader.Vert(face.c).position));
+			}
+		}
+
+		inline static std::vector<Triangle3> BVHTest_RandomTriangles(size_t count, std::mt19937& rng) {
+			std::uniform_real_distribution<float> position(-32.0f, 32.0f);
+			std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+			std::vector<Triangle3> tris;
+			for (size_t i = 0u; i < count; i++) {
+				const Vector3 center(position(rng), position(rng) * (((i % 3u) == 0u) ? 1.0f : 0.05f), position(rng));
+				auto vertex = [&]() { return center + Vector3(offset(rng), offset(rng), offset(rng)); };
+				tris.push_back(Triangle3(vertex(), vertex(), vertex()));
+			}
+			return tris;
+		}
+
+		inline static std::vector<std::pair<Vector3, Vector3>> BVHTest_RandomRays(size_t count, const AABB& bounds, std::mt19937& rng) {
+			std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+			std::uniform_real_distribution<float> dir(-1.0f, 1.0f);
+			std::vector<std::pair<Vector3, Vector3>> rays;
+			const Vector3 size = bounds.end - bounds.start;
+			for (size_t i = 0u; i < count; i++) {
+				const Vector3 origin = bounds.start + Vector3(unit(rng) * size.x, unit(rng) * size.y, unit(rng) * size.z) * 1.5f - size * 0.25f;
+				Vector3 direction(dir(rng), dir(rng), dir(rng));
+				if (Math::Magnitude(direction) < 0.001f)
+					direction = Math::Forward();
+				rays.push_back(std::make_pair(origin, Math::Normalize(direction)));
+			}
+			return rays;
+		}
+
+		inline static void BVHTest_MoveTriangles(std::vector<Triangle3>& tris, float maxOffset, std::mt19937& rng) {
+			std::uniform_real_distribution<float> offset(-maxOffset, maxOffset);
+			for (size_t i = 0u; i < tris.size(); i++) {
+				const Vector3 delta(offset(rng), offset(rng), offset(rng));
+				Triangle3& tri = tris[i];
+				tri = Triangle3(tri.a + delta, tri.b + delta, tri.c + delta);
+			}
+		}
+
+		// Measures build time and raycast throughput of Octree and BVH on the same geometry
+		inline static void BVHTest_CompareWithOctree(OS::Logger* logger, const std::string_view& name, const std::vector<Triangle3>& tris) {
+			ASSERT_FALSE(tris.empty());
+			Stopwatch stopwatch;
+			const Octree<Triangle3> octree = Octree<Triangle3>::Build(tris.begin(), tris.end());
+			const float octreeBuildTime = stopwatch.Reset();
+			const BVH<Triangle3> bvh = BVH<Triangle3>::Build(tris.begin(), tris.end());
+			const float bvhBuildTime = stopwatch.Reset();
+			ASSERT_EQ(bvh.Size(), tris.size());
+
+			std::mt19937 rng(7u);
+			const std::vector<std::pair<Vector3, Vector3>> rays = BVHTest_RandomRays(100000u, bvh.BoundingBox(), rng);
+			std::vector<float> octreeDistances(rays.size());
+			std::vector<float> bvhDistances(rays.size());
+			stopwatch.Reset();
+			for (size_t i = 0u; i < rays.size(); i++)
+				octreeDistances[i] = octree.Raycast(rays[i].first, rays[i].second).totalDistance;
+			const float octreeRaycastTime = stopwatch.Reset();
+			for (size_t i = 0u; i < rays.size(); i++)
+				bvhDistances[i] = bvh.Raycast(rays[i].first, rays[i].second).totalDistance;
+			const float bvhRaycastTime = stopwatch.Reset();
+
+			size_t hitCount = 0u;
+			size_t mismatchCount = 0u;
+			for (size_t i = 0u; i < rays.size(); i++) {
+				if (std::isfinite(bvhDistances[i]))
+					hitCount++;
+				if (std::isfinite(bvhDistances[i]) != std::isfinite(octreeDistances[i]) ||
+					(std::isfinite(bvhDistances[i]) && std::abs(bvhDistances[i] - octreeDistances[i]) > 0.001f))
+					mismatchCount++;
+			}
+			EXPECT_LE(mismatchCount, rays.size() / 1000u);
+
+			logger->Info(std::fixed, std::setprecision(3), "BVHTest - ", name, ": Triangles: ", tris.size(), "; Nodes: ", bvh.NodeCount());
+			logger->Info(std::fixed, std::setprecision(3), "    Build time - Octree: ", octreeBuildTime * 1000.0f, "ms; BVH: ", bvhBuildTime * 1000.0f, "ms");
+			logger->Info(std::fixed, std::setprecision(3), "    Raycasts: ", rays.size(), "(", hitCount, " hits, ", mismatchCount, " mismatches) - Octree: ",
+				(float(rays.size()) / octreeRaycastTime / 1000000.0f), "M rays/s; BVH: ", (float(rays.size()) / bvhRaycastTime / 1000000.0f), "M rays/s");
+		}
+	}
+
+	// Closest hits and hit lists have to match brute-force raycasts against every triangle
+	TEST(BVHTest, Raycast) {
+		std::mt19937 rng(0u);
+		for (size_t count : { size_t(1u), size_t(7u), size_t(256u), size_t(16384u) }) {
+			const std::vector<Triangle3> tris = BVHTest_RandomTriangles(count, rng);
+			const BVH<Triangle3> bvh = BVH<Triangle3>::Build(tris.begin(), tris.end());
+			ASSERT_EQ(bvh.Size(), tris.size());
+			for (size_t i = 0u; i < tris.size(); i++)
+				EXPECT_EQ(bvh.IndexOf(&bvh[i]), i);
+
+			const std::vector<std::pair<Vector3, Vector3>> rays = BVHTest_RandomRays(512u, bvh.BoundingBox(), rng);
+			for (size_t rayId = 0u; rayId < rays.size(); rayId++) {
+				const Vector3& origin = rays[rayId].first;
+				const Vector3& direction = rays[rayId].second;
+				float closest = std::numeric_limits<float>::infinity();
+				size_t hitCount = 0u;
+				for (size_t i = 0u; i < tris.size(); i++) {
+					const Math::SweepDistance distance = Math::Raycast(tris[i], origin, direction);
+					if (!std::isfinite(distance.distance) || distance.distance < 0.0f) continue;
+					closest = Math::Min(closest, distance.distance);
+					hitCount++;
+				}
+
+				const BVH<Triangle3>::RaycastResult result = bvh.Raycast(origin, direction);
+				EXPECT_EQ(static_cast<bool>(result), std::isfinite(closest));
+				if (result) {
+					EXPECT_NEAR(result.totalDistance, closest, 0.001f);
+					EXPECT_EQ(&bvh[bvh.IndexOf(result.target)], result.target);
+				}
+
+				const std::vector<BVH<Triangle3>::RaycastResult> hits = bvh.RaycastAll(origin, direction, true);
+				EXPECT_EQ(hits.size(), hitCount);
+				for (size_t i = 1u; i < hits.size(); i++)
+					EXPECT_LE(hits[i - 1u].totalDistance, hits[i].totalDistance);
+			}
+		}
+	}
+
+	// Refitted BVH-s have to report the same hits as brute-force raycasts against moved triangles
+	TEST(BVHTest, Refit) {
+		std::mt19937 rng(3u);
+		std::vector<Triangle3> tris = BVHTest_RandomTriangles(8192u, rng);
+		BVH<Triangle3> bvh = BVH<Triangle3>::Build(tris.begin(), tris.end());
+		const size_t nodeCount = bvh.NodeCount();
+		for (size_t iteration = 0u; iteration < 4u; iteration++) {
+			BVHTest_MoveTriangles(tris, 4.0f, rng);
+			bvh = bvh.Refit(tris.begin(), tris.end());
+			ASSERT_EQ(bvh.Size(), tris.size());
+			EXPECT_EQ(bvh.NodeCount(), nodeCount);
+			for (size_t i = 0u; i < tris.size(); i++)
+				EXPECT_EQ(bvh[i].a, tris[i].a);
+
+			const std::vector<std::pair<Vector3, Vector3>> rays = BVHTest_RandomRays(256u, bvh.BoundingBox(), rng);
+			for (size_t rayId = 0u; rayId < rays.size(); rayId++) {
+				float closest = std::numeric_limits<float>::infinity();
+				size_t hitCount = 0u;
+				for (size_t i = 0u; i < tris.size(); i++) {
+					const Math::SweepDistance distance = Math::Raycast(tris[i], rays[rayId].first, rays[rayId].second);
+					if (!std::isfinite(distance.distance) || distance.distance < 0.0f) continue;
+					closest = Math::Min(closest, distance.distance);
+					hitCount++;
+				}
+				const BVH<Triangle3>::RaycastResult result = bvh.Raycast(rays[rayId].first, rays[rayId].second);
+				EXPECT_EQ(static_cast<bool>(result), std::isfinite(closest));
+				if (result)
+					EXPECT_NEAR(result.totalDistance, closest, 0.001f);
+				EXPECT_EQ(bvh.RaycastAll(rays[rayId].first, rays[rayId].second).size(), hitCount);
+			}
+		}
+
+		// Different element count should result in a rebuild:
+		tris.resize(tris.size() / 2u);
+		bvh = bvh.Refit(tris.begin(), tris.end());
+		EXPECT_EQ(bvh.Size(), tris.size());
+	}
+
+	// Closest sphere sweep hits have to match the Octree
+	TEST(BVHTest, Sweep) {
+		std::mt19937 rng(1u);
+		const std::vector<Triangle3> tris = BVHTest_RandomTriangles(4096u, rng);
+		const Octree<Triangle3> octree = Octree<Triangle3>::Build(tris.begin(), tris.end());
+		const BVH<Triangle3> bvh = BVH<Triangle3>::Build(tris.begin(), tris.end());
+		const Sphere sphere(0.5f);
+		const std::vector<std::pair<Vector3, Vector3>> rays = BVHTest_RandomRays(256u, bvh.BoundingBox(), rng);
+		size_t mismatchCount = 0u;
+		for (size_t rayId = 0u; rayId < rays.size(); rayId++) {
+			const auto octreeHit = octree.Sweep(sphere, rays[rayId].first, rays[rayId].second);
+			const auto bvhHit = bvh.Sweep(sphere, rays[rayId].first, rays[rayId].second);
+			if (static_cast<bool>(octreeHit) != static_cast<bool>(bvhHit) ||
+				(bvhHit && std::abs(octreeHit.totalDistance - bvhHit.totalDistance) > 0.001f))
+				mismatchCount++;
+		}
+		EXPECT_LE(mismatchCount, size_t(1u));
+	}
+
+	// Build and raycast performance comparison with Octree on a large random triangle soup
+	TEST(BVHTest, Performance_RandomTriangles) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		std::mt19937 rng(2u);
+		BVHTest_CompareWithOctree(logger, "Random triangles", BVHTest_RandomTriangles(262144u, rng));
+	}
+
+	// Build and raycast performance comparison with Octree on an OBJ test mesh
+	TEST(BVHTest, Performance_OBJ) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		const std::vector<Reference<TriMesh>> meshes = TriMeshesFromOBJ("Assets/Meshes/OBJ/Bear/ursus_proximus.obj", logger);
+		ASSERT_FALSE(meshes.empty());
+		std::vector<Triangle3> tris;
+		for (size_t i = 0u; i < meshes.size(); i++)
+			BVHTest_AddMeshTriangles(meshes[i], tris);
+		BVHTest_CompareWithOctree(logger, "ursus_proximus.obj", tris);
+	}
+
+	// Build and raycast performance comparison with Octree on an FBX test mesh
+	TEST(BVHTest, Performance_FBX) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		const Reference<FBXData> data = FBXData::Extract(OS::Path("Assets/Meshes/FBX/Cone_Guy/Cone_Guy_Static_Pose.fbx"), logger);
+		ASSERT_NE(data, nullptr);
+		std::vector<Triangle3> tris;
+		for (size_t i = 0u; i < data->MeshCount(); i++) {
+			const Reference<TriMesh> mesh = ToTriMesh(data->GetMesh(i)->mesh);
+			if (mesh != nullptr)
+				BVHTest_AddMeshTriangles(mesh, tris);
+		}
+		BVHTest_CompareWithOctree(logger, "Cone_Guy_Static_Pose.fbx", tris);
+	}
+
+	// Refit cost compared to full rebuilds for different element counts
+	TEST(BVHTest, Performance_RefitVsRebuild) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		std::mt19937 rng(4u);
+		for (size_t count : { size_t(10000u), size_t(100000u), size_t(1000000u) }) {
+			std::vector<Triangle3> tris = BVHTest_RandomTriangles(count, rng);
+			Stopwatch stopwatch;
+			const BVH<Triangle3> initial = BVH<Triangle3>::Build(tris.begin(), tris.end());
+			const float initialBuildTime = stopwatch.Reset();
+			BVHTest_MoveTriangles(tris, 0.5f, rng);
+			stopwatch.Reset();
+			const BVH<Triangle3> refitted = initial.Refit(tris.begin(), tris.end());
+			const float refitTime = stopwatch.Reset();
+			const BVH<Triangle3> rebuilt = BVH<Triangle3>::Build(tris.begin(), tris.end());
+			const float rebuildTime = stopwatch.Reset();
+			ASSERT_EQ(refitted.Size(), rebuilt.Size());
+
+			const std::vector<std::pair<Vector3, Vector3>> rays = BVHTest_RandomRays(100000u, rebuilt.BoundingBox(), rng);
+			stopwatch.Reset();
+			size_t refittedHits = 0u;
+			for (size_t i = 0u; i < rays.size(); i++)
+				if (refitted.Raycast(rays[i].first, rays[i].second)) refittedHits++;
+			const float refittedRaycastTime = stopwatch.Reset();
+			size_t rebuiltHits = 0u;
+			for (size_t i = 0u; i < rays.size(); i++)
+				if (rebuilt.Raycast(rays[i].first, rays[i].second)) rebuiltHits++;
+			const float rebuiltRaycastTime = stopwatch.Reset();
+			EXPECT_EQ(refittedHits, rebuiltHits);
+
+			logger->Info(std::fixed, std::setprecision(3), "BVHTest.Performance_RefitVsRebuild - Elements: ", count,
+				"; Initial build: ", initialBuildTime * 1000.0f, "ms; Refit: ", refitTime * 1000.0f, "ms; Rebuild: ", rebuildTime * 1000.0f, "ms");
+			logger->Info(std::fixed, std::setprecision(3), "    Raycasts after refit: ", (float(rays.size()) / refittedRaycastTime / 1000000.0f),
+				"M rays/s; After rebuild: ", (float(rays.size()) / rebuiltRaycastTime / 1000000.0f), "M rays/s");
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#include "../GtestHeaders.h"
+#include "Core/Memory/ContentHash.h"
+#include <random>
+
+
+namespace Jimara {
+	// Known xxHash64 values (reference implementation output)
+	TEST(ContentHashTest, XXHash64ReferenceValues) {
+		EXPECT_EQ(ContentHash::XXHash64("", 0u), 0xEF46DB3751D8E999ull);
+		EXPECT_EQ(ContentHash::XXHash64("abc", 3u), 0x44BC2CF5AD770999ull);
+	}
+
+	// Word loads do not depend on the alignment of the data
+	TEST(ContentHashTest, UnalignedData) {
+		std::mt19937 rng;
+		std::uniform_int_distribution<uint32_t> byteDis(0u, 255u);
+		std::vector<uint8_t> data(1024u + 16u);
+		for (size_t i = 0u; i < data.size(); i++)
+			data[i] = static_cast<uint8_t>(byteDis(rng));
+		for (size_t size = 0u; size <= 256u; size += 7u) {
+			const uint64_t aligned = ContentHash::XXHash64(data.data() + 8u, size);
+			std::vector<uint8_t> shifted(size + 16u);
+			for (size_t offset = 1u; offset < 8u; offset++) {
+				std::memcpy(shifted.data() + offset, data.data() + 8u, size);
+				EXPECT_EQ(ContentHash::XXHash64(shifted.data() + offset, size), aligned);
+				EXPECT_EQ(ContentHash::XXHash64(shifted.data() + offset, size, ContentHash::DIGEST_SEED),
+					ContentHash::XXHash64(data.data() + 8u, size, ContentHash::DIGEST_SEED));
+			}
+		}
+	}
+
+	// Both halves of the digest react to single bit changes and the halves are not the same
+	TEST(ContentHashTest, Digest) {
+		std::mt19937 rng;
+		std::uniform_int_distribution<uint32_t> byteDis(0u, 255u);
+		std::vector<uint8_t> data(4096u);
+		for (size_t i = 0u; i < data.size(); i++)
+			data[i] = static_cast<uint8_t>(byteDis(rng));
+		const ContentHash::Digest digest = ContentHash::DigestOf(MemoryBlock(data.data(), data.size(), nullptr));
+		EXPECT_NE(digest.xxHash, digest.seededHash);
+		EXPECT_EQ(digest, ContentHash::DigestOf(MemoryBlock(data.data(), data.size(), nullptr)));
+		for (size_t i = 0u; i < data.size(); i += 131u) {
+			const uint8_t bit = static_cast<uint8_t>(1u << (i % 8u));
+			data[i] ^= bit;
+			const ContentHash::Digest changed = ContentHash::DigestOf(MemoryBlock(data.data(), data.size(), nullptr));
+			EXPECT_NE(changed.xxHash, digest.xxHash);
+			EXPECT_NE(changed.seededHash, digest.seededHash);
+			data[i] ^= bit;
+		}
+		EXPECT_NE(ContentHash::DigestOf(MemoryBlock(data.data(), data.size() - 1u, nullptr)), digest);
+	}
+}
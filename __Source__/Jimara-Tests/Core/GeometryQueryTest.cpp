@@ -8,6 +8,7 @@
 #include <Data/Formats/WavefrontOBJ.h>
 #include <Graphics/GraphicsInstance.h>
 #include <Data/Geometry/MeshConstants.h>
+#include <random>
 
 
 
@@ -389,4 +390,212 @@ namespace Jimara {
 				grid.Push(PosedOctree<Triangle3>(sphereOctree, hitPose));
 			});
 	}
+
+	namespace {
+		inline static std::vector<Triangle3> GeometryQueries_RandomTriangles(size_t count, float range, std::mt19937& rng) {
+			std::uniform_real_distribution<float> position(-range, range);
+			std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+			std::vector<Triangle3> tris;
+			for (size_t i = 0u; i < count; i++) {
+				const Vector3 center(position(rng), position(rng), position(rng));
+				auto vertex = [&]() { return center + Vector3(offset(rng), offset(rng), offset(rng)); };
+				tris.push_back(Triangle3(vertex(), vertex(), vertex()));
+			}
+			return tris;
+		}
+	}
+
+	TEST(GeometryQueryTest, VoxelGrid_RemoveAt) {
+		std::mt19937 rng(0u);
+		std::vector<Triangle3> tris = GeometryQueries_RandomTriangles(2048u, 16.0f, rng);
+		VoxelGrid<Triangle3> grid;
+		grid.BoundingBox() = Math::BoundingBox(tris);
+		grid.GridSize() = Size3(16u);
+		for (size_t i = 0u; i < tris.size(); i++)
+			grid.Push(tris[i]);
+
+		std::uniform_real_distribution<float> coord(-16.0f, 16.0f);
+		while (!tris.empty()) {
+			// Remove some elements (mirroring swap-with-last on the reference list):
+			for (size_t i = 0u; i < 64u && !tris.empty(); i++) {
+				const size_t index = std::uniform_int_distribution<size_t>(0u, tris.size() - 1u)(rng);
+				grid.RemoveAt(index);
+				tris[index] = tris.back();
+				tris.pop_back();
+			}
+			ASSERT_EQ(grid.Size(), tris.size());
+			for (size_t i = 0u; i < tris.size(); i++) {
+				const Triangle3& element = grid[i];
+				EXPECT_EQ(grid.IndexOf(&element), i);
+				EXPECT_EQ(element.a, tris[i].a);
+			}
+
+			// Downward rays have to hit the same elements as the brute-force checks:
+			for (size_t rayId = 0u; rayId < 16u; rayId++) {
+				const Vector3 origin(coord(rng), 32.0f, coord(rng));
+				const Vector3 direction(0.0f, -1.0f, 0.0f);
+				float closest = std::numeric_limits<float>::infinity();
+				for (size_t i = 0u; i < tris.size(); i++) {
+					const Math::RaycastResult<Triangle3> distance = Math::Raycast(tris[i], origin, direction);
+					if (std::isfinite(distance.distance) && distance.distance >= 0.0f)
+						closest = Math::Min(closest, distance.distance);
+				}
+				const auto hit = grid.Raycast(origin, direction);
+				EXPECT_EQ(static_cast<bool>(hit), std::isfinite(closest));
+				if (hit) {
+					EXPECT_NEAR(hit.totalDistance, closest, 0.001f);
+					EXPECT_LT(grid.IndexOf(hit.target), tris.size());
+				}
+			}
+		}
+	}
+
+	TEST(GeometryQueryTest, VoxelGrid_IncrementalUpdatePerformance) {
+		const Reference<OS::Logger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+		std::mt19937 rng(1u);
+		for (size_t count : { size_t(10000u), size_t(100000u), size_t(1000000u) }) {
+			const float range = std::cbrt(float(count)) * 2.0f;
+			std::vector<Triangle3> tris = GeometryQueries_RandomTriangles(count, range, rng);
+			const AABB bounds = AABB(Vector3(-range - 2.0f), Vector3(range + 2.0f));
+			auto buildGrid = [&]() {
+				VoxelGrid<Triangle3> grid;
+				grid.BoundingBox() = bounds;
+				grid.GridSize() = Size3(64u);
+				for (size_t i = 0u; i < tris.size(); i++)
+					grid.Push(tris[i]);
+				return grid;
+			};
+			Stopwatch stopwatch;
+			VoxelGrid<Triangle3> grid = buildGrid();
+			const float buildTime = stopwatch.Reset();
+
+			// Move 1% of the elements in place:
+			const size_t movedCount = Math::Max(count / 100u, size_t(1u));
+			std::uniform_real_distribution<float> offset(-0.5f, 0.5f);
+			std::vector<size_t> movedIndices;
+			for (size_t i = 0u; i < movedCount; i++) {
+				const size_t index = std::uniform_int_distribution<size_t>(0u, tris.size() - 1u)(rng);
+				const Vector3 delta(offset(rng), offset(rng), offset(rng));
+				tris[index] = Triangle3(tris[index].a + delta, tris[index].b + delta, tris[index].c + delta);
+				movedIndices.push_back(index);
+			}
+			stopwatch.Reset();
+			for (size_t i = 0u; i < movedIndices.size(); i++)
+				grid[movedIndices[i]] = tris[movedIndices[i]];
+			const float updateTime = stopwatch.Reset();
+
+			// Remove 1% of the elements:
+			for (size_t i = 0u; i < movedCount; i++) {
+				const size_t index = std::uniform_int_distribution<size_t>(0u, tris.size() - 1u)(rng);
+				grid.RemoveAt(index);
+				tris[index] = tris.back();
+				tris.pop_back();
+			}
+			const float removeTime = stopwatch.Reset();
+			ASSERT_EQ(grid.Size(), tris.size());
+
+			// Full rebuild for comparison:
+			stopwatch.Reset();
+			const VoxelGrid<Triangle3> rebuilt = buildGrid();
+			const float rebuildTime = stopwatch.Reset();
+			EXPECT_EQ(rebuilt.Size(), grid.Size());
+
+			logger->Info(std::fixed, std::setprecision(3), "GeometryQueryTest.VoxelGrid_IncrementalUpdatePerformance - Elements: ", count,
+				"; Build: ", buildTime * 1000.0f, "ms; Updating ", movedCount, " elements: ", updateTime * 1000.0f,
+				"ms; Removing ", movedCount, " elements: ", removeTime * 1000.0f, "ms; Rebuild: ", rebuildTime * 1000.0f, "ms");
+		}
+	}
+
+	namespace {
+		// Coherent rays (a grid of parallel rays, like the ones used for nav mesh baking) and completely random rays:
+		inline static void GeometryQueries_RaycastBatchRays(
+			float range, size_t side, bool coherent, std::mt19937& rng, std::vector<Vector3>& positions, std::vector<Vector3>& directions) {
+			std::uniform_real_distribution<float> coord(-range, range);
+			std::uniform_real_distribution<float> offset(-1.0f, 1.0f);
+			for (size_t i = 0u; i < (side * side); i++)
+				if (coherent) {
+					positions.push_back(Vector3(
+						-range + (2.0f * range) * float(i % side) / float(side), range + 2.0f,
+						-range + (2.0f * range) * float(i / side) / float(side)));
+					directions.push_back(Math::Normalize(Vector3(0.05f, -1.0f, 0.1f)));
+				}
+				else {
+					positions.push_back(Vector3(coord(rng), coord(rng), coord(rng)));
+					directions.push_back(Math::Normalize(Vector3(offset(rng), offset(rng), offset(rng)) + Vector3(0.0f, 0.001f, 0.0f)));
+				}
+		}
+
+		template<typename ResultType>
+		inline static size_t GeometryQueries_CountBatchMismatches(const std::vector<ResultType>& a, const std::vector<ResultType>& b) {
+			size_t count = 0u;
+			for (size_t i = 0u; i < a.size(); i++) {
+				if (a[i].target != b[i].target)
+					count++;
+				else if (a[i].target != nullptr && static_cast<Math::SweepDistance>(a[i]).distance != static_cast<Math::SweepDistance>(b[i]).distance)
+					count++;
+			}
+			return count;
+		}
+	}
+
+	TEST(GeometryQueryTest, RaycastBatch) {
+		std::mt19937 rng(2u);
+		const float range = 16.0f;
+		const std::vector<Triangle3> tris = GeometryQueries_RandomTriangles(4096u, range, rng);
+		const Octree<Triangle3> octree = Octree<Triangle3>::Build(tris.begin(), tris.end());
+		const PosedOctree<Triangle3> posedOctree(octree, Math::MatrixFromEulerAngles(Vector3(15.0f, 30.0f, 45.0f)));
+
+		for (size_t coherent = 0u; coherent < 2u; coherent++) {
+			std::vector<Vector3> positions;
+			std::vector<Vector3> directions;
+			// Odd ray count, to make sure the incomplete last packet is fine:
+			GeometryQueries_RaycastBatchRays(range, 63u, coherent != 0u, rng, positions, directions);
+			const size_t rayCount = positions.size();
+
+			std::vector<Octree<Triangle3>::RaycastResult> octreeHits(rayCount), octreeBatchHits(rayCount);
+			for (size_t i = 0u; i < rayCount; i++)
+				octreeHits[i] = octree.Raycast(positions[i], directions[i]);
+			octree.RaycastBatch(positions.data(), directions.data(), rayCount, octreeBatchHits.data());
+			EXPECT_EQ(GeometryQueries_CountBatchMismatches(octreeHits, octreeBatchHits), 0u);
+			EXPECT_GT(std::count_if(octreeHits.begin(), octreeHits.end(), [](const auto& hit) { return static_cast<bool>(hit); }), 0);
+
+			std::vector<Math::RaycastResult<PosedOctree<Triangle3>>> posedHits(rayCount), posedBatchHits(rayCount);
+			for (size_t i = 0u; i < rayCount; i++)
+				posedHits[i] = posedOctree.Raycast(positions[i], directions[i]);
+			posedOctree.RaycastBatch(positions.data(), directions.data(), rayCount, posedBatchHits.data());
+			EXPECT_EQ(GeometryQueries_CountBatchMismatches(posedHits, posedBatchHits), 0u);
+		}
+	}
+
+	TEST(GeometryQueryTest, RaycastBatch_Performance) {
+		const Reference<OS::Logger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+		std::mt19937 rng(3u);
+		for (size_t count : { size_t(10000u), size_t(100000u) }) {
+			const float range = std::cbrt(float(count)) * 2.0f;
+			const std::vector<Triangle3> tris = GeometryQueries_RandomTriangles(count, range, rng);
+			const Octree<Triangle3> octree = Octree<Triangle3>::Build(tris.begin(), tris.end());
+
+			for (size_t coherent = 0u; coherent < 2u; coherent++) {
+				std::vector<Vector3> positions;
+				std::vector<Vector3> directions;
+				GeometryQueries_RaycastBatchRays(range, 256u, coherent != 0u, rng, positions, directions);
+				const size_t rayCount = positions.size();
+				auto raysPerSecond = [&](float time) { return float(rayCount) / Math::Max(time, std::numeric_limits<float>::epsilon()); };
+				Stopwatch stopwatch;
+
+				std::vector<Octree<Triangle3>::RaycastResult> octreeHits(rayCount), octreeBatchHits(rayCount);
+				stopwatch.Reset();
+				for (size_t i = 0u; i < rayCount; i++)
+					octreeHits[i] = octree.Raycast(positions[i], directions[i]);
+				const float octreeTime = stopwatch.Reset();
+				octree.RaycastBatch(positions.data(), directions.data(), rayCount, octreeBatchHits.data());
+				const float octreeBatchTime = stopwatch.Reset();
+				EXPECT_EQ(GeometryQueries_CountBatchMismatches(octreeHits, octreeBatchHits), 0u);
+
+				logger->Info(std::fixed, std::setprecision(0), "GeometryQueryTest.RaycastBatch_Performance - Triangles: ", count,
+					"; Rays: ", rayCount, (coherent != 0u) ? " (coherent)" : " (random)",
+					"; Octree: ", raysPerSecond(octreeTime), " rays/s; Octree batch: ", raysPerSecond(octreeBatchTime), " rays/s");
+			}
+		}
+	}
 }
@@ -1,6 +1,8 @@
 #include "../GtestHeaders.h"
 #include "Core/Systems/JobSystem.h"
+#include "Core/Stopwatch.h"
 #include "OS/Logging/StreamLogger.h"
+#include <iomanip>
 
 
 namespace Jimara {
@@ -107,7 +109,10 @@ namespace Jimara {
 
 		public:
 
-			inline void AddDependency(Value<uint64_t>* value) { m_values.push_back(value); }
+			inline void AddDependency(Value<uint64_t>* value) { 
+				m_values.push_back(value); 
+				DependenciesChanged();
+			}
 
 			template<typename... Values>
 			inline void AddDependency(Value<uint64_t>* first, Value<uint64_t>* second, Values... rest) {
@@ -120,6 +125,7 @@ namespace Jimara {
 					if (m_values[i] == value) {
 						std::swap(m_values[i], m_values.back());
 						m_values.pop_back();
+						DependenciesChanged();
 						break;
 					}
 			}
@@ -369,5 +375,268 @@ namespace Jimara {
 		// A->A
 		sumA->AddDependency(sumA);
 		ASSERT_FALSE(system.Execute(logger));
+		ASSERT_FALSE(system.ExecuteScheduled(logger));
+	}
+
+
+	namespace {
+		class CountingJob : public virtual JobSystem::Job {
+		private:
+			std::vector<Reference<CountingJob>> m_dependencies;
+			std::atomic<size_t> m_executionCount = 0u;
+			std::atomic<size_t> m_orderViolations = 0u;
+
+		protected:
+			inline virtual void Execute()override {
+				const size_t count = m_executionCount.load();
+				for (size_t i = 0; i < m_dependencies.size(); i++)
+					if (m_dependencies[i]->m_executionCount.load() != (count + 1u))
+						m_orderViolations++;
+				m_executionCount = count + 1u;
+			}
+
+			inline virtual void CollectDependencies(Callback<Job*> record) override {
+				for (size_t i = 0; i < m_dependencies.size(); i++)
+					record(m_dependencies[i]);
+			}
+
+		public:
+			inline void AddDependency(CountingJob* job) { 
+				m_dependencies.push_back(job); 
+				DependenciesChanged();
+			}
+			inline size_t ExecutionCount()const { return m_executionCount; }
+			inline size_t OrderViolations()const { return m_orderViolations; }
+		};
+
+		class BusyJob : public virtual CountingJob {
+		private:
+			const size_t m_cost;
+			volatile uint64_t m_result = 0u;
+
+		protected:
+			inline virtual void Execute()override {
+				uint64_t value = m_cost;
+				for (size_t i = 0; i < m_cost; i++)
+					value = (value * 6364136223846793005u) + 1442695040888963407u;
+				m_result = value;
+				CountingJob::Execute();
+			}
+
+		public:
+			inline BusyJob(size_t cost) : m_cost(cost) {}
+		};
+	}
+
+	// Checks that the dependency-driven execution respects dependencies and that the iterative one still reports iterations
+	TEST(JobSystemTest, ExecutionOrder) {
+		static const size_t CHAIN_COUNT = 8u;
+		static const size_t CHAIN_LENGTH = 32u;
+		for (size_t threadCount = 1u; threadCount <= 8u; threadCount <<= 1u) {
+			JobSystem system(threadCount);
+			std::vector<Reference<CountingJob>> jobs;
+			Reference<CountingJob> sink = Object::Instantiate<CountingJob>();
+			for (size_t chain = 0u; chain < CHAIN_COUNT; chain++)
+				for (size_t i = 0u; i < CHAIN_LENGTH; i++) {
+					const Reference<CountingJob> job = Object::Instantiate<CountingJob>();
+					if (i > 0u) job->AddDependency(jobs.back());
+					if (chain > 0u) job->AddDependency(jobs[((chain - 1u) * CHAIN_LENGTH) + i]);
+					jobs.push_back(job);
+				}
+			for (size_t i = 0u; i < jobs.size(); i += 3u)
+				sink->AddDependency(jobs[i]);
+			system.Add(sink);
+
+			ASSERT_TRUE(system.ExecuteScheduled());
+			size_t iterationCount = 0u;
+			auto countIteration = [&]() { iterationCount++; };
+			ASSERT_TRUE(system.Execute(nullptr, Callback<>::FromCall(&countIteration)));
+			ASSERT_EQ(iterationCount, CHAIN_COUNT + CHAIN_LENGTH);
+
+			for (size_t i = 0u; i < jobs.size(); i++) {
+				ASSERT_EQ(jobs[i]->ExecutionCount(), 2u);
+				ASSERT_EQ(jobs[i]->OrderViolations(), 0u);
+			}
+			ASSERT_EQ(sink->ExecutionCount(), 2u);
+			ASSERT_EQ(sink->OrderViolations(), 0u);
+		}
+	}
+
+	// Compares dependency-driven execution to the iterative one for wide, deep and skewed job graphs
+	TEST(JobSystemTest, Performance) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		static const size_t FAST_JOB_COST = 256u;
+		static const size_t SLOW_JOB_COST = (1u << 18u);
+		static const size_t ITERATION_COUNT = 16u;
+
+		typedef std::vector<Reference<BusyJob>> JobGraph;
+		
+		// Many independent jobs, feeding a single sink:
+		auto createWideGraph = [&]() {
+			JobGraph jobs;
+			jobs.push_back(Object::Instantiate<BusyJob>(FAST_JOB_COST));
+			for (size_t i = 0u; i < 4096u; i++) {
+				const Reference<BusyJob> job = Object::Instantiate<BusyJob>(FAST_JOB_COST);
+				jobs[0]->AddDependency(job);
+				jobs.push_back(job);
+			}
+			return jobs;
+		};
+
+		// A few long independent dependency chains:
+		auto createDeepGraph = [&]() {
+			JobGraph jobs;
+			for (size_t chain = 0u; chain < 8u; chain++)
+				for (size_t i = 0u; i < 256u; i++) {
+					const Reference<BusyJob> job = Object::Instantiate<BusyJob>(FAST_JOB_COST * 16u);
+					if (i > 0u) job->AddDependency(jobs.back());
+					jobs.push_back(job);
+				}
+			return jobs;
+		};
+
+		// Short chains with one slow job per 'level', blocking unrelated dependants in iterative mode:
+		auto createSkewedGraph = [&]() {
+			JobGraph jobs;
+			static const size_t LEVEL_COUNT = 8u;
+			static const size_t CHAIN_COUNT = 64u;
+			for (size_t chain = 0u; chain < CHAIN_COUNT; chain++)
+				for (size_t level = 0u; level < LEVEL_COUNT; level++) {
+					const Reference<BusyJob> job = Object::Instantiate<BusyJob>(((chain % LEVEL_COUNT) == level) ? SLOW_JOB_COST : (FAST_JOB_COST * 16u));
+					if (level > 0u) job->AddDependency(jobs.back());
+					jobs.push_back(job);
+				}
+			return jobs;
+		};
+
+		auto measure = [&](const char* graphName, const JobGraph& jobs, size_t threadCount) {
+			JobSystem system(threadCount);
+			for (size_t i = 0u; i < jobs.size(); i++)
+				system.Add(jobs[i]);
+			
+			Stopwatch stopwatch;
+			for (size_t i = 0u; i < ITERATION_COUNT; i++)
+				EXPECT_TRUE(system.Execute(logger));
+			const float iterativeTime = stopwatch.Reset();
+			for (size_t i = 0u; i < ITERATION_COUNT; i++)
+				EXPECT_TRUE(system.ExecuteScheduled(logger));
+			const float scheduledTime = stopwatch.Reset();
+
+			for (size_t i = 0u; i < jobs.size(); i++) {
+				EXPECT_EQ(jobs[i]->ExecutionCount(), ITERATION_COUNT * 2u);
+				EXPECT_EQ(jobs[i]->OrderViolations(), 0u);
+			}
+			logger->Info(std::fixed, std::setprecision(3),
+				"JobSystemTest.Performance - ", graphName, " (jobs: ", jobs.size(), "; threads: ", threadCount, "): ",
+				"Iterative: ", (iterativeTime * 1000.0f / ITERATION_COUNT), "ms; ",
+				"Scheduled: ", (scheduledTime * 1000.0f / ITERATION_COUNT), "ms");
+		};
+
+		const size_t threadCount = std::max((size_t)std::thread::hardware_concurrency(), (size_t)1u);
+		measure("Wide", createWideGraph(), threadCount);
+		measure("Deep", createDeepGraph(), threadCount);
+		measure("Skewed", createSkewedGraph(), threadCount);
+	}
+
+	// Checks that the cached graph is rebuilt when needed and reused otherwise
+	TEST(JobSystemTest, StaticTopology) {
+		JobSystem system(std::thread::hardware_concurrency());
+		ASSERT_FALSE(system.StaticTopology());
+		system.SetStaticTopology(true);
+		ASSERT_TRUE(system.StaticTopology());
+
+		Reference<SimpleCounter> counterA = Object::Instantiate<SimpleCounter>();
+		Reference<SimpleCounter> counterB = Object::Instantiate<SimpleCounter>();
+		Reference<SimpleSum> sum = Object::Instantiate<SimpleSum>(counterA);
+		system.Add(sum);
+
+		ASSERT_TRUE(system.Execute());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, 1u);
+		ASSERT_EQ(system.GraphInfo().jobCount, 2u);
+		ASSERT_EQ(sum->Get(), 1u);
+
+		// Nothing changed, so the graph should be reused:
+		ASSERT_TRUE(system.Execute());
+		ASSERT_TRUE(system.ExecuteScheduled());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, 1u);
+		ASSERT_EQ(system.GraphInfo().executionCount, 3u);
+		ASSERT_EQ(counterA->Get(), 3u);
+		ASSERT_EQ(sum->Get(), 3u);
+
+		// Dependency change should trigger a rebuild:
+		sum->AddDependency(counterB);
+		ASSERT_TRUE(system.Execute());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, 2u);
+		ASSERT_EQ(system.GraphInfo().jobCount, 3u);
+		ASSERT_EQ(counterA->Get(), 4u);
+		ASSERT_EQ(counterB->Get(), 1u);
+		ASSERT_EQ(sum->Get(), 5u);
+
+		// Adding and removing jobs should trigger a rebuild:
+		system.Add(counterA);
+		ASSERT_TRUE(system.Execute());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, 3u);
+		system.Remove(sum);
+		ASSERT_TRUE(system.Execute());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, 4u);
+		ASSERT_EQ(system.GraphInfo().jobCount, 1u);
+		ASSERT_EQ(counterA->Get(), 6u);
+		ASSERT_EQ(counterB->Get(), 2u);
+		ASSERT_EQ(sum->Get(), 7u);
+
+		// Circular dependencies should still be reported:
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		system.Add(sum);
+		sum->AddDependency(sum);
+		ASSERT_FALSE(system.Execute(logger));
+		ASSERT_FALSE(system.Execute(logger));
+		sum->RemoveDependency(sum);
+		ASSERT_TRUE(system.Execute(logger));
+
+		// Disabling static topology should make the system rebuild the graph each time:
+		system.SetStaticTopology(false);
+		const size_t rebuildCount = system.GraphInfo().rebuildCount;
+		ASSERT_TRUE(system.Execute());
+		ASSERT_TRUE(system.Execute());
+		ASSERT_EQ(system.GraphInfo().rebuildCount, rebuildCount + 2u);
+	}
+
+	// Compares per-frame graph construction time with and without static topology
+	TEST(JobSystemTest, GraphConstructionTime) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		static const size_t JOB_COUNT = 8192u;
+		static const size_t ITERATION_COUNT = 64u;
+		std::vector<Reference<CountingJob>> jobs;
+		for (size_t i = 0u; i < JOB_COUNT; i++) {
+			const Reference<CountingJob> job = Object::Instantiate<CountingJob>();
+			for (size_t j = 1u; j <= 4u && (j * j) <= i; j++)
+				job->AddDependency(jobs[i - (j * j)]);
+			jobs.push_back(job);
+		}
+
+		auto measure = [&](bool staticTopology) {
+			JobSystem system(std::thread::hardware_concurrency());
+			system.SetStaticTopology(staticTopology);
+			for (size_t i = 0u; i < jobs.size(); i += 2u)
+				system.Add(jobs[i]);
+			system.Add(jobs.back());
+			for (size_t i = 0u; i < ITERATION_COUNT; i++)
+				EXPECT_TRUE(system.Execute(logger));
+			const JobSystem::GraphStatistics info = system.GraphInfo();
+			EXPECT_EQ(info.executionCount, ITERATION_COUNT);
+			EXPECT_EQ(info.rebuildCount, staticTopology ? 1u : ITERATION_COUNT);
+			EXPECT_EQ(info.jobCount, JOB_COUNT);
+			logger->Info(std::fixed, std::setprecision(3),
+				"JobSystemTest.GraphConstructionTime - StaticTopology: ", staticTopology,
+				"; Jobs: ", info.jobCount, "; Rebuilds: ", info.rebuildCount,
+				"; Average graph construction time: ", (info.totalConstructionTime * 1000.0f / info.executionCount), "ms");
+		};
+		measure(false);
+		measure(true);
+
+		for (size_t i = 0u; i < jobs.size(); i++) {
+			EXPECT_EQ(jobs[i]->ExecutionCount(), ITERATION_COUNT * 2u);
+			EXPECT_EQ(jobs[i]->OrderViolations(), 0u);
+		}
 	}
 }
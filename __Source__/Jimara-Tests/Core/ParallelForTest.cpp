@@ -0,0 +1,112 @@
+#include "../GtestHeaders.h"
+#include "Core/Systems/ParallelFor.h"
+#include "Core/Stopwatch.h"
+#include "OS/Logging/StreamLogger.h"
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	// Makes sure ParallelFor visits each index exactly once
+	TEST(ParallelForTest, ParallelFor) {
+		ThreadBlock block(ThreadBlock::WaitMode::ADAPTIVE);
+		for (size_t count : { size_t(0u), size_t(1u), size_t(7u), size_t(1000u), size_t(100000u) })
+			for (size_t grainSize : { size_t(0u), size_t(1u), size_t(64u), size_t(4096u) }) {
+				std::vector<std::atomic<uint32_t>> visits(count + 2u);
+				ParallelFor(block, 8u, 1u, count + 1u, grainSize, [&](size_t i) { visits[i]++; });
+				EXPECT_EQ(visits[0], 0u);
+				EXPECT_EQ(visits[count + 1u], 0u);
+				for (size_t i = 1u; i <= count; i++)
+					ASSERT_EQ(visits[i], 1u);
+			}
+	}
+
+	// Makes sure ParallelReduce is correct and deterministic
+	TEST(ParallelForTest, ParallelReduce) {
+		ThreadBlock block(ThreadBlock::WaitMode::ADAPTIVE);
+		static const size_t COUNT = 100000u;
+		const uint64_t sum = ParallelReduce(block, 8u, 0u, COUNT, 256u, uint64_t(0u),
+			[](uint64_t& acc, size_t i) { acc += i; },
+			[](uint64_t a, uint64_t b) { return a + b; });
+		EXPECT_EQ(sum, (uint64_t(COUNT) * (COUNT - 1u)) / 2u);
+
+		auto floatSum = [&](size_t maxThreads) {
+			return ParallelReduce(block, maxThreads, 0u, COUNT, 100u, 0.0f,
+				[](float& acc, size_t i) { acc += 1.0f / float(i + 1u); },
+				[](float a, float b) { return a + b; });
+		};
+		const float singleThreaded = floatSum(1u);
+		for (size_t i = 0u; i < 8u; i++)
+			EXPECT_EQ(floatSum(8u), singleThreaded);
+
+		EXPECT_EQ(ParallelReduce(block, 8u, 5u, 5u, 1u, 7, [](int&, size_t) {}, [](int a, int b) { return a + b; }), 7);
+	}
+
+	// Makes sure ParallelSort produces sorted output
+	TEST(ParallelForTest, ParallelSort) {
+		ThreadBlock block(ThreadBlock::WaitMode::ADAPTIVE);
+		std::mt19937 rng(0u);
+		for (size_t count : { size_t(0u), size_t(1u), size_t(3u), size_t(1000u), size_t(123457u) }) {
+			std::vector<uint32_t> values(count);
+			for (size_t i = 0u; i < count; i++)
+				values[i] = static_cast<uint32_t>(rng() % 1000u);
+			std::vector<uint32_t> expected = values;
+			std::sort(expected.begin(), expected.end());
+			ParallelSort(block, 8u, values.begin(), values.end(), 16u);
+			EXPECT_EQ(values, expected);
+			ParallelSort(block, 8u, values.begin(), values.end(), 16u, [](uint32_t a, uint32_t b) { return a > b; });
+			std::reverse(expected.begin(), expected.end());
+			EXPECT_EQ(values, expected);
+		}
+	}
+
+	// Makes sure nested calls do not deadlock, even if they target the same block
+	TEST(ParallelForTest, Nesting) {
+		ThreadBlock adaptiveBlock(ThreadBlock::WaitMode::ADAPTIVE);
+		ThreadBlock blockingBlock(ThreadBlock::WaitMode::BLOCKING);
+		static const size_t OUTER_COUNT = 64u;
+		static const size_t INNER_COUNT = 256u;
+		for (ThreadBlock* block : { &adaptiveBlock, &blockingBlock }) {
+			std::atomic<size_t> counter = 0u;
+			ParallelFor(*block, 4u, 0u, OUTER_COUNT, 1u, [&](size_t) {
+				ParallelFor(*block, 4u, 0u, INNER_COUNT, 16u, [&](size_t) { counter++; });
+				});
+			EXPECT_EQ(counter.load(), OUTER_COUNT * INNER_COUNT);
+
+			// Busy block should fall back to the calling thread and report it:
+			std::atomic<size_t> otherCounter = 0u;
+			std::atomic<size_t> fallbackCount = 0u;
+			const size_t busyCount = blockingBlock.BusyCount();
+			EXPECT_TRUE(ParallelFor(adaptiveBlock, 4u, 0u, OUTER_COUNT, 1u, [&](size_t) {
+				if (!ParallelFor(blockingBlock, 4u, 0u, INNER_COUNT, 16u, [&](size_t) { otherCounter++; }))
+					fallbackCount++;
+				}));
+			EXPECT_EQ(otherCounter.load(), OUTER_COUNT * INNER_COUNT);
+			EXPECT_EQ(blockingBlock.BusyCount() - busyCount, fallbackCount.load());
+		}
+	}
+
+	// Compares ParallelFor with a plain loop for uneven per-element costs
+	TEST(ParallelForTest, Performance) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		ThreadBlock block(ThreadBlock::WaitMode::ADAPTIVE);
+		static const size_t COUNT = (1u << 14u);
+		std::vector<uint64_t> results(COUNT);
+		auto work = [&](size_t i) {
+			uint64_t value = i;
+			const size_t cost = ((i % 64u) == 0u) ? 4096u : 64u;
+			for (size_t j = 0u; j < cost; j++)
+				value = (value * 6364136223846793005u) + 1442695040888963407u;
+			results[i] = value;
+		};
+		Stopwatch stopwatch;
+		for (size_t i = 0u; i < COUNT; i++)
+			work(i);
+		const float serialTime = stopwatch.Reset();
+		const size_t threadCount = std::max((size_t)std::thread::hardware_concurrency(), (size_t)1u);
+		ParallelFor(block, threadCount, 0u, COUNT, 16u, work);
+		const float parallelTime = stopwatch.Reset();
+		logger->Info(std::fixed, std::setprecision(3),
+			"ParallelForTest.Performance - Serial: ", serialTime * 1000.0f, "ms; ParallelFor(threads: ", threadCount, "): ", parallelTime * 1000.0f, "ms");
+	}
+}
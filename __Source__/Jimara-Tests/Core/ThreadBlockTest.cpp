@@ -0,0 +1,107 @@
+#include "../GtestHeaders.h"
+#include "Core/Collections/ThreadBlock.h"
+#include "Core/Stopwatch.h"
+#include "OS/Logging/StreamLogger.h"
+#include <iomanip>
+
+
+namespace Jimara {
+	namespace {
+		struct InvocationCounter {
+			std::vector<std::atomic<size_t>> invocations;
+			std::atomic<size_t> threadCountMismatches = 0u;
+			size_t expectedThreadCount = 0u;
+
+			inline InvocationCounter(size_t maxThreads) : invocations(maxThreads) {}
+
+			inline static void Invoke(ThreadBlock::ThreadInfo info, void* selfPtr) {
+				InvocationCounter* self = reinterpret_cast<InvocationCounter*>(selfPtr);
+				if (info.threadCount != self->expectedThreadCount) self->threadCountMismatches++;
+				if (info.threadId < self->invocations.size()) self->invocations[info.threadId]++;
+			}
+		};
+
+		inline static void CheckInvocations(ThreadBlock::WaitMode mode) {
+			static const size_t MAX_THREADS = 8u;
+			static const size_t ITERATIONS_PER_COUNT = 64u;
+			ThreadBlock block(mode);
+			EXPECT_EQ(block.Mode(), mode);
+			InvocationCounter counter(MAX_THREADS);
+			const Callback<ThreadBlock::ThreadInfo, void*> invoke(InvocationCounter::Invoke);
+			
+			// Varying thread count, including 0:
+			for (size_t threadCount = 0u; threadCount <= MAX_THREADS; threadCount++) {
+				counter.expectedThreadCount = threadCount;
+				for (size_t i = 0u; i < ITERATIONS_PER_COUNT; i++)
+					block.Execute(threadCount, &counter, invoke);
+			}
+			EXPECT_EQ(counter.threadCountMismatches, 0u);
+			for (size_t threadId = 0u; threadId < MAX_THREADS; threadId++)
+				EXPECT_EQ(counter.invocations[threadId], (MAX_THREADS - threadId) * ITERATIONS_PER_COUNT);
+
+			// Dispatch with fewer threads after a pause (ADAPTIVE workers should have parked by then):
+			std::this_thread::sleep_for(std::chrono::milliseconds(50));
+			counter.expectedThreadCount = 2u;
+			block.Execute(2u, &counter, invoke);
+			EXPECT_EQ(counter.threadCountMismatches, 0u);
+			EXPECT_EQ(counter.invocations[0], (MAX_THREADS * ITERATIONS_PER_COUNT) + 1u);
+			EXPECT_EQ(counter.invocations[1], ((MAX_THREADS - 1u) * ITERATIONS_PER_COUNT) + 1u);
+			EXPECT_EQ(counter.invocations[2], (MAX_THREADS - 2u) * ITERATIONS_PER_COUNT);
+		}
+	}
+
+	// Makes sure each thread is invoked exactly once per Execute() call in BLOCKING mode
+	TEST(ThreadBlockTest, Invocations_Blocking) {
+		CheckInvocations(ThreadBlock::WaitMode::BLOCKING);
+	}
+
+	// Makes sure each thread is invoked exactly once per Execute() call in ADAPTIVE mode
+	TEST(ThreadBlockTest, Invocations_Adaptive) {
+		CheckInvocations(ThreadBlock::WaitMode::ADAPTIVE);
+	}
+
+	// Makes sure, ADAPTIVE mode runs thread 0 on the caller and BLOCKING never does
+	TEST(ThreadBlockTest, CallerParticipation) {
+		auto check = [](ThreadBlock::WaitMode mode) {
+			ThreadBlock block(mode);
+			std::thread::id threadZeroId;
+			auto recordThreadId = [&](ThreadBlock::ThreadInfo info, void*) {
+				if (info.threadId == 0u) threadZeroId = std::this_thread::get_id();
+			};
+			block.Execute(4u, nullptr, Callback<ThreadBlock::ThreadInfo, void*>::FromCall(&recordThreadId));
+			return threadZeroId == std::this_thread::get_id();
+		};
+		EXPECT_FALSE(check(ThreadBlock::WaitMode::BLOCKING));
+		EXPECT_TRUE(check(ThreadBlock::WaitMode::ADAPTIVE));
+	}
+
+	// Compares dispatch latency of tiny jobs between BLOCKING and ADAPTIVE modes
+	TEST(ThreadBlockTest, DispatchLatency) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		static const size_t DISPATCH_COUNT = 4096u;
+		const size_t maxThreads = std::max((size_t)std::thread::hardware_concurrency(), (size_t)4u);
+		
+		auto measure = [&](ThreadBlock::WaitMode mode, size_t threadCount) {
+			ThreadBlock block(mode);
+			std::atomic<size_t> counter = 0u;
+			auto job = [&](ThreadBlock::ThreadInfo, void*) { counter++; };
+			const Callback<ThreadBlock::ThreadInfo, void*> callback = Callback<ThreadBlock::ThreadInfo, void*>::FromCall(&job);
+			block.Execute(threadCount, nullptr, callback);
+			counter = 0u;
+			Stopwatch stopwatch;
+			for (size_t i = 0u; i < DISPATCH_COUNT; i++)
+				block.Execute(threadCount, nullptr, callback);
+			const float elapsed = stopwatch.Elapsed();
+			EXPECT_EQ(counter.load(), DISPATCH_COUNT * threadCount);
+			return (elapsed * 1000000.0f / DISPATCH_COUNT);
+		};
+
+		for (size_t threadCount = 1u; threadCount <= maxThreads; threadCount <<= 1u) {
+			const float blocking = measure(ThreadBlock::WaitMode::BLOCKING, threadCount);
+			const float adaptive = measure(ThreadBlock::WaitMode::ADAPTIVE, threadCount);
+			logger->Info(std::fixed, std::setprecision(3),
+				"ThreadBlockTest.DispatchLatency - threadCount: ", threadCount,
+				"; BLOCKING: ", blocking, "us; ADAPTIVE: ", adaptive, "us");
+		}
+	}
+}
@@ -0,0 +1,283 @@
+#include "../GtestHeaders.h"
+#include "Data/Animation.h"
+#include "Core/Stopwatch.h"
+#include "OS/Logging/StreamLogger.h"
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	namespace {
+		// Creates a bezier curve with random keyframes
+		inline static Reference<TimelineCurve<float, BezierNode<float>>> AnimationClipTest_RandomCurve(
+			float duration, float keyInterval, float minValue, float maxValue, std::mt19937& rng) {
+			Reference<TimelineCurve<float, BezierNode<float>>> curve = Object::Instantiate<TimelineCurve<float, BezierNode<float>>>();
+			std::uniform_real_distribution<float> dis(minValue, maxValue);
+			for (float time = 0.0f; time < (duration + keyInterval); time += keyInterval)
+				(*curve)[Math::Min(time, duration)] = BezierNode<float>(dis(rng));
+			return curve;
+		}
+
+		// Creates a clip with float, Vector3 and euler angle tracks
+		inline static Reference<AnimationClip> AnimationClipTest_RandomClip(size_t trackTripletCount, float duration, std::mt19937& rng) {
+			Reference<AnimationClip> clip = Object::Instantiate<AnimationClip>("RandomClip");
+			AnimationClip::Writer writer(clip);
+			writer.SetDuration(duration);
+			for (size_t i = 0u; i < trackTripletCount; i++) {
+				AnimationClip::FloatBezier* floatTrack = writer.AddTrack<AnimationClip::FloatBezier>();
+				const Reference<TimelineCurve<float, BezierNode<float>>> floatCurve = AnimationClipTest_RandomCurve(duration, 0.5f, -1.0f, 1.0f, rng);
+				for (auto it = floatCurve->begin(); it != floatCurve->end(); ++it)
+					(*floatTrack)[it->first] = it->second;
+				writer.AddTrack<AnimationClip::TripleFloatCombine>(
+					AnimationClipTest_RandomCurve(duration, 0.5f, -1.0f, 1.0f, rng),
+					AnimationClipTest_RandomCurve(duration, 0.5f, -1.0f, 1.0f, rng),
+					AnimationClipTest_RandomCurve(duration, 0.5f, -1.0f, 1.0f, rng));
+				writer.AddTrack<AnimationClip::EulerAngleTrack>(
+					AnimationClipTest_RandomCurve(duration, 0.5f, -180.0f, 180.0f, rng),
+					AnimationClipTest_RandomCurve(duration, 0.5f, -180.0f, 180.0f, rng),
+					AnimationClipTest_RandomCurve(duration, 0.5f, -180.0f, 180.0f, rng),
+					static_cast<AnimationClip::EulerAngleTrack::EvaluationMode>(i % static_cast<size_t>(AnimationClip::EulerAngleTrack::EvaluationMode::MODE_COUNT)));
+			}
+			return clip;
+		}
+
+		// Difference between rotation matrices, generated from euler angles
+		inline static float AnimationClipTest_RotationDelta(const Vector3& a, const Vector3& b) {
+			const Matrix4 matA = Math::MatrixFromEulerAngles(a);
+			const Matrix4 matB = Math::MatrixFromEulerAngles(b);
+			float delta = 0.0f;
+			for (size_t i = 0u; i < 3u; i++)
+				delta = Math::Max(delta, Math::Magnitude(Vector3(matA[i]) - Vector3(matB[i])));
+			return delta;
+		}
+	}
+
+	// Baked tracks have to match the source tracks at sample points and stay close in-between
+	TEST(AnimationClipTest, BakedSampling) {
+		std::mt19937 rng;
+		const Reference<AnimationClip> clip = AnimationClipTest_RandomClip(12u, 4.0f, rng);
+		const Reference<const BakedAnimationClip> baked = clip->Baked();
+		ASSERT_NE(baked, nullptr);
+		ASSERT_EQ(baked->TrackCount(), clip->TrackCount());
+		EXPECT_EQ(baked->Duration(), clip->Duration());
+		EXPECT_EQ(baked->SampleCount(), static_cast<size_t>(clip->Duration() * BakedAnimationClip::DEFAULT_SAMPLE_RATE) + 1u);
+
+		// Note: Interpolating euler angles can deviate a bit more near the gimbal lock, so we only check mean error in-between samples for those.
+		float eulerErrorSum = 0.0f;
+		size_t eulerErrorCount = 0u;
+		const float sampleInterval = clip->Duration() / static_cast<float>(baked->SampleCount() - 1u);
+		for (size_t trackId = 0u; trackId < clip->TrackCount(); trackId++) {
+			const AnimationClip::Track* track = clip->GetTrack(trackId);
+			const BakedAnimationClip::Track& bakedTrack = baked->GetTrack(trackId);
+			ASSERT_TRUE(bakedTrack.Baked());
+			for (size_t sampleId = 0u; sampleId < (2u * baked->SampleCount() - 1u); sampleId++) {
+				const float time = Math::Min(static_cast<float>(sampleId) * 0.5f * sampleInterval, clip->Duration());
+				const bool isSamplePoint = ((sampleId & 1u) == 0u);
+				if (bakedTrack.ComponentCount() == 1u) {
+					float value = 0.0f;
+					ASSERT_TRUE(bakedTrack.Sample(time, value));
+					Vector3 invalid;
+					EXPECT_FALSE(bakedTrack.Sample(time, invalid));
+					EXPECT_NEAR(value, dynamic_cast<const ParametricCurve<float, float>*>(track)->Value(time), isSamplePoint ? 0.0001f : 0.01f);
+				}
+				else {
+					ASSERT_EQ(bakedTrack.ComponentCount(), 3u);
+					Vector3 value(0.0f);
+					ASSERT_TRUE(bakedTrack.Sample(time, value));
+					float invalid;
+					EXPECT_FALSE(bakedTrack.Sample(time, invalid));
+					const Vector3 expected = dynamic_cast<const ParametricCurve<Vector3, float>*>(track)->Value(time);
+					if (dynamic_cast<const AnimationClip::EulerAngleTrack*>(track) != nullptr) {
+						const float delta = AnimationClipTest_RotationDelta(value, expected);
+						if (isSamplePoint) {
+							EXPECT_LT(delta, 0.001f);
+							// Each component can only be unwrapped by a multiple of 360 degrees, so that the per-component blending is not affected:
+							for (size_t i = 0u; i < 3u; i++) {
+								const float offset = value[i] - expected[i];
+								EXPECT_NEAR(offset, 360.0f * std::round(offset / 360.0f), 0.01f);
+							}
+						}
+						else {
+							eulerErrorSum += delta;
+							eulerErrorCount++;
+						}
+					}
+					else EXPECT_LT(Math::Magnitude(value - expected), isSamplePoint ? 0.0001f : 0.01f);
+				}
+			}
+		}
+		ASSERT_GT(eulerErrorCount, 0u);
+		EXPECT_LT(eulerErrorSum / static_cast<float>(eulerErrorCount), 0.01f);
+	}
+
+	// Compressed tracks have to stay within the error budget and constant tracks should not store any samples
+	TEST(AnimationClipTest, CompressedSampling) {
+		std::mt19937 rng;
+		const Reference<AnimationClip> clip = AnimationClipTest_RandomClip(12u, 4.0f, rng);
+		{
+			AnimationClip::Writer writer(clip);
+			AnimationClip::FloatBezier* constantTrack = writer.AddTrack<AnimationClip::FloatBezier>();
+			(*constantTrack)[0.0f] = BezierNode<float>(7.0f);
+			(*constantTrack)[clip->Duration()] = BezierNode<float>(7.0f);
+			writer.Compression().valueError = 0.001f;
+			writer.Compression().angleError = 0.1f;
+		}
+		const Reference<const BakedAnimationClip> compressed = clip->Baked();
+		const Reference<const BakedAnimationClip> uncompressed = BakedAnimationClip::Bake(clip);
+		ASSERT_NE(compressed, nullptr);
+		ASSERT_NE(uncompressed, nullptr);
+		ASSERT_EQ(compressed->TrackCount(), uncompressed->TrackCount());
+		ASSERT_EQ(compressed->SampleCount(), uncompressed->SampleCount());
+		EXPECT_LT(compressed->SampleDataSize(), uncompressed->SampleDataSize());
+
+		const BakedAnimationClip::Track& constantTrack = compressed->GetTrack(compressed->TrackCount() - 1u);
+		EXPECT_TRUE(constantTrack.Baked());
+		EXPECT_EQ(constantTrack.SampleCount(), 0u);
+		{
+			float value = 0.0f;
+			EXPECT_TRUE(constantTrack.Sample(1.0f, value));
+			EXPECT_NEAR(value, 7.0f, 0.001f);
+		}
+
+		const float sampleInterval = clip->Duration() / static_cast<float>(uncompressed->SampleCount() - 1u);
+		for (size_t trackId = 0u; trackId < compressed->TrackCount(); trackId++) {
+			const BakedAnimationClip::Track& track = compressed->GetTrack(trackId);
+			const BakedAnimationClip::Track& reference = uncompressed->GetTrack(trackId);
+			ASSERT_EQ(track.ComponentCount(), reference.ComponentCount());
+			EXPECT_LE(track.SampleCount(), reference.SampleCount());
+			for (size_t sampleId = 0u; sampleId < uncompressed->SampleCount(); sampleId++) {
+				const float time = Math::Min(static_cast<float>(sampleId) * sampleInterval, clip->Duration());
+				if (track.ComponentCount() == 1u) {
+					float value = 0.0f, expected = 0.0f;
+					ASSERT_TRUE(track.Sample(time, value));
+					ASSERT_TRUE(reference.Sample(time, expected));
+					EXPECT_NEAR(value, expected, 0.0011f);
+				}
+				else {
+					Vector3 value(0.0f), expected(0.0f);
+					ASSERT_TRUE(track.Sample(time, value));
+					ASSERT_TRUE(reference.Sample(time, expected));
+					if (dynamic_cast<const AnimationClip::EulerAngleTrack*>(clip->GetTrack(trackId)) != nullptr)
+						EXPECT_LT(AnimationClipTest_RotationDelta(value, expected), 0.01f);
+					else EXPECT_LT(Math::Magnitude(value - expected), 0.002f);
+				}
+			}
+		}
+	}
+
+	// Baked data should be retained till the clip gets modified
+	TEST(AnimationClipTest, BakedInvalidation) {
+		std::mt19937 rng;
+		const Reference<AnimationClip> clip = AnimationClipTest_RandomClip(1u, 1.0f, rng);
+		const Reference<const BakedAnimationClip> baked = clip->Baked();
+		ASSERT_NE(baked, nullptr);
+		EXPECT_EQ(clip->Baked(), baked);
+		{
+			AnimationClip::Writer writer(clip);
+			writer.SetDuration(2.0f);
+		}
+		const Reference<const BakedAnimationClip> rebaked = clip->Baked();
+		ASSERT_NE(rebaked, nullptr);
+		EXPECT_NE(rebaked, baked);
+		EXPECT_EQ(rebaked->Duration(), 2.0f);
+		EXPECT_EQ(baked->Duration(), 1.0f);
+		EXPECT_EQ(BakedAnimationClip::Bake(nullptr), nullptr);
+	}
+
+	// SetCompression() should not dirty the clip, unless it has to discard the existing baked data
+	TEST(AnimationClipTest, SetCompression) {
+		std::mt19937 rng;
+		const Reference<AnimationClip> clip = AnimationClipTest_RandomClip(2u, 1.0f, rng);
+		size_t dirtyCount = 0u;
+		void(*onDirty)(size_t*, const AnimationClip*) = [](size_t* count, const AnimationClip*) { (*count)++; };
+		const Callback<const AnimationClip*> onDirtyCallback(onDirty, &dirtyCount);
+		clip->OnDirty() += onDirtyCallback;
+
+		BakedAnimationClip::CompressionSettings compression;
+		compression.valueError = 0.001f;
+		compression.angleError = 0.1f;
+		clip->SetCompression(compression);
+		EXPECT_EQ(dirtyCount, 0u);
+		EXPECT_EQ(clip->Compression().valueError, compression.valueError);
+		EXPECT_EQ(clip->Compression().angleError, compression.angleError);
+
+		const Reference<const BakedAnimationClip> baked = clip->Baked();
+		ASSERT_NE(baked, nullptr);
+		clip->SetCompression(compression);
+		EXPECT_EQ(dirtyCount, 0u);
+		EXPECT_EQ(clip->Baked(), baked);
+
+		compression.valueError = 0.01f;
+		clip->SetCompression(compression);
+		EXPECT_EQ(dirtyCount, 1u);
+		EXPECT_NE(clip->Baked(), baked);
+		clip->OnDirty() -= onDirtyCallback;
+	}
+
+	// Compares sequential playback sampling through the source tracks, the baked clip and the compressed clip (and reports clip sizes)
+	TEST(AnimationClipTest, BakedSamplingPerformance) {
+		Reference<OS::StreamLogger> logger = Object::Instantiate<OS::StreamLogger>();
+		std::mt19937 rng;
+		static const constexpr size_t TRACK_TRIPLET_COUNT = 64u;
+		static const constexpr size_t FRAME_COUNT = 4096u;
+		static const constexpr float FRAME_TIME = 1.0f / 60.0f;
+		const Reference<AnimationClip> clip = AnimationClipTest_RandomClip(TRACK_TRIPLET_COUNT, 10.0f, rng);
+
+		Stopwatch stopwatch;
+		const Reference<const BakedAnimationClip> baked = clip->Baked();
+		const float bakeTime = stopwatch.Reset();
+		ASSERT_NE(baked, nullptr);
+
+		float curveSum = 0.0f;
+		for (size_t frame = 0u; frame < FRAME_COUNT; frame++) {
+			const float time = Math::FloatRemainder(static_cast<float>(frame) * FRAME_TIME, clip->Duration());
+			for (size_t trackId = 0u; trackId < clip->TrackCount(); trackId++) {
+				const AnimationTrack* track = clip->GetTrack(trackId);
+				const ParametricCurve<float, float>* floatCurve = dynamic_cast<const ParametricCurve<float, float>*>(track);
+				if (floatCurve != nullptr) curveSum += floatCurve->Value(time);
+				else curveSum += dynamic_cast<const ParametricCurve<Vector3, float>*>(track)->Value(time).x;
+			}
+		}
+		const float curveTime = stopwatch.Reset();
+
+		auto sampleBaked = [&](const BakedAnimationClip* bakedClip) {
+			float sum = 0.0f;
+			for (size_t frame = 0u; frame < FRAME_COUNT; frame++) {
+				const float time = Math::FloatRemainder(static_cast<float>(frame) * FRAME_TIME, clip->Duration());
+				for (size_t trackId = 0u; trackId < bakedClip->TrackCount(); trackId++) {
+					const BakedAnimationClip::Track& track = bakedClip->GetTrack(trackId);
+					float floatValue;
+					Vector3 vectorValue;
+					if (track.Sample(time, floatValue)) sum += floatValue;
+					else if (track.Sample(time, vectorValue)) sum += vectorValue.x;
+				}
+			}
+			return sum;
+		};
+		const float bakedSum = sampleBaked(baked);
+		const float bakedTime = stopwatch.Reset();
+
+		BakedAnimationClip::CompressionSettings compression;
+		compression.valueError = 0.001f;
+		compression.angleError = 0.1f;
+		const Reference<const BakedAnimationClip> compressed = BakedAnimationClip::Bake(clip, compression);
+		const float compressionTime = stopwatch.Reset();
+		ASSERT_NE(compressed, nullptr);
+		const float compressedSum = sampleBaked(compressed);
+		const float compressedTime = stopwatch.Reset();
+		EXPECT_TRUE(std::isfinite(curveSum));
+		EXPECT_TRUE(std::isfinite(bakedSum));
+		EXPECT_TRUE(std::isfinite(compressedSum));
+		const size_t sampleCount = FRAME_COUNT * clip->TrackCount();
+
+		logger->Info(std::fixed, std::setprecision(3),
+			"AnimationClipTest.BakedSamplingPerformance - Tracks: ", clip->TrackCount(), "; Frames: ", FRAME_COUNT,
+			"; Bake: ", bakeTime * 1000.0f, "ms (", baked->SampleDataSize(), " bytes); Source tracks: ", curveTime * 1000.0f,
+			"ms (", (sampleCount / Math::Max(curveTime, std::numeric_limits<float>::epsilon())), " samples/s); Baked: ", bakedTime * 1000.0f,
+			"ms (", (sampleCount / Math::Max(bakedTime, std::numeric_limits<float>::epsilon())), " samples/s)");
+		logger->Info(std::fixed, std::setprecision(3),
+			"AnimationClipTest.BakedSamplingPerformance - Compression: ", compressionTime * 1000.0f, "ms; Bytes per clip: ",
+			baked->SampleDataSize(), " -> ", compressed->SampleDataSize(), "; Compressed: ", compressedTime * 1000.0f,
+			"ms (", (sampleCount / Math::Max(compressedTime, std::numeric_limits<float>::epsilon())), " samples/s)");
+	}
+}
@@ -1,12 +1,16 @@
 #include "../GtestHeaders.h"
 #include "../Components/TestEnvironment/TestEnvironment.h"
 #include "Data/Serialization/Helpers/SerializeToJson.h"
+#include "Data/Serialization/Helpers/SerializeToBinary.h"
 #include "Data/Serialization/Helpers/ComponentHierarchySerializer.h"
+#include "Data/Serialization/Helpers/ComponentHierarchyInstantiationPlan.h"
+#include "Data/ComponentHierarchyInstancePool.h"
 #include "Data/Geometry/MeshGenerator.h"
 #include "Data/AssetDatabase/AssetSet.h"
 #include "Components/Transform.h"
 #include "Components/Lights/DirectionalLight.h"
 #include "Components/GraphicsObjects/MeshRenderer.h"
+#include "Core/Stopwatch.h"
 
 
 namespace Jimara {
@@ -171,6 +175,7 @@ namespace Jimara {
 			inline ComponentHierarchySerializerTest_ObjectEmitter(Component* parent, Transform* transform = nullptr)
 				: Component(parent, "Emitter"), m_transform(transform) {}
 
+			inline Transform* Target()const { return m_transform; }
 
 			inline virtual void GetFields(Callback<Serialization::SerializedObject> recordElement)override {
 				Component::GetFields(recordElement);
@@ -257,4 +262,321 @@ namespace Jimara {
 		};
 		environment.SetWindowName("You should be looking at the restored scene");
 	}
+
+	// Compares load times of the same (large) generated hierarchy, stored as json and in binary format
+	TEST(ComponentHierarchySerializerTest, JsonVsBinaryLoadPerformance) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		OS::Logger* log = scene->Context()->Log();
+
+		const constexpr size_t BRANCH_COUNT = 128u;
+		const constexpr size_t LEAF_COUNT = 32u;
+		const constexpr size_t ITERATION_COUNT = 4u;
+
+		std::function<size_t(Component*)> countComponents = [&](Component* component) -> size_t {
+			size_t count = 1u;
+			for (size_t i = 0; i < component->ChildCount(); i++)
+				count += countComponents(component->GetChild(i));
+			return count;
+		};
+
+		// Generate hierarchy:
+		Component* source = Object::Instantiate<Component>(scene->RootObject(), "Source");
+		for (size_t i = 0; i < BRANCH_COUNT; i++) {
+			Transform* branch = Object::Instantiate<Transform>(source, "Branch_" + std::to_string(i), Vector3(static_cast<float>(i), 0.0f, 0.0f));
+			for (size_t j = 0; j < LEAF_COUNT; j++)
+				Object::Instantiate<Transform>(branch, "Leaf_" + std::to_string(j),
+					Vector3(0.0f, static_cast<float>(j), 0.0f), Vector3(0.0f, static_cast<float>(i + j), 0.0f), Vector3(1.0f + 0.01f * j));
+		}
+		const size_t componentCount = countComponents(source);
+
+		// Store it in both formats:
+		std::string jsonText;
+		std::vector<uint8_t> binary;
+		{
+			ComponentHierarchySerializerInput serializerInput;
+			serializerInput.rootComponent = source;
+			bool error = false;
+			jsonText = Serialization::SerializeToJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), log, error,
+				[&](const Serialization::SerializedObject&, bool&) -> nlohmann::json {
+					assert(false);
+					return "";
+				}).dump(1, '\t');
+			EXPECT_FALSE(error);
+			binary = Serialization::SerializeToBinary(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), log, error,
+				[&](const Serialization::SerializedObject&, bool&) -> GUID {
+					assert(false);
+					return {};
+				});
+			EXPECT_FALSE(error);
+		}
+		source->Destroy();
+
+		// Load both formats multiple times:
+		auto measureLoad = [&](const auto& load) {
+			float totalTime = 0.0f;
+			for (size_t i = 0; i < ITERATION_COUNT; i++) {
+				ComponentHierarchySerializerInput serializerInput;
+				serializerInput.rootComponent = Object::Instantiate<Component>(scene->RootObject(), "Target");
+				const Stopwatch stopwatch;
+				EXPECT_TRUE(load(serializerInput));
+				totalTime += stopwatch.Elapsed();
+				EXPECT_NE(serializerInput.rootComponent, nullptr);
+				if (serializerInput.rootComponent == nullptr) continue;
+				EXPECT_EQ(countComponents(serializerInput.rootComponent), componentCount);
+				EXPECT_EQ(serializerInput.rootComponent->ChildCount(), BRANCH_COUNT);
+				serializerInput.rootComponent->Destroy();
+			}
+			return totalTime / ITERATION_COUNT;
+		};
+		const float jsonTime = measureLoad([&](ComponentHierarchySerializerInput& serializerInput) {
+			const nlohmann::json json = nlohmann::json::parse(jsonText);
+			return Serialization::DeserializeFromJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), json, log,
+				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
+					assert(false);
+					return false;
+				});
+			});
+		const float binaryTime = measureLoad([&](ComponentHierarchySerializerInput& serializerInput) {
+			return Serialization::DeserializeFromBinary(ComponentHierarchySerializer::Instance()->Serialize(serializerInput),
+				MemoryBlock(binary.data(), binary.size(), nullptr), log,
+				[&](const Serialization::SerializedObject&, const GUID&) -> bool {
+					assert(false);
+					return false;
+				});
+			});
+
+		log->Info("ComponentHierarchySerializerTest::JsonVsBinaryLoadPerformance - ", componentCount, " components; ",
+			"Json: ", jsonText.size(), " bytes, ", (jsonTime * 1000.0f), "ms per load; ",
+			"Binary: ", binary.size(), " bytes, ", (binaryTime * 1000.0f), "ms per load (", (jsonTime / std::max(binaryTime, 0.000001f)), "x)");
+	}
+
+	namespace {
+		class ComponentHierarchySerializerTest_PlanSpowner : public virtual ComponentHierarchySpowner {
+		public:
+			const Reference<const ComponentHierarchyInstantiationPlan> plan;
+
+			inline ComponentHierarchySerializerTest_PlanSpowner(const ComponentHierarchyInstantiationPlan* p) : plan(p) {}
+
+			inline virtual Reference<Component> SpownHierarchy(Component* parent) final override { return plan->Instantiate(parent); }
+		};
+	}
+
+	// Compares spowns per second for a 50-component prefab: json deserialization vs compiled instantiation plan vs pre-warmed instance pool
+	TEST(ComponentHierarchySerializerTest, InstantiationPlanSpownRate) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		OS::Logger* log = scene->Context()->Log();
+		Reference<const Object> objectEmitterToken = TypeId::Of<ComponentHierarchySerializerTest_ObjectEmitter>().Register();
+
+		const constexpr size_t BRANCH_COUNT = 6u;
+		const constexpr size_t LEAF_COUNT = 6u;
+		const constexpr size_t PREFAB_COMPONENT_COUNT = 1u + BRANCH_COUNT * (1u + 1u + LEAF_COUNT) + 1u;
+		const constexpr size_t SPOWN_COUNT = 256u;
+		static_assert(PREFAB_COMPONENT_COUNT == 50u);
+
+		// Generate the prefab (Transforms, with emitters referencing some of them):
+		Component* source = Object::Instantiate<Component>(scene->RootObject(), "Source");
+		Transform* prefab = Object::Instantiate<Transform>(source, "Prefab", Vector3(1.0f, 2.0f, 3.0f));
+		for (size_t i = 0; i < BRANCH_COUNT; i++) {
+			Transform* branch = Object::Instantiate<Transform>(prefab, "Branch_" + std::to_string(i), Vector3(static_cast<float>(i), 0.0f, 0.0f));
+			for (size_t j = 0; j < LEAF_COUNT; j++)
+				Object::Instantiate<Transform>(branch, "Leaf_" + std::to_string(j),
+					Vector3(0.0f, static_cast<float>(j), 0.0f), Vector3(0.0f, static_cast<float>(i + j), 0.0f), Vector3(1.0f + 0.01f * j));
+			Object::Instantiate<ComponentHierarchySerializerTest_ObjectEmitter>(branch, dynamic_cast<Transform*>(branch->GetChild(i % LEAF_COUNT)));
+		}
+		Object::Instantiate<ComponentHierarchySerializerTest_ObjectEmitter>(prefab, prefab)->SetEnabled(false);
+
+		// Flattens a subtree in depth-first preorder:
+		std::function<void(Component*, std::vector<Component*>&)> flatten = [&](Component* component, std::vector<Component*>& result) {
+			result.push_back(component);
+			for (size_t i = 0; i < component->ChildCount(); i++)
+				flatten(component->GetChild(i), result);
+		};
+		std::vector<Component*> sourceComponents;
+		flatten(prefab, sourceComponents);
+		ASSERT_EQ(sourceComponents.size(), PREFAB_COMPONENT_COUNT);
+
+		// Compares instance to the source prefab (including the internal references):
+		auto checkInstance = [&](Component* instance) {
+			ASSERT_NE(instance, nullptr);
+			std::vector<Component*> components;
+			flatten(instance, components);
+			ASSERT_EQ(components.size(), sourceComponents.size());
+			for (size_t i = 0; i < components.size(); i++) {
+				Component* expected = sourceComponents[i];
+				Component* component = components[i];
+				ASSERT_EQ(typeid(*component), typeid(*expected));
+				EXPECT_EQ(component->Name(), expected->Name());
+				EXPECT_EQ(component->Enabled(), expected->Enabled());
+				EXPECT_EQ(component->ChildCount(), expected->ChildCount());
+				const Transform* expectedTransform = dynamic_cast<Transform*>(expected);
+				if (expectedTransform != nullptr) {
+					const Transform* transform = dynamic_cast<Transform*>(component);
+					EXPECT_EQ(transform->LocalPosition(), expectedTransform->LocalPosition());
+					EXPECT_EQ(transform->LocalScale(), expectedTransform->LocalScale());
+					EXPECT_LT(Math::Magnitude(transform->LocalEulerAngles() - expectedTransform->LocalEulerAngles()), 0.001f);
+				}
+				const ComponentHierarchySerializerTest_ObjectEmitter* expectedEmitter = dynamic_cast<ComponentHierarchySerializerTest_ObjectEmitter*>(expected);
+				if (expectedEmitter != nullptr) {
+					const ComponentHierarchySerializerTest_ObjectEmitter* emitter = dynamic_cast<ComponentHierarchySerializerTest_ObjectEmitter*>(component);
+					const size_t expectedIndex = std::find(sourceComponents.begin(), sourceComponents.end(), expectedEmitter->Target()) - sourceComponents.begin();
+					const size_t index = std::find(components.begin(), components.end(), emitter->Target()) - components.begin();
+					EXPECT_EQ(index, expectedIndex);
+					EXPECT_LT(index, components.size());
+				}
+			}
+		};
+
+		// Store prefab as json:
+		std::string jsonText;
+		{
+			ComponentHierarchySerializerInput serializerInput;
+			serializerInput.rootComponent = prefab;
+			bool error = false;
+			jsonText = Serialization::SerializeToJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), log, error,
+				[&](const Serialization::SerializedObject&, bool&) -> nlohmann::json {
+					assert(false);
+					return "";
+				}).dump(1, '\t');
+			EXPECT_FALSE(error);
+		}
+		const nlohmann::json json = nlohmann::json::parse(jsonText);
+
+		// Measures spowns per second:
+		auto measureSpownRate = [&](const auto& spown) {
+			Component* parent = Object::Instantiate<Component>(scene->RootObject(), "Target");
+			const Stopwatch stopwatch;
+			for (size_t i = 0; i < SPOWN_COUNT; i++)
+				spown(parent);
+			const float elapsed = stopwatch.Elapsed();
+			EXPECT_EQ(parent->ChildCount(), SPOWN_COUNT);
+			for (size_t i = 0; i < parent->ChildCount(); i++)
+				checkInstance(parent->GetChild(i));
+			parent->Destroy();
+			return static_cast<float>(SPOWN_COUNT) / std::max(elapsed, 0.000001f);
+		};
+
+		const float jsonRate = measureSpownRate([&](Component* parent) {
+			ComponentHierarchySerializerInput serializerInput;
+			serializerInput.rootComponent = Object::Instantiate<Component>(parent);
+			EXPECT_TRUE(Serialization::DeserializeFromJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), json, log,
+				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
+					assert(false);
+					return false;
+				}));
+			});
+
+		const Reference<ComponentHierarchyInstantiationPlan> plan = ComponentHierarchyInstantiationPlan::Compile(prefab);
+		ASSERT_NE(plan, nullptr);
+		EXPECT_EQ(plan->ComponentCount(), PREFAB_COMPONENT_COUNT);
+		const float planRate = measureSpownRate([&](Component* parent) { EXPECT_NE(plan->Instantiate(parent), nullptr); });
+
+		const Reference<ComponentHierarchySerializerTest_PlanSpowner> spowner = Object::Instantiate<ComponentHierarchySerializerTest_PlanSpowner>(plan);
+		const Reference<ComponentHierarchyInstancePool> pool = ComponentHierarchyInstancePool::Create(spowner, scene->Context(), SPOWN_COUNT);
+		ASSERT_NE(pool, nullptr);
+		EXPECT_EQ(pool->ReadyCount(), SPOWN_COUNT);
+		const float poolRate = measureSpownRate([&](Component* parent) { EXPECT_NE(pool->Spown(parent), nullptr); });
+		EXPECT_EQ(pool->ReadyCount(), 0u);
+
+		log->Info("ComponentHierarchySerializerTest::InstantiationPlanSpownRate - ", PREFAB_COMPONENT_COUNT, " components per prefab; ",
+			"Json: ", jsonRate, " spowns/sec; ",
+			"Plan: ", planRate, " spowns/sec (", (planRate / std::max(jsonRate, 0.000001f)), "x); ",
+			"Pool: ", poolRate, " spowns/sec (", (poolRate / std::max(jsonRate, 0.000001f)), "x)");
+		source->Destroy();
+	}
+
+	// Pooled instances live outside the RootObject hierarchy, so saving and reloading the scene only picks them up once they are handed out
+	TEST(ComponentHierarchySerializerTest, InstancePoolRoundTrip) {
+		Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		OS::Logger* log = scene->Context()->Log();
+		std::unique_lock<std::recursive_mutex> lock(scene->Context()->UpdateLock());
+
+		Reference<ComponentHierarchyInstantiationPlan> plan;
+		{
+			Transform* prefab = Object::Instantiate<Transform>(scene->RootObject(), "Pooled", Vector3(1.0f, 2.0f, 3.0f));
+			Object::Instantiate<Transform>(prefab, "PooledChild");
+			plan = ComponentHierarchyInstantiationPlan::Compile(prefab);
+			prefab->Destroy();
+		}
+		ASSERT_NE(plan, nullptr);
+		Transform* content = Object::Instantiate<Transform>(scene->RootObject(), "Content");
+		Object::Instantiate<Transform>(content, "ContentChild");
+
+		static const constexpr size_t POOL_SIZE = 4u;
+		const Reference<ComponentHierarchySerializerTest_PlanSpowner> spowner = Object::Instantiate<ComponentHierarchySerializerTest_PlanSpowner>(plan);
+		const Reference<ComponentHierarchyInstancePool> pool = ComponentHierarchyInstancePool::Create(spowner, scene->Context(), POOL_SIZE);
+		ASSERT_NE(pool, nullptr);
+		EXPECT_EQ(pool->ReadyCount(), POOL_SIZE);
+
+		// Counts components with the given name within the subtree:
+		std::function<size_t(Component*, const std::string&)> countNamed = [&](Component* component, const std::string& name) {
+			size_t count = (component->Name() == name) ? 1u : 0u;
+			for (size_t i = 0; i < component->ChildCount(); i++)
+				count += countNamed(component->GetChild(i), name);
+			return count;
+		};
+
+		// Saves the scene and reloads it into a fresh one:
+		auto reload = [&]() -> Reference<Scene> {
+			ComponentHierarchySerializerInput serializerInput;
+			serializerInput.rootComponent = scene->RootObject();
+			bool error = false;
+			const std::string jsonText = Serialization::SerializeToJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), log, error,
+				[&](const Serialization::SerializedObject&, bool&) -> nlohmann::json {
+					assert(false);
+					return "";
+				}).dump(1, '\t');
+			EXPECT_FALSE(error);
+			const Reference<Scene> reloaded = CreateScene();
+			if (reloaded == nullptr)
+				return nullptr;
+			std::unique_lock<std::recursive_mutex> reloadedLock(reloaded->Context()->UpdateLock());
+			serializerInput.rootComponent = reloaded->RootObject();
+			EXPECT_TRUE(Serialization::DeserializeFromJson(ComponentHierarchySerializer::Instance()->Serialize(serializerInput), nlohmann::json::parse(jsonText), log,
+				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
+					assert(false);
+					return false;
+				}));
+			return reloaded;
+		};
+
+		// Pool holder and the pooled instances are neither a part of the saved scene, nor active:
+		{
+			EXPECT_EQ(scene->RootObject()->ChildCount(), 1u);
+			EXPECT_EQ(countNamed(scene->RootObject(), "ComponentHierarchyInstancePool"), 0u);
+			EXPECT_EQ(countNamed(scene->RootObject(), "Pooled"), 0u);
+			const Reference<Scene> reloaded = reload();
+			ASSERT_NE(reloaded, nullptr);
+			std::unique_lock<std::recursive_mutex> reloadedLock(reloaded->Context()->UpdateLock());
+			EXPECT_EQ(reloaded->RootObject()->ChildCount(), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "Content"), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "ContentChild"), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "ComponentHierarchyInstancePool"), 0u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "Pooled"), 0u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "PooledChild"), 0u);
+		}
+
+		// Handed out instance becomes a regular part of the scene:
+		{
+			const Reference<Component> instance = pool->Spown(content);
+			ASSERT_NE(instance, nullptr);
+			EXPECT_EQ(instance->Parent(), content);
+			EXPECT_EQ(pool->ReadyCount(), POOL_SIZE - 1u);
+			scene->Update(0.01f);
+			EXPECT_TRUE(instance->ActiveInHierarchy());
+			const Reference<Scene> reloaded = reload();
+			ASSERT_NE(reloaded, nullptr);
+			std::unique_lock<std::recursive_mutex> reloadedLock(reloaded->Context()->UpdateLock());
+			EXPECT_EQ(reloaded->RootObject()->ChildCount(), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "ContentChild"), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "Pooled"), 1u);
+			EXPECT_EQ(countNamed(reloaded->RootObject(), "PooledChild"), 1u);
+			const Transform* pooled = dynamic_cast<Transform*>(reloaded->RootObject()->GetChild(0u)->GetChild(1u));
+			ASSERT_NE(pooled, nullptr);
+			EXPECT_EQ(pooled->Name(), "Pooled");
+			EXPECT_EQ(pooled->LocalPosition(), Vector3(1.0f, 2.0f, 3.0f));
+		}
+	}
 }
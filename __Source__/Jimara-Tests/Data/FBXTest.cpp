@@ -3,12 +3,16 @@
 #include "OS/IO/MMappedFile.h"
 #include "OS/Logging/StreamLogger.h"
 #include "Data/Formats/FBX/FBXData.h"
+#include "Data/Formats/FBX/FBXCookedData.h"
 #include "Data/Materials/SampleDiffuse/SampleDiffuseShader.h"
 #include "Data/Geometry/MeshGenerator.h"
 #include "Components/GraphicsObjects/MeshRenderer.h"
 #include "Components/GraphicsObjects/SkinnedMeshRenderer.h"
 #include "Components/Animation/Animator.h"
 #include "Components/Lights/DirectionalLight.h"
+#include "Core/Stopwatch.h"
+#include <filesystem>
+#include <iomanip>
 #include <sstream>
 #include <cassert>
 
@@ -437,4 +441,193 @@ namespace Jimara {
 
 		RenderFBXDataOnTestEnvironment(data, "Default Cube (Non-Ascii File)");
 	}
+
+	// Cooked data has to restore exactly the same meshes, hierarchy and animations as the ones extracted from the source file
+	TEST(FBXTest, CookedData) {
+		Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		const OS::Path sourcePath = "Assets/Meshes/FBX/Cone_Guy/Cone_Guy_Animated.fbx";
+		Reference<OS::MMappedFile> fileMapping = OS::MMappedFile::Create(sourcePath, logger);
+		ASSERT_NE(fileMapping, nullptr);
+		const FBXHelpers::FBXCookedData::SourceKey sourceKey = FBXHelpers::FBXCookedData::Key(*fileMapping);
+
+		Stopwatch stopwatch;
+		const Reference<FBXData> data = FBXData::Extract(*fileMapping, logger);
+		const float extractionTime = stopwatch.Reset();
+		ASSERT_NE(data, nullptr);
+
+		std::vector<uint8_t> cooked;
+		ASSERT_TRUE(FBXHelpers::FBXCookedData::Cook(data, sourceKey, cooked, logger));
+		stopwatch.Reset();
+		const Reference<FBXData> restored = FBXHelpers::FBXCookedData::Restore(MemoryBlock(cooked.data(), cooked.size(), nullptr), sourceKey, logger);
+		const float restoreTime = stopwatch.Reset();
+		ASSERT_NE(restored, nullptr);
+		logger->Info(std::fixed, std::setprecision(3), "FBXTest::CookedData - Extract: ", (extractionTime * 1000.0f), "ms; Restore: ", (restoreTime * 1000.0f),
+			"ms (source: ", fileMapping->operator MemoryBlock().Size(), " bytes; cooked: ", cooked.size(), " bytes)");
+
+		// Wrong key or version has to be rejected:
+		{
+			FBXHelpers::FBXCookedData::SourceKey wrongKey = sourceKey;
+			wrongKey.contentHash++;
+			EXPECT_EQ(FBXHelpers::FBXCookedData::Restore(MemoryBlock(cooked.data(), cooked.size(), nullptr), wrongKey, logger), nullptr);
+			wrongKey = sourceKey;
+			wrongKey.sourceSize++;
+			EXPECT_EQ(FBXHelpers::FBXCookedData::Restore(MemoryBlock(cooked.data(), cooked.size(), nullptr), wrongKey, logger), nullptr);
+		}
+		EXPECT_EQ(FBXHelpers::FBXCookedData::Restore(MemoryBlock(cooked.data(), cooked.size() - 1u, nullptr), sourceKey, logger), nullptr);
+
+		// Meshes:
+		ASSERT_EQ(restored->MeshCount(), data->MeshCount());
+		for (size_t i = 0u; i < data->MeshCount(); i++) {
+			const FBXMesh* a = data->GetMesh(i);
+			const FBXMesh* b = restored->GetMesh(i);
+			EXPECT_EQ(a->uid, b->uid);
+			PolyMesh::Reader readerA(a->mesh);
+			PolyMesh::Reader readerB(b->mesh);
+			EXPECT_EQ(readerA.Name(), readerB.Name());
+			ASSERT_EQ(readerA.VertCount(), readerB.VertCount());
+			for (uint32_t v = 0u; v < readerA.VertCount(); v++) {
+				EXPECT_EQ(readerA.Vert(v).position, readerB.Vert(v).position);
+				EXPECT_EQ(readerA.Vert(v).normal, readerB.Vert(v).normal);
+				EXPECT_EQ(readerA.Vert(v).uv, readerB.Vert(v).uv);
+			}
+			ASSERT_EQ(readerA.FaceCount(), readerB.FaceCount());
+			for (uint32_t f = 0u; f < readerA.FaceCount(); f++) {
+				ASSERT_EQ(readerA.Face(f).Size(), readerB.Face(f).Size());
+				for (size_t j = 0u; j < readerA.Face(f).Size(); j++)
+					EXPECT_EQ(readerA.Face(f)[j], readerB.Face(f)[j]);
+			}
+			const FBXSkinnedMesh* skinnedA = dynamic_cast<const FBXSkinnedMesh*>(a);
+			const FBXSkinnedMesh* skinnedB = dynamic_cast<const FBXSkinnedMesh*>(b);
+			ASSERT_EQ(skinnedA == nullptr, skinnedB == nullptr);
+			if (skinnedA == nullptr)
+				continue;
+			EXPECT_EQ(skinnedA->rootBoneId, skinnedB->rootBoneId);
+			EXPECT_EQ(skinnedA->boneIds, skinnedB->boneIds);
+			SkinnedPolyMesh::Reader skinA(skinnedA->SkinnedMesh());
+			SkinnedPolyMesh::Reader skinB(skinnedB->SkinnedMesh());
+			ASSERT_EQ(skinA.BoneCount(), skinB.BoneCount());
+			for (uint32_t bone = 0u; bone < skinA.BoneCount(); bone++)
+				EXPECT_EQ(skinA.BoneData(bone), skinB.BoneData(bone));
+			for (uint32_t v = 0u; v < skinA.VertCount(); v++) {
+				ASSERT_EQ(skinA.WeightCount(v), skinB.WeightCount(v));
+				for (uint32_t w = 0u; w < skinA.WeightCount(v); w++) {
+					EXPECT_EQ(skinA.Weight(v, w).boneIndex, skinB.Weight(v, w).boneIndex);
+					EXPECT_EQ(skinA.Weight(v, w).boneWeight, skinB.Weight(v, w).boneWeight);
+				}
+			}
+		}
+
+		// Hierarchy:
+		{
+			std::vector<std::pair<const FBXNode*, const FBXNode*>> nodes = { std::make_pair(data->RootNode(), restored->RootNode()) };
+			for (size_t i = 0u; i < nodes.size(); i++) {
+				const FBXNode* a = nodes[i].first;
+				const FBXNode* b = nodes[i].second;
+				EXPECT_EQ(a->uid, b->uid);
+				EXPECT_EQ(a->name, b->name);
+				EXPECT_EQ(a->position, b->position);
+				EXPECT_EQ(a->rotation, b->rotation);
+				EXPECT_EQ(a->scale, b->scale);
+				ASSERT_EQ(a->meshes.Size(), b->meshes.Size());
+				for (size_t j = 0u; j < a->meshes.Size(); j++)
+					EXPECT_EQ(a->meshes[j]->uid, b->meshes[j]->uid);
+				ASSERT_EQ(a->children.size(), b->children.size());
+				for (size_t j = 0u; j < a->children.size(); j++)
+					nodes.push_back(std::make_pair(a->children[j].operator->(), b->children[j].operator->()));
+			}
+		}
+
+		// Animations:
+		ASSERT_EQ(restored->AnimationCount(), data->AnimationCount());
+		for (size_t i = 0u; i < data->AnimationCount(); i++) {
+			const AnimationClip* a = data->GetAnimation(i)->clip;
+			const AnimationClip* b = restored->GetAnimation(i)->clip;
+			EXPECT_EQ(data->GetAnimation(i)->uid, restored->GetAnimation(i)->uid);
+			EXPECT_EQ(a->Name(), b->Name());
+			EXPECT_EQ(a->Duration(), b->Duration());
+			ASSERT_EQ(a->TrackCount(), b->TrackCount());
+			for (size_t t = 0u; t < a->TrackCount(); t++) {
+				const AnimationClip::Track* trackA = a->GetTrack(t);
+				const AnimationClip::Track* trackB = b->GetTrack(t);
+				EXPECT_EQ(trackA->TargetField(), trackB->TargetField());
+				ASSERT_EQ(trackA->BindingCount(), trackB->BindingCount());
+				for (size_t j = 0u; j < trackA->BindingCount(); j++) {
+					EXPECT_EQ(trackA->BindingName(j), trackB->BindingName(j));
+					EXPECT_EQ(trackA->BindingType(j), trackB->BindingType(j));
+				}
+				const ParametricCurve<Vector3, float>* curveA = dynamic_cast<const ParametricCurve<Vector3, float>*>(trackA);
+				const ParametricCurve<Vector3, float>* curveB = dynamic_cast<const ParametricCurve<Vector3, float>*>(trackB);
+				ASSERT_NE(curveA, nullptr);
+				ASSERT_NE(curveB, nullptr);
+				for (float time = 0.0f; time <= a->Duration(); time += (a->Duration() / 64.0f + 0.001f))
+					EXPECT_EQ(curveA->Value(time), curveB->Value(time));
+			}
+		}
+
+		// File round-trip; second load should come from the cooked file and be considerably faster than the initial import:
+		{
+			const OS::Path cookedPath = std::filesystem::temp_directory_path() / "FBXTest_CookedData.jfbx";
+			std::error_code error;
+			std::filesystem::remove(cookedPath, error);
+			stopwatch.Reset();
+			const Reference<FBXData> first = FBXHelpers::FBXCookedData::Load(sourcePath, cookedPath, logger);
+			const float firstLoadTime = stopwatch.Reset();
+			EXPECT_NE(first, nullptr);
+			EXPECT_TRUE(std::filesystem::exists(cookedPath, error));
+			const Reference<FBXData> second = FBXHelpers::FBXCookedData::Load(sourcePath, cookedPath, logger);
+			const float secondLoadTime = stopwatch.Reset();
+			ASSERT_NE(second, nullptr);
+			EXPECT_EQ(second->MeshCount(), data->MeshCount());
+			EXPECT_EQ(second->AnimationCount(), data->AnimationCount());
+			// Temporary files never stay behind:
+			for (const auto& entry : std::filesystem::directory_iterator(cookedPath.parent_path(), error))
+				EXPECT_FALSE(entry.path().extension() == ".tmp" &&
+					OS::Path(entry.path().filename()).operator std::string().rfind(OS::Path(cookedPath.filename()).operator std::string(), 0u) == 0u);
+			logger->Info(std::fixed, std::setprecision(3), "FBXTest::CookedData - Load (import & cook): ", (firstLoadTime * 1000.0f),
+				"ms; Load (cooked): ", (secondLoadTime * 1000.0f), "ms");
+			std::filesystem::remove(cookedPath, error);
+		}
+	}
+
+	// Measures FBXContent::Decode and FBXData::Extract throughput over all FBX files from the test assets
+	TEST(FBXTest, DecodePerformance) {
+		Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		std::vector<OS::Path> sourcePaths;
+		for (const auto& entry : std::filesystem::recursive_directory_iterator(std::filesystem::path("Assets/Meshes/FBX/")))
+			if (entry.is_regular_file() && entry.path().extension() == ".fbx")
+				sourcePaths.push_back(entry.path());
+		ASSERT_FALSE(sourcePaths.empty());
+
+		static const constexpr size_t ITERATIONS = 8u;
+		auto megabytesPerSecond = [](size_t bytes, float seconds) { return (static_cast<double>(bytes) / 1000000.0) / std::max(static_cast<double>(seconds), 0.000001); };
+		size_t totalBytes = 0u;
+		float totalDecodeTime = 0.0f;
+		float totalExtractTime = 0.0f;
+		for (size_t i = 0; i < sourcePaths.size(); i++) {
+			Reference<OS::MMappedFile> fileMapping = OS::MMappedFile::Create(sourcePaths[i], logger);
+			ASSERT_NE(fileMapping, nullptr);
+			const MemoryBlock block = *fileMapping;
+
+			Stopwatch stopwatch;
+			Reference<FBXContent> content;
+			for (size_t iteration = 0; iteration < ITERATIONS; iteration++) {
+				content = FBXContent::Decode(block, logger);
+				ASSERT_NE(content, nullptr);
+			}
+			const float decodeTime = stopwatch.Reset() / static_cast<float>(ITERATIONS);
+			for (size_t iteration = 0; iteration < ITERATIONS; iteration++)
+				EXPECT_NE(FBXData::Extract(content, logger), nullptr);
+			const float extractTime = stopwatch.Reset() / static_cast<float>(ITERATIONS);
+
+			totalBytes += block.Size();
+			totalDecodeTime += decodeTime;
+			totalExtractTime += extractTime;
+			logger->Info(std::fixed, std::setprecision(3), "FBXTest::DecodePerformance - ", sourcePaths[i], " (", block.Size(), " bytes): Decode: ",
+				(decodeTime * 1000.0f), "ms (", megabytesPerSecond(block.Size(), decodeTime), " MB/s); Extract: ", 
+				(extractTime * 1000.0f), "ms (", megabytesPerSecond(block.Size(), extractTime), " MB/s)");
+		}
+		logger->Info(std::fixed, std::setprecision(3), "FBXTest::DecodePerformance - Total (", sourcePaths.size(), " files; ", totalBytes, " bytes): Decode: ",
+			megabytesPerSecond(totalBytes, totalDecodeTime), " MB/s; Extract: ", megabytesPerSecond(totalBytes, totalExtractTime),
+			" MB/s; Decode & Extract: ", megabytesPerSecond(totalBytes, totalDecodeTime + totalExtractTime), " MB/s");
+	}
 }
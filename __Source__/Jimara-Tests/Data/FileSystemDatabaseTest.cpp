@@ -3,68 +3,226 @@
 #include "Data/Geometry/Mesh.h"
 #include "Core/TypeRegistration/TypeRegistration.h"
 #include "Data/AssetDatabase/FileSystemDatabase/FileSystemDatabase.h"
+#include <fstream>
+#include <thread>
+#include <map>
 
 
 namespace Jimara {
-	// Test basic FileSystemDatabase construction and queries (for static state)
-	TEST(FileSystemDatabaseTest, Basics) {
-		Reference<Jimara::Test::CountingLogger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
-
-		Reference<Graphics::GraphicsDevice> graphicsDevice = [&]() -> Reference<Graphics::GraphicsDevice> {
-			Reference<Application::AppInformation> appInformation =
-				Object::Instantiate<Application::AppInformation>("FileSystemDatabaseTest", Application::AppVersion(0, 0, 1));
-			Reference<Graphics::GraphicsInstance> graphicsInstance = Graphics::GraphicsInstance::Create(logger, appInformation);
-			if (graphicsInstance == nullptr)
-				return nullptr;
-			for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++)
-				if (graphicsInstance->GetPhysicalDevice(i)->Type() == Graphics::PhysicalDevice::DeviceType::DESCRETE) {
+	namespace {
+		// Creates the devices, required by the FileSystemDatabase (fields are left as nullptr on failure)
+		inline static FileSystemDatabase::CreateArgs FileSystemDatabaseTest_CreateArgs(OS::Logger* logger) {
+			Reference<Graphics::GraphicsDevice> graphicsDevice = [&]() -> Reference<Graphics::GraphicsDevice> {
+				Reference<Application::AppInformation> appInformation =
+					Object::Instantiate<Application::AppInformation>("FileSystemDatabaseTest", Application::AppVersion(0, 0, 1));
+				Reference<Graphics::GraphicsInstance> graphicsInstance = Graphics::GraphicsInstance::Create(logger, appInformation);
+				if (graphicsInstance == nullptr)
+					return nullptr;
+				for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++)
+					if (graphicsInstance->GetPhysicalDevice(i)->Type() == Graphics::PhysicalDevice::DeviceType::DESCRETE) {
+						Reference<Graphics::GraphicsDevice> device = graphicsInstance->GetPhysicalDevice(i)->CreateLogicalDevice();
+						if (device != nullptr) return device;
+					}
+				for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++)
+					if (graphicsInstance->GetPhysicalDevice(i)->Type() == Graphics::PhysicalDevice::DeviceType::INTEGRATED) {
+						Reference<Graphics::GraphicsDevice> device = graphicsInstance->GetPhysicalDevice(i)->CreateLogicalDevice();
+						if (device != nullptr) return device;
+					}
+				for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++) {
 					Reference<Graphics::GraphicsDevice> device = graphicsInstance->GetPhysicalDevice(i)->CreateLogicalDevice();
 					if (device != nullptr) return device;
 				}
-			for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++)
-				if (graphicsInstance->GetPhysicalDevice(i)->Type() == Graphics::PhysicalDevice::DeviceType::INTEGRATED) {
-					Reference<Graphics::GraphicsDevice> device = graphicsInstance->GetPhysicalDevice(i)->CreateLogicalDevice();
+				return nullptr;
+			}();
+
+			const Reference<ShaderLibrary> shaderLoader = FileSystemShaderLibrary::Create("Shaders/", logger);
+
+			Reference<Physics::PhysicsInstance> physicsInstance = Physics::PhysicsInstance::Create(logger);
+
+			Reference<Audio::AudioDevice> audioDevice = [&]() -> Reference<Audio::AudioDevice> {
+				Reference<Audio::AudioInstance> audioInstance = Audio::AudioInstance::Create(logger);
+				if (audioInstance == nullptr) return nullptr;
+				if (audioInstance->DefaultDevice() != nullptr) {
+					Reference<Audio::AudioDevice> device = audioInstance->DefaultDevice()->CreateLogicalDevice();
+					if (device != nullptr) return device;
+				}
+				for (size_t i = 0u; i < audioInstance->PhysicalDeviceCount(); i++) {
+					Reference<Audio::AudioDevice> device = audioInstance->PhysicalDevice(i)->CreateLogicalDevice();
 					if (device != nullptr) return device;
 				}
-			for (size_t i = 0u; i < graphicsInstance->PhysicalDeviceCount(); i++) {
-				Reference<Graphics::GraphicsDevice> device = graphicsInstance->GetPhysicalDevice(i)->CreateLogicalDevice();
-				if (device != nullptr) return device;
+				return nullptr;
+			}();
+
+			FileSystemDatabase::CreateArgs createArgs = {};
+			createArgs.logger = logger;
+			createArgs.graphicsDevice = graphicsDevice;
+			if (graphicsDevice != nullptr) {
+				createArgs.bindlessBuffers = graphicsDevice->CreateArrayBufferBindlessSet();
+				createArgs.bindlessSamplers = graphicsDevice->CreateTextureSamplerBindlessSet();
+			}
+			createArgs.shaderLibrary = shaderLoader;
+			createArgs.physicsInstance = physicsInstance;
+			createArgs.audioDevice = audioDevice;
+			return createArgs;
+		}
+
+		// Records Import() calls of the test importer per file name
+		struct FileSystemDatabaseTest_ImportState {
+			struct FileRecord {
+				size_t importCount = 0u;
+				std::string content;
+				std::string previousImportData;
+			};
+
+			mutable std::mutex lock;
+			std::map<std::string, FileRecord> files;
+			std::atomic<uint32_t> importerVersion = 0u;
+
+			inline FileRecord Get(const std::string& fileName)const {
+				std::unique_lock<std::mutex> guard(lock);
+				const auto it = files.find(fileName);
+				return (it == files.end()) ? FileRecord() : it->second;
+			}
+
+			inline void Reset() {
+				std::unique_lock<std::mutex> guard(lock);
+				files.clear();
+			}
+		};
+
+		class FileSystemDatabaseTest_Resource : public virtual Resource {};
+
+		class FileSystemDatabaseTest_Asset : public virtual Asset::Of<FileSystemDatabaseTest_Resource> {
+		public:
+			inline FileSystemDatabaseTest_Asset(const GUID& guid) : Asset(guid) {}
+
+		protected:
+			inline virtual Reference<FileSystemDatabaseTest_Resource> LoadItem() final override { return Object::Instantiate<FileSystemDatabaseTest_Resource>(); }
+			inline virtual void UnloadItem(FileSystemDatabaseTest_Resource*) final override {}
+		};
+
+		// Stores file content as PreviousImportData and records what it received from the previous import
+		class FileSystemDatabaseTest_Importer : public virtual FileSystemDatabase::AssetImporter {
+		public:
+			GUID guid = GUID::Generate();
+			FileSystemDatabaseTest_ImportState* const state;
+			Reference<FileSystemDatabaseTest_Asset> asset;
+
+			inline FileSystemDatabaseTest_Importer(FileSystemDatabaseTest_ImportState* importState) : state(importState) {}
+
+			inline virtual bool Import(Callback<const AssetInfo&> reportAsset) final override {
+				const OS::Path path = AssetFilePath();
+				std::string content;
+				{
+					std::ifstream stream((const std::filesystem::path&)path, std::ios::binary);
+					if (!stream.is_open()) return false;
+					content = std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+				}
+				{
+					std::unique_lock<std::mutex> guard(state->lock);
+					const std::string fileName = OS::Path(path.filename());
+					FileSystemDatabaseTest_ImportState::FileRecord& record = state->files[fileName];
+					record.importCount++;
+					record.content = content;
+					record.previousImportData = PreviousImportData();
+				}
+				PreviousImportData() = "Imported: " + content;
+				if (asset == nullptr || asset->Guid() != guid)
+					asset = Object::Instantiate<FileSystemDatabaseTest_Asset>(guid);
+				AssetInfo info;
+				info.asset = asset;
+				info.resourceName = OS::Path(path.stem());
+				reportAsset(info);
+				return true;
+			}
+		};
+
+		class FileSystemDatabaseTest_ImporterSerializer : public virtual FileSystemDatabase::AssetImporter::Serializer {
+		public:
+			FileSystemDatabaseTest_ImportState* const state;
+
+			inline FileSystemDatabaseTest_ImporterSerializer(FileSystemDatabaseTest_ImportState* importState)
+				: Serialization::ItemSerializer("FileSystemDatabaseTest_ImporterSerializer", "Test importer serializer"), state(importState) {}
+
+			inline virtual Reference<FileSystemDatabase::AssetImporter> CreateReader() final override {
+				return Object::Instantiate<FileSystemDatabaseTest_Importer>(state);
+			}
+
+			inline virtual void GetFields(const Callback<Serialization::SerializedObject>& recordElement, FileSystemDatabase::AssetImporter* target)const final override {
+				FileSystemDatabaseTest_Importer* importer = dynamic_cast<FileSystemDatabaseTest_Importer*>(target);
+				if (importer == nullptr) return;
+				static const Reference<const GUID::Serializer> serializer = Object::Instantiate<GUID::Serializer>("GUID", "GUID of the test asset");
+				recordElement(serializer->Serialize(importer->guid));
+			}
+
+			inline virtual uint32_t ImporterVersion()const final override { return state->importerVersion; }
+
+			inline static const OS::Path& Extension() {
+				static const OS::Path extension = ".fsdbtest";
+				return extension;
+			}
+		};
+
+		// Keeps the test importer registered, while in scope
+		struct FileSystemDatabaseTest_ImporterRegistration {
+			const Reference<FileSystemDatabaseTest_ImporterSerializer> serializer;
+
+			inline FileSystemDatabaseTest_ImporterRegistration(FileSystemDatabaseTest_ImportState* state)
+				: serializer(Object::Instantiate<FileSystemDatabaseTest_ImporterSerializer>(state)) {
+				serializer->Register(FileSystemDatabaseTest_ImporterSerializer::Extension());
 			}
-			return nullptr;
-		}();
-		ASSERT_NE(graphicsDevice, nullptr);
-
-		const Reference<ShaderLibrary> shaderLoader = FileSystemShaderLibrary::Create("Shaders/", logger);
-		ASSERT_NE(shaderLoader, nullptr);
-
-		Reference<Physics::PhysicsInstance> physicsInstance = Physics::PhysicsInstance::Create(logger);
-		ASSERT_NE(physicsInstance, nullptr);
-
-		Reference<Audio::AudioDevice> audioDevice = [&]() -> Reference<Audio::AudioDevice> {
-			Reference<Audio::AudioInstance> audioInstance = Audio::AudioInstance::Create(logger);
-			if (audioInstance == nullptr) return nullptr;
-			if (audioInstance->DefaultDevice() != nullptr) {
-				Reference<Audio::AudioDevice> device = audioInstance->DefaultDevice()->CreateLogicalDevice();
-				if (device != nullptr) return device;
+
+			inline ~FileSystemDatabaseTest_ImporterRegistration() {
+				serializer->Unregister(FileSystemDatabaseTest_ImporterSerializer::Extension());
 			}
-			for (size_t i = 0u; i < audioInstance->PhysicalDeviceCount(); i++) {
-				Reference<Audio::AudioDevice> device = audioInstance->PhysicalDevice(i)->CreateLogicalDevice();
-				if (device != nullptr) return device;
+		};
+
+		// Creates an empty asset directory within the temp directory
+		inline static OS::Path FileSystemDatabaseTest_CreateDirectory(const std::string_view& name) {
+			const std::filesystem::path path = std::filesystem::temp_directory_path() / std::string(name);
+			std::error_code error;
+			std::filesystem::remove_all(path, error);
+			std::filesystem::create_directories(path, error);
+			return path;
+		}
+
+		inline static void FileSystemDatabaseTest_WriteFile(const OS::Path& path, const std::string_view& content) {
+			std::ofstream stream((const std::filesystem::path&)path, std::ios::binary);
+			stream.write(content.data(), content.size());
+		}
+
+		// Moves the last modified date forward without changing the content
+		inline static void FileSystemDatabaseTest_TouchFile(const OS::Path& path) {
+			const std::filesystem::file_time_type writeTime = std::filesystem::last_write_time(path);
+			std::filesystem::last_write_time(path, writeTime + std::chrono::seconds(2));
+		}
+
+		// Waits for the directory observer and the import threads to catch up (returns false on timeout)
+		template<typename ConditionType>
+		inline static bool FileSystemDatabaseTest_WaitFor(const ConditionType& condition) {
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+			while (!condition()) {
+				if (std::chrono::steady_clock::now() > deadline) return false;
+				std::this_thread::sleep_for(std::chrono::milliseconds(10));
 			}
-			return nullptr;
-		}();
-		ASSERT_NE(audioDevice, nullptr);
+			return true;
+		}
+	}
+
+	// Test basic FileSystemDatabase construction and queries (for static state)
+	TEST(FileSystemDatabaseTest, Basics) {
+		Reference<Jimara::Test::CountingLogger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+
+		const FileSystemDatabase::CreateArgs baseArgs = FileSystemDatabaseTest_CreateArgs(logger);
+		ASSERT_NE(baseArgs.graphicsDevice, nullptr);
+		ASSERT_NE(baseArgs.shaderLibrary, nullptr);
+		ASSERT_NE(baseArgs.physicsInstance, nullptr);
+		ASSERT_NE(baseArgs.audioDevice, nullptr);
 
 		Reference<BuiltInTypeRegistrator> typeRegistrator = BuiltInTypeRegistrator::Instance();
 		Reference<FileSystemDatabase> database;
 		{
-			FileSystemDatabase::CreateArgs createArgs = {};
-			createArgs.graphicsDevice = graphicsDevice;
-			createArgs.bindlessBuffers = graphicsDevice->CreateArrayBufferBindlessSet();
-			createArgs.bindlessSamplers = graphicsDevice->CreateTextureSamplerBindlessSet();
-			createArgs.shaderLibrary = shaderLoader;
-			createArgs.physicsInstance = physicsInstance;
-			createArgs.audioDevice = audioDevice;
+			FileSystemDatabase::CreateArgs createArgs = baseArgs;
 			createArgs.assetDirectory = OS::Path("Assets");
 			database = FileSystemDatabase::Create(createArgs);
 		}
@@ -270,4 +428,131 @@ namespace Jimara {
 			EXPECT_EQ(assetCountCallback, 2u);
 		}
 	}
+
+	// Touching a file does not invoke the importer again; changing the content without changing the size does
+	TEST(FileSystemDatabaseTest, Reimport) {
+		Reference<Jimara::Test::CountingLogger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+		FileSystemDatabase::CreateArgs createArgs = FileSystemDatabaseTest_CreateArgs(logger);
+		ASSERT_NE(createArgs.graphicsDevice, nullptr);
+		ASSERT_NE(createArgs.shaderLibrary, nullptr);
+		ASSERT_NE(createArgs.physicsInstance, nullptr);
+		ASSERT_NE(createArgs.audioDevice, nullptr);
+
+		FileSystemDatabaseTest_ImportState state;
+		FileSystemDatabaseTest_ImporterRegistration registration(&state);
+		const OS::Path directory = FileSystemDatabaseTest_CreateDirectory("FileSystemDatabaseTest_Reimport");
+		const OS::Path filePath = std::filesystem::path(directory) / "File.fsdbtest";
+		const OS::Path sentinelPath = std::filesystem::path(directory) / "Sentinel.fsdbtest";
+		FileSystemDatabaseTest_WriteFile(filePath, "0123456789");
+		FileSystemDatabaseTest_WriteFile(sentinelPath, "Sentinel 0");
+
+		// Single import thread processes the files in the order of the change notifications, so the sentinel tells when the touch has been handled:
+		createArgs.assetDirectory = directory;
+		createArgs.importThreadCount = 1u;
+		Reference<FileSystemDatabase> database = FileSystemDatabase::Create(createArgs);
+		ASSERT_NE(database, nullptr);
+		EXPECT_EQ(state.Get("File.fsdbtest").importCount, 1u);
+		EXPECT_EQ(state.Get("Sentinel.fsdbtest").importCount, 1u);
+
+		FileSystemDatabaseTest_TouchFile(filePath);
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		FileSystemDatabaseTest_WriteFile(sentinelPath, "Sentinel 1");
+		ASSERT_TRUE(FileSystemDatabaseTest_WaitFor([&]() { return state.Get("Sentinel.fsdbtest").content == "Sentinel 1"; }));
+		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		EXPECT_EQ(state.Get("File.fsdbtest").importCount, 1u);
+
+		// Same size, different content:
+		FileSystemDatabaseTest_WriteFile(filePath, "9876543210");
+		ASSERT_TRUE(FileSystemDatabaseTest_WaitFor([&]() { return state.Get("File.fsdbtest").content == "9876543210"; }));
+		EXPECT_GT(state.Get("File.fsdbtest").importCount, 1u);
+		EXPECT_NE(state.Get("File.fsdbtest").previousImportData, "Imported: 0123456789");
+
+		database = nullptr;
+		std::error_code error;
+		std::filesystem::remove_all(directory, error);
+	}
+
+	// Import index keeps PreviousImportData across restarts, as long as the content stays the same (last modified date does not matter)
+	TEST(FileSystemDatabaseTest, ImportIndexRestart) {
+		Reference<Jimara::Test::CountingLogger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+		FileSystemDatabase::CreateArgs createArgs = FileSystemDatabaseTest_CreateArgs(logger);
+		ASSERT_NE(createArgs.graphicsDevice, nullptr);
+		ASSERT_NE(createArgs.shaderLibrary, nullptr);
+		ASSERT_NE(createArgs.physicsInstance, nullptr);
+		ASSERT_NE(createArgs.audioDevice, nullptr);
+
+		FileSystemDatabaseTest_ImportState state;
+		FileSystemDatabaseTest_ImporterRegistration registration(&state);
+		const OS::Path directory = FileSystemDatabaseTest_CreateDirectory("FileSystemDatabaseTest_ImportIndexRestart");
+		const OS::Path indexPath = std::filesystem::temp_directory_path() / "FileSystemDatabaseTest_ImportIndexRestart.bin";
+		const OS::Path filePath = std::filesystem::path(directory) / "File.fsdbtest";
+		std::error_code error;
+		std::filesystem::remove(indexPath, error);
+		FileSystemDatabaseTest_WriteFile(filePath, "Content");
+		createArgs.assetDirectory = directory;
+		createArgs.previousImportDataCache = indexPath;
+
+		auto restart = [&]() {
+			state.Reset();
+			const Reference<FileSystemDatabase> database = FileSystemDatabase::Create(createArgs);
+			EXPECT_NE(database, nullptr);
+			// Every file goes through the importer on startup:
+			EXPECT_EQ(state.Get("File.fsdbtest").importCount, 1u);
+		};
+
+		restart();
+		EXPECT_EQ(state.Get("File.fsdbtest").previousImportData, "");
+		EXPECT_TRUE(std::filesystem::exists(indexPath));
+
+		FileSystemDatabaseTest_TouchFile(filePath);
+		restart();
+		EXPECT_EQ(state.Get("File.fsdbtest").previousImportData, "Imported: Content");
+
+		FileSystemDatabaseTest_WriteFile(filePath, "CONTENT");
+		restart();
+		EXPECT_EQ(state.Get("File.fsdbtest").previousImportData, "");
+		restart();
+		EXPECT_EQ(state.Get("File.fsdbtest").previousImportData, "Imported: CONTENT");
+
+		std::filesystem::remove_all(directory, error);
+		std::filesystem::remove(indexPath, error);
+	}
+
+	// Changing AssetImporter::Serializer::ImporterVersion() discards PreviousImportData
+	TEST(FileSystemDatabaseTest, ImporterVersion) {
+		Reference<Jimara::Test::CountingLogger> logger = Object::Instantiate<Jimara::Test::CountingLogger>();
+		FileSystemDatabase::CreateArgs createArgs = FileSystemDatabaseTest_CreateArgs(logger);
+		ASSERT_NE(createArgs.graphicsDevice, nullptr);
+		ASSERT_NE(createArgs.shaderLibrary, nullptr);
+		ASSERT_NE(createArgs.physicsInstance, nullptr);
+		ASSERT_NE(createArgs.audioDevice, nullptr);
+
+		FileSystemDatabaseTest_ImportState state;
+		FileSystemDatabaseTest_ImporterRegistration registration(&state);
+		const OS::Path directory = FileSystemDatabaseTest_CreateDirectory("FileSystemDatabaseTest_ImporterVersion");
+		const OS::Path indexPath = std::filesystem::temp_directory_path() / "FileSystemDatabaseTest_ImporterVersion.bin";
+		std::error_code error;
+		std::filesystem::remove(indexPath, error);
+		FileSystemDatabaseTest_WriteFile(std::filesystem::path(directory) / "File.fsdbtest", "Content");
+		createArgs.assetDirectory = directory;
+		createArgs.previousImportDataCache = indexPath;
+
+		auto restart = [&](uint32_t importerVersion) {
+			state.Reset();
+			state.importerVersion = importerVersion;
+			const Reference<FileSystemDatabase> database = FileSystemDatabase::Create(createArgs);
+			EXPECT_NE(database, nullptr);
+			EXPECT_EQ(state.Get("File.fsdbtest").importCount, 1u);
+			return state.Get("File.fsdbtest").previousImportData;
+		};
+
+		EXPECT_EQ(restart(0u), "");
+		EXPECT_EQ(restart(0u), "Imported: Content");
+		EXPECT_EQ(restart(1u), "");
+		EXPECT_EQ(restart(1u), "Imported: Content");
+		EXPECT_EQ(restart(0u), "");
+
+		std::filesystem::remove_all(directory, error);
+		std::filesystem::remove(indexPath, error);
+	}
 }
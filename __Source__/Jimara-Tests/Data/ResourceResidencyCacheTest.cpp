@@ -0,0 +1,205 @@
+#include "../GtestHeaders.h"
+#include "Data/AssetDatabase/AssetSet.h"
+#include "Data/AssetDatabase/ResourceResidencyCache.h"
+
+
+namespace Jimara {
+	namespace {
+		class ResourceResidencyCacheTest_Resource : public virtual Resource {
+		public:
+			const size_t size;
+
+			inline ResourceResidencyCacheTest_Resource(size_t sz) : size(sz) {}
+		};
+
+		class ResourceResidencyCacheTest_Asset : public virtual Asset::Of<ResourceResidencyCacheTest_Resource> {
+		public:
+			const size_t size;
+			std::atomic<size_t> loadCount = 0u;
+			std::atomic<size_t> unloadCount = 0u;
+
+			inline ResourceResidencyCacheTest_Asset(size_t sz) : Asset(GUID::Generate()), size(sz) {}
+
+		protected:
+			inline virtual Reference<ResourceResidencyCacheTest_Resource> LoadItem() final override {
+				loadCount++;
+				return Object::Instantiate<ResourceResidencyCacheTest_Resource>(size);
+			}
+
+			inline virtual void UnloadItem(ResourceResidencyCacheTest_Resource*) final override {
+				unloadCount++;
+			}
+		};
+
+		inline static Reference<ResourceResidencyCache> CreateCache(size_t budget) {
+			const Reference<ResourceResidencyCache> cache = Object::Instantiate<ResourceResidencyCache>(budget);
+			static size_t(*estimateSize)(const Resource*) = [](const Resource* resource) -> size_t {
+				return dynamic_cast<const ResourceResidencyCacheTest_Resource*>(resource)->size;
+			};
+			cache->SetSizeEstimate(TypeId::Of<ResourceResidencyCacheTest_Resource>(), ResourceResidencyCache::SizeEstimateFn(estimateSize));
+			return cache;
+		}
+	}
+
+	// Without the cache, resources get unloaded as soon as they are released
+	TEST(ResourceResidencyCacheTest, NoCache) {
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		const Reference<ResourceResidencyCacheTest_Asset> asset = Object::Instantiate<ResourceResidencyCacheTest_Asset>(16u);
+		database->InsertAsset(asset);
+		EXPECT_EQ(database->ResidencyCache(), nullptr);
+
+		for (size_t i = 1u; i <= 4u; i++) {
+			EXPECT_NE(database->FindAsset(asset->Guid())->LoadResource(), nullptr);
+			EXPECT_EQ(asset->GetLoadedResource(), nullptr);
+			EXPECT_EQ(asset->loadCount, i);
+			EXPECT_EQ(asset->unloadCount, i);
+		}
+	}
+
+	// Released resources stay loaded and get reused
+	TEST(ResourceResidencyCacheTest, Retention) {
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		const Reference<ResourceResidencyCache> cache = CreateCache(1024u);
+		database->SetResidencyCache(cache);
+		EXPECT_EQ(database->ResidencyCache(), cache);
+
+		const Reference<ResourceResidencyCacheTest_Asset> asset = Object::Instantiate<ResourceResidencyCacheTest_Asset>(16u);
+		database->InsertAsset(asset);
+
+		Resource* address = nullptr;
+		{
+			const Reference<Resource> resource = database->FindAsset(asset->Guid())->LoadResource();
+			ASSERT_NE(resource, nullptr);
+			address = resource;
+			EXPECT_EQ(cache->Stats().residentCount, 0u);
+		}
+		EXPECT_EQ(asset->GetLoadedResource(), address);
+		EXPECT_EQ(asset->unloadCount, 0u);
+		{
+			const ResourceResidencyCache::Statistics stats = cache->Stats();
+			EXPECT_EQ(stats.hits, 0u);
+			EXPECT_EQ(stats.misses, 1u);
+			EXPECT_EQ(stats.residentCount, 1u);
+			EXPECT_EQ(stats.residentBytes, 16u);
+		}
+
+		for (size_t i = 1u; i <= 4u; i++) {
+			const Reference<Resource> resource = asset->LoadResource();
+			EXPECT_EQ(resource, address);
+			EXPECT_EQ(asset->loadCount, 1u);
+			const ResourceResidencyCache::Statistics stats = cache->Stats();
+			EXPECT_EQ(stats.hits, i);
+			EXPECT_EQ(stats.misses, 1u);
+			EXPECT_EQ(stats.residentCount, 0u);
+			EXPECT_EQ(stats.residentBytes, 0u);
+		}
+		EXPECT_EQ(cache->Stats().residentCount, 1u);
+
+		cache->Clear();
+		EXPECT_EQ(asset->GetLoadedResource(), nullptr);
+		EXPECT_EQ(asset->unloadCount, 1u);
+		EXPECT_EQ(cache->Stats().evictions, 1u);
+		EXPECT_EQ(cache->Stats().residentCount, 0u);
+	}
+
+	// Least recently released resources get evicted first, unless their priority is higher
+	TEST(ResourceResidencyCacheTest, Eviction) {
+		const Reference<ResourceResidencyCache> cache = CreateCache(300u);
+		std::vector<Reference<ResourceResidencyCacheTest_Asset>> assets;
+		for (size_t i = 0u; i < 5u; i++) {
+			assets.push_back(Object::Instantiate<ResourceResidencyCacheTest_Asset>(100u));
+			cache->Attach(assets.back());
+		}
+		cache->SetPriority(assets[0], 1);
+
+		for (size_t i = 0u; i < 4u; i++)
+			EXPECT_TRUE(cache->Prefetch(assets[i], (i == 0u) ? 1 : 0));
+		{
+			const ResourceResidencyCache::Statistics stats = cache->Stats();
+			EXPECT_EQ(stats.residentCount, 3u);
+			EXPECT_EQ(stats.residentBytes, 300u);
+			EXPECT_EQ(stats.evictions, 1u);
+		}
+		EXPECT_NE(assets[0]->GetLoadedResource(), nullptr);
+		EXPECT_EQ(assets[1]->GetLoadedResource(), nullptr);
+		EXPECT_NE(assets[2]->GetLoadedResource(), nullptr);
+		EXPECT_NE(assets[3]->GetLoadedResource(), nullptr);
+
+		// Resources in use do not count towards the budget:
+		{
+			const Reference<Resource> resource = assets[4]->LoadResource();
+			EXPECT_EQ(cache->Stats().residentCount, 3u);
+			EXPECT_EQ(cache->Stats().evictions, 1u);
+		}
+		EXPECT_EQ(cache->Stats().evictions, 2u);
+		EXPECT_EQ(assets[2]->GetLoadedResource(), nullptr);
+		EXPECT_NE(assets[4]->GetLoadedResource(), nullptr);
+
+		// Shrinking the budget evicts low-priority resources first:
+		cache->SetMemoryBudget(100u);
+		EXPECT_EQ(cache->Stats().residentCount, 1u);
+		EXPECT_NE(assets[0]->GetLoadedResource(), nullptr);
+		EXPECT_EQ(assets[3]->GetLoadedResource(), nullptr);
+		EXPECT_EQ(assets[4]->GetLoadedResource(), nullptr);
+
+		// Resources larger than the budget are never retained:
+		cache->SetMemoryBudget(50u);
+		EXPECT_EQ(assets[0]->GetLoadedResource(), nullptr);
+		EXPECT_TRUE(cache->Prefetch(assets[1]));
+		EXPECT_EQ(assets[1]->GetLoadedResource(), nullptr);
+		EXPECT_EQ(cache->Stats().residentCount, 0u);
+
+		for (size_t i = 0u; i < assets.size(); i++)
+			EXPECT_EQ(assets[i]->loadCount, assets[i]->unloadCount);
+	}
+
+	// Pinned resources stay loaded regardless of the budget
+	TEST(ResourceResidencyCacheTest, Pinning) {
+		const Reference<ResourceResidencyCache> cache = CreateCache(0u);
+		const Reference<ResourceResidencyCacheTest_Asset> asset = Object::Instantiate<ResourceResidencyCacheTest_Asset>(64u);
+
+		Reference<Resource> pinned = cache->Pin(asset);
+		ASSERT_NE(pinned, nullptr);
+		EXPECT_EQ(cache->Pin(asset), pinned);
+		{
+			const ResourceResidencyCache::Statistics stats = cache->Stats();
+			EXPECT_EQ(stats.pinnedCount, 1u);
+			EXPECT_EQ(stats.pinnedBytes, 64u);
+			EXPECT_EQ(stats.residentCount, 0u);
+		}
+		Resource* address = pinned;
+		pinned = nullptr;
+		EXPECT_EQ(asset->GetLoadedResource(), address);
+
+		cache->Unpin(asset);
+		EXPECT_EQ(asset->GetLoadedResource(), address);
+		EXPECT_EQ(cache->Stats().pinnedCount, 1u);
+
+		cache->Unpin(asset);
+		EXPECT_EQ(asset->GetLoadedResource(), nullptr);
+		EXPECT_EQ(cache->Stats().pinnedCount, 0u);
+		EXPECT_EQ(cache->Stats().pinnedBytes, 0u);
+		EXPECT_EQ(asset->loadCount, 1u);
+		EXPECT_EQ(asset->unloadCount, 1u);
+	}
+
+	// Destroying the cache releases everything and detaches the assets
+	TEST(ResourceResidencyCacheTest, Destruction) {
+		Reference<ResourceResidencyCache> cache = CreateCache(1024u);
+		const Reference<ResourceResidencyCacheTest_Asset> retainedAsset = Object::Instantiate<ResourceResidencyCacheTest_Asset>(16u);
+		const Reference<ResourceResidencyCacheTest_Asset> pinnedAsset = Object::Instantiate<ResourceResidencyCacheTest_Asset>(16u);
+		EXPECT_TRUE(cache->Prefetch(retainedAsset));
+		EXPECT_NE(cache->Pin(pinnedAsset), nullptr);
+		EXPECT_NE(retainedAsset->GetLoadedResource(), nullptr);
+		EXPECT_NE(pinnedAsset->GetLoadedResource(), nullptr);
+
+		cache = nullptr;
+		EXPECT_EQ(retainedAsset->GetLoadedResource(), nullptr);
+		EXPECT_EQ(pinnedAsset->GetLoadedResource(), nullptr);
+
+		EXPECT_NE(retainedAsset->LoadResource(), nullptr);
+		EXPECT_EQ(retainedAsset->GetLoadedResource(), nullptr);
+		EXPECT_EQ(retainedAsset->loadCount, 2u);
+		EXPECT_EQ(retainedAsset->unloadCount, 2u);
+	}
+}
@@ -0,0 +1,351 @@
+#include "../GtestHeaders.h"
+#include "../Memory.h"
+#include "../CountingLogger.h"
+#include "Data/Serialization/Helpers/SerializeToBinary.h"
+#include "Data/Serialization/Helpers/SerializeToJson.h"
+#include <random>
+#include <cstring>
+
+
+namespace Jimara {
+	namespace Serialization {
+		namespace {
+			struct BinarySimpleStruct {
+				int integer = 0;
+				char symbol = '\0';
+				std::string text = "";
+				Vector3 vector0 = Vector3(0.0f);
+				Vector3 vector1 = Vector3(0.0f);
+				Matrix3 matrix0 = Matrix3(0.0f);
+				Matrix4 matrix1 = Matrix4(0.0f);
+				GUID guid = {};
+
+				inline bool operator==(const BinarySimpleStruct& other)const {
+					return
+						(integer == other.integer) &&
+						(symbol == other.symbol) &&
+						(text == other.text) &&
+						(vector0 == other.vector0) &&
+						(vector1 == other.vector1) &&
+						(matrix0 == other.matrix0) &&
+						(matrix1 == other.matrix1) &&
+						(guid == other.guid);
+				}
+
+				class Serializer : public virtual SerializerList::From<BinarySimpleStruct> {
+				public:
+					inline Serializer(const std::string_view& name = "BinarySimpleStruct::Serializer", const std::string_view& hint = "")
+						: ItemSerializer(name, hint) {}
+
+					inline virtual void GetFields(const Callback<SerializedObject>& report, BinarySimpleStruct* target)const final override {
+						const Reference<const ItemSerializer::Of<int>> integerSerializer = IntSerializer::Create("integer");
+						report(integerSerializer->Serialize(target->integer));
+
+						static const Reference<const ItemSerializer::Of<char>> symbolSerializer = CharSerializer::Create("symbol");
+						report(symbolSerializer->Serialize(target->symbol));
+
+						static const Reference<const ItemSerializer::Of<BinarySimpleStruct>> textSerializer = StringViewSerializer::For<BinarySimpleStruct>(
+							"text", "Text hint",
+							[](BinarySimpleStruct* tg) -> std::string_view { return tg->text; },
+							[](const std::string_view& text, BinarySimpleStruct* tg) { tg->text = text; });
+						report(textSerializer->Serialize(target));
+
+						static const Reference<const ItemSerializer::Of<Vector3>> vectorSerializer = Vector3Serializer::Create("vector");
+						report(vectorSerializer->Serialize(target->vector0));
+						report(vectorSerializer->Serialize(target->vector1));
+
+						static const Reference<const ItemSerializer::Of<Matrix3>> matrix0Serializer = Matrix3Serializer::Create("matrix");
+						report(matrix0Serializer->Serialize(target->matrix0));
+
+						static const Reference<const ItemSerializer::Of<Matrix4>> matrix1Serializer = Matrix4Serializer::Create("matrix");
+						report(matrix1Serializer->Serialize(target->matrix1));
+
+						static const Reference<const GUID::Serializer> guidSerializer = Object::Instantiate<GUID::Serializer>("guid");
+						report(guidSerializer->Serialize(target->guid));
+					}
+
+					inline static Serializer* Instance() {
+						static Serializer instance;
+						return &instance;
+					}
+				};
+
+				inline static BinarySimpleStruct Create() {
+					BinarySimpleStruct result;
+					result.integer = 8;
+					result.symbol = 'w';
+					result.text = "Bla";
+					result.vector0 = Vector3(0.0f, 0.4f, 0.8f);
+					result.vector1 = Vector3(1.0f, 1.4f, 1.8f);
+					result.matrix0 = Matrix3(
+						Vector3(0.0f, 0.1f, 0.2f),
+						Vector3(1.0f, 1.1f, 1.2f),
+						Vector3(2.0f, 2.1f, 2.2f));
+					result.matrix1 = Matrix4(
+						Vector4(0.0f, 0.1f, 0.2f, 0.3f),
+						Vector4(1.0f, 1.1f, 1.2f, 1.3f),
+						Vector4(2.0f, 2.1f, 2.2f, 2.3f),
+						Vector4(3.0f, 3.1f, 3.2f, 3.3f));
+					result.guid = GUID::Generate();
+					return result;
+				}
+			};
+
+			inline static MemoryBlock BinaryBlock(const std::vector<uint8_t>& data) { return MemoryBlock(data.data(), data.size(), nullptr); }
+		}
+
+		TEST(SerializeToBinaryTest, BasicTypes) {
+			const Function<GUID, const SerializedObject&, bool&> ignoreObjectSerialization([](const SerializedObject&, bool&) { return GUID{}; });
+			const Function<bool, const SerializedObject&, const GUID&> ignoreObjectDeserialization([](const SerializedObject&, const GUID&) { return true; });
+			{
+				BinarySimpleStruct object;
+				bool error = false;
+				std::vector<uint8_t> data = SerializeToBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(object), nullptr, error, ignoreObjectSerialization);
+			}
+			Jimara::Test::Memory::MemorySnapshot snapshot;
+			{
+				Jimara::Test::CountingLogger logger;
+				auto testSingleValue = [&](auto value, const char* name) {
+					const Reference<const ItemSerializer::Of<decltype(value)>> serializer = ValueSerializer<decltype(value)>::Create(name);
+					bool error = false;
+					const std::vector<uint8_t> data = SerializeToBinary(serializer->Serialize(value), &logger, error, ignoreObjectSerialization);
+					if (error) return false;
+					else if (!IsSerializedBinary(BinaryBlock(data)))
+						logger.Error("Binary header missing!");
+
+					decltype(value) deserialized = {};
+					if (!DeserializeFromBinary(serializer->Serialize(deserialized), BinaryBlock(data), &logger, ignoreObjectDeserialization))
+						logger.Error("Failed to desererialize from binary!");
+					else if (value != deserialized)
+						logger.Error("Value mismatch!");
+					else return true;
+					return false;
+				};
+				EXPECT_TRUE(testSingleValue((bool)true, "Boolean"));
+				EXPECT_TRUE(testSingleValue((bool)false, "Boolean"));
+
+				EXPECT_TRUE(testSingleValue((char)'a', "Char"));
+				EXPECT_TRUE(testSingleValue((signed char)'b', "Signed Char"));
+				EXPECT_TRUE(testSingleValue((unsigned char)'c', "Unsigned Char"));
+#pragma warning(disable: 4066)
+				EXPECT_TRUE(testSingleValue((wchar_t)L'ჭ', "Wide Char"));
+#pragma warning(default: 4066)
+
+				EXPECT_TRUE(testSingleValue((short)-1223, "Short"));
+				EXPECT_TRUE(testSingleValue((unsigned short)3245, "Unsigned Short"));
+
+				EXPECT_TRUE(testSingleValue((int)-32334, "Int"));
+				EXPECT_TRUE(testSingleValue((unsigned int)973421, "Unsigned Int"));
+
+				EXPECT_TRUE(testSingleValue((long)-78564, "Long"));
+				EXPECT_TRUE(testSingleValue((unsigned long)9492, "Unsigned Long"));
+
+				EXPECT_TRUE(testSingleValue((long long)-8752213, "Long Long"));
+				EXPECT_TRUE(testSingleValue((unsigned long long)~0ull, "Unsigned Long Long"));
+
+				EXPECT_TRUE(testSingleValue((float)94343.342543f, "Float"));
+				EXPECT_TRUE(testSingleValue((double)-4535675632.99324236, "Double"));
+
+				EXPECT_TRUE(testSingleValue(Vector2(2.0f, 5.2f), "Vector2"));
+				EXPECT_TRUE(testSingleValue(Vector3(1.0f, -3.2f, 8.2), "Vector3"));
+				EXPECT_TRUE(testSingleValue(Vector4(-2.2f, 1.2f, 9.8, -89.12), "Vector4"));
+
+				EXPECT_TRUE(testSingleValue(Matrix2(
+					Vector2(0.0f, 0.1f),
+					Vector2(1.0f, 1.1f)), "Matrix2"));
+				EXPECT_TRUE(testSingleValue(Matrix3(
+					Vector3(0.0f, 0.1f, 0.2f),
+					Vector3(1.0f, 1.1f, 1.2f),
+					Vector3(2.0f, 2.1f, 2.2f)), "Matrix3"));
+				EXPECT_TRUE(testSingleValue(Matrix4(
+					Vector4(0.0f, 0.1f, 0.2f, 0.3f),
+					Vector4(1.0f, 1.1f, 1.2f, 1.3f),
+					Vector4(2.0f, 2.1f, 2.2f, 2.3f),
+					Vector4(3.0f, 3.1f, 3.2f, 3.3f)), "Matrix4"));
+
+				{
+					std::wstring text(L"ტექსტი");
+					bool error = false;
+					const Reference<const ItemSerializer::Of<std::wstring>> serializer = ValueSerializer<std::wstring_view>::For<std::wstring>(
+						"Text", "Hint",
+						[](std::wstring* text) -> std::wstring_view { return *text; },
+						[](const std::wstring_view& view, std::wstring* text) { *text = view; });
+					const std::vector<uint8_t> data = SerializeToBinary(serializer->Serialize(text), &logger, error, ignoreObjectSerialization);
+					EXPECT_FALSE(error);
+					std::wstring copy;
+					EXPECT_TRUE(DeserializeFromBinary(serializer->Serialize(copy), BinaryBlock(data), &logger, ignoreObjectDeserialization));
+					EXPECT_TRUE(text == copy);
+				}
+
+				{
+					BinarySimpleStruct object = BinarySimpleStruct::Create();
+					bool error = false;
+					const std::vector<uint8_t> data = SerializeToBinary(
+						BinarySimpleStruct::Serializer::Instance()->Serialize(object), &logger, error, ignoreObjectSerialization);
+					EXPECT_FALSE(error);
+					BinarySimpleStruct copy;
+					EXPECT_TRUE(DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(copy), BinaryBlock(data), &logger, ignoreObjectDeserialization));
+					EXPECT_TRUE(object == copy);
+
+					// Data does not have to be aligned:
+					std::vector<uint8_t> shifted(data.size() + 1u);
+					std::memcpy(shifted.data() + 1u, data.data(), data.size());
+					BinarySimpleStruct shiftedCopy;
+					EXPECT_TRUE(DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(shiftedCopy),
+						MemoryBlock(shifted.data() + 1u, data.size(), nullptr), &logger, ignoreObjectDeserialization));
+					EXPECT_TRUE(object == shiftedCopy);
+				}
+
+				EXPECT_TRUE(logger.Numfailures() == 0);
+			}
+			EXPECT_TRUE(snapshot.Compare());
+		}
+
+
+
+		namespace {
+			struct BinaryCompoundStruct {
+				BinarySimpleStruct simpleA;
+				BinarySimpleStruct simpleB;
+				int num = 0;
+				Reference<OS::Logger> logger = nullptr;
+
+				inline bool operator==(const BinaryCompoundStruct& other)const {
+					return
+						(simpleA == other.simpleA) &&
+						(simpleB == other.simpleB) &&
+						(num == other.num) &&
+						(logger == other.logger);
+				}
+
+				class Serializer : public virtual SerializerList::From<BinaryCompoundStruct> {
+				private:
+					inline Serializer() : ItemSerializer("BinaryCompoundStruct::Serializer") {}
+
+				public:
+					inline virtual void GetFields(const Callback<SerializedObject>& report, BinaryCompoundStruct* target)const final override {
+						static const Reference<const ItemSerializer::Of<BinarySimpleStruct>> simpleASerializer = Object::Instantiate<BinarySimpleStruct::Serializer>("simpleA");
+						report(simpleASerializer->Serialize(&target->simpleA));
+
+						static const Reference<const ItemSerializer::Of<BinarySimpleStruct>> simpleBSerializer = Object::Instantiate<BinarySimpleStruct::Serializer>("simpleB");
+						report(simpleBSerializer->Serialize(&target->simpleB));
+
+						static const Reference<const ItemSerializer::Of<int>> integerSerializer = IntSerializer::Create("num");
+						report(integerSerializer->Serialize(target->num));
+
+						static const Reference<const ItemSerializer::Of<Reference<OS::Logger>>> loggerReferenceSerializer = ValueSerializer<Reference<OS::Logger>>::Create("logger");
+						report(loggerReferenceSerializer->Serialize(&target->logger));
+					}
+
+					inline static Serializer* Instance() {
+						static Serializer instance;
+						return &instance;
+					}
+				};
+			};
+		}
+
+		TEST(SerializeToBinaryTest, CompundType) {
+			{
+				BinaryCompoundStruct object;
+				bool error = false;
+				std::vector<uint8_t> data = SerializeToBinary(BinaryCompoundStruct::Serializer::Instance()->Serialize(object), nullptr, error,
+					[](const SerializedObject&, bool&) { return GUID{}; });
+			}
+			Jimara::Test::Memory::MemorySnapshot snapshot;
+			{
+				Jimara::Test::CountingLogger logger;
+				const GUID loggerId = GUID::Generate();
+				BinaryCompoundStruct object;
+				object.simpleA = BinarySimpleStruct::Create();
+				object.num = 9;
+				object.logger = &logger;
+
+				size_t numObjectSerializeRequests = 0;
+				bool error = false;
+				const std::vector<uint8_t> data = SerializeToBinary(BinaryCompoundStruct::Serializer::Instance()->Serialize(object), &logger, error,
+					[&](const SerializedObject& serializedObject, bool&) -> GUID {
+						numObjectSerializeRequests++;
+						const Reference<Object> value = serializedObject.GetObjectValue();
+						return (value == static_cast<Object*>(object.logger)) ? loggerId : GUID{};
+					});
+				EXPECT_FALSE(error);
+				EXPECT_EQ(numObjectSerializeRequests, 1);
+
+				BinaryCompoundStruct copy;
+				EXPECT_TRUE(DeserializeFromBinary(BinaryCompoundStruct::Serializer::Instance()->Serialize(copy), BinaryBlock(data), &logger,
+					[&](const SerializedObject& serializedObject, const GUID& id) -> bool {
+						numObjectSerializeRequests++;
+						serializedObject.SetObjectValue((id == loggerId) ? object.logger.operator->() : nullptr);
+						return true;
+					}));
+				EXPECT_EQ(numObjectSerializeRequests, 2);
+				EXPECT_TRUE(copy == object);
+				EXPECT_TRUE(logger.Numfailures() == 0);
+			}
+			EXPECT_TRUE(snapshot.Compare());
+		}
+
+		TEST(SerializeToBinaryTest, InvalidData) {
+			const Function<GUID, const SerializedObject&, bool&> ignoreObjectSerialization([](const SerializedObject&, bool&) { return GUID{}; });
+			const Function<bool, const SerializedObject&, const GUID&> ignoreObjectDeserialization([](const SerializedObject&, const GUID&) { return true; });
+			{
+				BinarySimpleStruct object;
+				bool error = false;
+				nlohmann::json json = SerializeToJson(BinarySimpleStruct::Serializer::Instance()->Serialize(object), nullptr, error,
+					[](const SerializedObject&, bool&) { return nlohmann::json(); });
+			}
+			Jimara::Test::Memory::MemorySnapshot snapshot;
+			{
+				Jimara::Test::CountingLogger logger;
+				BinarySimpleStruct object = BinarySimpleStruct::Create();
+				bool error = false;
+				const std::vector<uint8_t> data = SerializeToBinary(
+					BinarySimpleStruct::Serializer::Instance()->Serialize(object), &logger, error, ignoreObjectSerialization);
+				ASSERT_FALSE(error);
+
+				// Json is not binary:
+				{
+					const std::string json = SerializeToJson(BinarySimpleStruct::Serializer::Instance()->Serialize(object), &logger, error,
+						[](const SerializedObject&, bool&) { return nlohmann::json(); }).dump();
+					EXPECT_FALSE(IsSerializedBinary(MemoryBlock(json.data(), json.size(), nullptr)));
+					BinarySimpleStruct copy;
+					EXPECT_FALSE(DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(copy),
+						MemoryBlock(json.data(), json.size(), nullptr), &logger, ignoreObjectDeserialization));
+				}
+
+				// Truncated data is rejected as a whole:
+				for (size_t size = 0u; size < data.size(); size++) {
+					BinarySimpleStruct copy;
+					EXPECT_FALSE(DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(copy),
+						MemoryBlock(data.data(), size, nullptr), nullptr, ignoreObjectDeserialization));
+				}
+
+				// Random corruption should never crash:
+				std::mt19937 rng(0u);
+				for (size_t i = 0u; i < 1024u; i++) {
+					std::vector<uint8_t> corrupted = data;
+					corrupted[8u + (rng() % (corrupted.size() - 8u))] ^= static_cast<uint8_t>(1u << (rng() % 8u));
+					BinarySimpleStruct copy;
+					DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(copy), BinaryBlock(corrupted), nullptr, ignoreObjectDeserialization);
+				}
+
+				// Missing fields keep their default values:
+				{
+					const Reference<const ItemSerializer::Of<int>> integerSerializer = IntSerializer::Create("integer");
+					int value = 17;
+					const std::vector<uint8_t> partialData = SerializeToBinary(integerSerializer->Serialize(value), &logger, error, ignoreObjectSerialization);
+					EXPECT_FALSE(error);
+					BinarySimpleStruct copy;
+					copy.text = "Default";
+					EXPECT_TRUE(DeserializeFromBinary(BinarySimpleStruct::Serializer::Instance()->Serialize(copy), BinaryBlock(partialData), &logger, ignoreObjectDeserialization));
+					EXPECT_EQ(copy.text, "Default");
+					EXPECT_EQ(copy.integer, 0);
+				}
+
+				EXPECT_FALSE(error);
+			}
+			EXPECT_TRUE(snapshot.Compare());
+		}
+	}
+}
@@ -0,0 +1,290 @@
+#include "../../GtestHeaders.h"
+#include "Environment/LogicSimulation/BatchResourceLoader.h"
+#include "Data/AssetDatabase/AssetSet.h"
+#include <condition_variable>
+#include <algorithm>
+#include <random>
+#include <thread>
+
+
+namespace Jimara {
+	namespace {
+		// Shared state of the test assets (load order and an optional gate, blocking LoadItem() calls till opened)
+		struct BatchResourceLoaderTest_State {
+			std::mutex lock;
+			std::condition_variable gateCondition;
+			bool gateOpen = true;
+			std::vector<size_t> startOrder;
+			std::vector<size_t> finishOrder;
+
+			inline void SetGate(bool open) {
+				std::unique_lock<std::mutex> guard(lock);
+				gateOpen = open;
+				gateCondition.notify_all();
+			}
+
+			inline size_t StartedCount() {
+				std::unique_lock<std::mutex> guard(lock);
+				return startOrder.size();
+			}
+		};
+
+		class BatchResourceLoaderTest_Resource : public virtual Resource {};
+
+		class BatchResourceLoaderTest_Asset : public virtual Asset::Of<BatchResourceLoaderTest_Resource> {
+		public:
+			const size_t id;
+			BatchResourceLoaderTest_State* const state;
+			std::vector<Reference<BatchResourceLoaderTest_Asset>> dependencies;
+			std::atomic<bool> dependenciesReady = true;
+			std::atomic<bool> blockDiscovery = false;
+
+			inline BatchResourceLoaderTest_Asset(size_t index, BatchResourceLoaderTest_State* testState)
+				: Asset(GUID::Generate()), id(index), state(testState) {}
+
+			inline virtual void GetDependencies(const Callback<const GUID&>& reportDependency)const final override {
+				if (blockDiscovery) {
+					std::unique_lock<std::mutex> guard(state->lock);
+					while (!state->gateOpen)
+						state->gateCondition.wait(guard);
+				}
+				for (size_t i = 0u; i < dependencies.size(); i++)
+					reportDependency(dependencies[i]->Guid());
+			}
+
+		protected:
+			inline virtual Reference<BatchResourceLoaderTest_Resource> LoadItem() final override {
+				for (size_t i = 0u; i < dependencies.size(); i++)
+					if (dependencies[i]->GetLoadedResource() == nullptr)
+						dependenciesReady = false;
+				{
+					std::unique_lock<std::mutex> guard(state->lock);
+					state->startOrder.push_back(id);
+					while (!state->gateOpen)
+						state->gateCondition.wait(guard);
+				}
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+				{
+					std::unique_lock<std::mutex> guard(state->lock);
+					state->finishOrder.push_back(id);
+				}
+				return Object::Instantiate<BatchResourceLoaderTest_Resource>();
+			}
+		};
+
+		inline static Reference<Scene> CreateScene() {
+			Scene::CreateArgs args;
+			args.createMode = Scene::CreateArgs::CreateMode::CREATE_DEFAULT_FIELDS_AND_SUPRESS_WARNINGS;
+			return Scene::Create(args);
+		}
+
+		inline static std::vector<Reference<BatchResourceLoaderTest_Asset>> CreateAssets(
+			size_t count, BatchResourceLoaderTest_State* state, AssetSet* database) {
+			std::vector<Reference<BatchResourceLoaderTest_Asset>> assets;
+			for (size_t i = 0u; i < count; i++) {
+				assets.push_back(Object::Instantiate<BatchResourceLoaderTest_Asset>(i, state));
+				database->InsertAsset(assets.back());
+			}
+			return assets;
+		}
+
+		inline static size_t WorkerThreadCount() {
+			return Math::Max(static_cast<size_t>(std::thread::hardware_concurrency()), size_t(1u));
+		}
+	}
+
+	// Declared dependencies get discovered, become part of the batch and get loaded before their dependents
+	TEST(BatchResourceLoaderTest, DependencyOrder) {
+		const Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		BatchResourceLoaderTest_State state;
+		const std::vector<Reference<BatchResourceLoaderTest_Asset>> assets = CreateAssets(6u, &state, database);
+		assets[0]->dependencies = { assets[1], assets[2] };
+		assets[1]->dependencies = { assets[3] };
+		assets[2]->dependencies = { assets[3], assets[4] };
+
+		std::atomic<size_t> finishedCallCount = 0u;
+		void(*onFinished)(std::atomic<size_t>*, BatchResourceLoader*) = [](std::atomic<size_t>* count, BatchResourceLoader*) { (*count)++; };
+		std::atomic<size_t> maxReportedTotal = 0u;
+		void(*onProgress)(std::atomic<size_t>*, const BatchResourceLoader::Progress&) = [](std::atomic<size_t>* total, const BatchResourceLoader::Progress& progress) {
+			size_t value = total->load();
+			while (value < progress.totalAssets && (!total->compare_exchange_weak(value, progress.totalAssets)));
+		};
+
+		const std::vector<BatchResourceLoader::Request> requests = { { assets[0]->Guid(), 0 }, { assets[5]->Guid(), 0 }, { GUID::Generate(), 0 } };
+		const Reference<BatchResourceLoader> loader = BatchResourceLoader::Load(scene->Context(), requests,
+			Callback<BatchResourceLoader*>(onFinished, &finishedCallCount),
+			Callback<const BatchResourceLoader::Progress&>(onProgress, &maxReportedTotal), database);
+		ASSERT_NE(loader, nullptr);
+		loader->Wait();
+		EXPECT_TRUE(loader->Finished());
+		EXPECT_FALSE(loader->Canceled());
+
+		// Assets 0-5 and the missing one:
+		const BatchResourceLoader::Progress progress = loader->CurrentProgress();
+		EXPECT_EQ(progress.totalAssets, 7u);
+		EXPECT_EQ(progress.finishedAssets, 7u);
+		EXPECT_EQ(progress.failedAssets, 1u);
+		EXPECT_EQ(progress.fraction, 1.0f);
+		EXPECT_EQ(maxReportedTotal, 7u);
+
+		for (size_t i = 0u; i < assets.size(); i++) {
+			EXPECT_TRUE(assets[i]->dependenciesReady);
+			EXPECT_NE(loader->GetResource<BatchResourceLoaderTest_Resource>(assets[i]->Guid()), nullptr);
+		}
+		EXPECT_EQ(loader->GetResource(requests.back().guid), nullptr);
+
+		auto position = [&](size_t id) { return std::find(state.finishOrder.begin(), state.finishOrder.end(), id) - state.finishOrder.begin(); };
+		EXPECT_EQ(state.finishOrder.size(), assets.size());
+		EXPECT_LT(position(1u), position(0u));
+		EXPECT_LT(position(2u), position(0u));
+		EXPECT_LT(position(3u), position(1u));
+		EXPECT_LT(position(3u), position(2u));
+		EXPECT_LT(position(4u), position(2u));
+
+		// onFinished is invoked through ExecuteAfterUpdate queue:
+		EXPECT_EQ(finishedCallCount, 0u);
+		scene->Update(0.01f);
+		EXPECT_EQ(finishedCallCount, 1u);
+	}
+
+	// Higher priority assets start loading first (up to the number of the loads running in parallel)
+	TEST(BatchResourceLoaderTest, PriorityOrder) {
+		const Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		BatchResourceLoaderTest_State state;
+		const size_t threadCount = WorkerThreadCount();
+		const std::vector<Reference<BatchResourceLoaderTest_Asset>> assets = CreateAssets(threadCount * 4u + 32u, &state, database);
+
+		// Priority grows with the index, so the expected start order is the reverse of the asset order (requests are shuffled to make sure it's not the request order):
+		std::vector<BatchResourceLoader::Request> requests;
+		for (size_t i = 0u; i < assets.size(); i++)
+			requests.push_back({ assets[i]->Guid(), static_cast<int>(i) });
+		std::shuffle(requests.begin(), requests.end(), std::mt19937(7u));
+
+		const Reference<BatchResourceLoader> loader = BatchResourceLoader::Load(scene->Context(), requests,
+			Callback(Unused<BatchResourceLoader*>), Callback(Unused<const BatchResourceLoader::Progress&>), database);
+		ASSERT_NE(loader, nullptr);
+		loader->Wait();
+		EXPECT_EQ(loader->CurrentProgress().finishedAssets, assets.size());
+		EXPECT_EQ(loader->CurrentProgress().failedAssets, 0u);
+
+		// Picking is ordered, but the picked loads run in parallel, so the recorded order may be off by the number of the worker threads:
+		ASSERT_EQ(state.startOrder.size(), assets.size());
+		for (size_t i = 0u; i < state.startOrder.size(); i++) {
+			const size_t expectedPosition = assets.size() - 1u - state.startOrder[i];
+			const size_t distance = (expectedPosition > i) ? (expectedPosition - i) : (i - expectedPosition);
+			EXPECT_LE(distance, threadCount);
+		}
+		scene->Update(0.01f);
+	}
+
+	// Cancel() skips the assets that have not started loading, finishes the batch and lets Wait() return
+	TEST(BatchResourceLoaderTest, Cancel) {
+		const Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		BatchResourceLoaderTest_State state;
+		const size_t threadCount = WorkerThreadCount();
+		const std::vector<Reference<BatchResourceLoaderTest_Asset>> assets = CreateAssets(threadCount * 4u + 8u, &state, database);
+		std::vector<BatchResourceLoader::Request> requests;
+		for (size_t i = 0u; i < assets.size(); i++)
+			requests.push_back({ assets[i]->Guid(), 0 });
+
+		std::atomic<size_t> finishedCallCount = 0u;
+		void(*onFinished)(std::atomic<size_t>*, BatchResourceLoader*) = [](std::atomic<size_t>* count, BatchResourceLoader*) { (*count)++; };
+
+		// With the gate closed, at most threadCount loads can start:
+		state.SetGate(false);
+		const Reference<BatchResourceLoader> loader = BatchResourceLoader::Load(scene->Context(), requests,
+			Callback<BatchResourceLoader*>(onFinished, &finishedCallCount), Callback(Unused<const BatchResourceLoader::Progress&>), database);
+		ASSERT_NE(loader, nullptr);
+		while (state.StartedCount() <= 0u)
+			std::this_thread::yield();
+		loader->Cancel();
+		EXPECT_TRUE(loader->Canceled());
+		state.SetGate(true);
+		loader->Wait();
+		EXPECT_TRUE(loader->Finished());
+
+		const size_t startedCount = state.StartedCount();
+		EXPECT_GT(startedCount, 0u);
+		EXPECT_LE(startedCount, threadCount);
+		size_t loadedCount = 0u;
+		for (size_t i = 0u; i < assets.size(); i++)
+			if (loader->GetResource(assets[i]->Guid()) != nullptr)
+				loadedCount++;
+		EXPECT_EQ(loadedCount, startedCount);
+
+		// Canceled assets count as finished (not failed), so the progress is complete:
+		const BatchResourceLoader::Progress progress = loader->CurrentProgress();
+		EXPECT_EQ(progress.totalAssets, assets.size());
+		EXPECT_EQ(progress.finishedAssets, assets.size());
+		EXPECT_EQ(progress.failedAssets, 0u);
+		EXPECT_EQ(progress.fraction, 1.0f);
+
+		scene->Update(0.01f);
+		EXPECT_EQ(finishedCallCount, 1u);
+	}
+
+	// Dependency discovery is the first task of the batch, so Load() does not wait for it (and the batch can be canceled before it runs)
+	TEST(BatchResourceLoaderTest, AsynchronousDiscovery) {
+		const Reference<Scene> scene = CreateScene();
+		ASSERT_NE(scene, nullptr);
+		const Reference<AssetSet> database = Object::Instantiate<AssetSet>();
+		BatchResourceLoaderTest_State state;
+		const std::vector<Reference<BatchResourceLoaderTest_Asset>> assets = CreateAssets(4u, &state, database);
+		assets[0]->dependencies = { assets[1], assets[2] };
+		assets[0]->blockDiscovery = true;
+		const std::vector<BatchResourceLoader::Request> requests = { { assets[0]->Guid(), 0 }, { assets[3]->Guid(), 0 } };
+
+		std::atomic<size_t> finishedCallCount = 0u;
+		void(*onFinished)(std::atomic<size_t>*, BatchResourceLoader*) = [](std::atomic<size_t>* count, BatchResourceLoader*) { (*count)++; };
+
+		// Discovery is blocked by the gate, but Load() still returns:
+		{
+			state.SetGate(false);
+			const Reference<BatchResourceLoader> loader = BatchResourceLoader::Load(scene->Context(), requests,
+				Callback<BatchResourceLoader*>(onFinished, &finishedCallCount), Callback(Unused<const BatchResourceLoader::Progress&>), database);
+			ASSERT_NE(loader, nullptr);
+			EXPECT_FALSE(loader->Finished());
+			EXPECT_EQ(loader->CurrentProgress().totalAssets, 0u);
+			EXPECT_EQ(loader->CurrentProgress().fraction, 0.0f);
+			EXPECT_EQ(loader->GetResource(assets[0]->Guid()), nullptr);
+			EXPECT_EQ(state.StartedCount(), 0u);
+			state.SetGate(true);
+			loader->Wait();
+			EXPECT_TRUE(loader->Finished());
+			EXPECT_EQ(loader->CurrentProgress().totalAssets, assets.size());
+			EXPECT_EQ(loader->CurrentProgress().failedAssets, 0u);
+			for (size_t i = 0u; i < assets.size(); i++) {
+				EXPECT_TRUE(assets[i]->dependenciesReady);
+				EXPECT_NE(loader->GetResource(assets[i]->Guid()), nullptr);
+			}
+			scene->Update(0.01f);
+			EXPECT_EQ(finishedCallCount, 1u);
+		}
+
+		// Batch, canceled before the discovery gets done, finishes without loading anything:
+		{
+			finishedCallCount = 0u;
+			state.startOrder.clear();
+			state.SetGate(false);
+			const Reference<BatchResourceLoader> loader = BatchResourceLoader::Load(scene->Context(), requests,
+				Callback<BatchResourceLoader*>(onFinished, &finishedCallCount), Callback(Unused<const BatchResourceLoader::Progress&>), database);
+			ASSERT_NE(loader, nullptr);
+			loader->Cancel();
+			EXPECT_TRUE(loader->Canceled());
+			state.SetGate(true);
+			loader->Wait();
+			EXPECT_TRUE(loader->Finished());
+			EXPECT_EQ(loader->CurrentProgress().fraction, 1.0f);
+			EXPECT_EQ(loader->CurrentProgress().failedAssets, 0u);
+			EXPECT_EQ(state.StartedCount(), 0u);
+			scene->Update(0.01f);
+			EXPECT_EQ(finishedCallCount, 1u);
+		}
+	}
+}
@@ -0,0 +1,418 @@
+#include "../GtestHeaders.h"
+#include "Math/Algorithms/Pathfinding.h"
+#include "OS/Logging/StreamLogger.h"
+#include "Core/Stopwatch.h"
+#include "Core/Collections/Stacktor.h"
+#include "Math/Primitives/Triangle.h"
+#include <unordered_map>
+#include <iomanip>
+#include <random>
+
+
+namespace Jimara {
+	namespace {
+		// Grid with random cell costs and obstacles (4-connected)
+		struct PathfindingTest_Grid {
+			uint32_t width = 0u;
+			uint32_t height = 0u;
+			std::vector<float> costs;
+			std::vector<bool> blocked;
+
+			inline PathfindingTest_Grid(uint32_t w, uint32_t h, float blockedFraction, std::mt19937& rng) : width(w), height(h) {
+				std::uniform_real_distribution<float> costDis(1.0f, 3.0f);
+				std::uniform_real_distribution<float> blockDis(0.0f, 1.0f);
+				for (uint32_t i = 0u; i < (width * height); i++) {
+					costs.push_back(costDis(rng));
+					blocked.push_back(blockDis(rng) < blockedFraction);
+				}
+			}
+
+			template<typename ReportFn>
+			inline void GetNeighbors(uint32_t node, const ReportFn& report)const {
+				const int x = static_cast<int>(node % width);
+				const int y = static_cast<int>(node / width);
+				static const int DX[] = { 1, -1, 0, 0 };
+				static const int DY[] = { 0, 0, 1, -1 };
+				for (size_t i = 0u; i < 4u; i++) {
+					const int nx = x + DX[i];
+					const int ny = y + DY[i];
+					if (nx < 0 || ny < 0 || nx >= static_cast<int>(width) || ny >= static_cast<int>(height))
+						continue;
+					const uint32_t neighbor = static_cast<uint32_t>(ny) * width + static_cast<uint32_t>(nx);
+					if (!blocked[neighbor])
+						report(neighbor, (costs[node] + costs[neighbor]) * 0.5f);
+				}
+			}
+
+			inline float Heuristic(uint32_t node, uint32_t end)const {
+				return static_cast<float>(
+					std::abs(static_cast<int>(node % width) - static_cast<int>(end % width)) +
+					std::abs(static_cast<int>(node / width) - static_cast<int>(end / width)));
+			}
+		};
+
+		// Triangle adjacency graph of a jittered, triangulated grid (roughly how nav mesh surfaces look like to the pathfinder)
+		struct PathfindingTest_TriangleMesh {
+			uint32_t width = 0u;
+			uint32_t height = 0u;
+			std::vector<Vector3> centers;
+			std::vector<bool> blocked;
+
+			inline PathfindingTest_TriangleMesh(uint32_t w, uint32_t h, float blockedFraction, std::mt19937& rng) : width(w), height(h) {
+				std::uniform_real_distribution<float> jitterDis(-0.25f, 0.25f);
+				std::uniform_real_distribution<float> blockDis(0.0f, 1.0f);
+				for (uint32_t i = 0u; i < (width * height * 2u); i++) {
+					const uint32_t cell = (i >> 1u);
+					const float offset = ((i & 1u) == 0u) ? 0.33f : 0.66f;
+					centers.push_back(Vector3(
+						static_cast<float>(cell % width) + offset + jitterDis(rng), 0.0f,
+						static_cast<float>(cell / width) + offset + jitterDis(rng)));
+					blocked.push_back(blockDis(rng) < blockedFraction);
+				}
+			}
+
+			template<typename ReportFn>
+			inline void GetNeighbors(uint32_t node, const ReportFn& report)const {
+				const uint32_t cell = (node >> 1u);
+				const int x = static_cast<int>(cell % width);
+				const int y = static_cast<int>(cell / width);
+				auto reportTriangle = [&](int cx, int cy, uint32_t half) {
+					if (cx < 0 || cy < 0 || cx >= static_cast<int>(width) || cy >= static_cast<int>(height))
+						return;
+					const uint32_t neighbor = ((static_cast<uint32_t>(cy) * width + static_cast<uint32_t>(cx)) << 1u) + half;
+					if (!blocked[neighbor])
+						report(neighbor, Math::Magnitude(centers[neighbor] - centers[node]));
+				};
+				if ((node & 1u) == 0u) {
+					reportTriangle(x, y, 1u);
+					reportTriangle(x - 1, y, 1u);
+					reportTriangle(x, y - 1, 1u);
+				}
+				else {
+					reportTriangle(x, y, 0u);
+					reportTriangle(x + 1, y, 0u);
+					reportTriangle(x, y + 1, 0u);
+				}
+			}
+
+			inline float Heuristic(uint32_t node, uint32_t end)const {
+				return Math::Magnitude(centers[end] - centers[node]);
+			}
+		};
+
+		// Posed, bumpy triangulated grid with two neighbor expansion strategies, mirroring NavMesh surfaces before and after baking the portal graph:
+		// Per-expansion shared edge discovery (normals and edge matching recalculated for each neighbor) and the precomputed portal lists
+		struct PathfindingTest_Surface {
+			struct Portal {
+				Size2 faces = Size2(0u);
+				Vector3 midpoint = Vector3(0.0f);
+				float width = 0.0f;
+			};
+
+			Matrix4 pose = Math::Identity();
+			float poseScale = 1.0f;
+			float normalThreshold = 0.0f;
+			float radius = 0.0f;
+			std::vector<Triangle3> faces;
+			std::vector<Vector3> centers;
+			std::vector<Stacktor<uint32_t, 3u>> faceNeighbors;
+			std::vector<Vector3> faceNormals;
+			std::vector<Portal> portals;
+			std::vector<Stacktor<uint32_t, 3u>> facePortals;
+			std::vector<bool> blocked;
+
+			inline PathfindingTest_Surface(uint32_t width, uint32_t height, float maxTiltAngle, float agentRadius, std::mt19937& rng)
+				: normalThreshold(std::cos(Math::Radians(maxTiltAngle))), radius(agentRadius) {
+				poseScale = 1.5f;
+				pose = Math::MatrixFromEulerAngles(Vector3(10.0f, 30.0f, 0.0f));
+				for (size_t i = 0u; i < 3u; i++)
+					pose[static_cast<int>(i)] *= poseScale;
+
+				std::uniform_real_distribution<float> jitterDis(-0.2f, 0.2f);
+				std::uniform_real_distribution<float> heightDis(0.0f, 0.4f);
+				std::vector<Vector3> vertices;
+				for (uint32_t y = 0u; y <= height; y++)
+					for (uint32_t x = 0u; x <= width; x++)
+						vertices.push_back(Vector3(static_cast<float>(x) + jitterDis(rng), heightDis(rng), static_cast<float>(y) + jitterDis(rng)));
+				std::vector<Size3> indices;
+				for (uint32_t y = 0u; y < height; y++)
+					for (uint32_t x = 0u; x < width; x++) {
+						const uint32_t v00 = y * (width + 1u) + x;
+						const uint32_t v10 = v00 + 1u;
+						const uint32_t v01 = v00 + width + 1u;
+						const uint32_t v11 = v01 + 1u;
+						indices.push_back(Size3(v00, v01, v11));
+						indices.push_back(Size3(v00, v11, v10));
+					}
+
+				std::unordered_map<uint64_t, std::pair<uint32_t, uint32_t>> edgeFaces;
+				for (uint32_t faceId = 0u; faceId < indices.size(); faceId++) {
+					const Size3 face = indices[faceId];
+					faces.push_back(Triangle3(vertices[face.x], vertices[face.y], vertices[face.z]));
+					centers.push_back((vertices[face.x] + vertices[face.y] + vertices[face.z]) / 3.0f);
+					faceNormals.push_back(Math::Normalize(Math::Cross(faces.back()[2u] - faces.back()[0u], faces.back()[1u] - faces.back()[0u])));
+					for (uint32_t e = 0u; e < 3u; e++) {
+						const uint32_t a = face[e];
+						const uint32_t b = face[(e + 1u) % 3u];
+						const uint64_t key = (uint64_t(Math::Min(a, b)) << 32u) | uint64_t(Math::Max(a, b));
+						auto it = edgeFaces.find(key);
+						if (it == edgeFaces.end())
+							edgeFaces[key] = std::make_pair(faceId, e);
+						else {
+							Portal portal = {};
+							portal.faces = Size2(it->second.first, faceId);
+							portal.midpoint = (vertices[a] + vertices[b]) * 0.5f;
+							portal.width = Math::Magnitude(vertices[b] - vertices[a]);
+							portals.push_back(portal);
+						}
+					}
+				}
+				faceNeighbors.resize(faces.size());
+				facePortals.resize(faces.size());
+				for (uint32_t portalId = 0u; portalId < portals.size(); portalId++) {
+					const Size2 portalFaces = portals[portalId].faces;
+					faceNeighbors[portalFaces.x].Push(portalFaces.y);
+					faceNeighbors[portalFaces.y].Push(portalFaces.x);
+					facePortals[portalFaces.x].Push(portalId);
+					facePortals[portalFaces.y].Push(portalId);
+				}
+				blocked.resize(faces.size(), false);
+			}
+
+			// Reports neighbors, discovering shared edges, normals and widths from the face geometry on each expansion
+			template<typename ReportFn>
+			inline void GetNeighborsFromGeometry(uint32_t node, const ReportFn& report)const {
+				auto calculateNormal = [&](const Triangle3& tri) {
+					return Math::Normalize(Vector3(pose * Vector4(Math::Normalize(Math::Cross(tri[2u] - tri[0u], tri[1u] - tri[0u])), 0.0f)));
+				};
+				const Triangle3 tri0 = faces[node];
+				const Vector3 normal0 = calculateNormal(tri0);
+				const Vector3 center = pose * Vector4(centers[node], 1.0f);
+				const Stacktor<uint32_t, 3u>& neighbors = faceNeighbors[node];
+				for (size_t nId = 0u; nId < neighbors.Size(); nId++) {
+					const uint32_t neighborId = neighbors[nId];
+					const Triangle3 tri1 = faces[neighborId];
+					if (Math::Dot(calculateNormal(tri1), normal0) < normalThreshold)
+						continue;
+					for (uint32_t eI0 = 0u; eI0 < 3u; eI0++) {
+						const Vector3& a0 = tri0[eI0];
+						const Vector3& b0 = tri0[(eI0 + 1u) % 3u];
+						const float distanceThresh = 0.01f * Math::Magnitude(a0 - b0);
+						bool found = false;
+						for (uint32_t eI1 = 0u; eI1 < 3u; eI1++) {
+							const Vector3& a1 = tri1[eI1];
+							const Vector3& b1 = tri1[(eI1 + 1u) % 3u];
+							if (Math::Magnitude(a0 - b1) > distanceThresh || Math::Magnitude(b0 - a1) > distanceThresh)
+								continue;
+							const Vector3 worldOffset = pose * Vector4(b0 - a0, 0.0f);
+							if ((Math::Magnitude(worldOffset) * 0.5f) >= radius) {
+								const Vector3 midpoint = pose * Vector4((a0 + b0) * 0.5f, 1.0f);
+								const Vector3 neighborCenter = pose * Vector4(centers[neighborId], 1.0f);
+								report(neighborId, Math::Magnitude(midpoint - center) + Math::Magnitude(neighborCenter - midpoint));
+							}
+							found = true;
+							break;
+						}
+						if (found)
+							break;
+					}
+				}
+			}
+
+			// Reports neighbors, traversing the precomputed portal lists (only the pose transforms are left per expansion)
+			template<typename ReportFn>
+			inline void GetNeighbors(uint32_t node, const ReportFn& report)const {
+				auto worldNormal = [&](uint32_t faceId) {
+					return Math::Normalize(Vector3(pose * Vector4(faceNormals[faceId], 0.0f)));
+				};
+				const Vector3 normal0 = worldNormal(node);
+				const Vector3 center = pose * Vector4(centers[node], 1.0f);
+				const Stacktor<uint32_t, 3u>& portalIds = facePortals[node];
+				for (size_t pId = 0u; pId < portalIds.Size(); pId++) {
+					const Portal& portal = portals[portalIds[pId]];
+					const uint32_t neighborId = (portal.faces.x == node) ? portal.faces.y : portal.faces.x;
+					if (Math::Dot(worldNormal(neighborId), normal0) < normalThreshold)
+						continue;
+					if ((portal.width * poseScale * 0.5f) < radius)
+						continue;
+					const Vector3 midpoint = pose * Vector4(portal.midpoint, 1.0f);
+					const Vector3 neighborCenter = pose * Vector4(centers[neighborId], 1.0f);
+					report(neighborId, Math::Magnitude(midpoint - center) + Math::Magnitude(neighborCenter - midpoint));
+				}
+			}
+
+			inline float Heuristic(uint32_t node, uint32_t end)const {
+				return Math::Magnitude(Vector3(pose * Vector4(centers[end] - centers[node], 0.0f)));
+			}
+		};
+
+		// Random unblocked start-end pairs
+		template<typename GraphType>
+		inline static std::vector<std::pair<uint32_t, uint32_t>> PathfindingTest_Queries(const GraphType& graph, size_t count, std::mt19937& rng) {
+			std::vector<std::pair<uint32_t, uint32_t>> queries;
+			std::uniform_int_distribution<uint32_t> dis(0u, static_cast<uint32_t>(graph.blocked.size() - 1u));
+			while (queries.size() < count) {
+				const uint32_t a = dis(rng);
+				const uint32_t b = dis(rng);
+				if ((!graph.blocked[a]) && (!graph.blocked[b]))
+					queries.push_back(std::make_pair(a, b));
+			}
+			return queries;
+		}
+
+		// Cost of a path (negative, if the path is not connected)
+		template<typename GraphType>
+		inline static float PathfindingTest_PathCost(const GraphType& graph, const std::vector<uint32_t>& path) {
+			float cost = 0.0f;
+			for (size_t i = 1u; i < path.size(); i++) {
+				float edgeCost = -1.0f;
+				graph.GetNeighbors(path[i - 1u], [&](uint32_t neighbor, float distance) {
+					if (neighbor == path[i])
+						edgeCost = distance;
+					});
+				if (edgeCost < 0.0f)
+					return -1.0f;
+				cost += edgeCost;
+			}
+			return cost;
+		}
+
+		// Makes sure PathfindingContext finds paths of the same cost as AStar() and logs time spent by both
+		template<typename GraphType>
+		inline static void PathfindingTest_CompareWithAStar(const GraphType& graph, size_t queryCount, const char* graphName, std::mt19937& rng) {
+			const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+			const std::vector<std::pair<uint32_t, uint32_t>> queries = PathfindingTest_Queries(graph, queryCount, rng);
+			Algorithms::PathfindingContext<uint32_t, float> context;
+			std::vector<uint32_t> path;
+			float aStarTime = 0.0f;
+			float contextTime = 0.0f;
+			size_t foundCount = 0u;
+			for (size_t i = 0u; i < queries.size(); i++) {
+				const uint32_t start = queries[i].first;
+				const uint32_t end = queries[i].second;
+				auto heuristic = [&](uint32_t node) { return graph.Heuristic(node, end); };
+				auto getNeighbors = [&](uint32_t node, const auto& report) { graph.GetNeighbors(node, report); };
+
+				Stopwatch stopwatch;
+				const std::vector<uint32_t> reference = Algorithms::AStar(start, end, heuristic, getNeighbors);
+				aStarTime += stopwatch.Reset();
+				const Algorithms::PathfindingStatus status = context.FindPath(start, end, heuristic, getNeighbors, path);
+				contextTime += stopwatch.Reset();
+
+				if (reference.empty()) {
+					EXPECT_EQ(status, Algorithms::PathfindingStatus::NOT_FOUND);
+					EXPECT_TRUE(path.empty());
+					continue;
+				}
+				foundCount++;
+				ASSERT_EQ(status, Algorithms::PathfindingStatus::FOUND);
+				ASSERT_FALSE(path.empty());
+				EXPECT_EQ(path.front(), start);
+				EXPECT_EQ(path.back(), end);
+				const float referenceCost = PathfindingTest_PathCost(graph, reference);
+				const float cost = PathfindingTest_PathCost(graph, path);
+				EXPECT_GE(cost, 0.0f);
+				EXPECT_NEAR(cost, referenceCost, referenceCost * 0.001f);
+				EXPECT_NEAR(context.PathCost(), cost, cost * 0.001f);
+			}
+			EXPECT_GT(foundCount, 0u);
+			logger->Info(std::fixed, std::setprecision(3),
+				"PathfindingTest::", graphName, " - ", queries.size(), " queries (", foundCount, " paths found); ",
+				"AStar: ", (aStarTime * 1000.0f), "ms; PathfindingContext: ", (contextTime * 1000.0f), "ms");
+		}
+	}
+
+	// PathfindingContext has to find optimal paths on grids (same costs as AStar)
+	TEST(PathfindingTest, Grid) {
+		std::mt19937 rng;
+		const PathfindingTest_Grid grid(256u, 256u, 0.25f, rng);
+		PathfindingTest_CompareWithAStar(grid, 256u, "Grid", rng);
+	}
+
+	// PathfindingContext has to find optimal paths on triangle adjacency graphs (same costs as AStar)
+	TEST(PathfindingTest, TriangleMesh) {
+		std::mt19937 rng;
+		const PathfindingTest_TriangleMesh mesh(128u, 128u, 0.15f, rng);
+		PathfindingTest_CompareWithAStar(mesh, 256u, "TriangleMesh", rng);
+	}
+
+	// Node budget, partial paths, early termination and cached distances
+	TEST(PathfindingTest, BudgetAndTermination) {
+		std::mt19937 rng;
+		const PathfindingTest_Grid grid(64u, 64u, 0.0f, rng);
+		const uint32_t start = 0u;
+		const uint32_t end = (64u * 64u - 1u);
+		auto heuristic = [&](uint32_t node) { return grid.Heuristic(node, end); };
+		auto getNeighbors = [&](uint32_t node, const auto& report) { grid.GetNeighbors(node, report); };
+		Algorithms::PathfindingContext<uint32_t, float> context;
+		std::vector<uint32_t> path;
+
+		{
+			Algorithms::PathfindingSettings settings;
+			settings.maxExpandedNodes = 16u;
+			EXPECT_EQ(context.FindPath(start, end, heuristic, getNeighbors, path, settings), Algorithms::PathfindingStatus::INTERRUPTED);
+			EXPECT_TRUE(path.empty());
+
+			settings.allowPartialPath = true;
+			EXPECT_EQ(context.FindPath(start, end, heuristic, getNeighbors, path, settings), Algorithms::PathfindingStatus::INTERRUPTED);
+			ASSERT_FALSE(path.empty());
+			EXPECT_EQ(path.front(), start);
+			EXPECT_LT(grid.Heuristic(path.back(), end), grid.Heuristic(start, end));
+			EXPECT_GE(PathfindingTest_PathCost(grid, path), 0.0f);
+		}
+
+		{
+			auto terminate = [](uint32_t, float distanceSoFar) { return distanceSoFar > 8.0f; };
+			EXPECT_EQ(context.FindPath(start, end, heuristic, getNeighbors, terminate, path, Algorithms::PathfindingSettings()),
+				Algorithms::PathfindingStatus::INTERRUPTED);
+			EXPECT_TRUE(path.empty());
+		}
+
+		{
+			EXPECT_EQ(context.FindPath(start, end, heuristic, getNeighbors, path), Algorithms::PathfindingStatus::FOUND);
+			float distance = -1.0f;
+			EXPECT_TRUE(context.TryGetDistance(start, distance));
+			EXPECT_EQ(distance, 0.0f);
+			EXPECT_TRUE(context.TryGetDistance(end, distance));
+			EXPECT_EQ(distance, context.PathCost());
+			EXPECT_TRUE(context.DiscoveredNodeCount() > 0u);
+		}
+	}
+
+	// Benchmarks nav-mesh-like searches with per-expansion shared edge discovery against the precomputed portal graph (both have to find the same paths)
+	TEST(PathfindingTest, PortalGraphBenchmark) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		std::mt19937 rng;
+		const PathfindingTest_Surface surface(96u, 96u, 30.0f, 0.1f, rng);
+		const std::vector<std::pair<uint32_t, uint32_t>> queries = PathfindingTest_Queries(surface, 256u, rng);
+		Algorithms::PathfindingContext<uint32_t, float> context;
+		std::vector<uint32_t> path;
+		float geometryTime = 0.0f;
+		float portalTime = 0.0f;
+		size_t foundCount = 0u;
+		for (size_t i = 0u; i < queries.size(); i++) {
+			const uint32_t end = queries[i].second;
+			auto heuristic = [&](uint32_t node) { return surface.Heuristic(node, end); };
+			auto getNeighborsFromGeometry = [&](uint32_t node, const auto& report) { surface.GetNeighborsFromGeometry(node, report); };
+			auto getNeighbors = [&](uint32_t node, const auto& report) { surface.GetNeighbors(node, report); };
+
+			Stopwatch stopwatch;
+			const Algorithms::PathfindingStatus referenceStatus = context.FindPath(queries[i].first, end, heuristic, getNeighborsFromGeometry, path);
+			const float referenceCost = context.PathCost();
+			geometryTime += stopwatch.Reset();
+			const Algorithms::PathfindingStatus status = context.FindPath(queries[i].first, end, heuristic, getNeighbors, path);
+			portalTime += stopwatch.Reset();
+
+			ASSERT_EQ(status, referenceStatus);
+			if (status != Algorithms::PathfindingStatus::FOUND)
+				continue;
+			foundCount++;
+			EXPECT_NEAR(context.PathCost(), referenceCost, referenceCost * 0.001f);
+			EXPECT_NEAR(PathfindingTest_PathCost(surface, path), referenceCost, referenceCost * 0.001f);
+		}
+		EXPECT_GT(foundCount, 0u);
+		logger->Info(std::fixed, std::setprecision(3),
+			"PathfindingTest::PortalGraphBenchmark - ", surface.faces.size(), " faces; ", queries.size(), " queries (", foundCount, " paths found); ",
+			"Per-expansion edge discovery: ", (geometryTime * 1000.0f), "ms; Precomputed portals: ", (portalTime * 1000.0f), "ms");
+	}
+}
@@ -0,0 +1,249 @@
+#include "../../GtestHeaders.h"
+#include "Jimara-StateMachines/Navigation/NavMesh/NavMeshAgent.h"
+#include "Data/Geometry/Mesh.h"
+#include "Environment/Scene/Scene.h"
+#include "Components/Transform.h"
+#include "OS/Logging/StreamLogger.h"
+#include "Core/Stopwatch.h"
+#include <stdexcept>
+#include <iomanip>
+#include <random>
+#include <thread>
+
+
+namespace Jimara {
+	namespace {
+		inline static Reference<Scene> NavMeshTest_CreateScene() {
+			Scene::CreateArgs args;
+			args.createMode = Scene::CreateArgs::CreateMode::CREATE_DEFAULT_FIELDS_AND_SUPRESS_WARNINGS;
+			return Scene::Create(args);
+		}
+
+		// Bumpy grid with cellCount x cellCount quads (heights are random, so that the surface bake does not merge the faces)
+		inline static Reference<TriMesh> NavMeshTest_BumpyGrid(uint32_t cellCount, float cellSize, std::mt19937& rng) {
+			const Reference<TriMesh> mesh = Object::Instantiate<TriMesh>("NavMeshTest_BumpyGrid");
+			TriMesh::Writer writer(mesh);
+			std::uniform_real_distribution<float> heightDis(0.0f, cellSize * 0.1f);
+			for (uint32_t z = 0u; z <= cellCount; z++)
+				for (uint32_t x = 0u; x <= cellCount; x++)
+					writer.AddVert(MeshVertex(
+						Vector3(static_cast<float>(x) * cellSize, heightDis(rng), static_cast<float>(z) * cellSize),
+						Math::Up(), Vector2(static_cast<float>(x), static_cast<float>(z)) / static_cast<float>(cellCount)));
+			for (uint32_t z = 0u; z < cellCount; z++)
+				for (uint32_t x = 0u; x < cellCount; x++) {
+					const uint32_t v00 = z * (cellCount + 1u) + x;
+					const uint32_t v10 = v00 + 1u;
+					const uint32_t v01 = v00 + cellCount + 1u;
+					const uint32_t v11 = v01 + 1u;
+					writer.AddFace(TriangleFace(v00, v10, v11));
+					writer.AddFace(TriangleFace(v00, v11, v01));
+				}
+			return mesh;
+		}
+
+		// Shared NavMesh instance of a new scene with a single bumpy grid surface (NavMeshAgents within the scene use the same instance)
+		struct NavMeshTest_GridNavMesh {
+			Reference<Scene> scene;
+			Reference<NavMesh> navMesh;
+			Reference<NavMesh::Surface> surface;
+			Reference<NavMesh::SurfaceInstance> instance;
+
+			inline NavMeshTest_GridNavMesh(uint32_t cellCount, float cellSize, std::mt19937& rng) {
+				scene = NavMeshTest_CreateScene();
+				if (scene == nullptr)
+					return;
+				navMesh = NavMesh::Instance(scene->Context());
+				surface = Object::Instantiate<NavMesh::Surface>(ConfigurableResource::CreateArgs());
+				{
+					NavMesh::SurfaceSettings settings;
+					settings.mesh = NavMeshTest_BumpyGrid(cellCount, cellSize, rng);
+					settings.edgeLengthThreshold = 0.0f;
+					settings.simplificationAngleThreshold = 0.0f;
+					surface->Settings() = settings;
+				}
+				instance = Object::Instantiate<NavMesh::SurfaceInstance>(navMesh);
+				instance->Shape() = surface;
+				instance->Enabled() = true;
+			}
+
+			inline ~NavMeshTest_GridNavMesh() {
+				if (instance != nullptr)
+					instance->Enabled() = false;
+			}
+		};
+
+		// Target point for the NavMeshAgents (agents read it during the scene update, so it's only safe to move it in-between the updates)
+		class NavMeshTest_AgentTarget : public virtual VectorInput::ComponentFrom<Vector3> {
+		public:
+			Vector3 position;
+
+			inline NavMeshTest_AgentTarget(Component* parent, const Vector3& targetPosition)
+				: Component(parent, "NavMeshTest_AgentTarget"), position(targetPosition) {}
+
+			inline virtual std::optional<Vector3> EvaluateInput()final override { return position; }
+		};
+
+		inline static float NavMeshTest_PathLength(const std::vector<NavMesh::PathNode>& path) {
+			float length = 0.0f;
+			for (size_t i = 1u; i < path.size(); i++)
+				length += Math::Magnitude(path[i].position - path[i - 1u].position);
+			return length;
+		}
+	}
+
+	// Hierarchical (cluster corridor) searches on a large surface should find paths, not much longer than the exhaustive face-level search
+	TEST(NavMeshTest, HierarchicalPathLength) {
+		static const constexpr uint32_t CELL_COUNT = 32u;
+		static const constexpr float CELL_SIZE = 1.0f;
+		std::mt19937 rng;
+		const NavMeshTest_GridNavMesh grid(CELL_COUNT, CELL_SIZE, rng);
+		ASSERT_NE(grid.navMesh, nullptr);
+		const Reference<NavMesh> navMesh = grid.navMesh;
+		const Reference<const NavMesh::BakedSurfaceData> bakedData = grid.surface->Data();
+		ASSERT_NE(bakedData, nullptr);
+		EXPECT_GT(bakedData->octree.Size(), 256u);
+		EXPECT_GT(bakedData->clusters.size(), 1u);
+
+		NavMesh::AgentOptions hierarchicalOptions;
+		hierarchicalOptions.radius = 0.0f;
+		hierarchicalOptions.surfaceSearchRadius = CELL_SIZE;
+		hierarchicalOptions.maxTiltAngle = 45.0f;
+		NavMesh::AgentOptions exhaustiveOptions = hierarchicalOptions;
+		exhaustiveOptions.flags = exhaustiveOptions.flags | NavMesh::AgentFlags::DISABLE_HIERARCHICAL_SEARCH;
+
+		static const constexpr size_t QUERY_COUNT = 64u;
+		std::uniform_real_distribution<float> coordDis(0.5f * CELL_SIZE, (static_cast<float>(CELL_COUNT) - 0.5f) * CELL_SIZE);
+		float hierarchicalTotal = 0.0f;
+		float exhaustiveTotal = 0.0f;
+		for (size_t i = 0u; i < QUERY_COUNT; i++) {
+			const Vector3 start(coordDis(rng), CELL_SIZE * 0.05f, coordDis(rng));
+			const Vector3 end(coordDis(rng), CELL_SIZE * 0.05f, coordDis(rng));
+			const std::vector<NavMesh::PathNode> hierarchicalPath = navMesh->CalculatePath(start, end, Math::Up(), hierarchicalOptions);
+			const std::vector<NavMesh::PathNode> exhaustivePath = navMesh->CalculatePath(start, end, Math::Up(), exhaustiveOptions);
+			ASSERT_FALSE(exhaustivePath.empty());
+			ASSERT_FALSE(hierarchicalPath.empty());
+			EXPECT_LT(Math::Magnitude(hierarchicalPath.front().position - exhaustivePath.front().position), 0.01f);
+			EXPECT_LT(Math::Magnitude(hierarchicalPath.back().position - exhaustivePath.back().position), 0.01f);
+			const float hierarchicalLength = NavMeshTest_PathLength(hierarchicalPath);
+			const float exhaustiveLength = NavMeshTest_PathLength(exhaustivePath);
+			EXPECT_LE(hierarchicalLength, exhaustiveLength * 1.25f + 0.01f);
+			hierarchicalTotal += hierarchicalLength;
+			exhaustiveTotal += exhaustiveLength;
+		}
+		EXPECT_LE(hierarchicalTotal, exhaustiveTotal * 1.1f);
+	}
+
+	// Search failures should propagate to the caller and should not leave broken entries in the path cache
+	TEST(NavMeshTest, PathCacheFailedSearch) {
+		std::mt19937 rng;
+		const NavMeshTest_GridNavMesh grid(8u, 1.0f, rng);
+		ASSERT_NE(grid.navMesh, nullptr);
+
+		NavMesh::AgentOptions options;
+		options.surfaceSearchRadius = 1.0f;
+		options.maxTiltAngle = 45.0f;
+		options.pathCacheGroup = 1u;
+		const Vector3 start(0.5f, 0.05f, 0.5f);
+		const Vector3 end(7.5f, 0.05f, 7.5f);
+
+		auto failingWeight = [](const NavMesh::PathNode&, const NavMesh::PathNode&) -> float {
+			throw std::runtime_error("NavMeshTest.PathCacheFailedSearch - Intentional failure");
+		};
+		options.additionalPathWeight = &failingWeight;
+		EXPECT_THROW(grid.navMesh->CalculatePath(start, end, Math::Up(), options), std::runtime_error);
+		EXPECT_EQ(grid.navMesh->CacheStatistics().missCount, 1u);
+
+		auto zeroWeight = [](const NavMesh::PathNode&, const NavMesh::PathNode&) -> float { return 0.0f; };
+		options.additionalPathWeight = &zeroWeight;
+		EXPECT_FALSE(grid.navMesh->CalculatePath(start, end, Math::Up(), options).empty());
+		EXPECT_EQ(grid.navMesh->CacheStatistics().missCount, 2u);
+		EXPECT_FALSE(grid.navMesh->CalculatePath(start, end, Math::Up(), options).empty());
+		EXPECT_EQ(grid.navMesh->CacheStatistics().hitCount, 1u);
+	}
+
+	// Crowd benchmark with actual NavMeshAgent components (scene updates drive the agent updater and the path requests get flushed on the NavMesh update thread);
+	// Reports throughput in agents per millisecond and makes sure every agent gets a path within the per-frame request budget
+	TEST(NavMeshTest, AgentCrowdBenchmark) {
+		const Reference<OS::Logger> logger = Object::Instantiate<OS::StreamLogger>();
+		static const constexpr uint32_t CELL_COUNT = 48u;
+		static const constexpr float CELL_SIZE = 1.0f;
+		std::mt19937 rng;
+		const NavMeshTest_GridNavMesh grid(CELL_COUNT, CELL_SIZE, rng);
+		ASSERT_NE(grid.navMesh, nullptr);
+		ASSERT_NE(grid.surface->Data(), nullptr);
+		SceneContext* const context = grid.scene->Context();
+
+		static const constexpr size_t AGENT_COUNT = 1024u;
+		static const constexpr size_t TARGET_COUNT = 16u;
+		static const constexpr size_t FRAME_COUNT = 32u;
+		static const constexpr size_t REQUEST_BUDGET = 128u;
+		std::uniform_real_distribution<float> coordDis(0.5f * CELL_SIZE, (static_cast<float>(CELL_COUNT) - 0.5f) * CELL_SIZE);
+		auto randomPoint = [&]() { return Vector3(coordDis(rng), CELL_SIZE * 0.05f, coordDis(rng)); };
+
+		std::vector<Reference<NavMeshTest_AgentTarget>> targets;
+		std::vector<Reference<NavMeshAgent>> agents;
+		{
+			std::unique_lock<std::recursive_mutex> lock(context->UpdateLock());
+			for (size_t i = 0u; i < TARGET_COUNT; i++)
+				targets.push_back(Object::Instantiate<NavMeshTest_AgentTarget>(context->RootObject(), randomPoint()));
+			for (size_t i = 0u; i < AGENT_COUNT; i++) {
+				const Reference<Transform> transform = Object::Instantiate<Transform>(context->RootObject(), "Agent Transform", randomPoint());
+				const Reference<NavMeshAgent> agent = Object::Instantiate<NavMeshAgent>(transform);
+				agent->SetRadius(0.1f);
+				agent->SetSurfaceSearchRadius(CELL_SIZE);
+				agent->SetMaxTiltAngle(45.0f);
+				agent->SetTarget(targets[i % TARGET_COUNT]);
+				agents.push_back(agent);
+			}
+			NavMeshAgent::SetPathRequestBudget(context, REQUEST_BUDGET);
+			EXPECT_EQ(NavMeshAgent::PathRequestBudget(context), REQUEST_BUDGET);
+		}
+
+		// One of the targets moves each frame:
+		std::uniform_int_distribution<size_t> targetDis(0u, TARGET_COUNT - 1u);
+		float agentUpdateTime = 0.0f;
+		size_t maxRequestCount = 0u;
+		size_t maxDeferredRequestCount = 0u;
+		Stopwatch stopwatch;
+		for (size_t frame = 0u; frame < FRAME_COUNT; frame++) {
+			targets[targetDis(rng)]->position = randomPoint();
+			grid.scene->Update(0.01f);
+			const NavMeshAgent::PathRequestStatistics statistics = NavMeshAgent::RequestStatistics(context);
+			EXPECT_EQ(statistics.agentCount, AGENT_COUNT);
+			agentUpdateTime += statistics.agentUpdateTime;
+			maxRequestCount = Math::Max(maxRequestCount, statistics.requestCount);
+			maxDeferredRequestCount = Math::Max(maxDeferredRequestCount, statistics.deferredRequestCount);
+		}
+		const float totalTime = stopwatch.Elapsed();
+
+		// Flushes run asynchronously, so the last requests may need a few more frames to finish:
+		auto pathlessAgentCount = [&]() {
+			size_t count = 0u;
+			for (size_t i = 0u; i < agents.size(); i++) {
+				const std::shared_ptr<const std::vector<NavMesh::PathNode>> path = agents[i]->Path();
+				if (path == nullptr || path->empty())
+					count++;
+			}
+			return count;
+		};
+		{
+			Stopwatch timeout;
+			while (pathlessAgentCount() > 0u && timeout.Elapsed() < 10.0f) {
+				grid.scene->Update(0.01f);
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			}
+		}
+		EXPECT_EQ(pathlessAgentCount(), 0u);
+		EXPECT_GT(maxRequestCount, 0u);
+		EXPECT_LE(maxRequestCount, REQUEST_BUDGET);
+		EXPECT_GT(maxDeferredRequestCount, 0u);
+
+		const NavMeshAgent::PathRequestStatistics statistics = NavMeshAgent::RequestStatistics(context);
+		logger->Info(std::fixed, std::setprecision(3),
+			"NavMeshTest::AgentCrowdBenchmark - ", AGENT_COUNT, " agents; ", FRAME_COUNT, " frames; ",
+			(totalTime * 1000.0f / float(FRAME_COUNT)), "ms per frame; ",
+			(float(AGENT_COUNT * FRAME_COUNT) / Math::Max(agentUpdateTime * 1000.0f, std::numeric_limits<float>::epsilon())), " agents/ms (agent updates); ",
+			"last flush: ", statistics.requestCount, " requests, ", statistics.cacheHitCount, " cache hits, ",
+			statistics.mergedRequestCount, " merged, ", (statistics.pathfindingTime * 1000.0f), "ms");
+	}
+}
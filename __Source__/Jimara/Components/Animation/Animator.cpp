@@ -4,15 +4,121 @@
 #include "../../Data/Serialization/Attributes/HideInEditorAttribute.h"
 #include "../../Data/Serialization/Attributes/EnumAttribute.h"
 #include "../../Math/BinarySearch.h"
+#include "../../Environment/LogicSimulation/SimulationThreadBlock.h"
 
 
 namespace Jimara {
-	Animator::Animator(Component* parent, const std::string_view& name) : Component(parent, name) {
+	struct Animator::BatchUpdater : public virtual ObjectCache<Reference<const Object>>::StoredObject {
+	private:
+		// Minimal number of animators per parallel sampling chunk
+		static const constexpr size_t SAMPLE_GRAIN_SIZE = 4u;
+
+		const Reference<SceneContext> m_context;
+		const Reference<SimulationThreadBlock> m_threadBlock;
+		std::mutex m_animatorLock;
+		std::set<Animator*> m_animators;
+		std::vector<Reference<Animator>> m_updateBuffer;
+
+		void Update() {
+			// Collect active animators:
+			{
+				std::unique_lock<std::mutex> lock(m_animatorLock);
+				for (auto it = m_animators.begin(); it != m_animators.end(); ++it) {
+					Animator* animator = *it;
+					// Animator may be going out of scope on another thread; TryAddRef() makes sure we do not resurrect it:
+					if (!animator->TryAddRef())
+						continue;
+					const Reference<Animator> reference(animator);
+					animator->ReleaseRef();
+					if ((!animator->Destroyed()) && animator->ActiveInHierarchy())
+						m_updateBuffer.push_back(reference);
+				}
+			}
+			if (m_updateBuffer.empty())
+				return;
+
+			// Bindings and channel activation can subscribe to events and query serialized fields, so this part stays on the update thread:
+			for (size_t i = 0u; i < m_updateBuffer.size(); i++)
+				m_updateBuffer[i]->BeginUpdate();
+
+			// Sampling only reads the bindings and writes to per-animator pose buffers, so the animators can safely be processed in parallel:
+			m_threadBlock->ParallelFor(0u, m_updateBuffer.size(), SAMPLE_GRAIN_SIZE, [&](size_t index) {
+				m_updateBuffer[index]->SamplePose();
+				});
+
+			// Field setters may run arbitrary logic, so poses are applied in a single serial pass:
+			for (size_t i = 0u; i < m_updateBuffer.size(); i++)
+				m_updateBuffer[i]->EndUpdate();
+
+			m_updateBuffer.clear();
+		}
+
+	public:
+		inline BatchUpdater(SceneContext* context)
+			: m_context(context)
+			, m_threadBlock(SimulationThreadBlock::GetFor(context)) {
+			assert(m_context != nullptr);
+			m_context->OnUpdate() += Callback(&BatchUpdater::Update, this);
+		}
+
+		inline virtual ~BatchUpdater() {
+			m_context->OnUpdate() -= Callback(&BatchUpdater::Update, this);
+			assert(m_animators.empty());
+		}
+
+		static Reference<BatchUpdater> Instance(SceneContext* context) {
+			if (context == nullptr)
+				return nullptr;
+			struct Cache : public virtual ObjectCache<Reference<const Object>> {
+				static Reference<BatchUpdater> Get(SceneContext* ctx) {
+					static Cache cache;
+					static std::mutex creationLock;
+					std::unique_lock<std::mutex> lock(creationLock);
+					return cache.GetCachedOrCreate(ctx,
+						[&]() {
+							Reference<BatchUpdater> instance = Object::Instantiate<BatchUpdater>(ctx);
+							ctx->StoreDataObject(instance);
+							return instance;
+						});
+				}
+			};
+			return Cache::Get(context);
+		}
+
+		inline void AddAnimator(Animator* animator) {
+			std::unique_lock<std::mutex> lock(m_animatorLock);
+			m_animators.insert(animator);
+		}
+
+		inline void RemoveAnimator(Animator* animator) {
+			std::unique_lock<std::mutex> lock(m_animatorLock);
+			m_animators.erase(animator);
+		}
+
+		inline static void AddOrRemove(Animator* animator) {
+			BatchUpdater* updater = dynamic_cast<BatchUpdater*>(animator->m_updater.operator Jimara::Object * ());
+			if (updater == nullptr)
+				return;
+			else if ((!animator->Destroyed()) && animator->ActiveInHierarchy())
+				updater->AddAnimator(animator);
+			else updater->RemoveAnimator(animator);
+		}
+	};
+
+	Animator::Animator(Component* parent, const std::string_view& name) 
+		: Component(parent, name)
+		, m_updater(BatchUpdater::Instance(parent->Context())) {
 		OnDestroyed() += Callback(&Animator::OnComponentDead, this);
 		OnParentChanged() += Callback(&Animator::OnTransformHeirarchyChanged, this);
 	}
 
 	Animator::~Animator() {
+		{
+			BatchUpdater* updater = dynamic_cast<BatchUpdater*>(m_updater.operator Jimara::Object * ());
+			if (updater != nullptr)
+				updater->RemoveAnimator(this);
+			m_updater = nullptr;
+		}
 		OnParentChanged() -= Callback(&Animator::OnTransformHeirarchyChanged, this);
 		OnDestroyed() -= Callback(&Animator::OnComponentDead, this);
 		OnComponentDead(this);
@@ -262,31 +368,64 @@ namespace Jimara {
 		}
 	}
 
-	void Animator::Update() {
+	void Animator::OnComponentEnabled() {
+		BatchUpdater::AddOrRemove(this);
+	}
+
+	void Animator::OnComponentDisabled() {
+		BatchUpdater::AddOrRemove(this);
+	}
+
+
+
+	void Animator::BeginUpdate() {
 		if (Destroyed()) return;
 		Bind();
-		static thread_local std::vector<PlaybackState*> reactivatedStates;
-		reactivatedStates.clear();
+		m_reactivatedStates.clear();
 		for (auto it = m_reactivatedChannels.begin(); it != m_reactivatedChannels.end(); ++it)
 			if (((*it)->isPlaying) && size_t((*it) - m_channelStates.data()) < m_channelCount)
-				reactivatedStates.push_back(*it);
+				m_reactivatedStates.push_back(*it);
 		m_reactivatedChannels.clear();
-		ReactivateChannels(reactivatedStates);
-		Apply();
-		AdvanceTime(reactivatedStates);
-		DeactivateChannels();
-		reactivatedStates.clear();
+		ReactivateChannels(m_reactivatedStates);
 	}
 
+	void Animator::SamplePose() {
+		assert(m_pose.size() == m_flattenedFieldBindings.size());
+		const FieldBindingInfo* ptr = m_flattenedFieldBindings.data();
+		const FieldBindingInfo* const end = ptr + m_flattenedFieldBindings.size();
+		PoseValue* pose = m_pose.data();
+		while (ptr < end) {
+			if (ptr->sample != nullptr) {
+				if (ptr->activeBindingCount > 0u)
+					ptr->sample(ptr->bindings, ptr->activeBindingCount, *pose);
+				else pose->valid = false;
+			}
+			ptr++;
+			pose++;
+		}
+	}
 
+	void Animator::EndUpdate() {
+		if (!Destroyed()) {
+			Apply();
+			AdvanceTime(m_reactivatedStates);
+			DeactivateChannels();
+		}
+		m_reactivatedStates.clear();
+	}
 
 	void Animator::Apply() {
 		const FieldBindingInfo* ptr = m_flattenedFieldBindings.data();
 		const FieldBindingInfo* const end = ptr + m_flattenedFieldBindings.size();
+		const PoseValue* pose = m_pose.data();
 		while (ptr < end) {
-			if (ptr->activeBindingCount > 0u)
-				ptr->update(ptr->field, ptr->bindings, ptr->activeBindingCount);
+			if (ptr->activeBindingCount > 0u) {
+				if (ptr->apply != nullptr)
+					ptr->apply(ptr->field, *pose);
+				else ptr->update(ptr->field, ptr->bindings, ptr->activeBindingCount);
+			}
 			ptr++;
+			pose++;
 		}
 	}
 
@@ -338,6 +477,7 @@ namespace Jimara {
 		m_reactivatedChannels.clear();
 		m_activeTrackBindings.clear();
 		m_flattenedFieldBindings.clear();
+		m_pose.clear();
 		for (auto it = m_subscribedClips.begin(); it != m_subscribedClips.end(); ++it)
 			(*it)->OnDirty() -= Callback(&Animator::OnAnimationClipDirty, this);
 		m_subscribedClips.clear();
@@ -350,7 +490,12 @@ namespace Jimara {
 	}
 
 	struct Animator::BindingHelper {
-		typedef FieldUpdateFn(*GetUpdaterFn)(const Serialization::SerializedObject&);
+		struct FieldFunctions {
+			FieldUpdateFn update = nullptr;
+			FieldSampleFn sample = nullptr;
+			FieldApplyFn apply = nullptr;
+		};
+		typedef FieldFunctions(*GetUpdaterFn)(const Serialization::SerializedObject&);
 		typedef bool(*CheckTrackFn)(const AnimationTrack*);
 
 		inline static Vector3 LerpAngles(const Vector3& a, const Vector3& b, float t) {
@@ -373,6 +518,20 @@ namespace Jimara {
 
 		inline static float LerpAngles(float a, float b, float t) { return Math::LerpAngles(a, b, t); }
 
+		inline static void ToPose(float value, PoseValue& pose) { pose.value = Vector3(value, 0.0f, 0.0f); }
+		inline static void ToPose(const Vector3& value, PoseValue& pose) { pose.value = value; }
+		inline static void FromPose(const PoseValue& pose, float& value) { value = pose.value.x; }
+		inline static void FromPose(const PoseValue& pose, Vector3& value) { value = pose.value; }
+
+		template<typename Type>
+		inline static bool CurveValue(const TrackBinding& trackBinding, float time, Type& value) {
+			if (trackBinding.baked != nullptr && trackBinding.baked->Sample(time, value)) return true;
+			const ParametricCurve<Type, float>* const curve = dynamic_cast<const ParametricCurve<Type, float>*>(trackBinding.track);
+			if (curve == nullptr) return false;
+			value = curve->Value(time);
+			return true;
+		}
+
 		template<typename ValueType>
 		struct InterpolationState {
 			ValueType value = {};
@@ -384,12 +543,12 @@ namespace Jimara {
 
 			template<typename Type>
 			inline bool AddValue(const TrackBinding& trackBinding) {
-				const ParametricCurve<Type, float>* const curve = dynamic_cast<const ParametricCurve<Type, float>*>(trackBinding.track);
-				if (curve == nullptr) return false;
 				const float weight = trackBinding.state->weight;
 				if (weight <= 0.0f) return false;
+				Type curveValue;
+				if (!CurveValue(trackBinding, trackBinding.state->time, curveValue)) return false;
 #pragma warning(disable: 26451)
-				value += ValueType(curve->Value(trackBinding.state->time) * weight);
+				value += ValueType(curveValue * weight);
 #pragma warning(default: 26451)
 				totalWeight += weight;
 				return true;
@@ -413,16 +572,33 @@ namespace Jimara {
 				}
 			}
 
+			template<typename... CastableTypes>
+			inline static void SamplePose(const Animator::TrackBinding* start, size_t count, PoseValue& pose) {
+				InterpolationState state;
+				const Animator::TrackBinding* const end = start + count;
+				for (const Animator::TrackBinding* ptr = start; ptr < end; ptr++)
+					state.AddValue<ValueType, CastableTypes...>(*ptr);
+				pose.valid = (state.totalWeight > 0.0f);
+				if (pose.valid)
+					ToPose(ValueType(state.value / state.totalWeight), pose);
+			}
+
+			inline static void ApplyPose(const Animator::SerializedField& field, const PoseValue& pose) {
+				if (!pose.valid) return;
+				ValueType value;
+				FromPose(pose, value);
+				SetValue(field, value);
+			}
+
 			template<typename Type>
 			inline bool AddValueEuler(const TrackBinding& trackBinding) {
-				const ParametricCurve<Type, float>* const curve = dynamic_cast<const ParametricCurve<Type, float>*>(trackBinding.track);
-				if (curve == nullptr) return false;
 				const float blendWeight = trackBinding.state->weight;
 				if (blendWeight <= 0.0f) return false;
+				Type curveValue;
+				if (!CurveValue(trackBinding, trackBinding.state->time, curveValue)) return false;
 				totalWeight += blendWeight;
 				const float relativeWeight = blendWeight / totalWeight;
-				const Type curveValue = ValueType(curve->Value(trackBinding.state->time));
-				value = LerpAngles(value, curveValue, relativeWeight);
+				value = LerpAngles(value, ValueType(curveValue), relativeWeight);
 				return true;
 			}
 
@@ -442,11 +618,22 @@ namespace Jimara {
 					SetValue(field, state.value);
 			}
 
+			template<typename... CastableTypes>
+			inline static void SamplePoseEuler(const Animator::TrackBinding* start, size_t count, PoseValue& pose) {
+				InterpolationState state;
+				const Animator::TrackBinding* const end = start + count;
+				for (const Animator::TrackBinding* ptr = start; ptr < end; ptr++)
+					state.AddValueEuler<ValueType, CastableTypes...>(*ptr);
+				pose.valid = (state.totalWeight > 0.0f);
+				if (pose.valid)
+					ToPose(state.value, pose);
+			}
+
 			template<typename Type>
 			inline static bool SetValue(const Animator::SerializedField& field, const TrackBinding& trackBinding) {
-				const ParametricCurve<Type, float>* const curve = dynamic_cast<const ParametricCurve<Type, float>*>(trackBinding.track);
-				if (curve == nullptr) return false;
-				SetValue(field, curve->Value(trackBinding.state->time));
+				Type curveValue;
+				if (!CurveValue(trackBinding, trackBinding.state->time, curveValue)) return false;
+				SetValue(field, curveValue);
 				return true;
 			}
 
@@ -474,8 +661,10 @@ namespace Jimara {
 				std::is_same_v<ValueType, wchar_t> ||
 				std::is_same_v<ValueType, std::string_view> ||
 				std::is_same_v<ValueType, std::wstring_view>
-				, FieldUpdateFn> GetUpdateFn(const Serialization::SerializedObject&) {
-				return InterpolationState<ValueType>::template SetFirst<CastableTypes...>;
+				, FieldFunctions> GetUpdateFn(const Serialization::SerializedObject&) {
+				FieldFunctions functions;
+				functions.update = InterpolationState<ValueType>::template SetFirst<CastableTypes...>;
+				return functions;
 			}
 
 			template<typename ValueType, typename... CastableTypes>
@@ -494,18 +683,28 @@ namespace Jimara {
 				std::is_same_v<ValueType, Matrix2> ||
 				std::is_same_v<ValueType, Matrix3> ||
 				std::is_same_v<ValueType, Matrix4>
-				, FieldUpdateFn> GetUpdateFn(const Serialization::SerializedObject&) {
-				return InterpolationState<ValueType>::template Interpolate<CastableTypes...>;
+				, FieldFunctions> GetUpdateFn(const Serialization::SerializedObject&) {
+				FieldFunctions functions;
+				functions.update = InterpolationState<ValueType>::template Interpolate<CastableTypes...>;
+				return functions;
 			}
 
 			template<typename ValueType, typename... CastableTypes>
 			inline static std::enable_if_t<
 				std::is_same_v<ValueType, float> ||
 				std::is_same_v<ValueType, Vector3>
-				, FieldUpdateFn> GetUpdateFn(const Serialization::SerializedObject& object) {
-				if (object.Serializer()->FindAttributeOfType<Serialization::EulerAnglesAttribute>() != nullptr)
-					return InterpolationState<ValueType>::template InterpolateEuler<CastableTypes...>;
-				else return InterpolationState<ValueType>::template Interpolate<CastableTypes...>;
+				, FieldFunctions> GetUpdateFn(const Serialization::SerializedObject& object) {
+				FieldFunctions functions;
+				if (object.Serializer()->FindAttributeOfType<Serialization::EulerAnglesAttribute>() != nullptr) {
+					functions.update = InterpolationState<ValueType>::template InterpolateEuler<CastableTypes...>;
+					functions.sample = InterpolationState<ValueType>::template SamplePoseEuler<CastableTypes...>;
+				}
+				else {
+					functions.update = InterpolationState<ValueType>::template Interpolate<CastableTypes...>;
+					functions.sample = InterpolationState<ValueType>::template SamplePose<CastableTypes...>;
+				}
+				functions.apply = InterpolationState<ValueType>::ApplyPose;
+				return functions;
 			}
 		};
 
@@ -524,7 +723,7 @@ namespace Jimara {
 			return std::make_pair(InterpolationFunctions::GetUpdateFn<ValueType, CastableTypes...>, IsCurveOfType<ValueType, CastableTypes...>);
 		}
 
-		inline static FieldUpdateFn GetUpdateFn(const Serialization::SerializedObject& serializedField, const AnimationClip::Track* track) {
+		inline static FieldFunctions GetFieldFunctions(const Serialization::SerializedObject& serializedField, const AnimationClip::Track* track) {
 			static const std::pair<GetUpdaterFn, CheckTrackFn>* APPLY_FUNCTIONS = []() -> const std::pair<GetUpdaterFn, CheckTrackFn>*{
 				static const constexpr size_t FUNCTION_COUNT = static_cast<size_t>(Serialization::ItemSerializer::Type::SERIALIZER_TYPE_COUNT);
 				static std::pair<GetUpdaterFn, CheckTrackFn> functions[FUNCTION_COUNT];
@@ -556,19 +755,19 @@ namespace Jimara {
 				return functions;
 			}();
 
-			if (track == nullptr) return nullptr;
-			else if (track->TargetField() != serializedField.Serializer()->TargetName()) return nullptr;
+			if (track == nullptr) return {};
+			else if (track->TargetField() != serializedField.Serializer()->TargetName()) return {};
 
 			const Serialization::ItemSerializer* serializer = serializedField.Serializer();
-			if (serializer == nullptr) return nullptr;
+			if (serializer == nullptr) return {};
 
 			const Serialization::ItemSerializer::Type type = serializer->GetType();
-			if (type >= Serialization::ItemSerializer::Type::SERIALIZER_TYPE_COUNT) return nullptr;
+			if (type >= Serialization::ItemSerializer::Type::SERIALIZER_TYPE_COUNT) return {};
 
 			const std::pair<GetUpdaterFn, CheckTrackFn>& applyFn = APPLY_FUNCTIONS[static_cast<size_t>(type)];
 			if (applyFn.second(track))
 				return applyFn.first(serializedField);
-			else return nullptr;
+			else return {};
 		}
 
 		
@@ -621,31 +820,35 @@ namespace Jimara {
 					if (playbackState.weight <= 0.0f)
 						continue;
 					const AnimationTrack* const track = ptr->track;
-					const ParametricCurve<Vector3, float>* curve = dynamic_cast<const ParametricCurve<Vector3, float>*>(track);
+					auto curveValue = [&](float time) {
+						Vector3 value = Vector3(0.0f);
+						CurveValue(*ptr, time, value);
+						return value;
+					};
 
 					Vector3 localDelta;
 					const float animationDuration = std::abs(track->Duration());
-					const Vector3 startPos = curve->Value(playbackState.time);
+					const Vector3 startPos = curveValue(playbackState.time);
 					if (animationDuration > std::numeric_limits<float>::epsilon()) {
 						const float trackDeltaTime = animatorDeltaTime * playbackState.speed;
 						assert(playbackState.time >= 0.0f);
 						const float nextTime = playbackState.time + trackDeltaTime;
 						auto loopedDistance = [&](auto loopT) {
 							return
-								((curve->Value(animationDuration) - curve->Value(0.0f)) * (trackDeltaTime / animationDuration)) +
-								(curve->Value(Math::FloatRemainder(nextTime, animationDuration)) - curve->Value(loopT));
+								((curveValue(animationDuration) - curveValue(0.0f)) * (trackDeltaTime / animationDuration)) +
+								(curveValue(Math::FloatRemainder(nextTime, animationDuration)) - curveValue(loopT));
 						};
 						if (nextTime < 0) {
 							if (playbackState.loop)
 								localDelta = loopedDistance(animationDuration);
-							else localDelta = curve->Value(0.0f) - startPos;
+							else localDelta = curveValue(0.0f) - startPos;
 						}
 						else if (nextTime > animationDuration) {
 							if (playbackState.loop)
 								localDelta = loopedDistance(0.0f);
-							else localDelta = curve->Value(animationDuration) - startPos;
+							else localDelta = curveValue(animationDuration) - startPos;
 						}
-						else localDelta = curve->Value(nextTime) - startPos;
+						else localDelta = curveValue(nextTime) - startPos;
 					}
 					else localDelta = Vector3(0.0f);
 
@@ -727,9 +930,13 @@ namespace Jimara {
 				for (const TrackBinding* ptr = start; ptr < end; ptr++) {
 					const PlaybackState& playbackState = *ptr->state;
 					const AnimationTrack* const track = ptr->track;
-					const ParametricCurve<Vector3, float>* curve = dynamic_cast<const ParametricCurve<Vector3, float>*>(track);
 					if (playbackState.weight <= 0.0f)
 						continue;
+					auto curveValue = [&](float time) {
+						Vector3 value = Vector3(0.0f);
+						CurveValue(*ptr, time, value);
+						return value;
+					};
 
 					const float animationDuration = std::abs(track->Duration());
 					const float trackDeltaTime = animatorDeltaTime * playbackState.speed;
@@ -740,8 +947,8 @@ namespace Jimara {
 
 					weightSoFar += playbackState.weight;
 					const float weightFraction = (playbackState.weight / weightSoFar);
-					startAngle = LerpAngles(startAngle, curve->Value(playbackState.time), weightFraction);
-					endAngle = LerpAngles(endAngle, curve->Value(nextTime), weightFraction);
+					startAngle = LerpAngles(startAngle, curveValue(playbackState.time), weightFraction);
+					endAngle = LerpAngles(endAngle, curveValue(nextTime), weightFraction);
 				}
 				if (weightSoFar <= 0.0f)
 					return;
@@ -804,6 +1011,7 @@ namespace Jimara {
 		for (size_t channelId = 0u; channelId < m_channelCount; channelId++) {
 			PlaybackState& channelState = m_channelStates[channelId];
 			AnimationClip* const clip = channelState.clip;
+			channelState.baked = (clip == nullptr) ? nullptr : clip->Baked();
 			if (clip == nullptr)
 				continue;
 			if (m_subscribedClips.find(clip) == m_subscribedClips.end()) {
@@ -823,13 +1031,13 @@ namespace Jimara {
 				
 				// Find target serialized field:
 				SerializedField serializedObject;
-				FieldUpdateFn updateFn = nullptr;
+				BindingHelper::FieldFunctions fieldFunctions;
 				{
 					if (animatedComponent == RootMotionSource() && 
 						dynamic_cast<const ParametricCurve<Vector3, float>*>(track) != nullptr) {
 						auto setUpdateFn = [&](FieldUpdateFn fn, const SerializedField& field) {
 							serializedObject = field;
-							updateFn = fn;
+							fieldFunctions.update = fn;
 						};
 						if (track->TargetField() == "Position")
 							setUpdateFn(BindingHelper::RootMotion::MovementUpdater, BindingHelper::RootMotion::MovementField(this));
@@ -839,8 +1047,8 @@ namespace Jimara {
 					if (serializedObject.serializer == nullptr) {
 						auto processField = [&](const Serialization::SerializedObject& serializedField) {
 							if (serializedField.Serializer() == nullptr || serializedObject.serializer != nullptr) return;
-							updateFn = BindingHelper::GetUpdateFn(serializedField, track);
-							if (updateFn == nullptr) return;
+							fieldFunctions = BindingHelper::GetFieldFunctions(serializedField, track);
+							if (fieldFunctions.update == nullptr) return;
 							serializedObject.serializer = serializedField.Serializer();
 							serializedObject.targetAddr = serializedField.TargetAddr();
 						};
@@ -859,8 +1067,15 @@ namespace Jimara {
 
 				// Add bindings:
 				FieldBinding& binding = fieldBindings[serializedObject];
-				binding.update = updateFn;
-				binding.tracks[&channelState].Push(track);
+				binding.update = fieldFunctions.update;
+				binding.sample = fieldFunctions.sample;
+				binding.apply = fieldFunctions.apply;
+				TrackBinding trackBinding = {};
+				trackBinding.track = track;
+				trackBinding.state = &channelState;
+				if (channelState.baked != nullptr && trackId < channelState.baked->TrackCount() && channelState.baked->GetTrack(trackId).Baked())
+					trackBinding.baked = &channelState.baked->GetTrack(trackId);
+				binding.tracks[&channelState].Push(trackBinding);
 				binding.bindingCount++;
 			}
 		}
@@ -882,6 +1097,8 @@ namespace Jimara {
 					FieldBindingInfo info = {};
 					info.field = fieldIt->first;
 					info.update = fieldIt->second.update;
+					info.sample = fieldIt->second.sample;
+					info.apply = fieldIt->second.apply;
 					info.tracks = &fieldIt->second.tracks;
 					info.bindings = bindingPtr;
 					info.activeBindingCount = 0u;
@@ -890,6 +1107,8 @@ namespace Jimara {
 					m_flattenedFieldBindings.push_back(info);
 				}
 			}
+			m_pose.clear();
+			m_pose.resize(m_flattenedFieldBindings.size());
 		}
 		m_bound = true;
 	}
@@ -909,10 +1128,11 @@ namespace Jimara {
 				if (tracks == info.tracks->end())
 					continue;
 
-				const AnimationTrack* const* trackIt = tracks->second.Data();
-				const AnimationTrack* const* const trackEnd = trackIt + tracks->second.Size();
+				const TrackBinding* trackIt = tracks->second.Data();
+				const TrackBinding* const trackEnd = trackIt + tracks->second.Size();
 				while (trackIt < trackEnd) {
-					const AnimationTrack* const track = *trackIt;
+					const TrackBinding& trackBinding = *trackIt;
+					const AnimationTrack* const track = trackBinding.track;
 					trackIt++;
 
 					// Find insertion index:
@@ -931,7 +1151,7 @@ namespace Jimara {
 					// Insert track record:
 					for (size_t index = info.activeBindingCount; index > insertionIndex; index--)
 						info.bindings[index] = info.bindings[index - 1u];
-					info.bindings[insertionIndex] = { track, state };
+					info.bindings[insertionIndex] = trackBinding;
 					info.activeBindingCount++;
 				}
 
@@ -10,8 +10,14 @@ namespace Jimara {
 
 	/// <summary>
 	/// Component, responsible for AnimationClip playback
+	/// <para/> Animators are not updated individually; instead, all active animators within the scene context are evaluated as a batch
+	/// from SceneContext::OnUpdate() (ie after all UpdatingComponents got updated and before the next physics synch point):
+	/// <para/>		0. Bindings and channel activation are refreshed for each animator on the main update thread;
+	/// <para/>		1. Float and Vector3 field values are sampled and blended into per-animator pose buffers in parallel, on the SimulationThreadBlock;
+	/// <para/>		2. Pose buffers and the remaining bindings (root motion included) are applied to the target fields in a single serial pass.
+	/// <para/> Root motion velocities, written during the last step, are consumed by the physics synch point on the next frame.
 	/// </summary>
-	class JIMARA_API Animator : public virtual Scene::LogicContext::UpdatingComponent {
+	class JIMARA_API Animator : public virtual Component {
 	public:
 		/// <summary>
 		/// Constructor
@@ -218,8 +224,11 @@ namespace Jimara {
 
 
 	protected:
-		/// <summary> Engine logic Update callback (should not be invoked by hand) </summary>
-		virtual void Update()override;
+		/// <summary> Invoked, whenever the component becomes active in hierarchy </summary>
+		virtual void OnComponentEnabled()override;
+
+		/// <summary> Invoked, whenever the component stops being active in hierarchy </summary>
+		virtual void OnComponentDisabled()override;
 
 	private:
 		// True, if the fields are mapped with the target objects
@@ -236,6 +245,7 @@ namespace Jimara {
 			bool loop = false;
 			bool isPlaying = false;
 			Reference<AnimationClip> clip;
+			Reference<const BakedAnimationClip> baked;
 		};
 
 		// New clip states:
@@ -268,17 +278,32 @@ namespace Jimara {
 		struct TrackBinding {
 			const AnimationTrack* track = nullptr;
 			const PlaybackState* state = nullptr;
+			const BakedAnimationClip::Track* baked = nullptr;
 		};
 
 		// Generic field update function
 		typedef void(*FieldUpdateFn)(const SerializedField&, const TrackBinding*, size_t);
 
+		// Sampled (blended) field value, stored within the pose buffer
+		struct PoseValue {
+			Vector3 value = Vector3(0.0f);
+			bool valid = false;
+		};
+
+		// Samples blended field value (has to be thread-safe; invoked from the parallel sampling pass)
+		typedef void(*FieldSampleFn)(const TrackBinding*, size_t, PoseValue&);
+
+		// Applies sampled value to the field (invoked from the serial apply pass)
+		typedef void(*FieldApplyFn)(const SerializedField&, const PoseValue&);
+
 		// TrackBinding objects for SerializedField
 		struct FieldBinding {
-			using PerChannelTracks = std::map<const PlaybackState*, Stacktor<const AnimationTrack*, 1u>>;
+			using PerChannelTracks = std::map<const PlaybackState*, Stacktor<TrackBinding, 1u>>;
 			PerChannelTracks tracks;
 			size_t bindingCount = 0u;
 			FieldUpdateFn update = Unused<const SerializedField&, const TrackBinding*, size_t>;
+			FieldSampleFn sample = nullptr;
+			FieldApplyFn apply = nullptr;
 		};
 
 		// Binding information storage
@@ -292,6 +317,9 @@ namespace Jimara {
 		struct FieldBindingInfo {
 			SerializedField field;
 			FieldUpdateFn update = nullptr;
+			// If sample and apply functions are present, update is not used and the field goes through the pose buffer instead
+			FieldSampleFn sample = nullptr;
+			FieldApplyFn apply = nullptr;
 			// Bindings is always a concatenation of: [Active Track Bindings sorted in ascending order by ClipPlaybackState] [Some preallocation you do not need to worry about]
 			TrackBinding* bindings = nullptr;
 			size_t activeBindingCount = 0u;
@@ -299,12 +327,31 @@ namespace Jimara {
 			const FieldBinding::PerChannelTracks* tracks = nullptr;
 		};
 		std::vector<FieldBindingInfo> m_flattenedFieldBindings;
+
+		// Pose buffer (one entry per m_flattenedFieldBindings element)
+		std::vector<PoseValue> m_pose;
+
+		// Channels, reactivated during the current update
+		std::vector<PlaybackState*> m_reactivatedStates;
+
+		// Per-context batch updater
+		Reference<Object> m_updater;
 		
 		// Some internal functions and helpers are stored here...
 		struct BindingHelper;
 		struct SerializedPlayState;
+		struct BatchUpdater;
+
+		// Batch update, step 0: Binds fields and activates reactivated channels (main thread)
+		void BeginUpdate();
+
+		// Batch update, step 1: Samples pose buffer (thread-safe between different animators)
+		void SamplePose();
+
+		// Batch update, step 2: Applies the pose buffer, invokes update() function for the remaining FieldBinding objects and advances time (main thread)
+		void EndUpdate();
 
-		// Invokes update() function for all FieldBinding objects
+		// Applies the pose buffer and invokes update() function for all the remaining FieldBinding objects
 		void Apply();
 
 		// Increments AnimationTime-s for each ClipPlaybackState and prunes finished animations
@@ -333,6 +380,6 @@ namespace Jimara {
 	JIMARA_DEFINE_ENUMERATION_BOOLEAN_OPERATIONS(Animator::RootMotionFlags);
 
 	// Type detail callbacks
-	template<> inline void TypeIdDetails::GetParentTypesOf<Animator>(const Callback<TypeId>& report) { report(TypeId::Of<Scene::LogicContext::UpdatingComponent>()); }
+	template<> inline void TypeIdDetails::GetParentTypesOf<Animator>(const Callback<TypeId>& report) { report(TypeId::Of<Component>()); }
 	template<> JIMARA_API void TypeIdDetails::GetTypeAttributesOf<Animator>(const Callback<const Object*>& report);
 }
@@ -73,14 +73,9 @@ namespace Jimara {
 	}
 
 	bool Component::ActiveInHierarchy()const {
-		if (Destroyed()) return false;
-		const Component* component = this;
-		const Component* sceneRootObject = Context()->RootObject();
-		while (component != nullptr && component != sceneRootObject) {
-			if (!component->Enabled()) return false;
-			component = component->Parent();
-		}
-		return true;
+		const uint8_t flags = m_flags.load();
+		return (flags & (static_cast<uint8_t>(Flags::DESTROYED) | static_cast<uint8_t>(Flags::ACTIVE_IN_HIERARCHY)))
+			== static_cast<uint8_t>(Flags::ACTIVE_IN_HIERARCHY);
 	}
 
 	SceneContext* Component::Context()const { return m_context; }
@@ -102,6 +97,36 @@ namespace Jimara {
 	Component* Component::Parent()const { return m_parent; }
 
 	namespace {
+		// Hierarchy change, requested from a parallel update phase (see SceneContext::ExecuteDeferred()):
+		struct DeferredHierarchyChange : public virtual Object {
+			Reference<Component> component;
+			Reference<Component> parent;
+			size_t index = 0u;
+
+			inline static void SetParent(Object* changePtr) {
+				DeferredHierarchyChange* const change = dynamic_cast<DeferredHierarchyChange*>(changePtr);
+				change->component->SetParent(change->parent);
+			}
+
+			inline static void SetIndexInParent(Object* changePtr) {
+				DeferredHierarchyChange* const change = dynamic_cast<DeferredHierarchyChange*>(changePtr);
+				change->component->SetIndexInParent(change->index);
+			}
+
+			inline static void Destroy(Object* changePtr) {
+				DeferredHierarchyChange* const change = dynamic_cast<DeferredHierarchyChange*>(changePtr);
+				change->component->Destroy();
+			}
+
+			inline static void Schedule(Component* component, Component* parent, size_t index, void(*apply)(Object*)) {
+				const Reference<DeferredHierarchyChange> change = Object::Instantiate<DeferredHierarchyChange>();
+				change->component = component;
+				change->parent = parent;
+				change->index = index;
+				component->Context()->ExecuteDeferred(Callback<Object*>(apply), change);
+			}
+		};
+
 		template<typename SetChildIdFn>
 		inline static void EraseChildAt(std::vector<Component*>& children, size_t childId, SetChildIdFn setChildId) {
 #ifndef NDEBUG
@@ -118,6 +143,12 @@ namespace Jimara {
 	}
 
 	void Component::SetParent(Component* newParent) {
+		// Child lists are shared with the other components, so parallel updates can not modify them directly:
+		if (m_context->InParallelUpdate()) {
+			DeferredHierarchyChange::Schedule(this, newParent, 0u, DeferredHierarchyChange::SetParent);
+			return;
+		}
+
 		// First, let us make sure, we don't end up orphaned after this operation:
 		if (newParent == nullptr) newParent = RootObject();
 		if (m_parent == newParent || newParent == this) return;
@@ -165,6 +196,7 @@ namespace Jimara {
 		else m_childId = 0;
 
 		// Inform heirarchy change listeners:
+		Transform::HierarchyChanged(this);
 		m_context->ComponentStateDirty(this, true);
 		{
 			ParentChangeInfo parentChangeInfo;
@@ -178,6 +210,10 @@ namespace Jimara {
 	size_t Component::IndexInParent()const { return m_childId; }
 
 	void Component::SetIndexInParent(size_t index) {
+		if (m_context->InParallelUpdate()) {
+			DeferredHierarchyChange::Schedule(this, nullptr, index, DeferredHierarchyChange::SetIndexInParent);
+			return;
+		}
 		if (Parent() == nullptr) return;
 		std::vector<Component*>& children = (((Component*)m_parent)->m_children);
 #ifndef NDEBUG
@@ -215,6 +251,10 @@ namespace Jimara {
 	Component* Component::GetChild(size_t index)const { return m_children[index]; }
 
 	void Component::SortChildren(const Function<bool, Component*, Component*>& less) {
+		if (m_context->InParallelUpdate()) {
+			Context()->Log()->Error("Component::SortChildren - Can not sort children from within a parallel update!");
+			return;
+		}
 		std::sort(m_children.begin(), m_children.end(), [&](const Reference<Component>& a, const Reference<Component>& b) -> bool { return less(a, b); });
 		for (size_t i = 0; i < m_children.size(); i++)
 			m_children[i]->m_childId.store(i);
@@ -227,6 +267,11 @@ namespace Jimara {
 	const Transform* Component::GetTransform()const { return GetComponentInParents<Transform>(); }
 
 	void Component::Destroy() {
+		if (m_context->InParallelUpdate()) {
+			DeferredHierarchyChange::Schedule(this, nullptr, 0u, DeferredHierarchyChange::Destroy);
+			return;
+		}
+
 		// Let us ignore this call if the component is already destroyed...
 		if (Destroyed()) {
 			Context()->Log()->Error("Component::Destroy - Attempting to doubly destroy a component!");
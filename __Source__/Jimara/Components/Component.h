@@ -155,7 +155,8 @@ namespace Jimara {
 		/// True, if the component is active in hierarchy
 		/// Notes: 
 		///		0. Enabled() means that the component is marked as 'Enabled'; ActiveInHierarchy() tells if the component and every link inside it's parent chain is active;
-		///		1. State of the root object is ignored by the internal logic, so disabling it will not change anything.
+		///		1. State of the root object is ignored by the internal logic, so disabling it will not change anything;
+		///		2. The state is cached and gets refreshed for the whole subtree on SetEnabled() and SetParent() calls, so the query itself is O(1).
 		/// </summary>
 		bool ActiveInHierarchy()const;
 
@@ -173,6 +174,8 @@ namespace Jimara {
 
 		/// <summary>
 		/// Sets new parent component
+		/// <para/> Note: If invoked from within a parallel-safe UpdatingComponent::Update(), the change is applied at the end of the parallel phase
+		///		(see SceneContext::ExecuteDeferred()); This includes the components created with a parent during the parallel phase.
 		/// </summary>
 		/// <param name="newParent"> New parent object to set (nullptr means the same as RootObject()) </param>
 		virtual void SetParent(Component* newParent);
@@ -182,6 +185,7 @@ namespace Jimara {
 
 		/// <summary>
 		/// Moves self in the parent's child list
+		/// <para/> Note: If invoked from within a parallel-safe UpdatingComponent::Update(), the change is applied at the end of the parallel phase.
 		/// </summary>
 		/// <param name="index"> Desired child index in parent </param>
 		void SetIndexInParent(size_t index);
@@ -201,6 +205,7 @@ namespace Jimara {
 
 		/// <summary>
 		/// Sorts child components
+		/// <para/> Note: Not supported from within a parallel-safe UpdatingComponent::Update() (an error is logged and the children stay unsorted).
 		/// </summary>
 		/// <param name="less"> 'Less' function </param>
 		void SortChildren(const Function<bool, Component*, Component*>& less);
@@ -234,7 +239,8 @@ namespace Jimara {
 		///		0. This call triggers OnDestroyed() on all affected objects;
 		///		1. Even if the code is meant to treat destroyed components as objects that no longer exist, 
 		///		regular old reference counting still applies and, therefore, the user should be wary of the circular references
-		///		and other memory-leak causing structures... Our framework is not magic and C++ has no inherent garbage collector :)
+		///		and other memory-leak causing structures... Our framework is not magic and C++ has no inherent garbage collector :);
+		///		2. If invoked from within a parallel-safe UpdatingComponent::Update(), the destruction happens at the end of the parallel phase.
 		/// </summary>
 		void Destroy();
 
@@ -469,9 +475,10 @@ namespace Jimara {
 		enum class Flags : uint8_t {
 			ENABLED = 1 << 0,
 			DESTROYED = 1 << 1,
-			STARTED = 1 << 2
+			STARTED = 1 << 2,
+			ACTIVE_IN_HIERARCHY = 1 << 3
 		};
-		std::atomic<uint8_t> m_flags = static_cast<uint8_t>(Flags::ENABLED);
+		std::atomic<uint8_t> m_flags = static_cast<uint8_t>(Flags::ENABLED) | static_cast<uint8_t>(Flags::ACTIVE_IN_HIERARCHY);
 
 		// Parent component (never nullptr)
 		std::atomic<Component*> m_parent;
@@ -158,30 +158,12 @@ namespace Jimara {
 				};
 				fixColliderList();
 
-				typedef void(*UpdateColliderStateFn)(ThreadBlock::ThreadInfo, void*);
-				static const UpdateColliderStateFn updateColliderStates = [](ThreadBlock::ThreadInfo info, void* selfPtr) {
-					ColliderSynchJob* const self = (ColliderSynchJob*)selfPtr;
-					const size_t totalColliderCount = self->m_activeColliders.size();
-					const size_t entriesPerThread = (self->m_activeColliders.size() + info.threadCount - 1u) / info.threadCount;
-					ActiveCollider* const firstCollider = self->m_activeColliders.data() + (entriesPerThread * info.threadId);
-					ActiveCollider* const lastCollider = self->m_activeColliders.data() +
-						Math::Min(entriesPerThread * (info.threadId + 1u), totalColliderCount);
-					for (ActiveCollider* ptr = firstCollider; ptr < lastCollider; ptr++) {
-						assert(!ptr->collider->Destroyed());
-						ptr->state = UpdateComponentState(ptr->collider);
-					}
-				};
-
 				static const constexpr size_t minCollidersPerThread = 32u;
-				const size_t threadCount = Math::Min(
-					(m_activeColliders.size() + minCollidersPerThread - 1u) / minCollidersPerThread, m_threadBlock->DefaultThreadCount());
-				if (threadCount <= 1u) {
-					ThreadBlock::ThreadInfo info = {};
-					info.threadCount = 1u;
-					info.threadId = 0u;
-					updateColliderStates(info, (void*)this);
-				}
-				else m_threadBlock->Execute(threadCount, (void*)this, Callback<ThreadBlock::ThreadInfo, void*>(updateColliderStates));
+				m_threadBlock->ParallelFor(0u, m_activeColliders.size(), minCollidersPerThread, [&](size_t colliderId) {
+					ActiveCollider& collider = m_activeColliders[colliderId];
+					assert(!collider.collider->Destroyed());
+					collider.state = UpdateComponentState(collider.collider);
+					});
 
 				{
 					const ActiveCollider* const end = m_activeColliders.data() + m_activeColliders.size();
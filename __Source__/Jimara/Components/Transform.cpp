@@ -1,16 +1,289 @@
 #include "Transform.h"
+#include "../Environment/LogicSimulation/SimulationThreadBlock.h"
 #include "../Data/Serialization/Attributes/EulerAnglesAttribute.h"
 #include "../Data/Serialization/Helpers/SerializerMacros.h"
 
 
 namespace Jimara {
+	struct Transform::Helpers {
+		static const constexpr uint8_t LOCAL_DIRTY = static_cast<uint8_t>(MatrixFlags::LOCAL_DIRTY);
+		static const constexpr uint8_t WORLD_DIRTY = static_cast<uint8_t>(MatrixFlags::WORLD_DIRTY);
+		static const constexpr uint8_t PARENT_DIRTY = static_cast<uint8_t>(MatrixFlags::PARENT_DIRTY);
+		static const constexpr uint8_t ALL_DIRTY = (LOCAL_DIRTY | WORLD_DIRTY | PARENT_DIRTY);
+		static const constexpr size_t NO_INDEX = ~size_t(0u);
+
+		inline static const Transform* ParentTransform(const Transform* self) {
+			if ((self->m_matrixFlags.load() & PARENT_DIRTY) != 0u) {
+				// SetFlags() takes the same lock, so the flag can not be set in between the parent lookup and the flag being cleared:
+				std::unique_lock<SpinLock> lock(self->m_matrixLock);
+				if ((self->m_matrixFlags.load() & PARENT_DIRTY) != 0u) {
+					self->m_matrixFlags &= static_cast<uint8_t>(~PARENT_DIRTY);
+					self->m_parentTransform = self->GetComponentInParents<Transform>(false);
+				}
+			}
+			return self->m_parentTransform.load();
+		}
+
+		// Note: m_matrixLock has to be locked
+		inline static void ComputeLocalMatrices(const Transform* self) {
+			Matrix4 matrix = Math::MatrixFromEulerAngles(self->m_localEulerAngles);
+			self->m_localRotationMatrix = matrix;
+			matrix[0u] *= self->m_localScale.x;
+			matrix[1u] *= self->m_localScale.y;
+			matrix[2u] *= self->m_localScale.z;
+			matrix[3u] = Vector4(self->m_localPosition, 1.0f);
+			self->m_localMatrix = matrix;
+		}
+
+		inline static void UpdateLocalMatrices(const Transform* self) {
+			if ((self->m_matrixFlags.load() & LOCAL_DIRTY) == 0u) return;
+			std::unique_lock<SpinLock> lock(self->m_matrixLock);
+			if ((self->m_matrixFlags.load() & LOCAL_DIRTY) == 0u) return;
+			ComputeLocalMatrices(self);
+			self->m_matrixFlags &= static_cast<uint8_t>(~LOCAL_DIRTY);
+		}
+
+		// Note: parent world matrices have to be up to date
+		inline static void UpdateWorldMatrices(const Transform* self, const Transform* parent) {
+			std::unique_lock<SpinLock> lock(self->m_matrixLock);
+			const uint8_t flags = self->m_matrixFlags.load();
+			if ((flags & WORLD_DIRTY) == 0u) return;
+			if ((flags & LOCAL_DIRTY) != 0u)
+				ComputeLocalMatrices(self);
+			if (parent == nullptr) {
+				self->m_worldMatrix = self->m_localMatrix;
+				self->m_worldRotationMatrix = self->m_localRotationMatrix;
+			}
+			else {
+				self->m_worldMatrix = parent->m_worldMatrix * self->m_localMatrix;
+				self->m_worldRotationMatrix = parent->m_worldRotationMatrix * self->m_localRotationMatrix;
+			}
+			self->m_matrixFlags &= static_cast<uint8_t>(~(LOCAL_DIRTY | WORLD_DIRTY));
+		}
+
+		inline static void UpdateWorldMatrices(const Transform* self) {
+			if ((self->m_matrixFlags.load() & WORLD_DIRTY) == 0u) return;
+			static thread_local Stacktor<const Transform*, 4u> matrixChain;
+			assert(matrixChain.Size() == 0u);
+
+			// Collect dirty parent chain (clean transforms can not have dirty parents):
+			const Transform* parent = self;
+			while (parent != nullptr && (parent->m_matrixFlags.load() & WORLD_DIRTY) != 0u) {
+				matrixChain.Push(parent);
+				parent = ParentTransform(parent);
+			}
+
+			// Calculate parent-to-child:
+			const Transform* const* ptr = matrixChain.Data() + matrixChain.Size();
+			while (ptr > matrixChain.Data()) {
+				ptr--;
+				UpdateWorldMatrices(*ptr, parent);
+				parent = (*ptr);
+			}
+
+			// Cleanup:
+			matrixChain.Clear();
+		}
+
+		inline static uint8_t SetFlags(const Transform* self, uint8_t flags);
+
+		inline static void InvalidateChildren(const Component* root, uint8_t flags, bool skipDirtySubtrees) {
+			static thread_local std::vector<const Component*> stack;
+			const size_t stackStart = stack.size();
+			for (size_t i = 0u; i < root->ChildCount(); i++)
+				stack.push_back(root->GetChild(i));
+			while (stack.size() > stackStart) {
+				const Component* component = stack.back();
+				stack.pop_back();
+				const Transform* transform = dynamic_cast<const Transform*>(component);
+				if (transform != nullptr) {
+					const uint8_t oldFlags = SetFlags(transform, flags);
+					// If the transform is already dirty, so are all of it's sub-transforms:
+					if (skipDirtySubtrees && (oldFlags & flags) == flags) continue;
+				}
+				for (size_t i = 0u; i < component->ChildCount(); i++)
+					stack.push_back(component->GetChild(i));
+			}
+		}
+
+		inline static void LocalTransformChanged(const Transform* self) {
+			const uint8_t oldFlags = SetFlags(self, LOCAL_DIRTY | WORLD_DIRTY);
+			if ((oldFlags & WORLD_DIRTY) == 0u)
+				InvalidateChildren(self, WORLD_DIRTY, true);
+		}
+
+		inline static void OnTransformDestroyed(Transform* self, Component*);
+	};
+
+	/// <summary>
+	/// Scene-wide flattened transform hierarchy;
+	/// <para/> Keeps all transforms from the scene sorted by depth and updates dirty world matrices level by level 
+	/// on the simulation thread block before each graphics synch point, so that the synch point jobs mostly see cached matrices.
+	/// </summary>
+	class Transform::Hierarchy : public virtual ObjectCache<Reference<const Object>>::StoredObject {
+	private:
+		const Reference<SceneContext> m_context;
+		const Reference<SimulationThreadBlock> m_threadBlock;
+
+		std::mutex m_lock;
+		std::vector<Transform*> m_transforms;
+		std::atomic<bool> m_topologyDirty = true;
+		std::atomic<bool> m_matricesDirty = true;
+
+		// Depth-sorted transforms; level i is [m_levelStarts[i], m_levelStarts[i + 1])
+		std::vector<const Transform*> m_sortedTransforms;
+		std::vector<size_t> m_levelStarts;
+		std::vector<size_t> m_levelCursors;
+		std::vector<const Transform*> m_chainBuffer;
+
+		inline void SortTransforms() {
+			static const constexpr size_t NO_DEPTH = ~size_t(0u);
+			for (size_t i = 0u; i < m_transforms.size(); i++)
+				m_transforms[i]->m_hierarchyDepth = NO_DEPTH;
+
+			// Calculate depths (each transform is visited only once):
+			size_t levelCount = 0u;
+			for (size_t i = 0u; i < m_transforms.size(); i++) {
+				const Transform* parent = m_transforms[i];
+				while (parent != nullptr && parent->m_hierarchy == this && parent->m_hierarchyDepth == NO_DEPTH) {
+					m_chainBuffer.push_back(parent);
+					parent = Helpers::ParentTransform(parent);
+				}
+				size_t depth = (parent != nullptr && parent->m_hierarchy == this) ? (parent->m_hierarchyDepth + 1u) : 0u;
+				while (!m_chainBuffer.empty()) {
+					m_chainBuffer.back()->m_hierarchyDepth = depth;
+					m_chainBuffer.pop_back();
+					depth++;
+				}
+				levelCount = std::max(levelCount, m_transforms[i]->m_hierarchyDepth + 1u);
+			}
+
+			// Sort by depth:
+			m_levelStarts.assign(levelCount + 1u, 0u);
+			for (size_t i = 0u; i < m_transforms.size(); i++)
+				m_levelStarts[m_transforms[i]->m_hierarchyDepth + 1u]++;
+			for (size_t i = 1u; i < m_levelStarts.size(); i++)
+				m_levelStarts[i] += m_levelStarts[i - 1u];
+			m_levelCursors = m_levelStarts;
+			m_sortedTransforms.resize(m_transforms.size());
+			for (size_t i = 0u; i < m_transforms.size(); i++) {
+				const Transform* transform = m_transforms[i];
+				m_sortedTransforms[m_levelCursors[transform->m_hierarchyDepth]++] = transform;
+			}
+		}
+
+		inline void Update() {
+			std::unique_lock<std::mutex> lock(m_lock);
+			if (m_topologyDirty.exchange(false))
+				SortTransforms();
+			if (!m_matricesDirty.exchange(false))
+				return;
+			static const constexpr size_t minTransformsPerThread = 256u;
+			for (size_t level = 1u; level < m_levelStarts.size(); level++)
+				m_threadBlock->ParallelFor(m_levelStarts[level - 1u], m_levelStarts[level], minTransformsPerThread, [&](size_t index) {
+					Helpers::UpdateWorldMatrices(m_sortedTransforms[index]);
+					});
+		}
+
+	public:
+		inline Hierarchy(SceneContext* context)
+			: m_context(context)
+			, m_threadBlock(SimulationThreadBlock::GetFor(context)) {
+			m_context->Graphics()->PreGraphicsSynch() += Callback(&Hierarchy::Update, this);
+		}
+
+		inline virtual ~Hierarchy() {
+			m_context->Graphics()->PreGraphicsSynch() -= Callback(&Hierarchy::Update, this);
+		}
+
+		inline static Reference<Hierarchy> GetFor(SceneContext* context) {
+			struct Cache : public virtual ObjectCache<Reference<const Object>> {
+				static Reference<Hierarchy> Get(SceneContext* context) {
+					static Cache cache;
+					static std::mutex creationLock;
+					std::unique_lock<std::mutex> lock(creationLock);
+					return cache.GetCachedOrCreate(context, [&]() {
+						const Reference<Hierarchy> instance = Object::Instantiate<Hierarchy>(context);
+						context->StoreDataObject(instance);
+						return instance;
+						});
+				}
+			};
+			return Cache::Get(context);
+		}
+
+		inline void Add(Transform* transform) {
+			std::unique_lock<std::mutex> lock(m_lock);
+			transform->m_hierarchyIndex = m_transforms.size();
+			m_transforms.push_back(transform);
+			m_topologyDirty = true;
+			m_matricesDirty = true;
+		}
+
+		inline void Remove(Transform* transform) {
+			std::unique_lock<std::mutex> lock(m_lock);
+			const size_t index = transform->m_hierarchyIndex;
+			if (index >= m_transforms.size() || m_transforms[index] != transform) return;
+			Transform* const last = m_transforms.back();
+			m_transforms[index] = last;
+			last->m_hierarchyIndex = index;
+			m_transforms.pop_back();
+			transform->m_hierarchyIndex = Helpers::NO_INDEX;
+			m_topologyDirty = true;
+		}
+
+		inline void Invalidate(bool topologyChanged) {
+			m_matricesDirty = true;
+			if (topologyChanged)
+				m_topologyDirty = true;
+		}
+	};
+
+	inline uint8_t Transform::Helpers::SetFlags(const Transform* self, uint8_t flags) {
+		uint8_t oldFlags;
+		{
+			std::unique_lock<SpinLock> lock(self->m_matrixLock);
+			oldFlags = self->m_matrixFlags.fetch_or(flags);
+		}
+		if (self->m_hierarchy != nullptr)
+			self->m_hierarchy->Invalidate((flags & PARENT_DIRTY) != 0u);
+		return oldFlags;
+	}
+
+	inline void Transform::Helpers::OnTransformDestroyed(Transform* self, Component*) {
+		SetFlags(self, ALL_DIRTY);
+		self->m_hierarchy->Remove(self);
+	}
+
+
 	Transform::Transform(Component* parent, const std::string_view& name, const Vector3& localPosition, const Vector3& localEulerAngles, const Vector3& localScale)
 		: Component(parent, name)
 		, m_localPosition(localPosition), m_localEulerAngles(localEulerAngles), m_localScale(localScale)
-		, m_frameCachedWorldMatrix(Math::Identity()), m_lastCachedFrameIndex(parent->Context()->FrameIndex() - 1u) {}
+		, m_matrixFlags(Helpers::ALL_DIRTY), m_parentTransform(nullptr)
+		, m_localMatrix(Math::Identity()), m_localRotationMatrix(Math::Identity())
+		, m_worldMatrix(Math::Identity()), m_worldRotationMatrix(Math::Identity())
+		, m_frameCachedWorldMatrix(Math::Identity()), m_lastCachedFrameIndex(parent->Context()->FrameIndex() - 1u)
+		, m_hierarchy(Hierarchy::GetFor(parent->Context())) {
+		m_hierarchy->Add(this);
+		OnDestroyed() += Callback<Component*>(Helpers::OnTransformDestroyed, this);
+	}
 
 	Transform::Transform(SceneContext* context, const std::string_view& name) 
-		: Component(context, name) {}
+		: Component(context, name)
+		, m_localPosition(0.0f), m_localEulerAngles(0.0f), m_localScale(1.0f)
+		, m_matrixFlags(Helpers::ALL_DIRTY), m_parentTransform(nullptr)
+		, m_localMatrix(Math::Identity()), m_localRotationMatrix(Math::Identity())
+		, m_worldMatrix(Math::Identity()), m_worldRotationMatrix(Math::Identity())
+		, m_frameCachedWorldMatrix(Math::Identity()), m_lastCachedFrameIndex(context->FrameIndex() - 1u)
+		, m_hierarchy(Hierarchy::GetFor(context)) {
+		m_hierarchy->Add(this);
+		OnDestroyed() += Callback<Component*>(Helpers::OnTransformDestroyed, this);
+	}
+
+	Transform::~Transform() {
+		OnDestroyed() -= Callback<Component*>(Helpers::OnTransformDestroyed, this);
+		m_hierarchy->Remove(this);
+	}
 
 	template<> void TypeIdDetails::GetTypeAttributesOf<Transform>(const Callback<const Object*>& report) {
 		static const Reference<ComponentFactory> factory = ComponentFactory::Create<Transform>(
@@ -18,10 +291,18 @@ namespace Jimara {
 		report(factory);
 	}
 
+	void Transform::HierarchyChanged(Component* subtreeRoot) {
+		const Transform* transform = dynamic_cast<const Transform*>(subtreeRoot);
+		if (transform != nullptr)
+			Helpers::SetFlags(transform, Helpers::WORLD_DIRTY | Helpers::PARENT_DIRTY);
+		Helpers::InvalidateChildren(subtreeRoot, Helpers::WORLD_DIRTY | Helpers::PARENT_DIRTY, false);
+	}
+
 	Vector3 Transform::LocalPosition()const { return m_localPosition; }
 
 	void Transform::SetLocalPosition(const Vector3& value) { 
 		m_localPosition = value;
+		Helpers::LocalTransformChanged(this);
 	}
 
 	Vector3 Transform::WorldPosition()const {
@@ -29,7 +310,7 @@ namespace Jimara {
 	}
 
 	void Transform::SetWorldPosition(const Vector3& value) {
-		const Transform* parent = GetComponentInParents<Transform>(false);
+		const Transform* parent = Helpers::ParentTransform(this);
 		if (parent == nullptr) SetLocalPosition(value);
 		else SetLocalPosition(Math::Inverse(parent->WorldMatrix()) * Vector4(value, 1));
 	}
@@ -39,16 +320,17 @@ namespace Jimara {
 
 	void Transform::SetLocalEulerAngles(const Vector3& value) {
 		m_localEulerAngles = value;
+		Helpers::LocalTransformChanged(this);
 	}
 
 	Vector3 Transform::WorldEulerAngles()const {
-		const Transform* parent = GetComponentInParents<Transform>(false);
+		const Transform* parent = Helpers::ParentTransform(this);
 		if (parent == nullptr) return m_localEulerAngles;
-		else return Math::EulerAnglesFromMatrix(parent->WorldRotationMatrix() * LocalRotationMatrix());
+		else return Math::EulerAnglesFromMatrix(WorldRotationMatrix());
 	}
 
 	void Transform::SetWorldEulerAngles(const Vector3& value) {
-		const Transform* parent = GetComponentInParents<Transform>(false);
+		const Transform* parent = Helpers::ParentTransform(this);
 		if (parent == nullptr) SetLocalEulerAngles(value);
 		else SetLocalEulerAngles(Math::EulerAnglesFromMatrix(Math::Inverse(parent->WorldRotationMatrix()) * Math::MatrixFromEulerAngles(value)));
 	}
@@ -58,46 +340,33 @@ namespace Jimara {
 
 	void Transform::SetLocalScale(const Vector3& value) {
 		m_localScale = value;
+		Helpers::LocalTransformChanged(this);
 	}
 
 	Vector3 Transform::LossyScale()const {
-		const Matrix4 worldRotation = WorldRotationMatrix();
-		const Matrix4 worldMatrix = WorldMatrix();
-		return Math::LossyScale(WorldMatrix(), WorldRotationMatrix());
+		Helpers::UpdateWorldMatrices(this);
+		return Math::LossyScale(m_worldMatrix, m_worldRotationMatrix);
 	}
 
 
 	Matrix4 Transform::LocalMatrix()const {
-		Matrix4 matrix = LocalRotationMatrix();
-		matrix[0u] *= m_localScale.x;
-		matrix[1u] *= m_localScale.y;
-		matrix[2u] *= m_localScale.z;
-		matrix[3] = Vector4(m_localPosition, 1.0f);
-		return matrix;
+		Helpers::UpdateLocalMatrices(this);
+		return m_localMatrix;
 	}
 
 	Matrix4 Transform::LocalRotationMatrix()const {
-		return Math::MatrixFromEulerAngles(m_localEulerAngles);
+		Helpers::UpdateLocalMatrices(this);
+		return m_localRotationMatrix;
 	}
 
 	Matrix4 Transform::WorldMatrix()const {
-		Matrix4 result = LocalMatrix();
-		const Transform* ptr = GetComponentInParents<Transform>(false);
-		while (ptr != nullptr) {
-			result = ptr->LocalMatrix() * result;
-			ptr = ptr->GetComponentInParents<Transform>(false);
-		}
-		return result;
+		Helpers::UpdateWorldMatrices(this);
+		return m_worldMatrix;
 	}
 
 	Matrix4 Transform::WorldRotationMatrix()const {
-		Matrix4 result = LocalRotationMatrix();
-		const Transform* ptr = GetComponentInParents<Transform>(false);
-		while (ptr != nullptr) {
-			result = ptr->LocalRotationMatrix() * result;
-			ptr = ptr->GetComponentInParents<Transform>(false);
-		}
-		return result;
+		Helpers::UpdateWorldMatrices(this);
+		return m_worldRotationMatrix;
 	}
 
 
@@ -106,15 +375,15 @@ namespace Jimara {
 	}
 
 	Vector3 Transform::LocalForward()const {
-		return Math::MatrixFromEulerAngles(m_localEulerAngles)[2u];
+		return LocalRotationMatrix()[2u];
 	}
 
 	Vector3 Transform::LocalRight()const {
-		return Math::MatrixFromEulerAngles(m_localEulerAngles)[0u];
+		return LocalRotationMatrix()[0u];
 	}
 
 	Vector3 Transform::LocalUp()const {
-		return Math::MatrixFromEulerAngles(m_localEulerAngles)[1u];
+		return LocalRotationMatrix()[1u];
 	}
 
 	Vector3 Transform::LocalToWorldDirection(const Vector3& localDirection)const {
@@ -160,40 +429,12 @@ namespace Jimara {
 	const Matrix4& Transform::FrameCachedWorldMatrix()const {
 		const uint64_t frameId = Context()->FrameIndex();
 		if (m_lastCachedFrameIndex.load() != frameId) {
-			static thread_local Stacktor<const Transform*, 4u> matrixChain;
-			assert(matrixChain.Size() == 0u);
-
-			// Collect parent chain:
-			const Transform* chainEnd = this;
-			while (chainEnd != nullptr) {
-				matrixChain.Push(chainEnd);
-				chainEnd = chainEnd->GetComponentInParents<Transform>(false);
-				if (chainEnd == nullptr || chainEnd->m_lastCachedFrameIndex.load() == frameId)
-					break;
-			}
-
-			// Calculate parent-to-child:
-			const Transform* const* ptr = matrixChain.Data() + (matrixChain.Size() - 1u);
-			while (true) {
-				const Transform* const tr = (*ptr);
-				
-				// Update transform (check in case other thread was calculating in parallel):
-				if (tr->m_lastCachedFrameIndex.load() != frameId) {
-					if (chainEnd == nullptr)
-						tr->m_frameCachedWorldMatrix = tr->LocalMatrix();
-					else tr->m_frameCachedWorldMatrix = chainEnd->m_frameCachedWorldMatrix * tr->LocalMatrix();
-					tr->m_lastCachedFrameIndex = frameId;
-				}
-
-				// Move to child:
-				if (tr == this)
-					break;
-				chainEnd = tr;
-				ptr--;
+			Helpers::UpdateWorldMatrices(this);
+			std::unique_lock<SpinLock> lock(m_matrixLock);
+			if (m_lastCachedFrameIndex.load() != frameId) {
+				m_frameCachedWorldMatrix = m_worldMatrix;
+				m_lastCachedFrameIndex = frameId;
 			}
-
-			// Cleanup:
-			matrixChain.Clear();
 		}
 		return m_frameCachedWorldMatrix;
 	}
@@ -26,6 +26,9 @@ namespace Jimara {
 			, const Vector3& localEulerAngles = Vector3(0.0f, 0.0f, 0.0f)
 			, const Vector3& localScale = Vector3(1.0f, 1.0f, 1.0f));
 
+		/// <summary> Virtual destructor </summary>
+		virtual ~Transform();
+
 		/// <summary> Position in "relative to parent transform" coordinate system </summary>
 		Vector3 LocalPosition()const;
 
@@ -202,9 +205,46 @@ namespace Jimara {
 		// Local scale
 		Vector3 m_localScale;
 
+		// Flags, telling which of the cached matrices are out of date
+		enum class MatrixFlags : uint8_t {
+			LOCAL_DIRTY = 1 << 0,
+			WORLD_DIRTY = 1 << 1,
+			PARENT_DIRTY = 1 << 2
+		};
+		mutable std::atomic<uint8_t> m_matrixFlags;
+
+		// Lock for cached matrix updates
+		mutable SpinLock m_matrixLock;
+
+		// Cached parent transform (valid, unless PARENT_DIRTY flag is set)
+		mutable std::atomic<const Transform*> m_parentTransform;
+
+		// Cached local matrices (valid, unless LOCAL_DIRTY flag is set)
+		mutable Matrix4 m_localMatrix;
+		mutable Matrix4 m_localRotationMatrix;
+
+		// Cached world matrices (valid, unless WORLD_DIRTY flag is set; WORLD_DIRTY on a transform implies WORLD_DIRTY on all of it's sub-transforms)
+		mutable Matrix4 m_worldMatrix;
+		mutable Matrix4 m_worldRotationMatrix;
+
 		// Local 'frame-cached' world transformation matrix
 		mutable Matrix4 m_frameCachedWorldMatrix;
 		mutable std::atomic<uint64_t> m_lastCachedFrameIndex;
+
+		// Scene-wide flattened transform hierarchy and our index/depth within it
+		class Hierarchy;
+		Reference<Hierarchy> m_hierarchy;
+		size_t m_hierarchyIndex = 0u;
+		mutable size_t m_hierarchyDepth = 0u;
+
+		// Some private helpers are defined here
+		struct Helpers;
+
+		// Invalidates cached parents and world matrices of all transforms within the subtree (invoked by Component, whenever the parent changes)
+		static void HierarchyChanged(Component* subtreeRoot);
+
+		// Component informs Transform about parent changes
+		friend class Component;
 	};
 
 	// Type detail callbacks
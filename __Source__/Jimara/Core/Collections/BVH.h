@@ -0,0 +1,1091 @@
+#pragma once
+#include "Octree.h"
+#include "Stacktor.h"
+#include "../Systems/ParallelFor.h"
+#include <algorithm>
+#include <optional>
+
+
+namespace Jimara {
+	/// <summary>
+	/// Helpers for BVH implementation
+	/// </summary>
+	namespace BVHHelpers {
+		/// <summary>
+		/// Thread block, BVH builds and refits use when the caller does not provide one (created on first use and shared by all BVH types)
+		/// <para/> Concurrent builds compete for the block; the ones that find it busy run on the calling thread (see ThreadBlock::BusyCount()).
+		/// </summary>
+		/// <returns> Shared thread block </returns>
+		inline ThreadBlock& SharedThreadBlock() {
+			static ThreadBlock block(ThreadBlock::WaitMode::ADAPTIVE);
+			return block;
+		}
+	}
+
+	/// <summary>
+	/// A generic Bounding Volume Hierarchy
+	/// <para/> Built with binned SAH (surface area heuristic) splits; large builds run on a thread block;
+	/// <para/> Nodes are compact (32 bytes, index-based children) and queries traverse them in front-to-back order;
+	/// <para/> Query surface and result types are the same as the ones of the Octree, so the two are interchangeable for the most part.
+	/// <para/> This wraps around a smart pointer to the immutable underlying data, so copying BVH-s is a trivial operation
+	/// </summary>
+	/// <typeparam name="Type"> Stored geometric element type </typeparam>
+	template<typename Type>
+	class BVH {
+	public:
+		/// <summary>
+		/// Hint, expected to be returned from inspectHit and onLeafHitsFinished
+		/// callbacks passed to generic cast/sweep functions (same as Octree's)
+		/// </summary>
+		using CastHint = typename Octree<Type>::CastHint;
+
+		/// <summary>
+		/// A generic Cast call result (same as Octree's)
+		/// </summary>
+		/// <typeparam name="HitInfo"> Hit information (depends on sweep geometry, or for Raycasts, can just be standard RaycastResult) </typeparam>
+		template<typename HitInfo>
+		using CastResult = typename Octree<Type>::template CastResult<HitInfo>;
+
+		/// <summary> Result of raycast calls </summary>
+		using RaycastResult = CastResult<Math::RaycastResult<Type>>;
+
+		/// <summary>
+		/// Result of Sweep calls
+		/// </summary>
+		/// <typeparam name="Shape"> Sweep shape type </typeparam>
+		template<typename Shape>
+		using SweepResult = CastResult<Math::SweepResult<Shape, Type>>;
+
+		/// <summary> Element count, below which Build will not bother using multiple threads </summary>
+		static const constexpr size_t PARALLEL_BUILD_THRESHOLD = 4096u;
+
+		/// <summary> Constructor (creates an empty BVH) </summary>
+		inline BVH() {}
+
+		/// <summary> Destructor </summary>
+		inline ~BVH() {}
+
+		/// <summary>
+		/// Builds a BVH
+		/// </summary>
+		/// <typeparam name="TypeIt"> Arbitary type that can be used as an iterator for Type objects </typeparam>
+		/// <typeparam name="CalculateShapeBBox"> Callable, that returns bounding box of a Type shape </typeparam>
+		/// <param name="start"> Iterator to the first element </param>
+		/// <param name="end"> Iterator to the sentinel element </param>
+		/// <param name="calculateShapeBBox"> Callable, that returns bounding box of a Type shape
+		/// (AABB box = calculateShapeBBox(const Type&#38;); may be invoked from several threads at once)
+		/// </param>
+		/// <param name="threadBlock"> Thread block to build on (if null and there are enough elements, BVHHelpers::SharedThreadBlock() will be used) </param>
+		/// <returns> New BVH </returns>
+		template<typename TypeIt, typename CalculateShapeBBox>
+		inline static BVH Build(
+			const TypeIt& start, const TypeIt& end,
+			const CalculateShapeBBox& calculateShapeBBox,
+			ThreadBlock* threadBlock = nullptr);
+
+		/// <summary>
+		/// Builds a BVH
+		/// </summary>
+		/// <typeparam name="TypeIt"> Arbitary type that can be used as an iterator for Type objects </typeparam>
+		/// <param name="start"> Iterator to the first element </param>
+		/// <param name="end"> Iterator to the sentinel element </param>
+		/// <param name="threadBlock"> Thread block to build on (if null and there are enough elements, BVHHelpers::SharedThreadBlock() will be used) </param>
+		/// <returns> New BVH </returns>
+		template<typename TypeIt>
+		inline static BVH Build(const TypeIt& start, const TypeIt& end, ThreadBlock* threadBlock = nullptr);
+
+		/// <summary>
+		/// Creates a BVH with the same node hierarchy, but with new elements and refitted node bounds
+		/// <para/> Intended for the cases when the elements move around (poses change and such), but stay the 'same' otherwise;
+		/// refit is much cheaper than Build, but the query performance degrades as the elements drift away from their original positions,
+		/// so an occasional full rebuild is recommended after large changes;
+		/// <para/> If the element count differs from Size(), this will fall back to Build;
+		/// <para/> Elements that did not have valid bounds during the initial Build stay excluded from the queries.
+		/// </summary>
+		/// <typeparam name="TypeIt"> Arbitary type that can be used as an iterator for Type objects </typeparam>
+		/// <typeparam name="CalculateShapeBBox"> Callable, that returns bounding box of a Type shape </typeparam>
+		/// <param name="start"> Iterator to the first element (element order should be the same as during the initial Build) </param>
+		/// <param name="end"> Iterator to the sentinel element </param>
+		/// <param name="calculateShapeBBox"> Callable, that returns bounding box of a Type shape
+		/// (AABB box = calculateShapeBBox(const Type&#38;); may be invoked from several threads at once)
+		/// </param>
+		/// <param name="threadBlock"> Thread block to refit on (if null and there are enough elements, BVHHelpers::SharedThreadBlock() will be used) </param>
+		/// <returns> Refitted BVH </returns>
+		template<typename TypeIt, typename CalculateShapeBBox>
+		inline BVH Refit(
+			const TypeIt& start, const TypeIt& end,
+			const CalculateShapeBBox& calculateShapeBBox,
+			ThreadBlock* threadBlock = nullptr)const;
+
+		/// <summary>
+		/// Creates a BVH with the same node hierarchy, but with new elements and refitted node bounds
+		/// <para/> Refer to the overload with calculateShapeBBox for details.
+		/// </summary>
+		/// <typeparam name="TypeIt"> Arbitary type that can be used as an iterator for Type objects </typeparam>
+		/// <param name="start"> Iterator to the first element (element order should be the same as during the initial Build) </param>
+		/// <param name="end"> Iterator to the sentinel element </param>
+		/// <param name="threadBlock"> Thread block to refit on (if null and there are enough elements, BVHHelpers::SharedThreadBlock() will be used) </param>
+		/// <returns> Refitted BVH </returns>
+		template<typename TypeIt>
+		inline BVH Refit(const TypeIt& start, const TypeIt& end, ThreadBlock* threadBlock = nullptr)const;
+
+		/// <summary> BVH's combined bounding box </summary>
+		inline AABB BoundingBox()const;
+
+		/// <summary> Stored element count </summary>
+		inline size_t Size()const;
+
+		/// <summary> Number of nodes within the hierarchy </summary>
+		inline size_t NodeCount()const;
+
+		/// <summary>
+		/// Stored element by index (order is the same as during the initial Build command)
+		/// </summary>
+		/// <param name="index"> Element index </param>
+		/// <returns> Element </returns>
+		inline const Type& operator[](size_t index)const;
+
+		/// <summary>
+		/// Returns index of given element
+		/// <para/> Element, passed as the argument has to be returned internally by
+		/// any of the operator[]/Cast/Raycast/Sweep operations via public API. Otherwise, the behaviour is undefined.
+		/// </summary>
+		/// <param name="element"> Element pointer </param>
+		/// <returns> Index of the element based on it's index during the initial Build </returns>
+		inline size_t IndexOf(const Type* element)const;
+
+		/// <summary>
+		/// Generic cast function inside the BVH
+		/// <para/> Nodes are visited in the order of their entry distances; hits are reported through inspectHit callback and are not sorted;
+		/// <para/> Reports are "interrupted" with onLeafHitsFinished calls, which get invoked once there are no unvisited nodes,
+		/// closer than the closest hit reported since the last onLeafHitsFinished call.
+		/// In other words, the closest hit is always within the first batch of reported hits (same guarantee as Octree's).
+		/// </summary>
+		/// <typeparam name="InspectHit"> Callable, that provides user with an intersection information (should return CastHint) </typeparam>
+		/// <typeparam name="OnLeafHitsFinished"> Callable, that lets the user know that a batch of hits has been reported (should return CastHint) </typeparam>
+		/// <typeparam name="SweepAgainstAABB"> Callable, that calculates Sweep/Raycast distance between the cast shape/ray and an AABB </typeparam>
+		/// <typeparam name="SweepAgainstGeometry"> Callable, that calculates Sweep/Raycast information between the cast shape/ray and target Type geometry </typeparam>
+		/// <param name="position"> Raycast/Sweep/Whatever origin/offset </param>
+		/// <param name="direction"> Cast direction </param>
+		/// <param name="inspectHit"> Callback, that provides user with an intersection information
+		/// (should return CastHint; receives result from sweepAgainstGeometry, total sweep distance and const reference to the geometry that got hit)
+		/// </param>
+		/// <param name="onLeafHitsFinished"> Callback, that lets the user know that a batch of hits has been reported (should return CastHint) </param>
+		/// <param name="sweepAgainstAABB"> Callable, that calculates Sweep/Raycast distance between the cast shape/ray and an AABB
+		/// (return value should be castable to Math&#58;&#58;SweepDistance)
+		/// </param>
+		/// <param name="sweepAgainstGeometry"> Callable, that calculates Sweep/Raycast information between the cast shape/ray and target Type geometry
+		/// (Should satisfy the same requirenments as Math&#58;&#58;Raycast&#60;Type&#62; or Math&#58;&#58;Sweep&#60;Shape, Type&#62;)
+		/// </param>
+		template<typename InspectHit, typename OnLeafHitsFinished,
+			typename SweepAgainstAABB, typename SweepAgainstGeometry>
+		inline void Cast(
+			const Vector3& position, const Vector3& direction,
+			const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished,
+			const SweepAgainstAABB& sweepAgainstAABB, const SweepAgainstGeometry& sweepAgainstGeometry)const;
+
+		/// <summary>
+		/// Generic raycast function inside the BVH (same reporting rules as Cast)
+		/// </summary>
+		/// <typeparam name="InspectHit"> Callable, that provides user with an intersection information (should return CastHint) </typeparam>
+		/// <typeparam name="OnLeafHitsFinished"> Callable, that lets the user know that a batch of hits has been reported (should return CastHint) </typeparam>
+		/// <param name="position"> Ray origin </param>
+		/// <param name="direction"> Ray direction </param>
+		/// <param name="inspectHit"> Callback, that provides user with an intersection information (should return CastHint) </param>
+		/// <param name="onLeafHitsFinished"> Callback, that lets the user know that a batch of hits has been reported (should return CastHint) </param>
+		template<typename InspectHit, typename OnLeafHitsFinished>
+		inline void Raycast(
+			const Vector3& position, const Vector3& direction,
+			const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished)const;
+
+		/// <summary>
+		/// Generic sweep function inside the BVH (same reporting rules as Cast)
+		/// </summary>
+		/// <typeparam name="Shape"> 'Swept' geometry type </typeparam>
+		/// <typeparam name="InspectHit"> Callable, that provides user with an intersection information (should return CastHint) </typeparam>
+		/// <typeparam name="OnLeafHitsFinished"> Callable, that lets the user know that a batch of hits has been reported (should return CastHint) </typeparam>
+		/// <param name="shape"> 'Swept' shape </param>
+		/// <param name="position"> Initial shape location </param>
+		/// <param name="direction"> Sweep direction </param>
+		/// <param name="inspectHit"> Callback, that provides user with an intersection information (should return CastHint) </param>
+		/// <param name="onLeafHitsFinished"> Callback, that lets the user know that a batch of hits has been reported (should return CastHint) </param>
+		template<typename Shape, typename InspectHit, typename OnLeafHitsFinished>
+		inline void Sweep(
+			const Shape& shape, const Vector3& position, const Vector3& direction,
+			const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished)const;
+
+		/// <summary>
+		/// Raycast, reporting the closest hit
+		/// </summary>
+		/// <param name="position"> Ray position </param>
+		/// <param name="direction"> Ray direction </param>
+		/// <param name="result"> Result will be stored here </param>
+		/// <returns> True, if the ray hits anything </returns>
+		inline bool Raycast(const Vector3& position, const Vector3& direction, RaycastResult& result)const;
+
+		/// <summary>
+		/// Raycast, reporting the closest hit
+		/// </summary>
+		/// <param name="position"> Ray position </param>
+		/// <param name="direction"> Ray direction </param>
+		/// <returns> Closest hit if found, null-target otherwise </returns>
+		inline RaycastResult Raycast(const Vector3& position, const Vector3& direction)const;
+
+		/// <summary>
+		/// Raycast, reporting all hits
+		/// </summary>
+		/// <param name="position"> Ray position </param>
+		/// <param name="direction"> Ray direction </param>
+		/// <param name="result"> Hits will be appended to this list </param>
+		/// <param name="sort"> If true, reported hits will be sorted based on the distance </param>
+		/// <returns> Number of reported hits </returns>
+		inline size_t RaycastAll(const Vector3& position, const Vector3& direction, std::vector<RaycastResult>& result, bool sort = false)const;
+
+		/// <summary>
+		/// Raycast, reporting all hits
+		/// </summary>
+		/// <param name="position"> Ray position </param>
+		/// <param name="direction"> Ray direction </param>
+		/// <param name="sort"> If true, reported hits will be sorted based on the distance </param>
+		/// <returns> All hits </returns>
+		inline std::vector<RaycastResult> RaycastAll(const Vector3& position, const Vector3& direction, bool sort = false)const;
+
+		/// <summary>
+		/// Sweep, reporting the closest hit
+		/// </summary>
+		/// <typeparam name="Shape"> Shape that's being swept </typeparam>
+		/// <param name="shape"> Shape that's being swept </param>
+		/// <param name="position"> Initial shape location </param>
+		/// <param name="direction"> Sweep direction </param>
+		/// <param name="result"> Hit information will be stored here </param>
+		/// <returns> True, if the shape hits anything </returns>
+		template<typename Shape>
+		inline bool Sweep(const Shape& shape, const Vector3& position, const Vector3& direction, SweepResult<Shape>& result)const;
+
+		/// <summary>
+		/// Sweep, reporting the closest hit
+		/// </summary>
+		/// <typeparam name="Shape"> Shape that's being swept </typeparam>
+		/// <param name="shape"> Shape that's being swept </param>
+		/// <param name="position"> Initial shape location </param>
+		/// <param name="direction"> Sweep direction </param>
+		/// <returns> Closest hit if found, null-target otherwise </returns>
+		template<typename Shape>
+		inline SweepResult<Shape> Sweep(const Shape& shape, const Vector3& position, const Vector3& direction)const;
+
+		/// <summary>
+		/// Sweep, reporting all contacts
+		/// </summary>
+		/// <typeparam name="Shape"> Shape that's being swept </typeparam>
+		/// <param name="shape"> Shape that's being swept </param>
+		/// <param name="position"> Initial shape location </param>
+		/// <param name="direction"> Sweep direction </param>
+		/// <param name="result"> Hits will be appended to this list </param>
+		/// <param name="sort"> If true, reported hits will be sorted based on the distance </param>
+		/// <returns> Number of reported hits </returns>
+		template<typename Shape>
+		inline size_t SweepAll(const Shape& shape, const Vector3& position, const Vector3& direction, std::vector<SweepResult<Shape>>& result, bool sort = false)const;
+
+		/// <summary>
+		/// Sweep, reporting all contacts
+		/// </summary>
+		/// <typeparam name="Shape"> Shape that's being swept </typeparam>
+		/// <param name="shape"> Shape that's being swept </param>
+		/// <param name="position"> Initial shape location </param>
+		/// <param name="direction"> Sweep direction </param>
+		/// <param name="sort"> If true, reported hits will be sorted based on the distance </param>
+		/// <returns> All hits </returns>
+		template<typename Shape>
+		inline std::vector<SweepResult<Shape>> SweepAll(const Shape& shape, const Vector3& position, const Vector3& direction, bool sort = false)const;
+
+
+	private:
+		// Node (leaf, if elemCount is nonzero; otherwise, children are stored at firstIndex and firstIndex + 1)
+		struct Node {
+			Vector3 start = Vector3(0.0f);
+			uint32_t firstIndex = 0u;
+			Vector3 end = Vector3(0.0f);
+			uint32_t elemCount = 0u;
+
+			inline AABB Bounds()const { return AABB(start, end); }
+		};
+		static_assert(sizeof(Node) == 32u);
+
+		// Stored data
+		struct Data {
+			std::vector<Type> elements;
+			std::vector<uint32_t> leafElements;
+			std::vector<Node> nodes;
+		};
+		std::shared_ptr<const Data> m_data;
+
+		// Actual constructor with data:
+		inline BVH(const std::shared_ptr<const Data>& data) : m_data(data) {}
+
+		// Build internals
+		struct Builder;
+
+		// Raycast against a node (NaN if the node is missed, or behind the ray)
+		inline static float RaycastBounds(const Node& node, const Vector3& rayOrigin, const Vector3& inverseDirection) {
+			float ds = (node.start.x - rayOrigin.x) * inverseDirection.x;
+			float de = (node.end.x - rayOrigin.x) * inverseDirection.x;
+			float mn = Math::Min(ds, de);
+			float mx = Math::Max(ds, de);
+			ds = (node.start.y - rayOrigin.y) * inverseDirection.y;
+			de = (node.end.y - rayOrigin.y) * inverseDirection.y;
+			mn = Math::Max(mn, Math::Min(ds, de));
+			mx = Math::Min(mx, Math::Max(ds, de));
+			ds = (node.start.z - rayOrigin.z) * inverseDirection.z;
+			de = (node.end.z - rayOrigin.z) * inverseDirection.z;
+			mn = Math::Max(mn, Math::Min(ds, de));
+			mx = Math::Min(mx, Math::Max(ds, de));
+			if (mn > mx + Math::INTERSECTION_EPSILON || mx < -Math::INTERSECTION_EPSILON)
+				return std::numeric_limits<float>::quiet_NaN();
+			else return mn;
+		}
+
+		// Node traversal with AABB distance function taking node as the argument
+		template<typename InspectHit, typename OnLeafHitsFinished,
+			typename NodeDistance, typename SweepAgainstGeometry>
+		inline void Traverse(
+			const Vector3& position, const Vector3& direction,
+			const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished,
+			const NodeDistance& nodeDistance, const SweepAgainstGeometry& sweepAgainstGeometry)const;
+
+	public:
+		/// <summary>
+		/// Standard casting strategy, collecting all hits along the cast path
+		/// <para/> Unlike Octree::CastAll, sorting here is applied to the whole list of reported hits.
+		/// </summary>
+		/// <typeparam name="HitType"> Hit type, reported by sweepAgainstGeometry call </typeparam>
+		/// <typeparam name="CastFn"> Callable, that performs the underlying cast call </typeparam>
+		/// <param name="castFn"> Underlying Cast call, that will simply receive inspectHit and onLeafHitsFinished functions </param>
+		/// <param name="result"> Result will be appended to this list </param>
+		/// <param name="sort"> If true, the results will be sorted </param>
+		/// <returns> Number of reported hits </returns>
+		template<typename HitType, typename CastFn>
+		inline static size_t CastAll(const CastFn& castFn, std::vector<CastResult<HitType>>& result, bool sort) {
+			const size_t initialCount = result.size();
+			castFn(
+				[&](const HitType& hit, float totalDistance, const Type& target) {
+					result.push_back(CastResult<HitType> { hit, &target, totalDistance });
+					return CastHint::CONTINUE_CAST;
+				},
+				[&]() { return CastHint::CONTINUE_CAST; });
+			if (sort && (result.size() - initialCount) > 1u)
+				std::sort(result.data() + initialCount, result.data() + result.size(),
+					[&](const CastResult<HitType>& a, const CastResult<HitType>& b) {
+						Math::SweepDistance distA = a;
+						Math::SweepDistance distB = b;
+						return distA.distance < distB.distance;
+					});
+			return result.size() - initialCount;
+		}
+
+		/// <summary>
+		/// Standard casting strategy, collecting all hits along the cast path
+		/// </summary>
+		/// <typeparam name="HitType"> Hit type, reported by sweepAgainstGeometry call </typeparam>
+		/// <typeparam name="CastFn"> Callable, that performs the underlying cast call </typeparam>
+		/// <param name="castFn"> Underlying Cast call, that will simply receive inspectHit and onLeafHitsFinished functions </param>
+		/// <param name="sort"> If true, the results will be sorted </param>
+		/// <returns> List of reported hits </returns>
+		template<typename HitType, typename CastFn>
+		inline static std::vector<CastResult<HitType>> CastAll(const CastFn& castFn, bool sort) {
+			std::vector<CastResult<HitType>> result;
+			CastAll<HitType, CastFn>(castFn, result, sort);
+			return result;
+		}
+	};
+
+
+	namespace Math {
+		/// <summary>
+		/// Overlap between a BVH and a bounding box
+		/// <para/> For performance reasons, this only compares the boundaries; this can not tell the user if there are any actual element overlaps.
+		/// </summary>
+		/// <typeparam name="Type"> BVH element type </typeparam>
+		/// <param name="bvh"> BVH </param>
+		/// <param name="bbox"> Bounding box </param>
+		/// <returns> Overlap info </returns>
+		template<typename Type>
+		inline ShapeOverlapResult<BVH<Type>, AABB> Overlap(const BVH<Type>& bvh, const AABB& bbox) {
+			if (bvh.Size() <= 0u)
+				return {};
+			return Overlap(bvh.BoundingBox(), bbox);
+		}
+
+		/// <summary>
+		/// Overlap between a BVH and a bounding box
+		/// </summary>
+		/// <typeparam name="Type"> BVH element type </typeparam>
+		/// <param name="bbox"> Bounding box </param>
+		/// <param name="bvh"> BVH </param>
+		/// <returns> Overlap info </returns>
+		template<typename Type>
+		inline ShapeOverlapResult<AABB, BVH<Type>> Overlap(const AABB& bbox, const BVH<Type>& bvh) {
+			return Overlap(bvh, bbox);
+		}
+
+		/// <summary>
+		/// BVH Raycast result
+		/// </summary>
+		/// <typeparam name="Type"> BVH element type </typeparam>
+		template<typename Type>
+		struct RaycastResult<BVH<Type>> : public BVH<Type>::RaycastResult {
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="src"> Result to copy </param>
+			inline RaycastResult(const typename BVH<Type>::RaycastResult& src = {}) : BVH<Type>::RaycastResult(src) {}
+		};
+
+		/// <summary>
+		/// BVH Sweep result
+		/// </summary>
+		/// <typeparam name="SweptType"> Swept shape type </typeparam>
+		/// <typeparam name="Type"> BVH element type </typeparam>
+		template<typename SweptType, typename Type>
+		struct SweepResult<SweptType, BVH<Type>> : public BVH<Type>::template SweepResult<SweptType> {
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="src"> Result to copy </param>
+			inline SweepResult(const typename BVH<Type>::template SweepResult<SweptType>& src = {})
+				: BVH<Type>::template SweepResult<SweptType>(src) {}
+		};
+	}
+
+
+
+
+
+	template<typename Type>
+	struct BVH<Type>::Builder {
+		// Bin count per axis
+		static const constexpr uint32_t BIN_COUNT = 16u;
+
+		// Nodes with this many elements or less will always be leaves
+		static const constexpr uint32_t MIN_LEAF_SIZE = 2u;
+
+		// Nodes with more elements than this will always get split if possible
+		static const constexpr uint32_t MAX_LEAF_SIZE = 8u;
+
+		// Relative cost of node traversal to element intersection
+		static const constexpr float TRAVERSAL_COST = 1.0f;
+
+		// Minimal element count for binning on multiple threads
+		static const constexpr size_t PARALLEL_BINNING_THRESHOLD = 65536u;
+
+		// Binning chunk size for ParallelReduce
+		static const constexpr size_t BINNING_GRAIN_SIZE = 16384u;
+
+		// Empty bounding box
+		inline static AABB EmptyBounds() {
+			return AABB(Vector3(std::numeric_limits<float>::infinity()), Vector3(-std::numeric_limits<float>::infinity()));
+		}
+
+		// Element bounds with start and end fixed to be min and max
+		inline static AABB ElementBounds(const AABB& bnd) {
+			return AABB(
+				Vector3(Math::Min(bnd.start.x, bnd.end.x), Math::Min(bnd.start.y, bnd.end.y), Math::Min(bnd.start.z, bnd.end.z)),
+				Vector3(Math::Max(bnd.start.x, bnd.end.x), Math::Max(bnd.start.y, bnd.end.y), Math::Max(bnd.start.z, bnd.end.z)));
+		}
+
+		// True, if element bounds are valid
+		inline static bool IsValid(const AABB& bnd) {
+			return
+				std::isfinite(bnd.start.x) && std::isfinite(bnd.start.y) && std::isfinite(bnd.start.z) &&
+				std::isfinite(bnd.end.x) && std::isfinite(bnd.end.y) && std::isfinite(bnd.end.z);
+		}
+
+		// Decides on thread count (if not enough elements, everything will run on the calling thread and threadBlock will be set to null)
+		inline static size_t ThreadCount(size_t elementCount, ThreadBlock*& threadBlock) {
+			const size_t threadCount = (elementCount >= PARALLEL_BUILD_THRESHOLD)
+				? Math::Max(size_t(std::thread::hardware_concurrency()), size_t(1u)) : size_t(1u);
+			if (threadCount <= 1u) {
+				threadBlock = nullptr;
+				return 1u;
+			}
+			if (threadBlock == nullptr)
+				threadBlock = &BVHHelpers::SharedThreadBlock();
+			return threadCount;
+		}
+
+		// Expands bounds
+		inline static void Expand(AABB& bounds, const AABB& other) {
+			bounds.start = Vector3(
+				Math::Min(bounds.start.x, other.start.x), Math::Min(bounds.start.y, other.start.y), Math::Min(bounds.start.z, other.start.z));
+			bounds.end = Vector3(
+				Math::Max(bounds.end.x, other.end.x), Math::Max(bounds.end.y, other.end.y), Math::Max(bounds.end.z, other.end.z));
+		}
+
+		// Surface area of a bounding box (0 for empty boxes)
+		inline static float SurfaceArea(const AABB& bounds) {
+			const Vector3 size = bounds.end - bounds.start;
+			if (size.x < 0.0f || size.y < 0.0f || size.z < 0.0f)
+				return 0.0f;
+			return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+
+		// Element and centroid bounds of an element range
+		struct RangeBounds {
+			AABB bounds = EmptyBounds();
+			AABB centroidBounds = EmptyBounds();
+
+			inline void Include(const AABB& elemBounds, const Vector3& centroid) {
+				Expand(bounds, elemBounds);
+				Expand(centroidBounds, AABB(centroid, centroid));
+			}
+
+			inline void Include(const RangeBounds& other) {
+				Expand(bounds, other.bounds);
+				Expand(centroidBounds, other.centroidBounds);
+			}
+		};
+
+		// SAH bins for each axis
+		struct Bins {
+			RangeBounds bounds[3u][BIN_COUNT];
+			uint32_t counts[3u][BIN_COUNT] = {};
+		};
+
+		// Pending node
+		struct Task {
+			uint32_t node;
+			uint32_t first;
+			uint32_t last;
+			RangeBounds bounds;
+		};
+
+		// Build state
+		const std::shared_ptr<Data>& data;
+		std::vector<AABB> elemBounds;
+		std::vector<Vector3> centroids;
+		ThreadBlock* threadBlock = nullptr;
+		size_t threadCount = 1u;
+
+		inline Builder(const std::shared_ptr<Data>& d) : data(d) {}
+
+		// Bin index of an element on given axis
+		inline static uint32_t BinId(float centroid, float start, float scale) {
+			const float bin = (centroid - start) * scale;
+			return (bin > 0.0f) ? Math::Min(static_cast<uint32_t>(bin), BIN_COUNT - 1u) : 0u;
+		}
+
+		// Bin scales for each axis
+		inline static Vector3 BinScales(const AABB& centroidBounds) {
+			const Vector3 extents = centroidBounds.end - centroidBounds.start;
+			auto scale = [](float extent) { return (extent > 0.0f) ? (float(BIN_COUNT) / extent) : 0.0f; };
+			return Vector3(scale(extents.x), scale(extents.y), scale(extents.z));
+		}
+
+		// Adds an element to the bins
+		inline void AddToBins(Bins& bins, uint32_t elementId, const AABB& centroidBounds, const Vector3& scales)const {
+			const AABB& bnd = elemBounds[elementId];
+			const Vector3& centroid = centroids[elementId];
+			for (size_t axis = 0u; axis < 3u; axis++) {
+				if (scales[axis] <= 0.0f)
+					continue;
+				const uint32_t binId = BinId(centroid[axis], centroidBounds.start[axis], scales[axis]);
+				bins.bounds[axis][binId].Include(bnd, centroid);
+				bins.counts[axis][binId]++;
+			}
+		}
+
+		// Fills the bins for a range of elements
+		inline void FillBins(Bins& bins, const Task& task, const Vector3& scales)const {
+			const uint32_t* const order = data->leafElements.data();
+			const size_t count = (task.last - task.first);
+			if (threadBlock == nullptr || threadCount <= 1u || count < PARALLEL_BINNING_THRESHOLD) {
+				for (uint32_t i = task.first; i < task.last; i++)
+					AddToBins(bins, order[i], task.bounds.centroidBounds, scales);
+				return;
+			}
+			bins = ParallelReduce(*threadBlock, threadCount, size_t(task.first), size_t(task.last), BINNING_GRAIN_SIZE, Bins(),
+				[&](Bins& partial, size_t i) { AddToBins(partial, order[i], task.bounds.centroidBounds, scales); },
+				[](const Bins& a, const Bins& b) {
+					Bins rv = a;
+					for (size_t axis = 0u; axis < 3u; axis++)
+						for (size_t binId = 0u; binId < BIN_COUNT; binId++) {
+							rv.bounds[axis][binId].Include(b.bounds[axis][binId]);
+							rv.counts[axis][binId] += b.counts[axis][binId];
+						}
+					return rv;
+				});
+		}
+
+		// Calculates element and centroid bounds for a range
+		inline RangeBounds CalculateBounds(uint32_t first, uint32_t last)const {
+			RangeBounds rv;
+			for (uint32_t i = first; i < last; i++) {
+				const uint32_t elementId = data->leafElements[i];
+				rv.Include(elemBounds[elementId], centroids[elementId]);
+			}
+			return rv;
+		}
+
+		// Fills node data and either makes it a leaf, or creates children and adds their tasks to the list
+		template<typename TaskList>
+		inline void ProcessTask(const Task& task, std::vector<Node>& nodes, TaskList& tasks)const {
+			{
+				Node& node = nodes[task.node];
+				const float aabbEpsilon = Math::INTERSECTION_EPSILON * 8.0f;
+				node.start = task.bounds.bounds.start - aabbEpsilon;
+				node.end = task.bounds.bounds.end + aabbEpsilon;
+				node.firstIndex = task.first;
+				node.elemCount = (task.last - task.first);
+			}
+			const uint32_t count = (task.last - task.first);
+			if (count <= MIN_LEAF_SIZE)
+				return;
+
+			// Find best split:
+			const Vector3 scales = BinScales(task.bounds.centroidBounds);
+			std::optional<Bins> bins;
+			size_t bestAxis = 3u;
+			uint32_t bestSplit = 0u;
+			float bestCost = std::numeric_limits<float>::infinity();
+			RangeBounds bestLeft, bestRight;
+			if (scales.x > 0.0f || scales.y > 0.0f || scales.z > 0.0f) {
+				bins.emplace();
+				FillBins(bins.value(), task, scales);
+				const float nodeArea = Math::Max(SurfaceArea(task.bounds.bounds), std::numeric_limits<float>::epsilon());
+				for (size_t axis = 0u; axis < 3u; axis++) {
+					if (scales[axis] <= 0.0f)
+						continue;
+					RangeBounds rightBounds[BIN_COUNT];
+					uint32_t rightCounts[BIN_COUNT] = {};
+					for (uint32_t binId = BIN_COUNT - 1u; binId > 0u; binId--) {
+						rightBounds[binId] = bins->bounds[axis][binId];
+						rightCounts[binId] = bins->counts[axis][binId];
+						if (binId < (BIN_COUNT - 1u)) {
+							rightBounds[binId].Include(rightBounds[binId + 1u]);
+							rightCounts[binId] += rightCounts[binId + 1u];
+						}
+					}
+					RangeBounds leftBounds;
+					uint32_t leftCount = 0u;
+					for (uint32_t split = 1u; split < BIN_COUNT; split++) {
+						leftBounds.Include(bins->bounds[axis][split - 1u]);
+						leftCount += bins->counts[axis][split - 1u];
+						if (leftCount <= 0u || rightCounts[split] <= 0u)
+							continue;
+						const float cost = TRAVERSAL_COST +
+							(SurfaceArea(leftBounds.bounds) * float(leftCount) + SurfaceArea(rightBounds[split].bounds) * float(rightCounts[split])) / nodeArea;
+						if (cost < bestCost) {
+							bestCost = cost;
+							bestAxis = axis;
+							bestSplit = split;
+							bestLeft = leftBounds;
+							bestRight = rightBounds[split];
+						}
+					}
+				}
+			}
+
+			// Leaf, if splitting does not pay off:
+			if (count <= MAX_LEAF_SIZE && (bestAxis >= 3u || bestCost >= float(count)))
+				return;
+
+			// Partition:
+			uint32_t* const order = data->leafElements.data();
+			uint32_t mid;
+			if (bestAxis < 3u) {
+				const float start = task.bounds.centroidBounds.start[bestAxis];
+				const float scale = scales[bestAxis];
+				mid = static_cast<uint32_t>(std::partition(order + task.first, order + task.last, [&](uint32_t elementId) {
+					return BinId(centroids[elementId][bestAxis], start, scale) < bestSplit;
+					}) - order);
+			}
+			else {
+				// All centroids are the same; we just split in the middle to keep leaves small:
+				mid = task.first + (count >> 1u);
+				bestLeft = CalculateBounds(task.first, mid);
+				bestRight = CalculateBounds(mid, task.last);
+			}
+			assert(mid > task.first && mid < task.last);
+
+			// Create children:
+			const uint32_t firstChild = static_cast<uint32_t>(nodes.size());
+			{
+				Node& node = nodes[task.node];
+				node.firstIndex = firstChild;
+				node.elemCount = 0u;
+			}
+			nodes.resize(nodes.size() + 2u);
+			tasks.push_back(Task{ firstChild, task.first, mid, bestLeft });
+			tasks.push_back(Task{ firstChild + 1u, mid, task.last, bestRight });
+		}
+
+		// Builds a subtree on the calling thread (result[0] is the subtree root; child indices are local)
+		inline void BuildSubtree(const Task& root, std::vector<Node>& result)const {
+			result.clear();
+			result.resize(1u);
+			std::vector<Task> tasks;
+			tasks.push_back(Task{ 0u, root.first, root.last, root.bounds });
+			while (!tasks.empty()) {
+				const Task task = tasks.back();
+				tasks.pop_back();
+				ProcessTask(task, result, tasks);
+			}
+		}
+
+		// Builds the whole tree
+		inline void BuildTree(uint32_t elementCount, const RangeBounds& rootBounds) {
+			std::vector<Node>& nodes = data->nodes;
+			nodes.resize(1u);
+
+			// Top levels are split on the calling thread (with parallel binning), until the subtrees get small enough:
+			const size_t subtreeSize = Math::Max(size_t(elementCount) / Math::Max(threadCount * 8u, size_t(1u)), size_t(1024u));
+			std::vector<Task> tasks;
+			std::vector<Task> subtrees;
+			tasks.push_back(Task{ 0u, 0u, elementCount, rootBounds });
+			while (!tasks.empty()) {
+				const Task task = tasks.back();
+				tasks.pop_back();
+				if (threadCount > 1u && (task.last - task.first) <= subtreeSize)
+					subtrees.push_back(task);
+				else ProcessTask(task, nodes, tasks);
+			}
+			if (subtrees.empty())
+				return;
+
+			// Subtrees are built in parallel:
+			std::vector<std::vector<Node>> subtreeNodes(subtrees.size());
+			std::sort(subtrees.begin(), subtrees.end(), [](const Task& a, const Task& b) { return (a.last - a.first) > (b.last - b.first); });
+			ParallelFor(*threadBlock, threadCount, 0u, subtrees.size(), 1u, [&](size_t subtreeId) {
+				BuildSubtree(subtrees[subtreeId], subtreeNodes[subtreeId]);
+				});
+
+			// Subtrees are merged into the main node list (subtree roots replace the placeholders):
+			for (size_t subtreeId = 0u; subtreeId < subtrees.size(); subtreeId++) {
+				const std::vector<Node>& subtree = subtreeNodes[subtreeId];
+				const uint32_t offset = static_cast<uint32_t>(nodes.size()) - 1u;
+				auto fixChildIndex = [&](Node node) {
+					if (node.elemCount <= 0u)
+						node.firstIndex += offset;
+					return node;
+				};
+				nodes[subtrees[subtreeId].node] = fixChildIndex(subtree[0u]);
+				for (size_t i = 1u; i < subtree.size(); i++)
+					nodes.push_back(fixChildIndex(subtree[i]));
+			}
+		}
+	};
+
+	template<typename Type>
+	template<typename TypeIt, typename CalculateShapeBBox>
+	inline BVH<Type> BVH<Type>::Build(
+		const TypeIt& start, const TypeIt& end,
+		const CalculateShapeBBox& calculateShapeBBox,
+		ThreadBlock* threadBlock) {
+		const std::shared_ptr<Data> data = std::make_shared<Data>();
+		Builder builder(data);
+
+		// Collect elements:
+		for (TypeIt ptr = start; ptr != end; ++ptr)
+			data->elements.push_back(*ptr);
+		const size_t elementCount = data->elements.size();
+		if (elementCount <= 0u || elementCount > size_t(~uint32_t(0u)))
+			return {};
+
+		// Decide on thread count:
+		builder.threadCount = Builder::ThreadCount(elementCount, threadBlock);
+		builder.threadBlock = threadBlock;
+
+		// Calculate individual bounding boxes and centroids:
+		builder.elemBounds.resize(elementCount);
+		builder.centroids.resize(elementCount);
+		auto calculateElementBounds = [&](size_t i) {
+			const AABB bounds = Builder::ElementBounds(calculateShapeBBox(static_cast<const Type&>(data->elements[i])));
+			builder.elemBounds[i] = bounds;
+			builder.centroids[i] = (bounds.start + bounds.end) * 0.5f;
+		};
+		if (builder.threadBlock != nullptr)
+			ParallelFor(*builder.threadBlock, builder.threadCount, 0u, elementCount, 1024u, calculateElementBounds);
+		else for (size_t i = 0u; i < elementCount; i++)
+			calculateElementBounds(i);
+
+		// Collect elements with valid boundaries:
+		typename Builder::RangeBounds rootBounds;
+		for (size_t i = 0u; i < elementCount; i++) {
+			const AABB& bnd = builder.elemBounds[i];
+			if (Builder::IsValid(bnd)) {
+				data->leafElements.push_back(static_cast<uint32_t>(i));
+				rootBounds.Include(bnd, builder.centroids[i]);
+			}
+		}
+		if (data->leafElements.empty())
+			return {};
+
+		// Build node hierarchy:
+		builder.BuildTree(static_cast<uint32_t>(data->leafElements.size()), rootBounds);
+		return BVH(data);
+	}
+
+	template<typename Type>
+	template<typename TypeIt>
+	inline BVH<Type> BVH<Type>::Build(const TypeIt& start, const TypeIt& end, ThreadBlock* threadBlock) {
+		return Build(start, end, [](const Type& elem) { return Math::BoundingBox(elem); }, threadBlock);
+	}
+
+	template<typename Type>
+	template<typename TypeIt, typename CalculateShapeBBox>
+	inline BVH<Type> BVH<Type>::Refit(
+		const TypeIt& start, const TypeIt& end,
+		const CalculateShapeBBox& calculateShapeBBox,
+		ThreadBlock* threadBlock)const {
+		const std::shared_ptr<const Data> source = m_data;
+		const std::shared_ptr<Data> data = std::make_shared<Data>();
+
+		// Collect elements (if the count does not match, we just rebuild):
+		for (TypeIt ptr = start; ptr != end; ++ptr)
+			data->elements.push_back(*ptr);
+		if (source == nullptr || source->elements.size() != data->elements.size())
+			return Build(data->elements.begin(), data->elements.end(), calculateShapeBBox, threadBlock);
+		data->leafElements = source->leafElements;
+		data->nodes = source->nodes;
+
+		// Refit leaves:
+		const size_t threadCount = Builder::ThreadCount(data->elements.size(), threadBlock);
+		Node* const nodes = data->nodes.data();
+		const float aabbEpsilon = Math::INTERSECTION_EPSILON * 8.0f;
+		auto refitLeaf = [&](size_t nodeId) {
+			Node& node = nodes[nodeId];
+			if (node.elemCount <= 0u)
+				return;
+			AABB bounds = Builder::EmptyBounds();
+			const uint32_t* ptr = data->leafElements.data() + node.firstIndex;
+			const uint32_t* const ptrEnd = ptr + node.elemCount;
+			while (ptr < ptrEnd) {
+				const AABB bnd = Builder::ElementBounds(calculateShapeBBox(static_cast<const Type&>(data->elements[*ptr])));
+				ptr++;
+				if (Builder::IsValid(bnd))
+					Builder::Expand(bounds, bnd);
+			}
+			node.start = bounds.start - aabbEpsilon;
+			node.end = bounds.end + aabbEpsilon;
+		};
+		if (threadBlock != nullptr)
+			ParallelFor(*threadBlock, threadCount, 0u, data->nodes.size(), 256u, refitLeaf);
+		else for (size_t i = 0u; i < data->nodes.size(); i++)
+			refitLeaf(i);
+
+		// Refit internal nodes (children are always stored after their parents, so a reverse pass goes bottom-up):
+		for (size_t nodeId = data->nodes.size(); nodeId-- > 0u;) {
+			Node& node = nodes[nodeId];
+			if (node.elemCount > 0u)
+				continue;
+			AABB bounds = nodes[node.firstIndex].Bounds();
+			Builder::Expand(bounds, nodes[node.firstIndex + 1u].Bounds());
+			node.start = bounds.start;
+			node.end = bounds.end;
+		}
+
+		return BVH(data);
+	}
+
+	template<typename Type>
+	template<typename TypeIt>
+	inline BVH<Type> BVH<Type>::Refit(const TypeIt& start, const TypeIt& end, ThreadBlock* threadBlock)const {
+		return Refit(start, end, [](const Type& elem) { return Math::BoundingBox(elem); }, threadBlock);
+	}
+
+	template<typename Type>
+	inline AABB BVH<Type>::BoundingBox()const {
+		const std::shared_ptr<const Data> data = m_data;
+		return data == nullptr ? AABB(Vector3(0.0f), Vector3(0.0f)) : data->nodes[0u].Bounds();
+	}
+
+	template<typename Type>
+	inline size_t BVH<Type>::Size()const {
+		const std::shared_ptr<const Data> data = m_data;
+		return data == nullptr ? size_t(0u) : data->elements.size();
+	}
+
+	template<typename Type>
+	inline size_t BVH<Type>::NodeCount()const {
+		const std::shared_ptr<const Data> data = m_data;
+		return data == nullptr ? size_t(0u) : data->nodes.size();
+	}
+
+	template<typename Type>
+	inline const Type& BVH<Type>::operator[](size_t index)const {
+		return m_data->elements[index];
+	}
+
+	template<typename Type>
+	inline size_t BVH<Type>::IndexOf(const Type* element)const {
+		return element - m_data->elements.data();
+	}
+
+	template<typename Type>
+	template<typename InspectHit, typename OnLeafHitsFinished,
+		typename NodeDistance, typename SweepAgainstGeometry>
+	inline void BVH<Type>::Traverse(
+		const Vector3& position, const Vector3& direction,
+		const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished,
+		const NodeDistance& nodeDistance, const SweepAgainstGeometry& sweepAgainstGeometry)const {
+
+		// Check if there is data:
+		const std::shared_ptr<const Data> data = m_data;
+		if (data == nullptr)
+			return;
+		const Node* const nodes = data->nodes.data();
+		const Type* const elements = data->elements.data();
+		const uint32_t* const leafElements = data->leafElements.data();
+
+		// Pending nodes are kept in a min-heap, sorted by entry distance:
+		struct Entry {
+			float distance;
+			uint32_t node;
+			inline bool operator<(const Entry& other)const { return distance > other.distance; }
+		};
+		Stacktor<Entry, 64u> queue;
+		auto push = [&](uint32_t nodeId) {
+			const float distance = nodeDistance(nodes[nodeId]);
+			if (!std::isfinite(distance))
+				return;
+			queue.Push(Entry{ Math::Max(distance, 0.0f), nodeId });
+			std::push_heap(queue.Data(), queue.Data() + queue.Size());
+		};
+		push(0u);
+
+		// Hits are reported in batches; batch ends when no node is closer than the closest reported hit:
+		float closestBatchHit = std::numeric_limits<float>::infinity();
+		bool batchHasHits = false;
+		auto finishBatch = [&]() -> bool {
+			if (!batchHasHits)
+				return false;
+			batchHasHits = false;
+			closestBatchHit = std::numeric_limits<float>::infinity();
+			return onLeafHitsFinished() == CastHint::STOP_CAST;
+		};
+
+		while (queue.Size() > 0u) {
+			std::pop_heap(queue.Data(), queue.Data() + queue.Size());
+			const Entry entry = queue[queue.Size() - 1u];
+			queue.Pop();
+			if (entry.distance >= closestBatchHit && finishBatch())
+				return;
+			const Node& node = nodes[entry.node];
+
+			// Interior nodes just add children to the queue:
+			if (node.elemCount <= 0u) {
+				push(node.firstIndex);
+				push(node.firstIndex + 1u);
+				continue;
+			}
+
+			// Leaf node cast:
+			const Vector3 offsetPos = position + direction * entry.distance;
+			const uint32_t* ptr = leafElements + node.firstIndex;
+			const uint32_t* const end = ptr + node.elemCount;
+			while (ptr < end) {
+				const Type& surface = elements[*ptr];
+				ptr++;
+				const auto result = sweepAgainstGeometry(surface, offsetPos, direction);
+				const Math::SweepDistance sweepDistance = result;
+				if ((!std::isfinite(sweepDistance.distance)) || sweepDistance.distance < 0.0f)
+					continue;
+				const float totalDistance = entry.distance + sweepDistance.distance;
+				if (inspectHit(result, totalDistance, surface) == CastHint::STOP_CAST)
+					return;
+				batchHasHits = true;
+				closestBatchHit = Math::Min(closestBatchHit, totalDistance);
+			}
+		}
+		finishBatch();
+	}
+
+	template<typename Type>
+	template<typename InspectHit, typename OnLeafHitsFinished,
+		typename SweepAgainstAABB, typename SweepAgainstGeometry>
+	inline void BVH<Type>::Cast(
+		const Vector3& position, const Vector3& direction,
+		const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished,
+		const SweepAgainstAABB& sweepAgainstAABB, const SweepAgainstGeometry& sweepAgainstGeometry)const {
+		Traverse(position, direction, inspectHit, onLeafHitsFinished,
+			[&](const Node& node) {
+				const Math::SweepDistance distance = sweepAgainstAABB(node.Bounds(), position, direction);
+				return distance.distance;
+			}, sweepAgainstGeometry);
+	}
+
+	template<typename Type>
+	template<typename InspectHit, typename OnLeafHitsFinished>
+	inline void BVH<Type>::Raycast(
+		const Vector3& position, const Vector3& direction,
+		const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished)const {
+		const Vector3 inverseDirection = 1.0f / direction;
+		Traverse(position, direction, inspectHit, onLeafHitsFinished,
+			[&](const Node& node) { return RaycastBounds(node, position, inverseDirection); }, Math::Raycast<Type>);
+	}
+
+	template<typename Type>
+	template<typename Shape, typename InspectHit, typename OnLeafHitsFinished>
+	inline void BVH<Type>::Sweep(
+		const Shape& shape, const Vector3& position, const Vector3& direction,
+		const InspectHit& inspectHit, const OnLeafHitsFinished& onLeafHitsFinished)const {
+		Cast(position, direction, inspectHit, onLeafHitsFinished,
+			[&](const AABB& bbox, const Vector3& pos, const Vector3& dir) { return Math::Sweep<Shape, AABB>(shape, bbox, pos, dir); },
+			[&](const Type& target, const Vector3& pos, const Vector3& dir) { return Math::Sweep<Shape, Type>(shape, target, pos, dir); });
+	}
+
+	template<typename Type>
+	inline bool BVH<Type>::Raycast(
+		const Vector3& position, const Vector3& direction, RaycastResult& result)const {
+		return Octree<Type>::CastClosest([&](const auto& inspectHit, const auto& leafDone) { Raycast(position, direction, inspectHit, leafDone); }, result);
+	}
+
+	template<typename Type>
+	inline typename BVH<Type>::RaycastResult BVH<Type>::Raycast(
+		const Vector3& position, const Vector3& direction)const {
+		return Octree<Type>::template CastClosest<Math::RaycastResult<Type>>(
+			[&](const auto& inspectHit, const auto& leafDone) { Raycast(position, direction, inspectHit, leafDone); });
+	}
+
+	template<typename Type>
+	inline size_t BVH<Type>::RaycastAll(
+		const Vector3& position, const Vector3& direction, std::vector<RaycastResult>& result, bool sort)const {
+		return CastAll([&](const auto& inspectHit, const auto& leafDone) { Raycast(position, direction, inspectHit, leafDone); }, result, sort);
+	}
+
+	template<typename Type>
+	inline std::vector<typename BVH<Type>::RaycastResult> BVH<Type>::RaycastAll(
+		const Vector3& position, const Vector3& direction, bool sort)const {
+		return CastAll<Math::RaycastResult<Type>>(
+			[&](const auto& inspectHit, const auto& leafDone) { Raycast(position, direction, inspectHit, leafDone); }, sort);
+	}
+
+	template<typename Type>
+	template<typename Shape>
+	inline bool BVH<Type>::Sweep(
+		const Shape& shape, const Vector3& position, const Vector3& direction, SweepResult<Shape>& result)const {
+		return Octree<Type>::CastClosest([&](const auto& inspectHit, const auto& leafDone) { Sweep(shape, position, direction, inspectHit, leafDone); }, result);
+	}
+
+	template<typename Type>
+	template<typename Shape>
+	inline typename BVH<Type>::template SweepResult<Shape> BVH<Type>::Sweep(
+		const Shape& shape, const Vector3& position, const Vector3& direction)const {
+		return Octree<Type>::template CastClosest<Math::SweepResult<Shape, Type>>(
+			[&](const auto& inspectHit, const auto& leafDone) { Sweep(shape, position, direction, inspectHit, leafDone); });
+	}
+
+	template<typename Type>
+	template<typename Shape>
+	inline size_t BVH<Type>::SweepAll(
+		const Shape& shape, const Vector3& position, const Vector3& direction, std::vector<SweepResult<Shape>>& result, bool sort)const {
+		return CastAll([&](const auto& inspectHit, const auto& leafDone) { Sweep(shape, position, direction, inspectHit, leafDone); }, result, sort);
+	}
+
+	template<typename Type>
+	template<typename Shape>
+	inline std::vector<typename BVH<Type>::template SweepResult<Shape>> BVH<Type>::SweepAll(
+		const Shape& shape, const Vector3& position, const Vector3& direction, bool sort)const {
+		return CastAll<Math::SweepResult<Shape, Type>>(
+			[&](const auto& inspectHit, const auto& leafDone) { Sweep(shape, position, direction, inspectHit, leafDone); }, sort);
+	}
+}
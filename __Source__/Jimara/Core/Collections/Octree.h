@@ -1,5 +1,6 @@
 #pragma once
 #include "../../Math/Primitives/PosedAABB.h"
+#include "../../Math/RayPacket.h"
 #include <vector>
 #include <memory>
 
@@ -230,6 +231,18 @@ namespace Jimara {
 		/// <returns> All hits </returns>
 		inline std::vector<RaycastResult> RaycastAll(const Vector3& position, const Vector3& direction, bool sort = false)const;
 
+		/// <summary>
+		/// Raycasts a batch of rays, reporting the closest hit for each one of them
+		/// <para/> Rays are traversed in packets of Math::RayPacket::WIDTH, with SIMD bounding box tests; 
+		/// packets with rays going in different directions (octants) fall back to scalar Raycast calls.
+		/// <para/> Results are the same as the ones from individual Raycast calls; for best performance, neighboring rays should be coherent.
+		/// </summary>
+		/// <param name="positions"> Ray positions (rayCount elements) </param>
+		/// <param name="directions"> Ray directions (rayCount elements) </param>
+		/// <param name="rayCount"> Number of rays </param>
+		/// <param name="results"> Closest hit per ray will be stored here (null-target, if the ray does not hit anything; rayCount elements) </param>
+		inline void RaycastBatch(const Vector3* positions, const Vector3* directions, size_t rayCount, RaycastResult* results)const;
+
 		/// <summary>
 		/// Sweep, reporting the closest hit
 		/// </summary>
@@ -568,6 +581,43 @@ namespace Jimara {
 			return rv;
 		}
 
+		/// <summary>
+		/// Raycasts a batch of rays against a posed octree
+		/// <para/> Pose is inverted only once per batch and the rays are traversed with Octree::RaycastBatch in pose-space;
+		/// results are the same as the ones from individual Raycast calls.
+		/// </summary>
+		/// <param name="rayOrigins"> Ray origin points (rayCount elements) </param>
+		/// <param name="directions"> Ray directions (rayCount elements) </param>
+		/// <param name="rayCount"> Number of rays </param>
+		/// <param name="results"> Raycast info per ray will be stored here (rayCount elements) </param>
+		inline void RaycastBatch(const Vector3* rayOrigins, const Vector3* directions, size_t rayCount, Math::RaycastResult<PosedOctree>* results)const {
+			static const constexpr size_t CHUNK_SIZE = 64u;
+			const Matrix4 inverseTransform = Math::Inverse(pose);
+			Vector3 localOrigins[CHUNK_SIZE];
+			Vector3 localDirections[CHUNK_SIZE];
+			typename Octree<Type>::RaycastResult localResults[CHUNK_SIZE];
+			for (size_t chunkStart = 0u; chunkStart < rayCount; chunkStart += CHUNK_SIZE) {
+				const size_t chunkSize = Math::Min(rayCount - chunkStart, CHUNK_SIZE);
+				for (size_t i = 0u; i < chunkSize; i++) {
+					localOrigins[i] = Vector3(inverseTransform * Vector4(rayOrigins[chunkStart + i], 1.0f));
+					localDirections[i] = Math::Normalize(Vector3(inverseTransform * Vector4(directions[chunkStart + i], 0.0f)));
+				}
+				octree.RaycastBatch(localOrigins, localDirections, chunkSize, localResults);
+				for (size_t i = 0u; i < chunkSize; i++) {
+					const typename Octree<Type>::RaycastResult& localResult = localResults[i];
+					Math::RaycastResult<PosedOctree>& rv = results[chunkStart + i];
+					if (!localResult) {
+						rv = {};
+						continue;
+					}
+					rv.localHit = localResult.hit;
+					rv.hitPoint = pose * Vector4(static_cast<Vector3>(static_cast<Math::SweepHitPoint>(rv.localHit)), 1.0f);
+					rv.distance = Math::Magnitude(rv.hitPoint - rayOrigins[chunkStart + i]);
+					rv.target = localResult.target;
+				}
+			}
+		}
+
 		/// <summary>
 		/// Performs a Sweep against a posed octree
 		/// </summary>
@@ -1055,6 +1105,110 @@ namespace Jimara {
 			[&](const auto& inspectHit, const auto& leafDone) { Raycast(position, direction, inspectHit, leafDone); }, sort);
 	}
 
+	template<typename Type>
+	inline void Octree<Type>::RaycastBatch(const Vector3* positions, const Vector3* directions, size_t rayCount, RaycastResult* results)const {
+		for (size_t i = 0u; i < rayCount; i++)
+			results[i] = {};
+		const std::shared_ptr<const Data> data = m_data;
+		if (data == nullptr)
+			return;
+
+		static const constexpr uint32_t WIDTH = Math::RayPacket::WIDTH;
+		struct PacketEntry {
+			const Node* node;
+			uint32_t laneMask;
+			float distances[WIDTH];
+		};
+		Stacktor<PacketEntry, 64u> stack;
+		for (size_t packetStart = 0u; packetStart < rayCount; packetStart += WIDTH) {
+			const size_t packetSize = Math::Min(rayCount - packetStart, size_t(WIDTH));
+			const Math::RayPacket packet(positions + packetStart, directions + packetStart, packetSize);
+			const Vector3* const packetPositions = positions + packetStart;
+			const Vector3* const packetDirections = directions + packetStart;
+			RaycastResult* const packetResults = results + packetStart;
+
+			// Incoherent rays would visit children in different order; those are handled by scalar code:
+			if (packetSize <= 1u || (!packet.Coherent())) {
+				for (size_t i = 0u; i < packetSize; i++)
+					Raycast(packetPositions[i], packetDirections[i], packetResults[i]);
+				continue;
+			}
+			const uint8_t childOrder = static_cast<uint8_t>(
+				((packet.negativeMask[0u] != 0u) ? 1u : 0u) |
+				((packet.negativeMask[1u] != 0u) ? 2u : 0u) |
+				((packet.negativeMask[2u] != 0u) ? 4u : 0u));
+
+			// Same as the leaf cast from Cast(), but for each ray that got to the leaf (rays with hits get marked as done):
+			uint32_t doneMask = 0u;
+			const auto castInLeaf = [&](const Node* node, uint32_t laneMask, const float* nodeDistances) {
+				float distances[WIDTH];
+				Vector3 offsetPositions[WIDTH];
+				for (uint32_t lane = 0u; lane < WIDTH; lane++)
+					if ((laneMask & (1u << lane)) != 0u) {
+						distances[lane] = Math::Max(nodeDistances[lane], 0.0f);
+						offsetPositions[lane] = packetPositions[lane] + packetDirections[lane] * distances[lane];
+					}
+				uint32_t hitMask = 0u;
+				const Type* const* ptr = node->elements;
+				const Type* const* const end = ptr + node->elemCount;
+				while (ptr < end) {
+					const Type& surface = **ptr;
+					ptr++;
+					for (uint32_t lane = 0u; lane < WIDTH; lane++) {
+						const uint32_t laneBit = (1u << lane);
+						if ((laneMask & laneBit) == 0u)
+							continue;
+						const Math::RaycastResult<Type> result = Math::Raycast<Type>(surface, offsetPositions[lane], packetDirections[lane]);
+						const Math::SweepDistance sweepDistance = result;
+						if ((!std::isfinite(sweepDistance.distance)) || sweepDistance.distance < 0.0f)
+							continue;
+						{
+							const Math::SweepHitPoint hitPoint = result;
+							const auto overlap = Math::Overlap<Vector3, AABB>(hitPoint.position, node->bounds);
+							const Math::ShapeOverlapVolume overlapVolume = overlap;
+							if ((!std::isfinite(overlapVolume.volume)) || overlapVolume.volume < 0.0f)
+								continue;
+						}
+						const float totalDistance = distances[lane] + sweepDistance.distance;
+						if ((hitMask & laneBit) == 0u || totalDistance < packetResults[lane].totalDistance)
+							packetResults[lane] = RaycastResult{ result, &surface, totalDistance };
+						hitMask |= laneBit;
+					}
+				}
+				doneMask |= hitMask;
+			};
+
+			// Depth-first traversal in the same child order as Cast(); children are tested when the parent gets visited, 
+			// so that only the ones hit by at least one active ray land on the stack:
+			stack.Clear();
+			{
+				PacketEntry root = {};
+				root.node = data->nodes.data();
+				root.laneMask = packet.CastPreInversed(root.node->bounds, root.distances);
+				stack.Push(root);
+			}
+			while (stack.Size() > 0u && doneMask != packet.validMask) {
+				const PacketEntry entry = stack[stack.Size() - 1u];
+				stack.Pop();
+				const uint32_t laneMask = entry.laneMask & (~doneMask);
+				if (laneMask == 0u)
+					continue;
+				else if (entry.node->elemCount > 0u)
+					castInLeaf(entry.node, laneMask, entry.distances);
+				else for (uint8_t childIndex = static_cast<uint8_t>(8u); childIndex > static_cast<uint8_t>(0u); childIndex--) {
+					const Node* const childPtr = entry.node->children[(childIndex - 1u) ^ childOrder];
+					if (childPtr == nullptr)
+						continue;
+					PacketEntry childEntry = {};
+					childEntry.node = childPtr;
+					childEntry.laneMask = packet.CastPreInversed(childPtr->bounds, childEntry.distances) & laneMask;
+					if (childEntry.laneMask != 0u)
+						stack.Push(childEntry);
+				}
+			}
+		}
+	}
+
 	template<typename Type>
 	template<typename Shape>
 	inline bool Octree<Type>::Sweep(
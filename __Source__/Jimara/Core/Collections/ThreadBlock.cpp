@@ -2,19 +2,55 @@
 
 
 namespace Jimara {
-	ThreadBlock::ThreadBlock() : m_executionArgs(nullptr) { }
+	namespace {
+		// Number of times the ADAPTIVE mode threads check for the state change before parking
+		static const constexpr size_t ADAPTIVE_SPIN_COUNT = 512u;
+
+		// Thread block, the current thread is executing a job for (used for nested TryExecute() call detection)
+		static thread_local const ThreadBlock* currentThreadBlock = nullptr;
+	}
+
+	ThreadBlock::ThreadBlock(WaitMode waitMode) : m_waitMode(waitMode), m_executionArgs(nullptr) { }
 
 	ThreadBlock::~ThreadBlock() {
 		m_executionArgs = nullptr;
+		if (m_waitMode == WaitMode::ADAPTIVE) {
+			m_adaptiveState.quit = true;
+			m_adaptiveState.dispatch = (m_adaptiveState.dispatch.load() + (((uint64_t)1u) << 32u));
+			std::unique_lock<std::mutex> lock(m_adaptiveState.parkLock);
+			m_adaptiveState.workerCondition.notify_all();
+		}
 		m_threads.clear();
 	}
 
 	void ThreadBlock::Execute(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job) {
 		std::unique_lock<std::mutex> lock(m_callLock);
+		ExecuteLocked(threadCount, data, job);
+	}
+
+	bool ThreadBlock::TryExecute(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job) {
+		if (currentThreadBlock == this) {
+			m_busyCount++;
+			return false;
+		}
+		std::unique_lock<std::mutex> lock(m_callLock, std::try_to_lock);
+		if (!lock.owns_lock()) {
+			m_busyCount++;
+			return false;
+		}
+		ExecuteLocked(threadCount, data, job);
+		return true;
+	}
+
+	void ThreadBlock::ExecuteLocked(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job) {
 		ExecutionArgs args = {};
 		args.threadCount = threadCount;
 		args.job = &job;
 		args.userData = data;
+		if (m_waitMode == WaitMode::ADAPTIVE) {
+			ExecuteAdaptive(threadCount, &args);
+			return;
+		}
 		m_executionArgs = &args;
 		for (size_t i = 0; i < threadCount; i++) {
 			if (m_threads.size() <= i) m_threads.push_back(std::make_unique<ThreadData>(this, i));
@@ -23,8 +59,56 @@ namespace Jimara {
 		m_callerSemaphore.wait(threadCount);
 	}
 
+	void ThreadBlock::ExecuteAdaptive(size_t threadCount, const ExecutionArgs* args) {
+		if (threadCount <= 0u) return;
+		
+		// Make sure we have enough workers (calling thread is the worker 0, so m_threads[i] has threadId of i + 1):
+		const size_t workerCount = (threadCount - 1u);
+		while (m_threads.size() < workerCount)
+			m_threads.push_back(std::make_unique<ThreadData>(this, m_threads.size() + 1u));
+
+		// Wake the workers up:
+		if (workerCount > 0u) {
+			m_executionArgs = args;
+			m_adaptiveState.pendingThreads = workerCount;
+			const uint64_t generation = ((m_adaptiveState.dispatch.load() >> 32u) + 1u);
+			m_adaptiveState.dispatch = ((generation << 32u) | ((uint64_t)threadCount & 0xFFFFFFFFu));
+			if (m_adaptiveState.parkedWorkers.load() > 0u) {
+				std::unique_lock<std::mutex> lock(m_adaptiveState.parkLock);
+				m_adaptiveState.workerCondition.notify_all();
+			}
+		}
+
+		// Do our part of the job:
+		{
+			ThreadInfo info = {};
+			info.threadId = 0u;
+			info.threadCount = threadCount;
+			const ThreadBlock* const lastBlock = currentThreadBlock;
+			currentThreadBlock = this;
+			(*args->job)(info, args->userData);
+			currentThreadBlock = lastBlock;
+		}
+
+		// Wait for the workers:
+		size_t spinCount = 0u;
+		while (m_adaptiveState.pendingThreads.load() > 0u) {
+			if (spinCount < ADAPTIVE_SPIN_COUNT) {
+				spinCount++;
+				std::this_thread::yield();
+				continue;
+			}
+			std::unique_lock<std::mutex> lock(m_adaptiveState.parkLock);
+			m_adaptiveState.callerParked = true;
+			m_adaptiveState.callerCondition.wait(lock, [&]() { return m_adaptiveState.pendingThreads.load() <= 0u; });
+			m_adaptiveState.callerParked = false;
+		}
+	}
+
 	ThreadBlock::ThreadData::ThreadData(ThreadBlock* block, size_t threadId) {
-		thread = std::thread(ThreadBlock::BlockThread, block, threadId, &semaphore);
+		if (block->m_waitMode == WaitMode::ADAPTIVE)
+			thread = std::thread(ThreadBlock::AdaptiveBlockThread, block, threadId, block->m_adaptiveState.dispatch.load());
+		else thread = std::thread(ThreadBlock::BlockThread, block, threadId, &semaphore);
 	}
 
 	ThreadBlock::ThreadData::~ThreadData() {
@@ -33,6 +117,7 @@ namespace Jimara {
 	}
 
 	void ThreadBlock::BlockThread(ThreadBlock* self, size_t threadId, Semaphore* semaphore) {
+		currentThreadBlock = self;
 		while (true) {
 			semaphore->wait();
 			const ExecutionArgs* args = self->m_executionArgs;
@@ -47,4 +132,44 @@ namespace Jimara {
 			if (shouldQuit) break;
 		}
 	}
+
+	void ThreadBlock::AdaptiveBlockThread(ThreadBlock* self, size_t threadId, uint64_t lastDispatch) {
+		auto& state = self->m_adaptiveState;
+		currentThreadBlock = self;
+		while (true) {
+			// Spin for a while and park if there's no new dispatch:
+			size_t spinCount = 0u;
+			while (state.dispatch.load() == lastDispatch) {
+				if (spinCount < ADAPTIVE_SPIN_COUNT) {
+					spinCount++;
+					std::this_thread::yield();
+					continue;
+				}
+				std::unique_lock<std::mutex> lock(state.parkLock);
+				state.parkedWorkers++;
+				state.workerCondition.wait(lock, [&]() { return state.dispatch.load() != lastDispatch; });
+				state.parkedWorkers--;
+			}
+			lastDispatch = state.dispatch.load();
+			if (state.quit.load()) break;
+
+			// Threads that are not a part of the dispatch just go back to waiting 
+			// (dispatch can not change before all participating threads are done, so args are guaranteed to be valid for the ones that are):
+			const size_t threadCount = static_cast<size_t>(lastDispatch & 0xFFFFFFFFu);
+			if (threadId >= threadCount) continue;
+			const ExecutionArgs* args = self->m_executionArgs;
+			{
+				ThreadInfo info = {};
+				info.threadId = threadId;
+				info.threadCount = threadCount;
+				(*args->job)(info, args->userData);
+			}
+
+			// Report completion:
+			if (state.pendingThreads.fetch_sub(1u) == 1u && state.callerParked.load()) {
+				std::unique_lock<std::mutex> lock(state.parkLock);
+				state.callerCondition.notify_one();
+			}
+		}
+	}
 }
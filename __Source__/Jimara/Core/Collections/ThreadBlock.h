@@ -6,6 +6,7 @@
 #include <atomic>
 #include <memory>
 #include <cstdint>
+#include <condition_variable>
 
 
 namespace Jimara {
@@ -14,8 +15,23 @@ namespace Jimara {
 	/// </summary>
 	class JIMARA_API ThreadBlock {
 	public:
-		/// <summary> Constructor </summary>
-		ThreadBlock();
+		/// <summary> Strategy, the thread block uses to dispatch work and wait for it </summary>
+		enum class WaitMode : uint8_t {
+			/// <summary> Workers park on their semaphores right away and the calling thread just waits for them (jobs never run on the calling thread) </summary>
+			BLOCKING = 0,
+
+			/// <summary> 
+			/// Workers spin for a while before parking and the calling thread participates as the worker 0 
+			/// (lower dispatch latency for frequent small jobs, at the cost of some busy-waiting) 
+			/// </summary>
+			ADAPTIVE = 1
+		};
+
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="waitMode"> Dispatch/wait strategy </param>
+		ThreadBlock(WaitMode waitMode = WaitMode::BLOCKING);
 
 		/// <summary> Virtual destructor </summary>
 		virtual ~ThreadBlock();
@@ -37,8 +53,28 @@ namespace Jimara {
 		/// <param name="job"> Arbitrary "Job", taking thread information and user data as arguments </param>
 		void Execute(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job);
 
+		/// <summary>
+		/// Executes a job on a thread block, if the block is not busy
+		/// <para/> Unlike Execute(), this one does not wait for other Execute() calls to finish and is safe to invoke from within the block's own jobs;
+		/// <para/> If the block is busy (some other Execute() call is in progress, or this is a nested call from one of the block's jobs), nothing gets executed.
+		/// </summary>
+		/// <param name="threadCount"> Number of threads to use </param>
+		/// <param name="data"> User data to pass back into the job callback </param>
+		/// <param name="job"> Arbitrary "Job", taking thread information and user data as arguments </param>
+		/// <returns> True, if the job got executed, false if the block was busy </returns>
+		bool TryExecute(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job);
+
+		/// <summary> Number of TryExecute() calls so far, that did not execute anything, because the block was busy </summary>
+		inline size_t BusyCount()const { return m_busyCount.load(); }
+
+		/// <summary> Dispatch/wait strategy </summary>
+		inline WaitMode Mode()const { return m_waitMode; }
+
 
 	private:
+		// Dispatch/wait strategy
+		const WaitMode m_waitMode;
+
 		// Per-thread data
 		struct ThreadData {
 			std::thread thread;
@@ -51,6 +87,9 @@ namespace Jimara {
 		// We use this to protect Execute() calls
 		std::mutex m_callLock;
 
+		// Number of TryExecute() calls, rejected because the block was busy
+		std::atomic<size_t> m_busyCount = 0u;
+
 		// Active thread list
 		std::vector<std::unique_ptr<ThreadData>> m_threads;
 
@@ -67,7 +106,37 @@ namespace Jimara {
 		// Arguments, used in Execute() call (nullptr means termination request for the threads)
 		const ExecutionArgs* volatile m_executionArgs;
 
+		// State of the ADAPTIVE mode:
+		struct {
+			// Dispatch identifier (upper 32 bits hold a generation, incremented with each dispatch; lower 32 bits hold the thread count)
+			std::atomic<uint64_t> dispatch = 0u;
+
+			// Number of workers that have not yet finished the current dispatch
+			std::atomic<size_t> pendingThreads = 0u;
+
+			// Set on destruction
+			std::atomic<bool> quit = false;
+
+			// Number of workers, parked on workerCondition and a flag for the caller parked on callerCondition
+			std::atomic<size_t> parkedWorkers = 0u;
+			std::atomic<bool> callerParked = false;
+
+			// Parking lock and conditions
+			std::mutex parkLock;
+			std::condition_variable workerCondition;
+			std::condition_variable callerCondition;
+		} m_adaptiveState;
+
+		// Executes a job (m_callLock has to be locked)
+		void ExecuteLocked(size_t threadCount, void* data, const Callback<ThreadInfo, void*>& job);
+
+		// Executes a job in ADAPTIVE mode
+		void ExecuteAdaptive(size_t threadCount, const ExecutionArgs* args);
+
 		// Individual thread logic within the block
 		static void BlockThread(ThreadBlock* self, size_t threadId, Semaphore* semaphore);
+
+		// Individual thread logic within the block (ADAPTIVE mode)
+		static void AdaptiveBlockThread(ThreadBlock* self, size_t threadId, uint64_t lastDispatch);
 	};
 }
@@ -57,6 +57,14 @@ namespace Jimara {
 		/// <summary> Removes last geometric element from the VoxelGrid </summary>
 		inline void Pop();
 
+		/// <summary>
+		/// Removes a geometric element from the VoxelGrid
+		/// <para/> The last element takes the place of the removed one (the same as swapping with last and popping), 
+		/// but unlike reassigning the element, no overlap tests are performed for the moved element.
+		/// </summary>
+		/// <param name="index"> Index of the element to remove </param>
+		inline void RemoveAt(size_t index);
+
 		/// <summary>
 		/// Stored geometric element by index
 		/// </summary>
@@ -492,6 +500,18 @@ namespace Jimara {
 		m_elements.pop_back();
 	}
 
+	template<typename Type>
+	inline void VoxelGrid<Type>::RemoveAt(size_t index) {
+		RemoveElementInfo(index);
+		const size_t lastIndex = m_elements.size() - 1u;
+		if (index != lastIndex) {
+			m_elements[index] = std::move(m_elements[lastIndex]);
+			for (size_t nodeId = m_elements[index].firstNodeId; nodeId != NoId; nodeId = m_bucketNodes[nodeId].nextElemNodeId)
+				m_bucketNodes[nodeId].elementId = index;
+		}
+		m_elements.pop_back();
+	}
+
 	template<typename Type>
 	inline const Type& VoxelGrid<Type>::operator[](size_t index)const {
 		return m_elements[index].shape;
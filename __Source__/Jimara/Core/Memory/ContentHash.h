@@ -0,0 +1,137 @@
+#pragma once
+#include "MemoryBlock.h"
+#include <cstring>
+
+
+namespace Jimara {
+	/// <summary>
+	/// Content hashing helpers for change detection and persistent cache keys
+	/// <para/> Results are stable across runs and platforms, so they are safe to store in files.
+	/// </summary>
+	struct ContentHash {
+		/// <summary> Reverses the byte order of a 64 bit word </summary>
+		inline static constexpr uint64_t SwapBytes(uint64_t value) {
+			value = ((value & 0x00ff00ff00ff00ffull) << 8u) | ((value >> 8u) & 0x00ff00ff00ff00ffull);
+			value = ((value & 0x0000ffff0000ffffull) << 16u) | ((value >> 16u) & 0x0000ffff0000ffffull);
+			return (value << 32u) | (value >> 32u);
+		}
+
+		/// <summary>
+		/// xxHash64 (https://github.com/Cyan4973/xxHash) of given data
+		/// </summary>
+		/// <param name="data"> Data to hash </param>
+		/// <param name="size"> Number of bytes in data </param>
+		/// <param name="seed"> Hash seed </param>
+		/// <returns> 64 bit hash </returns>
+		inline static uint64_t XXHash64(const void* data, size_t size, uint64_t seed = 0u) {
+			static const constexpr uint64_t PRIME_1 = 11400714785074694791ull;
+			static const constexpr uint64_t PRIME_2 = 14029467366897019727ull;
+			static const constexpr uint64_t PRIME_3 = 1609587929392839161ull;
+			static const constexpr uint64_t PRIME_4 = 9650029242287828579ull;
+			static const constexpr uint64_t PRIME_5 = 2870177450012600261ull;
+			auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+			// Words are loaded with memcpy (no alignment requirements) and are interpreted as little-endian on every platform:
+			const bool nativeLittleEndian = (NativeEndian() == Endian::LITTLE);
+			auto read64 = [&](const uint8_t* ptr) {
+				uint64_t value;
+				std::memcpy(&value, ptr, sizeof(uint64_t));
+				return nativeLittleEndian ? value : SwapBytes(value);
+			};
+			auto read32 = [&](const uint8_t* ptr) {
+				uint32_t value;
+				std::memcpy(&value, ptr, sizeof(uint32_t));
+				return static_cast<uint64_t>(nativeLittleEndian ? value : static_cast<uint32_t>(SwapBytes(static_cast<uint64_t>(value)) >> 32u));
+			};
+			auto round = [&](uint64_t acc, uint64_t input) { return rotl(acc + input * PRIME_2, 31) * PRIME_1; };
+			auto mergeRound = [&](uint64_t acc, uint64_t value) { return (acc ^ round(0u, value)) * PRIME_1 + PRIME_4; };
+
+			const uint8_t* ptr = reinterpret_cast<const uint8_t*>(data);
+			const uint8_t* const end = ptr + size;
+			uint64_t hash;
+			if (size >= 32u) {
+				uint64_t v1 = seed + PRIME_1 + PRIME_2;
+				uint64_t v2 = seed + PRIME_2;
+				uint64_t v3 = seed;
+				uint64_t v4 = seed - PRIME_1;
+				const uint8_t* const limit = end - 32u;
+				do {
+					v1 = round(v1, read64(ptr)); ptr += 8u;
+					v2 = round(v2, read64(ptr)); ptr += 8u;
+					v3 = round(v3, read64(ptr)); ptr += 8u;
+					v4 = round(v4, read64(ptr)); ptr += 8u;
+				} while (ptr <= limit);
+				hash = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+				hash = mergeRound(hash, v1);
+				hash = mergeRound(hash, v2);
+				hash = mergeRound(hash, v3);
+				hash = mergeRound(hash, v4);
+			}
+			else hash = seed + PRIME_5;
+			hash += static_cast<uint64_t>(size);
+
+			while ((end - ptr) >= 8) {
+				hash ^= round(0u, read64(ptr));
+				hash = rotl(hash, 27) * PRIME_1 + PRIME_4;
+				ptr += 8u;
+			}
+			if ((end - ptr) >= 4) {
+				hash ^= read32(ptr) * PRIME_1;
+				hash = rotl(hash, 23) * PRIME_2 + PRIME_3;
+				ptr += 4u;
+			}
+			while (ptr < end) {
+				hash ^= static_cast<uint64_t>(*ptr) * PRIME_5;
+				hash = rotl(hash, 11) * PRIME_1;
+				ptr++;
+			}
+
+			hash ^= (hash >> 33u);
+			hash *= PRIME_2;
+			hash ^= (hash >> 29u);
+			hash *= PRIME_3;
+			hash ^= (hash >> 32u);
+			return hash;
+		}
+
+		/// <summary>
+		/// xxHash64 of a memory block
+		/// </summary>
+		/// <param name="block"> Data to hash </param>
+		/// <param name="seed"> Hash seed </param>
+		/// <returns> 64 bit hash </returns>
+		inline static uint64_t XXHash64(const MemoryBlock& block, uint64_t seed = 0u) { return XXHash64(block.Data(), block.Size(), seed); }
+
+		/// <summary> Seed of the second half of a Digest </summary>
+		static const constexpr uint64_t DIGEST_SEED = 0x9e3779b97f4a7c15ull;
+
+		/// <summary>
+		/// Pair of differently seeded xxHash64 values of the same data (128 bits in total)
+		/// <para/> Used where a collision would silently skip a real change (change detection), since both halves colliding at once is practically impossible.
+		/// </summary>
+		struct Digest {
+			/// <summary> xxHash64 of the data </summary>
+			uint64_t xxHash = 0u;
+
+			/// <summary> xxHash64 of the data with DIGEST_SEED </summary>
+			uint64_t seededHash = 0u;
+
+			/// <summary> Compares digests </summary>
+			inline bool operator==(const Digest& other)const { return xxHash == other.xxHash && seededHash == other.seededHash; }
+
+			/// <summary> Compares digests </summary>
+			inline bool operator!=(const Digest& other)const { return !((*this) == other); }
+		};
+
+		/// <summary>
+		/// Digest of a memory block
+		/// </summary>
+		/// <param name="block"> Data to hash </param>
+		/// <returns> Unseeded and DIGEST_SEED-seeded xxHash64 of the data </returns>
+		inline static Digest DigestOf(const MemoryBlock& block) {
+			Digest digest;
+			digest.xxHash = XXHash64(block);
+			digest.seededHash = XXHash64(block, DIGEST_SEED);
+			return digest;
+		}
+	};
+}
@@ -39,6 +39,14 @@ namespace Jimara {
 		return m_referenceCount;
 	}
 
+	bool Object::TryAddRef()const {
+		std::size_t count = m_referenceCount.load();
+		while (count > 0u)
+			if (m_referenceCount.compare_exchange_weak(count, count + 1u))
+				return true;
+		return false;
+	}
+
 	void Object::OnOutOfScope()const {
 		const BulkAllocated* bulkAllocated = dynamic_cast<const BulkAllocated*>(this);
 		if (bulkAllocated == nullptr) {
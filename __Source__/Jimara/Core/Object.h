@@ -55,6 +55,13 @@ namespace Jimara {
 		/// </summary>
 		virtual void OnOutOfScope()const;
 
+		/// <summary>
+		/// Increments reference counter, unless it has already reached 0
+		/// <para /> Useful for safely 'resurrecting' objects from raw pointers, while they may be concurrently going out of scope.
+		/// </summary>
+		/// <returns> True, if the reference counter got incremented </returns>
+		bool TryAddRef()const;
+
 
 
 	private:
@@ -3,7 +3,7 @@
 
 namespace Jimara {
 	JobSystem::JobSystem(size_t maxThreads, size_t threadThreshold) 
-		: m_maxThreads(maxThreads), m_threadThreshold(threadThreshold) {}
+		: m_maxThreads(maxThreads), m_threadThreshold(threadThreshold), m_threadBlock(ThreadBlock::WaitMode::ADAPTIVE) {}
 
 	JobSystem::~JobSystem() {}
 
@@ -17,16 +17,33 @@ namespace Jimara {
 
 	void JobSystem::InternalJobSet::Add(Job* job) {
 		std::unique_lock<std::mutex> lock(m_dataLock);
-		m_jobs.Add(job);
+		if (m_jobs.Add(job))
+			m_dirty = true;
 	}
 
 	void JobSystem::InternalJobSet::Remove(Job* job) {
 		std::unique_lock<std::mutex> lock(m_dataLock);
-		m_jobs.Remove(job);
+		if (m_jobs.Remove(job))
+			m_dirty = true;
 	}
 
 	JobSystem::JobSet& JobSystem::Jobs() { return m_jobs; }
 
+	void JobSystem::SetStaticTopology(bool staticTopology) {
+		std::unique_lock<std::mutex> executionLock(m_executionLock);
+		if (m_staticTopology == staticTopology) return;
+		m_staticTopology = staticTopology;
+		m_graphCached = false;
+		ReleaseJobGraph();
+	}
+
+	bool JobSystem::StaticTopology()const { return m_staticTopology; }
+
+	JobSystem::GraphStatistics JobSystem::GraphInfo()const {
+		std::unique_lock<SpinLock> lock(m_graphStatisticsLock);
+		return m_graphStatistics;
+	}
+
 
 
 	namespace {
@@ -40,10 +57,68 @@ namespace Jimara {
 
 	bool JobSystem::Execute(OS::Logger* log, const Callback<>& onIterationComplete) {
 		std::unique_lock<std::mutex> executionLock(m_executionLock);
+		CollectJobGraph();
+		const bool result = ExecuteIterative(log, onIterationComplete);
+		ReleaseJobGraph();
+		return result;
+	}
+
+	bool JobSystem::ExecuteScheduled(OS::Logger* log) {
+		std::unique_lock<std::mutex> executionLock(m_executionLock);
+		CollectJobGraph();
+		const bool result = ExecuteJobQueues(log);
+		ReleaseJobGraph();
+		return result;
+	}
+
+	void JobSystem::CollectJobGraph() {
+		const Stopwatch stopwatch;
+		
+		// Rebuild the graph or reset dependency counts from the cache:
+		const bool rebuild = (!m_staticTopology) || (!m_graphCached) || m_jobs.m_dirty.load() || (!JobGraphValid());
+		if (rebuild) {
+			BuildJobGraph();
+			m_graphCached = m_staticTopology;
+		}
+		else for (size_t i = 0; i < m_jobBuffer.Size(); i++) {
+			const JobWithDependencies& job = m_jobBuffer[i];
+			job.dependencies = job.dependencyCount;
+		}
+
+		// Update statistics:
+		{
+			const float elapsed = stopwatch.Elapsed();
+			std::unique_lock<SpinLock> lock(m_graphStatisticsLock);
+			m_graphStatistics.lastConstructionTime = elapsed;
+			m_graphStatistics.totalConstructionTime += elapsed;
+			m_graphStatistics.executionCount++;
+			if (rebuild) m_graphStatistics.rebuildCount++;
+			m_graphStatistics.jobCount = m_jobBuffer.Size();
+		}
+	}
 
+	bool JobSystem::JobGraphValid() {
+		for (size_t i = 0; i < m_jobBuffer.Size(); i++) {
+			const JobWithDependencies& job = m_jobBuffer[i];
+			if (job.job->m_dependencyRevision.load() != job.dependencyRevision) return false;
+		}
+		return true;
+	}
+
+	void JobSystem::ReleaseJobGraph() {
+		if (m_graphCached) return;
+		m_jobBuffer.Clear();
+		m_topologicalOrder.clear();
+		m_topologicalOrderValid = false;
+	}
+
+	void JobSystem::BuildJobGraph() {
 		// Transfer system contents to jobs:
+		m_jobBuffer.Clear();
+		m_topologicalOrderValid = false;
 		{
 			std::unique_lock<std::mutex> lock(m_jobs.m_dataLock);
+			m_jobs.m_dirty = false;
 			m_jobBuffer.Add(m_jobs.m_jobs.Data(), m_jobs.m_jobs.Size());
 		}
 
@@ -63,8 +138,10 @@ namespace Jimara {
 			{
 				const JobWithDependencies& jobData = m_jobBuffer[jobId];
 				job = jobData.job;
+				jobData.dependencyRevision = job->m_dependencyRevision.load();
 				job->CollectDependencies(recordDependency);
-				jobData.dependencies = m_dependencyBuffer.size();
+				jobData.dependencyCount = m_dependencyBuffer.size();
+				jobData.dependencies = jobData.dependencyCount;
 			}
 			for (std::unordered_set<Reference<Job>>::const_iterator it = m_dependencyBuffer.begin(); it != m_dependencyBuffer.end(); ++it) {
 				Job* dependency = *it;
@@ -81,7 +158,9 @@ namespace Jimara {
 			}
 			m_dependencyBuffer.clear();
 		}
+	}
 
+	bool JobSystem::ExecuteIterative(OS::Logger* log, const Callback<>& onIterationComplete) {
 		// Find jobs that are ready to execute:
 		ExecutableJobs* executableJobsBack = m_executableJobs;
 		ExecutableJobs* executableJobsFront = m_executableJobs + 1;
@@ -144,11 +223,163 @@ namespace Jimara {
 		executableJobsBack->executionIndex = 0u;
 		executableJobsFront->jobs.clear();
 		executableJobsFront->executionIndex = 0u;
-		m_jobBuffer.Clear();
 		return (unexecutedJobsLeft <= 0);
 	}
 
 
+	bool JobSystem::ExecuteJobQueues(OS::Logger* log) {
+		const size_t jobCount = m_jobBuffer.Size();
+
+		// Sort jobs topologically to detect cycles and find the widest 'level' of the graph:
+		SortJobGraph();
+		const size_t maxWidth = m_maxGraphWidth;
+		const size_t executableJobCount = m_topologicalOrder.size();
+		if (executableJobCount < jobCount && log != nullptr)
+			log->Error("JobSystem::Execute - Job graph has circular dependencies!");
+
+		// Distribute initially available jobs between the worker queues:
+		const size_t threadThreshold = std::max(m_threadThreshold.load(), (size_t)1u);
+		const size_t numThreads = std::max(std::min((maxWidth + threadThreshold - 1) / threadThreshold, m_maxThreads.load()), (size_t)1u);
+		while (m_workerQueues.size() < numThreads)
+			m_workerQueues.push_back(std::make_unique<WorkerQueue>());
+		for (size_t i = 0; i < executableJobCount; i++) {
+			const size_t jobId = m_topologicalOrder[i];
+			if (m_jobBuffer[jobId].dependencies.load() > 0u) break;
+			m_workerQueues[i % numThreads]->jobs.push_back(jobId);
+			m_queuedJobs++;
+		}
+		m_jobsLeft = executableJobCount;
 
-	JobSystem::JobWithDependencies::JobWithDependencies(Job* j) : job(j), dependencies(0) {}
+		// Execute jobs:
+		if (executableJobCount <= 0u) {}
+		else if (numThreads > 1u)
+			m_threadBlock.Execute(numThreads, this, Callback<ThreadBlock::ThreadInfo, void*>(JobSystem::ExecuteScheduledJobs));
+		else {
+			ThreadBlock::ThreadInfo info;
+			info.threadCount = 1;
+			info.threadId = 0;
+			ExecuteScheduledJobs(info, this);
+		}
+
+		// Clear runtime collections:
+		for (size_t i = 0; i < m_workerQueues.size(); i++)
+			m_workerQueues[i]->jobs.clear();
+		m_queuedJobs = 0u;
+		return (executableJobCount >= jobCount);
+	}
+
+	void JobSystem::SortJobGraph() {
+		if (m_topologicalOrderValid) return;
+		const size_t jobCount = m_jobBuffer.Size();
+		m_maxGraphWidth = 0u;
+		m_dependencyCountBuffer.resize(jobCount);
+		m_topologicalOrder.clear();
+		for (size_t i = 0; i < jobCount; i++) {
+			const size_t count = m_jobBuffer[i].dependencyCount;
+			m_dependencyCountBuffer[i] = count;
+			if (count <= 0) m_topologicalOrder.push_back(i);
+		}
+		size_t levelStart = 0u;
+		while (levelStart < m_topologicalOrder.size()) {
+			const size_t levelEnd = m_topologicalOrder.size();
+			m_maxGraphWidth = std::max(m_maxGraphWidth, levelEnd - levelStart);
+			for (size_t i = levelStart; i < levelEnd; i++) {
+				const std::vector<size_t>& dependants = m_dependants[m_topologicalOrder[i]];
+				for (size_t depId = 0; depId < dependants.size(); depId++) {
+					size_t& count = m_dependencyCountBuffer[dependants[depId]];
+					count--;
+					if (count <= 0) m_topologicalOrder.push_back(dependants[depId]);
+				}
+			}
+			levelStart = levelEnd;
+		}
+		m_topologicalOrderValid = true;
+	}
+
+	void JobSystem::ExecuteScheduledJobs(ThreadBlock::ThreadInfo info, void* selfPtr) {
+		JobSystem* const self = (JobSystem*)selfPtr;
+		WorkerQueue& ownQueue = *self->m_workerQueues[info.threadId];
+		
+		// Takes a job from the back of our own queue or steals one from the front of some other worker's queue:
+		auto getJob = [&](size_t& jobId) -> bool {
+			{
+				std::unique_lock<SpinLock> lock(ownQueue.lock);
+				if (!ownQueue.jobs.empty()) {
+					jobId = ownQueue.jobs.back();
+					ownQueue.jobs.pop_back();
+					self->m_queuedJobs.fetch_sub(1u);
+					return true;
+				}
+			}
+			for (size_t i = 1u; i < info.threadCount; i++) {
+				WorkerQueue& victim = *self->m_workerQueues[(info.threadId + i) % info.threadCount];
+				std::unique_lock<SpinLock> lock(victim.lock);
+				if (victim.jobs.empty()) continue;
+				jobId = victim.jobs.front();
+				victim.jobs.pop_front();
+				self->m_queuedJobs.fetch_sub(1u);
+				return true;
+			}
+			return false;
+		};
+
+		while (self->m_jobsLeft.load() > 0u) {
+			size_t jobId;
+			if (!getJob(jobId)) {
+				// Nothing to steal; park till some job gets queued or the last one is done:
+				std::unique_lock<std::mutex> lock(self->m_workerLock);
+				self->m_idleWorkers.fetch_add(1u);
+				self->m_workerCondition.wait(lock, [&]() { 
+					return self->m_queuedJobs.load() > 0u || self->m_jobsLeft.load() <= 0u; 
+				});
+				self->m_idleWorkers.fetch_sub(1u);
+				continue;
+			}
+
+			// Execute the job:
+			const JobWithDependencies& job = self->m_jobBuffer[jobId];
+			job.job->Execute();
+
+			// Dependants with no more pending dependencies become runnable right away:
+			const std::vector<size_t>& dependants = self->m_dependants[jobId];
+			for (size_t depId = 0; depId < dependants.size(); depId++) {
+				const JobWithDependencies& dep = self->m_jobBuffer[dependants[depId]];
+				if (dep.dependencies.fetch_sub(1u) != 1u) continue;
+				{
+					std::unique_lock<SpinLock> lock(ownQueue.lock);
+					ownQueue.jobs.push_back(dependants[depId]);
+				}
+				self->m_queuedJobs.fetch_add(1u);
+				self->WakeIdleWorkers(false);
+			}
+			if (self->m_jobsLeft.fetch_sub(1u) == 1u)
+				self->WakeIdleWorkers(true);
+		}
+	}
+
+	void JobSystem::WakeIdleWorkers(bool all) {
+		// Counters are updated before this call and m_idleWorkers is incremented under m_workerLock before the wait predicate is checked,
+		// so if we see no idle workers here, any worker that parks later is guaranteed to see the updated counters:
+		if (m_idleWorkers.load() <= 0u) return;
+		std::unique_lock<std::mutex> lock(m_workerLock);
+		if (all) m_workerCondition.notify_all();
+		else m_workerCondition.notify_one();
+	}
+
+
+
+	JobSystem::JobWithDependencies::JobWithDependencies(Job* j) 
+		: job(j), dependencies(0), dependencyCount(0), dependencyRevision(0) {}
+
+	JobSystem::JobWithDependencies::JobWithDependencies(const JobWithDependencies& other) 
+		: job(other.job), dependencies(other.dependencies.load())
+		, dependencyCount(other.dependencyCount), dependencyRevision(other.dependencyRevision) {}
+
+	JobSystem::JobWithDependencies& JobSystem::JobWithDependencies::operator=(const JobWithDependencies& other) {
+		job = other.job;
+		dependencies = other.dependencies.load();
+		dependencyCount = other.dependencyCount;
+		dependencyRevision = other.dependencyRevision;
+		return *this;
+	}
 }
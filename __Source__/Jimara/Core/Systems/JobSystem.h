@@ -4,8 +4,12 @@
 #include "../Helpers.h"
 #include "../Collections/ObjectSet.h"
 #include "../Collections/ThreadBlock.h"
+#include "../Synch/SpinLock.h"
+#include "../Stopwatch.h"
 #include "../../OS/Logging/Logger.h"
 #include <unordered_set>
+#include <condition_variable>
+#include <deque>
 
 
 namespace Jimara {
@@ -28,6 +32,16 @@ namespace Jimara {
 			/// <param name="addDependency"> Calling this will record dependency for given job (individual dependencies do not have to be added to the system to be invoked) </param>
 			virtual void CollectDependencies(Callback<Job*> addDependency) = 0;
 
+			/// <summary>
+			/// Should be invoked by the job whenever the set of dependencies, reported by CollectDependencies, changes
+			/// Note: Job systems with static topology rely on this call to know when to rebuild cached dependency graph; others just ignore it.
+			/// </summary>
+			inline void DependenciesChanged() { m_dependencyRevision++; }
+
+		private:
+			// Incremented on each DependenciesChanged() call
+			std::atomic<size_t> m_dependencyRevision = 0u;
+
 			/// <summary> Job system is allowed to invoke Execute and CollectDependencies callbacks </summary>
 			friend class JobSystem;
 		};
@@ -44,13 +58,24 @@ namespace Jimara {
 
 
 		/// <summary>
-		/// Executes entire job system
+		/// Executes entire job system in 'iterations'
+		/// Note: Each iteration executes all jobs that are ready at the moment, waits for them to finish and only then looks for the next ready set;
+		///		this guarantees that there's a barrier between the dependencies and their dependants.
 		/// </summary>
 		/// <param name="log"> Logger for JobSystem error reporting (this logger is not accessible by jobs themselves, it's just for the system itself) </param>
 		/// <param name="onIterationComplete"> Invoked after each iteration of non-interdependent task block execution </param>
 		/// <returns> True, if all jobs within the system have been executed, false otherwise </returns>
 		bool Execute(OS::Logger* log = nullptr, const Callback<>& onIterationComplete = Callback<>(Unused<>));
 
+		/// <summary>
+		/// Executes entire job system with dependency-driven scheduling
+		/// Note: Jobs are scheduled on per-thread queues (with work stealing) and each one becomes runnable as soon as all of it's own dependencies are done;
+		///		there are no 'iterations' in this mode, so the callers that need a synchronization point between dependency levels should use Execute() instead.
+		/// </summary>
+		/// <param name="log"> Logger for JobSystem error reporting (this logger is not accessible by jobs themselves, it's just for the system itself) </param>
+		/// <returns> True, if all jobs within the system have been executed, false otherwise </returns>
+		bool ExecuteScheduled(OS::Logger* log = nullptr);
+
 		/// <summary>
 		/// Adds a job to the system
 		/// </summary>
@@ -87,6 +112,39 @@ namespace Jimara {
 		/// <summary> Set of jobs from the JobSystem (for access to the system without the ability to execute the system or hold any references to it) </summary>
 		JobSet& Jobs();
 
+		/// <summary>
+		/// Enables or disables 'static topology' mode
+		/// Note: With static topology, flattened and sorted dependency graph is cached between Execute() calls and is only rebuilt 
+		///		when jobs get added or removed from the system, or when any of the cached jobs reports a change through Job::DependenciesChanged();
+		///		Only enable this if all jobs within the system (including the dependencies that are not directly added) report the changes correctly.
+		/// </summary>
+		/// <param name="staticTopology"> If true, dependency graph will be cached </param>
+		void SetStaticTopology(bool staticTopology);
+
+		/// <summary> True, if the dependency graph is cached between Execute() calls (false by default) </summary>
+		bool StaticTopology()const;
+
+		/// <summary> Dependency graph construction statistics </summary>
+		struct GraphStatistics {
+			/// <summary> Time (in seconds) spent on dependency graph construction/validation during the last Execute() call </summary>
+			float lastConstructionTime = 0.0f;
+
+			/// <summary> Total time (in seconds) spent on dependency graph construction/validation during all Execute() calls </summary>
+			float totalConstructionTime = 0.0f;
+
+			/// <summary> Number of Execute() calls so far </summary>
+			size_t executionCount = 0u;
+
+			/// <summary> Number of Execute() calls that had to (re)build the dependency graph </summary>
+			size_t rebuildCount = 0u;
+
+			/// <summary> Number of jobs (including dependencies that are not directly added) during the last Execute() call </summary>
+			size_t jobCount = 0u;
+		};
+
+		/// <summary> Dependency graph construction statistics </summary>
+		GraphStatistics GraphInfo()const;
+
 	private:
 		// Job collection
 		struct InternalJobSet : public virtual JobSet {
@@ -101,6 +159,9 @@ namespace Jimara {
 
 			// Job collection
 			ObjectSet<Job> m_jobs;
+
+			// Set when m_jobs changes (cleared by the system, once the graph is rebuilt)
+			std::atomic<bool> m_dirty = true;
 		} m_jobs;
 
 		// Lock for execution
@@ -115,12 +176,26 @@ namespace Jimara {
 		// Execution thread block
 		ThreadBlock m_threadBlock;
 
+		// If true, m_jobBuffer, m_dependants and m_topologicalOrder are kept between Execute() calls
+		std::atomic<bool> m_staticTopology = false;
+
+		// True, if the cached graph can be reused (static topology only)
+		bool m_graphCached = false;
+
+		// Dependency graph construction statistics
+		GraphStatistics m_graphStatistics;
+		mutable SpinLock m_graphStatisticsLock;
+
 		// Job description (execution time)
 		struct JobWithDependencies {
 			Reference<Job> job;
-			mutable size_t dependencies;
+			mutable std::atomic<size_t> dependencies;
+			mutable size_t dependencyCount;
+			mutable size_t dependencyRevision;
 
 			JobWithDependencies(Job* j = nullptr);
+			JobWithDependencies(const JobWithDependencies& other);
+			JobWithDependencies& operator=(const JobWithDependencies& other);
 		};
 
 		// Execution job buffer:
@@ -136,5 +211,56 @@ namespace Jimara {
 			std::atomic<size_t> executionIndex = 0u;
 		};
 		ExecutableJobs m_executableJobs[2];
+
+		// Per-thread job queues for dependency-driven execution (owner thread works from the back, others steal from the front):
+		struct WorkerQueue {
+			SpinLock lock;
+			std::deque<size_t> jobs;
+		};
+		std::vector<std::unique_ptr<WorkerQueue>> m_workerQueues;
+
+		// Number of jobs, the worker threads still have to execute:
+		std::atomic<size_t> m_jobsLeft = 0u;
+
+		// Number of jobs, currently sitting in the worker queues:
+		std::atomic<size_t> m_queuedJobs = 0u;
+
+		// Idle workers wait on m_workerCondition till a job gets queued or there's nothing left to execute:
+		std::mutex m_workerLock;
+		std::condition_variable m_workerCondition;
+		std::atomic<size_t> m_idleWorkers = 0u;
+
+		// Dependency counts and topological order (used for cycle detection and the initial job distribution):
+		std::vector<size_t> m_dependencyCountBuffer;
+		std::vector<size_t> m_topologicalOrder;
+		size_t m_maxGraphWidth = 0u;
+		bool m_topologicalOrderValid = false;
+
+		// Transfers jobs from m_jobs to m_jobBuffer and fills dependency counts and m_dependants (or resets counts from the cache, if possible)
+		void CollectJobGraph();
+
+		// Builds m_jobBuffer and m_dependants from scratch
+		void BuildJobGraph();
+
+		// Checks if the cached graph is still valid
+		bool JobGraphValid();
+
+		// Fills m_topologicalOrder and m_maxGraphWidth if they are not valid already
+		void SortJobGraph();
+
+		// Clears job graph unless the topology is static
+		void ReleaseJobGraph();
+
+		// Executes jobs iteratively (with a barrier and onIterationComplete() call after each wave)
+		bool ExecuteIterative(OS::Logger* log, const Callback<>& onIterationComplete);
+
+		// Executes jobs with per-thread queues and work stealing
+		bool ExecuteJobQueues(OS::Logger* log);
+
+		// Wakes idle workers up, if there are any (invoked after a job gets queued or the last job is done)
+		void WakeIdleWorkers(bool all);
+
+		// Worker thread logic for ExecuteJobQueues
+		static void ExecuteScheduledJobs(ThreadBlock::ThreadInfo info, void* selfPtr);
 	};
 }
@@ -0,0 +1,193 @@
+#pragma once
+#include "../Collections/ThreadBlock.h"
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+
+namespace Jimara {
+	/// <summary>
+	/// Helpers for ParallelFor/ParallelReduce/ParallelSort implementations
+	/// </summary>
+	namespace ParallelHelpers {
+		/// <summary>
+		/// Executes a job on given thread block, or on the calling thread (as a single 'thread'), if the block is busy or threadCount is not greater than 1
+		/// <para/> Jobs are expected to claim their work through atomic counters, since any thread might end up doing all the work.
+		/// </summary>
+		/// <typeparam name="JobFn"> Callable, taking ThreadBlock::ThreadInfo as an argument </typeparam>
+		/// <param name="block"> Thread block to use </param>
+		/// <param name="threadCount"> Number of threads to use </param>
+		/// <param name="job"> Job to execute </param>
+		/// <returns> False, if the block was busy and the job had to fall back to the calling thread, true otherwise </returns>
+		template<typename JobFn>
+		inline static bool Execute(ThreadBlock& block, size_t threadCount, const JobFn& job) {
+			typedef void(*ExecuteFn)(ThreadBlock::ThreadInfo, void*);
+			static const ExecuteFn execute = [](ThreadBlock::ThreadInfo info, void* jobPtr) {
+				(*reinterpret_cast<const JobFn*>(jobPtr))(info);
+			};
+			void* const jobPtr = reinterpret_cast<void*>(const_cast<JobFn*>(&job));
+			const bool parallel = (threadCount > 1u);
+			if (parallel && block.TryExecute(threadCount, jobPtr, Callback<ThreadBlock::ThreadInfo, void*>(execute)))
+				return true;
+			ThreadBlock::ThreadInfo info = {};
+			info.threadId = 0u;
+			info.threadCount = 1u;
+			execute(info, jobPtr);
+			return (!parallel);
+		}
+
+		/// <summary>
+		/// Calculates the number of threads, worth using for given amount of work
+		/// </summary>
+		/// <param name="count"> Number of elements </param>
+		/// <param name="grainSize"> Minimal number of elements per chunk </param>
+		/// <param name="maxThreads"> Maximal number of threads </param>
+		/// <returns> Thread count </returns>
+		inline static size_t ThreadCount(size_t count, size_t grainSize, size_t maxThreads) {
+			return std::max(std::min((count + grainSize - 1u) / grainSize, maxThreads), size_t(1u));
+		}
+	}
+
+
+	/// <summary>
+	/// Invokes fn(i) for each i in [first, last) on a thread block
+	/// <para/> Threads claim chunks of decreasing size (never smaller than grainSize), so that uneven per-element costs get balanced;
+	/// <para/> Safe to invoke from within jobs (including the jobs of the same block): if the block is busy, everything runs on the calling thread.
+	/// </summary>
+	/// <typeparam name="Fn"> Callable, taking size_t index as an argument </typeparam>
+	/// <param name="block"> Thread block to use </param>
+	/// <param name="maxThreads"> Maximal number of threads to use </param>
+	/// <param name="first"> First index </param>
+	/// <param name="last"> End of the index range (exclusive) </param>
+	/// <param name="grainSize"> Minimal number of indices per chunk (0 will be treated as 1) </param>
+	/// <param name="fn"> Function to invoke for each index </param>
+	/// <returns> False, if the block was busy and everything ran on the calling thread (ThreadBlock::BusyCount() is incremented as well), true otherwise </returns>
+	template<typename Fn>
+	inline static bool ParallelFor(ThreadBlock& block, size_t maxThreads, size_t first, size_t last, size_t grainSize, const Fn& fn) {
+		if (last <= first) return true;
+		grainSize = std::max(grainSize, size_t(1u));
+		const size_t count = (last - first);
+		const size_t threadCount = ParallelHelpers::ThreadCount(count, grainSize, maxThreads);
+		std::atomic<size_t> next = first;
+		auto job = [&](ThreadBlock::ThreadInfo) {
+			while (true) {
+				size_t chunkStart = next.load();
+				size_t chunkEnd;
+				while (true) {
+					if (chunkStart >= last) return;
+					const size_t remaining = (last - chunkStart);
+					chunkEnd = chunkStart + std::min(remaining, std::max(grainSize, remaining / (threadCount * 2u)));
+					if (next.compare_exchange_weak(chunkStart, chunkEnd)) break;
+				}
+				for (size_t i = chunkStart; i < chunkEnd; i++)
+					fn(i);
+			}
+		};
+		return ParallelHelpers::Execute(block, threadCount, job);
+	}
+
+	/// <summary>
+	/// Reduces [first, last) index range to a single value on a thread block
+	/// <para/> Range is split into fixed chunks of grainSize elements and partial results are combined in chunk order,
+	/// so the result does not depend on the thread count or timing (even for non-associative floating point math);
+	/// <para/> Safe to invoke from within jobs (including the jobs of the same block): if the block is busy, everything runs on the calling thread
+	///		(such fallbacks can be detected through ThreadBlock::BusyCount()).
+	/// </summary>
+	/// <typeparam name="ValueType"> Reduction result type </typeparam>
+	/// <typeparam name="AccumulateFn"> Callable, taking (ValueType& accumulator, size_t index) as arguments </typeparam>
+	/// <typeparam name="CombineFn"> Callable, taking (const ValueType& a, const ValueType& b) as arguments and returning combined ValueType </typeparam>
+	/// <param name="block"> Thread block to use </param>
+	/// <param name="maxThreads"> Maximal number of threads to use </param>
+	/// <param name="first"> First index </param>
+	/// <param name="last"> End of the index range (exclusive) </param>
+	/// <param name="grainSize"> Number of indices per chunk (0 will be treated as 1) </param>
+	/// <param name="identity"> Initial value of each partial result </param>
+	/// <param name="accumulate"> Accumulates an index into partial result </param>
+	/// <param name="combine"> Combines two partial results </param>
+	/// <returns> Reduction result (identity, if the range is empty) </returns>
+	template<typename ValueType, typename AccumulateFn, typename CombineFn>
+	inline static ValueType ParallelReduce(
+		ThreadBlock& block, size_t maxThreads, size_t first, size_t last, size_t grainSize,
+		const ValueType& identity, const AccumulateFn& accumulate, const CombineFn& combine) {
+		if (last <= first) return identity;
+		grainSize = std::max(grainSize, size_t(1u));
+		const size_t count = (last - first);
+		const size_t chunkCount = (count + grainSize - 1u) / grainSize;
+		std::vector<ValueType> partialResults(chunkCount, identity);
+		std::atomic<size_t> nextChunk = 0u;
+		auto job = [&](ThreadBlock::ThreadInfo) {
+			while (true) {
+				const size_t chunkId = nextChunk.fetch_add(1u);
+				if (chunkId >= chunkCount) return;
+				const size_t chunkStart = first + (chunkId * grainSize);
+				const size_t chunkEnd = std::min(chunkStart + grainSize, last);
+				ValueType& result = partialResults[chunkId];
+				for (size_t i = chunkStart; i < chunkEnd; i++)
+					accumulate(result, i);
+			}
+		};
+		ParallelHelpers::Execute(block, ParallelHelpers::ThreadCount(count, grainSize, maxThreads), job);
+		ValueType result = partialResults[0u];
+		for (size_t i = 1u; i < chunkCount; i++)
+			result = combine(result, partialResults[i]);
+		return result;
+	}
+
+	/// <summary>
+	/// Sorts a random access range on a thread block
+	/// <para/> Range is split into chunks that get sorted in parallel and then merged pairwise in parallel rounds;
+	/// <para/> Sort is not stable; safe to invoke from within jobs (if the block is busy, everything runs on the calling thread).
+	/// </summary>
+	/// <typeparam name="IteratorType"> Random access iterator type </typeparam>
+	/// <typeparam name="CompareFn"> Comparator (same as the one std::sort expects) </typeparam>
+	/// <param name="block"> Thread block to use </param>
+	/// <param name="maxThreads"> Maximal number of threads to use </param>
+	/// <param name="first"> Range start </param>
+	/// <param name="last"> Range end </param>
+	/// <param name="grainSize"> Minimal number of elements per chunk (0 will be treated as 1) </param>
+	/// <param name="compare"> Comparator </param>
+	/// <returns> False, if the block was busy during any of the passes and some of the work ran on the calling thread, true otherwise </returns>
+	template<typename IteratorType, typename CompareFn>
+	inline static bool ParallelSort(ThreadBlock& block, size_t maxThreads, IteratorType first, IteratorType last, size_t grainSize, const CompareFn& compare) {
+		if (last <= first) return true;
+		grainSize = std::max(grainSize, size_t(1u));
+		const size_t count = static_cast<size_t>(std::distance(first, last));
+		const size_t threadCount = ParallelHelpers::ThreadCount(count, grainSize, maxThreads);
+		if (threadCount <= 1u) {
+			std::sort(first, last, compare);
+			return true;
+		}
+
+		// Sort chunks (chunk count is a power of 2 for simpler merging):
+		size_t chunkCount = 1u;
+		while (chunkCount < threadCount) chunkCount <<= 1u;
+		const size_t chunkSize = (count + chunkCount - 1u) / chunkCount;
+		auto chunkStart = [&](size_t chunkId) { return first + static_cast<std::ptrdiff_t>(std::min(chunkId * chunkSize, count)); };
+		bool parallel = ParallelFor(block, threadCount, 0u, chunkCount, 1u, [&](size_t chunkId) {
+			std::sort(chunkStart(chunkId), chunkStart(chunkId + 1u), compare);
+			});
+
+		// Merge sorted chunks:
+		for (size_t mergeSize = 1u; mergeSize < chunkCount; mergeSize <<= 1u)
+			parallel &= ParallelFor(block, threadCount, 0u, chunkCount / (mergeSize << 1u), 1u, [&](size_t mergeId) {
+				const size_t firstChunk = mergeId * (mergeSize << 1u);
+				std::inplace_merge(chunkStart(firstChunk), chunkStart(firstChunk + mergeSize), chunkStart(firstChunk + (mergeSize << 1u)), compare);
+				});
+		return parallel;
+	}
+
+	/// <summary>
+	/// Sorts a random access range on a thread block using operator&lt;
+	/// </summary>
+	/// <typeparam name="IteratorType"> Random access iterator type </typeparam>
+	/// <param name="block"> Thread block to use </param>
+	/// <param name="maxThreads"> Maximal number of threads to use </param>
+	/// <param name="first"> Range start </param>
+	/// <param name="last"> Range end </param>
+	/// <param name="grainSize"> Minimal number of elements per chunk (0 will be treated as 1) </param>
+	/// <returns> False, if the block was busy during any of the passes and some of the work ran on the calling thread, true otherwise </returns>
+	template<typename IteratorType>
+	inline static bool ParallelSort(ThreadBlock& block, size_t maxThreads, IteratorType first, IteratorType last, size_t grainSize) {
+		return ParallelSort(block, maxThreads, first, last, grainSize, [](const auto& a, const auto& b) { return a < b; });
+	}
+}
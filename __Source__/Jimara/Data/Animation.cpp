@@ -5,6 +5,177 @@
 
 
 namespace Jimara {
+	namespace {
+		// Shifts each one of the euler angles by a multiple of 360 degrees to bring it as close to the previous sample as possible
+		// Note: Equivalent triplets, like (180 - x, y + 180, z + 180), are intentionally ignored, since those would break per-component blending
+		//		(LerpAngles) between the clips that do not share the same representation.
+		inline static Vector3 UnwrapEulerAngles(const Vector3& previous, const Vector3& angles) {
+			auto unwrapAngle = [](float prev, float angle) { return angle + 360.0f * std::round((prev - angle) / 360.0f); };
+			return Vector3(unwrapAngle(previous.x, angles.x), unwrapAngle(previous.y, angles.y), unwrapAngle(previous.z, angles.z));
+		}
+	}
+
+	Reference<BakedAnimationClip> BakedAnimationClip::Bake(const AnimationClip* clip, float sampleRate) {
+		return Bake(clip, CompressionSettings(), sampleRate);
+	}
+
+	Reference<BakedAnimationClip> BakedAnimationClip::Bake(const AnimationClip* clip, const CompressionSettings& compression, float sampleRate) {
+		if (clip == nullptr) return nullptr;
+		Reference<BakedAnimationClip> result = new BakedAnimationClip();
+		result->ReleaseRef();
+
+		// Sample count and rate:
+		const float duration = std::abs(clip->Duration());
+		result->m_duration = duration;
+		result->m_sampleCount = Math::Max(static_cast<size_t>(std::ceil(duration * Math::Max(sampleRate, 0.0f))) + 1u, size_t(2u));
+		const size_t sampleCount = result->m_sampleCount;
+		auto sampleTime = [&](size_t sampleId, size_t count) {
+			return ((sampleId + 1u) < count) ? (static_cast<float>(sampleId) * duration / static_cast<float>(count - 1u)) : duration;
+		};
+		auto samplesPerSecond = [&](size_t count) {
+			return (duration > std::numeric_limits<float>::epsilon()) ? (static_cast<float>(count - 1u) / duration) : 0.0f;
+		};
+
+		// Uncompressed samples of the current track:
+		std::vector<float> rawSamples;
+
+		// Tries to compress the track using rawSamples (stores quantized samples and returns true on success):
+		std::vector<size_t> quantizedOffsets(clip->TrackCount(), ~size_t(0u));
+		std::vector<uint16_t> candidate;
+		auto compressTrack = [&](size_t trackId, float tolerance) -> bool {
+			Track& baked = result->m_tracks[trackId];
+			const size_t componentCount = baked.m_componentCount;
+			auto error = [&](float a, float b) {
+				return baked.m_angles ? std::abs(Math::FloatRemainder(a - b + 180.0f, 360.0f) - 180.0f) : std::abs(a - b);
+			};
+
+			// Constant tracks need only one value:
+			bool constant = true;
+			for (size_t component = 0u; component < componentCount; component++) {
+				const float* samples = rawSamples.data() + (component * sampleCount);
+				float minimum = samples[0u];
+				float maximum = samples[0u];
+				for (size_t sampleId = 1u; sampleId < sampleCount; sampleId++) {
+					minimum = Math::Min(minimum, samples[sampleId]);
+					maximum = Math::Max(maximum, samples[sampleId]);
+				}
+				baked.m_offset[component] = minimum;
+				baked.m_scale[component] = (maximum - minimum) / static_cast<float>(std::numeric_limits<uint16_t>::max());
+				if ((maximum - minimum) > (2.0f * tolerance))
+					constant = false;
+			}
+			if (constant) {
+				for (size_t component = 0u; component < componentCount; component++)
+					baked.m_offset[component] += baked.m_scale[component] * 0.5f * static_cast<float>(std::numeric_limits<uint16_t>::max());
+				baked.m_sampleCount = 2u;
+				baked.m_samplesPerSecond = 0.0f;
+				return true;
+			}
+
+			// Try lowering the sample rate, starting from the lowest one:
+			size_t stride = 1u;
+			while ((stride << 1u) < sampleCount) stride <<= 1u;
+			while (stride > 0u) {
+				const size_t count = ((sampleCount - 1u + stride - 1u) / stride) + 1u;
+				stride >>= 1u;
+				candidate.resize(count * componentCount);
+				baked.m_sampleCount = count;
+				baked.m_samplesPerSecond = samplesPerSecond(count);
+				baked.m_quantizedSamples = candidate.data();
+
+				// Quantize resampled values:
+				for (size_t component = 0u; component < componentCount; component++) {
+					const float* samples = rawSamples.data() + (component * sampleCount);
+					const float offset = baked.m_offset[component];
+					const float scale = baked.m_scale[component];
+					for (size_t sampleId = 0u; sampleId < count; sampleId++) {
+						const float position = Math::Min(sampleTime(sampleId, count) * samplesPerSecond(sampleCount), static_cast<float>(sampleCount - 1u));
+						const size_t index = Math::Min(static_cast<size_t>(position), sampleCount - 2u);
+						const float value = Math::Lerp(samples[index], samples[index + 1u], position - static_cast<float>(index));
+						const float quantized = (scale > 0.0f) ? std::round((value - offset) / scale) : 0.0f;
+						candidate[(component * count) + sampleId] = static_cast<uint16_t>(
+							Math::Min(Math::Max(quantized, 0.0f), static_cast<float>(std::numeric_limits<uint16_t>::max())));
+					}
+				}
+
+				// Validate against the original samples:
+				bool valid = true;
+				for (size_t sampleId = 0u; valid && sampleId < sampleCount; sampleId++) {
+					size_t index; float fraction;
+					baked.Locate(sampleTime(sampleId, sampleCount), index, fraction);
+					for (size_t component = 0u; component < componentCount; component++)
+						if (error(baked.SampleComponent(component, index, fraction), rawSamples[(component * sampleCount) + sampleId]) > tolerance) {
+							valid = false;
+							break;
+						}
+				}
+				baked.m_quantizedSamples = nullptr;
+				if (!valid) continue;
+				quantizedOffsets[trackId] = result->m_quantizedSamples.size();
+				result->m_quantizedSamples.insert(result->m_quantizedSamples.end(), candidate.begin(), candidate.end());
+				return true;
+			}
+			return false;
+		};
+
+		// Sample the tracks:
+		std::vector<size_t> sampleOffsets(clip->TrackCount(), ~size_t(0u));
+		result->m_tracks.resize(clip->TrackCount());
+		for (size_t trackId = 0u; trackId < clip->TrackCount(); trackId++) {
+			const AnimationClip::Track* track = clip->GetTrack(trackId);
+			Track& baked = result->m_tracks[trackId];
+			const ParametricCurve<float, float>* floatCurve = dynamic_cast<const ParametricCurve<float, float>*>(track);
+			const ParametricCurve<Vector3, float>* vectorCurve = dynamic_cast<const ParametricCurve<Vector3, float>*>(track);
+			if (floatCurve != nullptr) {
+				baked.m_componentCount = 1u;
+				rawSamples.resize(sampleCount);
+				for (size_t sampleId = 0u; sampleId < sampleCount; sampleId++)
+					rawSamples[sampleId] = floatCurve->Value(sampleTime(sampleId, sampleCount));
+			}
+			else if (vectorCurve != nullptr) {
+				baked.m_componentCount = 3u;
+				baked.m_angles = (dynamic_cast<const AnimationClip::EulerAngleTrack*>(track) != nullptr);
+				rawSamples.resize(3u * sampleCount);
+				Vector3 lastValue = Vector3(0.0f);
+				for (size_t sampleId = 0u; sampleId < sampleCount; sampleId++) {
+					Vector3 value = vectorCurve->Value(sampleTime(sampleId, sampleCount));
+					if (baked.m_angles && sampleId > 0u)
+						value = UnwrapEulerAngles(lastValue, value);
+					rawSamples[sampleId] = value.x;
+					rawSamples[sampleCount + sampleId] = value.y;
+					rawSamples[(sampleCount << 1u) + sampleId] = value.z;
+					lastValue = value;
+				}
+			}
+			else continue;
+
+			// Compress if requested:
+			const float tolerance = baked.m_angles ? compression.angleError : compression.valueError;
+			if (tolerance > 0.0f && compressTrack(trackId, tolerance))
+				continue;
+
+			// Store uncompressed samples:
+			baked.m_sampleCount = sampleCount;
+			baked.m_samplesPerSecond = samplesPerSecond(sampleCount);
+			sampleOffsets[trackId] = result->m_samples.size();
+			result->m_samples.insert(result->m_samples.end(), rawSamples.begin(), rawSamples.end());
+		}
+
+		// Buffers will not grow any more, so we can set the pointers:
+		for (size_t trackId = 0u; trackId < result->m_tracks.size(); trackId++) {
+			Track& baked = result->m_tracks[trackId];
+			if (sampleOffsets[trackId] != ~size_t(0u))
+				baked.m_samples = result->m_samples.data() + sampleOffsets[trackId];
+			if (quantizedOffsets[trackId] != ~size_t(0u))
+				baked.m_quantizedSamples = result->m_quantizedSamples.data() + quantizedOffsets[trackId];
+		}
+		return result;
+	}
+
+	BakedAnimationClip::~BakedAnimationClip() {}
+
+
+
 	AnimationClip::AnimationClip(const std::string_view& name) : m_name(name) {}
 
 	AnimationClip::~AnimationClip() {
@@ -22,6 +193,29 @@ namespace Jimara {
 
 	Event<const AnimationClip*>& AnimationClip::OnDirty()const { return m_onDirty; }
 
+	BakedAnimationClip::CompressionSettings AnimationClip::Compression()const { return m_compression; }
+
+	void AnimationClip::SetCompression(const BakedAnimationClip::CompressionSettings& compression) {
+		bool discardedBakedData;
+		{
+			std::unique_lock<std::mutex> changeLock(m_changeLock);
+			std::unique_lock<std::mutex> bakeLock(m_bakeLock);
+			if (m_compression.valueError == compression.valueError && m_compression.angleError == compression.angleError) return;
+			m_compression = compression;
+			discardedBakedData = (m_baked != nullptr);
+			m_baked = nullptr;
+		}
+		if (discardedBakedData)
+			m_onDirty(this);
+	}
+
+	Reference<const BakedAnimationClip> AnimationClip::Baked()const {
+		std::unique_lock<std::mutex> lock(m_bakeLock);
+		if (m_baked == nullptr)
+			m_baked = BakedAnimationClip::Bake(this, m_compression);
+		return m_baked;
+	}
+
 
 	float AnimationClip::Track::Duration()const { return m_owner == nullptr ? 0.0f : m_owner->Duration(); }
 
@@ -53,6 +247,12 @@ namespace Jimara {
 
 	const std::string& AnimationClip::Track::TargetField()const { return m_targetField; }
 
+	size_t AnimationClip::Track::BindingCount()const { return m_bindChain.size(); }
+
+	const std::string& AnimationClip::Track::BindingName(size_t index)const { return m_bindChain[index].name; }
+
+	TypeId AnimationClip::Track::BindingType(size_t index)const { return m_bindChain[index].type; }
+
 
 
 	AnimationClip::TripleFloatCombine::TripleFloatCombine(ParametricCurve<float, float>* x, ParametricCurve<float, float>* y, ParametricCurve<float, float>* z)
@@ -147,12 +347,18 @@ namespace Jimara {
 	AnimationClip::Writer::Writer(AnimationClip& animation) : Writer(&animation) {}
 
 	AnimationClip::Writer::~Writer() {
+		{
+			std::unique_lock<std::mutex> lock(m_animation->m_bakeLock);
+			m_animation->m_baked = nullptr;
+		}
 		m_animation->m_changeLock.unlock();
 		m_animation->m_onDirty(m_animation);
 	}
 
 	std::string& AnimationClip::Writer::Name()const { return m_animation->m_name; }
 
+	BakedAnimationClip::CompressionSettings& AnimationClip::Writer::Compression()const { return m_animation->m_compression; }
+
 	float AnimationClip::Writer::Duration()const { return m_animation->m_duration; }
 
 	void AnimationClip::Writer::SetDuration(float duration)const {
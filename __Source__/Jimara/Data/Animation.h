@@ -32,6 +32,198 @@ namespace Jimara {
 	template<typename ValueType>
 	class AnimationBezier : public virtual AnimationCurve<ValueType>, public virtual TimelineCurve<ValueType, BezierNode<ValueType>> {};
 
+	class AnimationClip;
+
+	/// <summary>
+	/// Baked representation of an AnimationClip
+	/// <para/> Float and Vector3 tracks are uniformly resampled into contiguous buffers (each track stores it's components as separate flat arrays);
+	///		sampling is just an index calculation and a linear interpolation between two neighbouring samples, 
+	///		with no tree searches, virtual calls or type casts involved.
+	/// <para/> Optionally, tracks can be compressed: constant tracks are reduced to a single value, 
+	///		sample rate is lowered per-track as long as the error stays within the budget and the samples are quantized to 16 bits within per-component ranges.
+	///		Compressed tracks are decoded on the fly, while sampling.
+	/// <para/> Tracks of any other type are not baked and should be evaluated through the original AnimationClip::Track.
+	/// </summary>
+	class JIMARA_API BakedAnimationClip : public virtual Object {
+	public:
+		/// <summary> Default number of samples per second </summary>
+		static const constexpr float DEFAULT_SAMPLE_RATE = 60.0f;
+
+		/// <summary>
+		/// Error budget for track compression (tolerances are measured against the uncompressed baked samples)
+		/// </summary>
+		struct CompressionSettings {
+			/// <summary> Maximal absolute error for generic float and Vector3 track components (0 or less means 'do not compress') </summary>
+			float valueError = 0.0f;
+
+			/// <summary> Maximal error for euler angle track components in degrees (0 or less means 'do not compress') </summary>
+			float angleError = 0.0f;
+		};
+
+		/// <summary>
+		/// Resamples AnimationClip tracks (no compression)
+		/// <para/> Note: Euler angle tracks (AnimationClip::EulerAngleTrack) are "unwrapped" to avoid interpolating across the 0-360 degree boundary.
+		/// </summary>
+		/// <param name="clip"> Clip to bake </param>
+		/// <param name="sampleRate"> Number of samples per second (actual rate will be slightly higher to fit the clip duration exactly) </param>
+		/// <returns> Baked clip (nullptr, if clip is null) </returns>
+		static Reference<BakedAnimationClip> Bake(const AnimationClip* clip, float sampleRate = DEFAULT_SAMPLE_RATE);
+
+		/// <summary>
+		/// Resamples and compresses AnimationClip tracks
+		/// <para/> Note: Euler angle tracks (AnimationClip::EulerAngleTrack) are "unwrapped" to avoid interpolating across the 0-360 degree boundary.
+		/// </summary>
+		/// <param name="clip"> Clip to bake </param>
+		/// <param name="compression"> Compression error budget </param>
+		/// <param name="sampleRate"> Number of samples per second before compression (actual rate will be slightly higher to fit the clip duration exactly) </param>
+		/// <returns> Baked clip (nullptr, if clip is null) </returns>
+		static Reference<BakedAnimationClip> Bake(const AnimationClip* clip, const CompressionSettings& compression, float sampleRate = DEFAULT_SAMPLE_RATE);
+
+		/// <summary> Virtual destructor </summary>
+		virtual ~BakedAnimationClip();
+
+		/// <summary> Clip duration/length at the time of baking </summary>
+		inline float Duration()const { return m_duration; }
+
+		/// <summary> Number of samples per uncompressed track (first sample is always at 0 and the last one at Duration()) </summary>
+		inline size_t SampleCount()const { return m_sampleCount; }
+
+		/// <summary> Total size of the sample buffers in bytes </summary>
+		inline size_t SampleDataSize()const { return (m_samples.size() * sizeof(float)) + (m_quantizedSamples.size() * sizeof(uint16_t)); }
+
+		/// <summary> Number of tracks (same as the source clip TrackCount()) </summary>
+		inline size_t TrackCount()const { return m_tracks.size(); }
+
+		/// <summary>
+		/// Single baked track
+		/// </summary>
+		class Track {
+		public:
+			/// <summary> Number of value components (1 for float, 3 for Vector3 tracks and 0 for the tracks that were not baked) </summary>
+			inline size_t ComponentCount()const { return m_componentCount; }
+
+			/// <summary> True, if the track has any samples </summary>
+			inline bool Baked()const { return m_componentCount > 0u; }
+
+			/// <summary> Number of stored samples per component (0 for constant and not baked tracks) </summary>
+			inline size_t SampleCount()const { return (m_samples != nullptr || m_quantizedSamples != nullptr) ? m_sampleCount : size_t(0u); }
+
+			/// <summary> True, if the samples are stored as 16 bit quantized values </summary>
+			inline bool Quantized()const { return m_quantizedSamples != nullptr; }
+
+			/// <summary>
+			/// Samples a floating point track
+			/// </summary>
+			/// <param name="time"> Time point (clamped to [0 - Duration()] range) </param>
+			/// <param name="value"> Result will be stored here </param>
+			/// <returns> True, if the track is a baked float track </returns>
+			inline bool Sample(float time, float& value)const {
+				if (m_componentCount != 1u) return false;
+				size_t index; float fraction;
+				Locate(time, index, fraction);
+				value = SampleComponent(0u, index, fraction);
+				return true;
+			}
+
+			/// <summary>
+			/// Samples a Vector3 track
+			/// </summary>
+			/// <param name="time"> Time point (clamped to [0 - Duration()] range) </param>
+			/// <param name="value"> Result will be stored here </param>
+			/// <returns> True, if the track is a baked Vector3 track </returns>
+			inline bool Sample(float time, Vector3& value)const {
+				if (m_componentCount != 3u) return false;
+				size_t index; float fraction;
+				Locate(time, index, fraction);
+				value = Vector3(
+					SampleComponent(0u, index, fraction),
+					SampleComponent(1u, index, fraction),
+					SampleComponent(2u, index, fraction));
+				return true;
+			}
+
+			/// <summary>
+			/// Fallback for the types that can never be baked
+			/// </summary>
+			/// <typeparam name="ValueType"> Any type other than float or Vector3 </typeparam>
+			/// <returns> False </returns>
+			template<typename ValueType>
+			inline bool Sample(float, ValueType&)const { return false; }
+
+		private:
+			// Uncompressed samples (m_componentCount arrays of m_sampleCount elements each)
+			const float* m_samples = nullptr;
+
+			// Quantized samples (m_componentCount arrays of m_sampleCount elements each; value = m_offset + m_scale * sample)
+			const uint16_t* m_quantizedSamples = nullptr;
+
+			// Quantization offset and scale (if both sample pointers are null, the track is constant and the value is stored in m_offset)
+			float m_offset[3] = { 0.0f, 0.0f, 0.0f };
+			float m_scale[3] = { 0.0f, 0.0f, 0.0f };
+
+			// Number of samples per component
+			size_t m_sampleCount = 0u;
+
+			// Number of components
+			size_t m_componentCount = 0u;
+
+			// Sample index per second
+			float m_samplesPerSecond = 0.0f;
+
+			// If true, sampled values will be wrapped to [0 - 360) range (set for euler angle tracks)
+			bool m_angles = false;
+
+			// Finds sample index and interpolation fraction for given time
+			inline void Locate(float time, size_t& index, float& fraction)const {
+				const float position = Math::Min(Math::Max(time * m_samplesPerSecond, 0.0f), static_cast<float>(m_sampleCount - 1u));
+				index = Math::Min(static_cast<size_t>(position), m_sampleCount - 2u);
+				fraction = position - static_cast<float>(index);
+			}
+
+			// Interpolates between samples
+			inline float SampleComponent(size_t component, size_t index, float fraction)const {
+				const size_t first = (component * m_sampleCount) + index;
+				float value;
+				if (m_samples != nullptr)
+					value = Math::Lerp(m_samples[first], m_samples[first + 1u], fraction);
+				else if (m_quantizedSamples != nullptr)
+					value = m_offset[component] + m_scale[component] * Math::Lerp(
+						static_cast<float>(m_quantizedSamples[first]), static_cast<float>(m_quantizedSamples[first + 1u]), fraction);
+				else value = m_offset[component];
+				return m_angles ? Math::FloatRemainder(value, 360.0f) : value;
+			}
+
+			// Only BakedAnimationClip can initialize tracks
+			friend class BakedAnimationClip;
+		};
+
+		/// <summary>
+		/// Baked track by index
+		/// </summary>
+		/// <param name="index"> Track index (same as the source track index) </param>
+		/// <returns> Baked track </returns>
+		inline const Track& GetTrack(size_t index)const { return m_tracks[index]; }
+
+	private:
+		// Clip duration
+		float m_duration = 0.0f;
+
+		// Number of samples per uncompressed track
+		size_t m_sampleCount = 0u;
+
+		// Uncompressed sample buffer
+		std::vector<float> m_samples;
+
+		// Quantized sample buffer
+		std::vector<uint16_t> m_quantizedSamples;
+
+		// Baked tracks
+		std::vector<Track> m_tracks;
+
+		// Constructor is private
+		inline BakedAnimationClip() {}
+	};
+
 	/// <summary>
 	/// Animation clip, well, storing a singular animation
 	/// </summary>
@@ -68,6 +260,23 @@ namespace Jimara {
 		/// <summary> Invoked, whenever an animation Writer goes out of scope </summary>
 		Event<const AnimationClip*>& OnDirty()const;
 
+		/// <summary> Compression settings, used by Baked() </summary>
+		BakedAnimationClip::CompressionSettings Compression()const;
+
+		/// <summary>
+		/// Sets compression settings, used by Baked()
+		/// <para/> Unlike Writer::Compression(), this does not mark the clip dirty;
+		/// baked data is only discarded (and OnDirty() fired) if it already exists and the settings actually change.
+		/// </summary>
+		/// <param name="compression"> Compression error budget </param>
+		void SetCompression(const BakedAnimationClip::CompressionSettings& compression);
+
+		/// <summary>
+		/// Baked clip data (see BakedAnimationClip; compressed if Compression() says so)
+		/// <para/> Baked on the first request and retained until the next Writer goes out of scope.
+		/// </summary>
+		Reference<const BakedAnimationClip> Baked()const;
+
 		/// <summary>
 		/// AnimationTrack, tied directly to the clip
 		/// </summary>
@@ -93,6 +302,23 @@ namespace Jimara {
 			/// <summary> Name of the target serialized field (if there's a duplicate name, well... that's, I guess, on the programmer that designed the class) </summary>
 			const std::string& TargetField()const;
 
+			/// <summary> Number of links within the binding chain, used by FindTarget() </summary>
+			size_t BindingCount()const;
+
+			/// <summary>
+			/// Name of the binding chain link
+			/// </summary>
+			/// <param name="index"> Link index [valid range is [0 - BindingCount())] </param>
+			/// <returns> Name of the Object to look for </returns>
+			const std::string& BindingName(size_t index)const;
+
+			/// <summary>
+			/// Type of the binding chain link
+			/// </summary>
+			/// <param name="index"> Link index [valid range is [0 - BindingCount())] </param>
+			/// <returns> Type of the Object to look for </returns>
+			TypeId BindingType(size_t index)const;
+
 		private:
 			// Owner clip
 			const AnimationClip* m_owner = nullptr;
@@ -328,6 +554,9 @@ namespace Jimara {
 			/// <summary> Animation clip name </summary>
 			std::string& Name()const;
 
+			/// <summary> Compression settings for the baked clip data </summary>
+			BakedAnimationClip::CompressionSettings& Compression()const;
+
 			/// <summary> Clip duration </summary>
 			float Duration()const;
 
@@ -428,6 +657,9 @@ namespace Jimara {
 		// Clip duration
 		float m_duration = 0.0f;
 
+		// Compression settings for the baked data
+		BakedAnimationClip::CompressionSettings m_compression;
+
 		// List of underlying tracks
 		std::vector<Reference<Track>> m_tracks;
 
@@ -436,6 +668,10 @@ namespace Jimara {
 
 		// Invoked when a writer goes out of scope
 		mutable EventInstance<const AnimationClip*> m_onDirty;
+
+		// Baked clip data and lock for it
+		mutable Reference<const BakedAnimationClip> m_baked;
+		mutable std::mutex m_bakeLock;
 	};
 
 	/// <summary>
@@ -1,4 +1,5 @@
 #include "AssetDatabase.h"
+#include "ResourceResidencyCache.h"
 #include <cassert>
 
 
@@ -15,6 +16,7 @@ namespace Jimara {
 
 		if (asset != nullptr) {
 			// Lock to prevent overlap with Asset::Load():
+			const ResourceResidencyCache::ResourceLockScope residencyLockScope;
 			std::unique_lock<std::mutex> lock(asset->m_resourceLock);
 			
 			// If there has been an overlap with Asset::Load(), we should cancel destruction:
@@ -22,6 +24,11 @@ namespace Jimara {
 			
 			// Otherwise, we are free to destroy all connection between the resource and the asset:
 			if (asset->m_resource == this) {
+				// Residency cache may take over the last reference, keeping the resource loaded:
+				ResourceResidencyCache* residencyCache = asset->m_residencyCache.load();
+				if (residencyCache != nullptr && residencyCache->RetainReleasedResource(asset, asset->m_resource))
+					return;
+
 				Resource* self = asset->m_resource;
 				asset->m_resource = nullptr;
 				{
@@ -50,14 +57,21 @@ namespace Jimara {
 	}
 
 	Reference<Resource> Asset::GetLoadedResource()const {
-		Reference<Resource> resource;
+		// Resource may already be on it's way to Resource::OnOutOfScope; TryAddRef() makes sure we do not resurrect it:
+		auto getResource = [&]() {
+			Reference<Resource> resource;
+			Resource* const current = m_resource;
+			if (current != nullptr && current->TryAddRef()) {
+				resource = current;
+				current->ReleaseRef();
+			}
+			return resource;
+		};
+		// Loading thread already holds m_resourceLock:
 		if (m_loadingThreadToken.load() == (&Asset_THREAD_TOKEN))
-			resource = m_resource;
-		else {
-			std::unique_lock<std::mutex> lock(m_resourceLock);
-			resource = m_resource;
-		}
-		return resource;
+			return getResource();
+		std::unique_lock<std::mutex> lock(m_resourceLock);
+		return getResource();
 	}
 
 	Reference<Resource> Asset::LoadResource(const Callback<LoadInfo>& reportProgress) {
@@ -65,11 +79,19 @@ namespace Jimara {
 		if (m_loadingThreadToken.load() == (&Asset_THREAD_TOKEN)) return nullptr;
 
 		// Only one thread at a time can 'load'
+		const ResourceResidencyCache::ResourceLockScope residencyLockScope;
 		std::unique_lock<std::mutex> lock(m_resourceLock);
 
-		// If we already have the resource loaded, we can just return it (Note that the resource uses the same lock, making this safe-ish enough):
-		if (m_resource != nullptr && m_resource->RefCount() > 0 && m_resource->m_asset == this)
-			return Reference<Resource>(m_resource);
+		// If we already have the resource loaded, we can just return it
+		// (Note that the resource uses the same lock; TryAddRef() makes sure we do not resurrect a resource, that's already on it's way to Resource::OnOutOfScope):
+		if (m_resource != nullptr && m_resource->m_asset == this && m_resource->TryAddRef()) {
+			const Reference<Resource> resource(m_resource);
+			m_resource->ReleaseRef();
+			ResourceResidencyCache* residencyCache = m_residencyCache.load();
+			if (residencyCache != nullptr)
+				residencyCache->OnLoadRequested(this, false);
+			return resource;
+		}
 
 		// If there's no resource loaded, we just load it and establish the connection:
 		m_reportProgress = &reportProgress;
@@ -85,9 +107,40 @@ namespace Jimara {
 				resource->m_asset = this;
 			}
 			m_resource = resource;
+			ResourceResidencyCache* residencyCache = m_residencyCache.load();
+			if (residencyCache != nullptr)
+				residencyCache->OnLoadRequested(this, true);
 		}
 		return resource;
 	}
 
 	Asset::Asset(const GUID& guid) : m_guid(guid) {}
+
+
+	AssetDatabase::AssetDatabase() {}
+
+	AssetDatabase::~AssetDatabase() {}
+
+	Reference<ResourceResidencyCache> AssetDatabase::ResidencyCache()const {
+		std::unique_lock<SpinLock> lock(m_residencyCacheLock);
+		const Reference<ResourceResidencyCache> cache = m_residencyCache;
+		return cache;
+	}
+
+	void AssetDatabase::SetResidencyCache(ResourceResidencyCache* cache) {
+		// Previous cache is released outside the lock, since it's destructor detaches from the assets:
+		Reference<ResourceResidencyCache> previousCache;
+		{
+			std::unique_lock<SpinLock> lock(m_residencyCacheLock);
+			previousCache = m_residencyCache;
+			m_residencyCache = cache;
+		}
+	}
+
+	void AssetDatabase::AttachToResidencyCache(Asset* asset)const {
+		if (asset == nullptr) return;
+		const Reference<ResourceResidencyCache> cache = ResidencyCache();
+		if (cache != nullptr)
+			cache->Attach(asset);
+	}
 }
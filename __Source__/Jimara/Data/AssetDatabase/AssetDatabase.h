@@ -7,6 +7,7 @@
 
 namespace Jimara {
 	class Asset;
+	class ResourceResidencyCache;
 
 	/// <summary>
 	/// A Resource is any runtime object, loaded from the AssetDatabase 
@@ -53,8 +54,9 @@ namespace Jimara {
 		// Lock for m_asset
 		mutable SpinLock m_assetLock;
 
-		// Asset needs to have access to the fields
+		// Asset and ResourceResidencyCache need to have access to the fields
 		friend class Asset;
+		friend class ResourceResidencyCache;
 	};
 
 	// Prent types of Resource
@@ -75,6 +77,14 @@ namespace Jimara {
 		/// <summary> True, if the resource, once loaded, can have any recursive external dependencies </summary>
 		inline virtual bool HasRecursiveDependencies()const { return false; }
 
+		/// <summary>
+		/// Reports the assets, the resource is known to depend on before it gets loaded (none by default)
+		/// <para /> Note: This is only a hint for the batch loaders, that lets them load the dependencies ahead of time and in parallel;
+		///		LoadResource() is expected to work regardless.
+		/// </summary>
+		/// <param name="reportDependency"> Each dependency GUID will be reported through this callback </param>
+		inline virtual void GetDependencies(const Callback<const GUID&>& reportDependency)const { Unused(reportDependency); }
+
 		/// <summary>
 		/// Refreshes/reloads all 'external' dependencies, thus making sure the Resource is up to date with the Asset Database.
 		/// </summary>
@@ -223,8 +233,12 @@ namespace Jimara {
 		// Loaded resource (not a Reference, to avoid cyclic dependencies)
 		Resource* m_resource = nullptr;
 
-		// Resource needs access to the internals
+		// Residency cache, the asset is attached to (not a Reference; the cache detaches itself on destruction)
+		std::atomic<ResourceResidencyCache*> m_residencyCache = nullptr;
+
+		// Resource and ResourceResidencyCache need access to the internals
 		friend class Resource;
+		friend class ResourceResidencyCache;
 	};
 
 	/// <summary>
@@ -401,6 +415,12 @@ namespace Jimara {
 	/// </summary>
 	class JIMARA_API AssetDatabase : public virtual Object {
 	public:
+		/// <summary> Constructor </summary>
+		AssetDatabase();
+
+		/// <summary> Virtual destructor </summary>
+		virtual ~AssetDatabase();
+
 		/// <summary>
 		/// Finds an asset within the database
 		/// <para /> Note: The asset may or may not be loaded once returned;
@@ -408,6 +428,39 @@ namespace Jimara {
 		/// <param name="id"> Asset identifier </param>
 		/// <returns> Asset reference, if found </returns>
 		virtual Reference<Asset> FindAsset(const GUID& id) = 0;
+
+		/// <summary>
+		/// Object, uniquely identifying the database
+		/// <para /> Unlike the address of the database, the address of the token can not be reused for as long as someone holds a reference to it,
+		///		so anything cached for a specific database can remember the token instead of keeping the database itself alive.
+		/// </summary>
+		inline const Object* IdentityToken()const { return m_identityToken; }
+
+		/// <summary> Residency cache, the assets returned by FindAsset() get attached to (nullptr by default) </summary>
+		Reference<ResourceResidencyCache> ResidencyCache()const;
+
+		/// <summary>
+		/// Sets residency cache (opt-in; retains recently released resources of the assets found in the database)
+		/// <para /> Note: Assets, that have already been handed out, get attached the next time they are found.
+		/// </summary>
+		/// <param name="cache"> Residency cache to use (nullptr to disable) </param>
+		void SetResidencyCache(ResourceResidencyCache* cache);
+
+	protected:
+		/// <summary>
+		/// Attaches the asset to the ResidencyCache() if there is one
+		/// <para /> Note: Implementations should invoke this for the assets they return from FindAsset().
+		/// </summary>
+		/// <param name="asset"> Asset, found within the database </param>
+		void AttachToResidencyCache(Asset* asset)const;
+
+	private:
+		// Identity token
+		const Reference<const Object> m_identityToken = Object::Instantiate<Object>();
+
+		// Residency cache and the lock for it
+		mutable SpinLock m_residencyCacheLock;
+		Reference<ResourceResidencyCache> m_residencyCache;
 	};
 
 	// Prent types of AssetDatabase
@@ -14,10 +14,15 @@ namespace Jimara {
 		/// <param name="id"> Asset identifier </param>
 		/// <returns> Asset reference, if found </returns>
 		inline virtual Reference<Asset> FindAsset(const GUID& id) final override {
-			std::unique_lock<SpinLock> lock(m_lock);
-			decltype(m_assets)::const_iterator it = m_assets.find(id);
-			if (it == m_assets.end()) return nullptr;
-			else return it->second;
+			Reference<Asset> asset;
+			{
+				std::unique_lock<SpinLock> lock(m_lock);
+				decltype(m_assets)::const_iterator it = m_assets.find(id);
+				if (it == m_assets.end()) return nullptr;
+				else asset = it->second;
+			}
+			AttachToResidencyCache(asset);
+			return asset;
 		}
 
 		/// <summary>
@@ -3,8 +3,12 @@
 #include "../../Serialization/Helpers/SerializeToJson.h"
 #include <filesystem>
 #include <fstream>
+#include <sstream>
+#include <unordered_set>
 #include <shared_mutex>
 #include <chrono>
+#include <algorithm>
+#include <cstring>
 
 
 namespace Jimara {
@@ -37,6 +41,128 @@ namespace Jimara {
 					loaders.push_back(it->first);
 			return loaders;
 		}
+
+		// FNV-1a of the path (stays the same across runs):
+		inline static uint64_t FileSystemDatabase_PathHash(const OS::Path& path) {
+			uint64_t pathHash = 14695981039346656037ull;
+			const std::string pathString = path;
+			for (size_t i = 0u; i < pathString.length(); i++)
+				pathHash = (pathHash ^ static_cast<uint64_t>(static_cast<uint8_t>(pathString[i]))) * 1099511628211ull;
+			return pathHash;
+		}
+
+		// Cooked file names are [file name].[path hash][extension]; path hash keeps same-named files from different directories apart:
+		inline static std::string FileSystemDatabase_CookedDataPrefix(const OS::Path& assetPath) {
+			std::stringstream stream;
+			stream << OS::Path(assetPath.filename()).operator std::string() << '.' << std::hex << FileSystemDatabase_PathHash(assetPath);
+			return stream.str();
+		}
+
+		// Configured cache directory may be shared between the databases (and may even contain unrelated files), 
+		// so each database only works within [cache directory]/[hash of the absolute asset directory path]/ and never touches anything outside it:
+		inline static OS::Path FileSystemDatabase_CookedDataDirectory(const OS::Path& cacheDirectory, const OS::Path& assetDirectory) {
+			std::error_code error;
+			std::filesystem::path root = std::filesystem::weakly_canonical(assetDirectory, error);
+			if (error) {
+				error.clear();
+				root = std::filesystem::absolute(assetDirectory, error);
+				if (error)
+					root = assetDirectory;
+			}
+			root = root.lexically_normal();
+			if (root.filename().empty())
+				root = root.parent_path();
+			std::stringstream stream;
+			stream << std::hex << FileSystemDatabase_PathHash(OS::Path(root));
+			return OS::Path(cacheDirectory / OS::Path(stream.str()));
+		}
+
+		// True, if the cooked file name starts with one of the prefixes, followed by an extension:
+		inline static bool FileSystemDatabase_HasCookedDataPrefix(const std::string& cookedFileName, const std::unordered_set<std::string>& prefixes) {
+			for (size_t pos = cookedFileName.find('.'); pos != std::string::npos; pos = cookedFileName.find('.', pos + 1u))
+				if (prefixes.find(cookedFileName.substr(0u, pos)) != prefixes.end())
+					return true;
+			return false;
+		}
+
+		// Deletes cooked files from the cache directory:
+		// Files that do not match any of the prefixes are deleted if pruneUnknown is set; 
+		// temporary files are only deleted if they are older than minTemporaryFileTime, since they might be written to at the moment.
+		inline static void FileSystemDatabase_RemoveCookedData(
+			const OS::Path& cacheDirectory, const std::unordered_set<std::string>& prefixes, bool pruneUnknown,
+			std::optional<std::filesystem::file_time_type> minTemporaryFileTime) {
+			std::error_code error;
+			if (!std::filesystem::is_directory(cacheDirectory, error))
+				return;
+			std::vector<std::filesystem::path> removedFiles;
+			for (std::filesystem::directory_iterator it(cacheDirectory, error), end; (!error) && it != end; it.increment(error)) {
+				std::error_code entryError;
+				if (!it->is_regular_file(entryError))
+					continue;
+				const std::string name = OS::Path(it->path().filename());
+				if (it->path().extension() == ".tmp") {
+					if (minTemporaryFileTime.has_value()) {
+						const std::filesystem::file_time_type writeTime = it->last_write_time(entryError);
+						if ((!entryError) && writeTime < minTemporaryFileTime.value())
+							removedFiles.push_back(it->path());
+					}
+				}
+				else if (FileSystemDatabase_HasCookedDataPrefix(name, prefixes) != pruneUnknown)
+					removedFiles.push_back(it->path());
+			}
+			for (size_t i = 0u; i < removedFiles.size(); i++)
+				std::filesystem::remove(removedFiles[i], error);
+		}
+
+		// Import index file layout: [magic][version][endianness tag][entry count] followed by the entries; 
+		// Each entry is [path][file size][last modified date][content xxHash][content seeded xxHash][importer version][previous import data], strings being prefixed by their length.
+		static const constexpr char FileSystemDatabase_ImportIndexMagic[4] = { 'J', 'F', 'S', 'I' };
+		static const constexpr uint32_t FileSystemDatabase_ImportIndexVersion = 3u;
+		static const constexpr uint32_t FileSystemDatabase_ImportIndexEndiannessTag = 0x01020304u;
+
+		struct FileSystemDatabase_ImportIndexWriter {
+			std::vector<uint8_t>& data;
+
+			template<typename Type>
+			inline void Value(const Type& value) {
+				const uint8_t* const ptr = reinterpret_cast<const uint8_t*>(&value);
+				data.insert(data.end(), ptr, ptr + sizeof(Type));
+			}
+
+			inline void String(const std::string& text) {
+				Value(static_cast<uint64_t>(text.length()));
+				data.insert(data.end(), text.begin(), text.end());
+			}
+		};
+
+		struct FileSystemDatabase_ImportIndexReader {
+			const uint8_t* ptr = nullptr;
+			const uint8_t* end = nullptr;
+			bool ok = true;
+
+			template<typename Type>
+			inline Type Value() {
+				Type value = {};
+				if ((!ok) || static_cast<size_t>(end - ptr) < sizeof(Type)) {
+					ok = false;
+					return value;
+				}
+				std::memcpy(&value, ptr, sizeof(Type));
+				ptr += sizeof(Type);
+				return value;
+			}
+
+			inline std::string String() {
+				const uint64_t length = Value<uint64_t>();
+				if ((!ok) || static_cast<uint64_t>(end - ptr) < length) {
+					ok = false;
+					return "";
+				}
+				const std::string text(reinterpret_cast<const char*>(ptr), static_cast<size_t>(length));
+				ptr += length;
+				return text;
+			}
+		};
 	}
 
 	Graphics::GraphicsDevice* FileSystemDatabase::AssetImporter::GraphicsDevice()const { return m_context->graphicsDevice; }
@@ -62,6 +188,14 @@ namespace Jimara {
 
 	OS::Logger* FileSystemDatabase::AssetImporter::Log()const { return GraphicsDevice()->Log(); }
 
+	std::optional<OS::Path> FileSystemDatabase::AssetImporter::CookedDataPath(const OS::Path& extension)const {
+		if (!m_context->cookedAssetCacheDirectory.has_value())
+			return std::optional<OS::Path>();
+		std::stringstream stream;
+		stream << FileSystemDatabase_CookedDataPrefix(AssetFilePath()) << extension.operator std::string();
+		return OS::Path(m_context->cookedAssetCacheDirectory.value() / OS::Path(stream.str()));
+	}
+
 	Reference<Asset> FileSystemDatabase::AssetImporter::FindAsset(const GUID& id) {
 		Reference<AssetDatabase> db;
 		if (m_context != nullptr) {
@@ -147,6 +281,9 @@ namespace Jimara {
 		ctx->shaderLibrary = configuration.shaderLibrary;
 		ctx->physicsInstance = configuration.physicsInstance;
 		ctx->audioDevice = configuration.audioDevice;
+		if (configuration.cookedAssetCacheDirectory.has_value())
+			ctx->cookedAssetCacheDirectory = FileSystemDatabase_CookedDataDirectory(
+				configuration.cookedAssetCacheDirectory.value(), configuration.assetDirectory);
 		return ctx;
 			}())
 		, m_assetDirectoryObserver(observer)
@@ -167,41 +304,47 @@ namespace Jimara {
 		assert(m_context->physicsInstance != nullptr);
 		assert(m_context->audioDevice != nullptr);
 		m_context->owner = this;
+		const std::filesystem::file_time_type startTime = std::filesystem::file_time_type::clock::now();
 
-		// Restore cached import data:
+		// Restore import index:
 		if (m_previousImportDataCache.has_value()) {
 			std::error_code fsError;
 			if (std::filesystem::exists(m_previousImportDataCache.value(), fsError))
 				if (!fsError) {
-					const Reference<OS::MMappedFile> metadataMapping = OS::MMappedFile::Create(m_previousImportDataCache.value());
-					if (metadataMapping != nullptr) {
-						try {
-							const MemoryBlock block = *metadataMapping;
-							nlohmann::json dataJson = nlohmann::json::parse(std::string_view(reinterpret_cast<const char*>(block.Data()), block.Size()));
-							if (dataJson.is_object()) {
-								for (auto it = dataJson.begin(); it != dataJson.end(); ++it) {
-									if (!it.value().is_object())
-										continue;
-									fsError = std::error_code();
-									if (!std::filesystem::exists(it.key(), fsError))
-										continue;
-									if (fsError)
-										continue;
-									auto lastModified = it.value().find("lastModifiedDate");
-									auto previousImportData = it.value().find("previousImportData");
-									if (lastModified == it.value().end() || (!lastModified.value().is_number()) ||
-										previousImportData == it.value().end() || (!previousImportData.value().is_string()))
-										continue;
-									PreviousFileImportData prevData = {};
-									prevData.lastModifiedDate = lastModified.value();
-									prevData.previousImportData = std::string(previousImportData.value());
-									m_previousImportData[it.key()] = prevData;
-								}
+					const Reference<OS::MMappedFile> indexMapping = OS::MMappedFile::Create(m_previousImportDataCache.value());
+					if (indexMapping != nullptr) {
+						const MemoryBlock block = *indexMapping;
+						FileSystemDatabase_ImportIndexReader reader;
+						reader.ptr = reinterpret_cast<const uint8_t*>(block.Data());
+						reader.end = reader.ptr + block.Size();
+						char magic[sizeof(FileSystemDatabase_ImportIndexMagic)] = {};
+						for (size_t i = 0u; i < sizeof(magic); i++)
+							magic[i] = reader.Value<char>();
+						// Anything with a different header (including the old json caches) is simply ignored:
+						if (reader.ok &&
+							std::memcmp(magic, FileSystemDatabase_ImportIndexMagic, sizeof(magic)) == 0 &&
+							reader.Value<uint32_t>() == FileSystemDatabase_ImportIndexVersion &&
+							reader.Value<uint32_t>() == FileSystemDatabase_ImportIndexEndiannessTag) {
+							const uint64_t entryCount = reader.Value<uint64_t>();
+							for (uint64_t i = 0u; i < entryCount && reader.ok; i++) {
+								const std::string path = reader.String();
+								FileImportRecord record = {};
+								record.fileSize = reader.Value<uint64_t>();
+								record.lastModifiedDate = reader.Value<uint64_t>();
+								record.contentHash.xxHash = reader.Value<uint64_t>();
+								record.contentHash.seededHash = reader.Value<uint64_t>();
+								record.importerVersion = reader.Value<uint32_t>();
+								record.previousImportData = reader.String();
+								if (!reader.ok)
+									break;
+								fsError = std::error_code();
+								if ((!std::filesystem::exists(path, fsError)) || fsError)
+									continue;
+								m_importIndex[path] = std::move(record);
 							}
+							if (!reader.ok)
+								m_importIndex.clear();
 						}
-						catch (nlohmann::json::parse_error&) { m_previousImportData.clear(); }
-						catch (nlohmann::json::other_error&) { m_previousImportData.clear(); }
-						catch (nlohmann::json::exception&) { m_previousImportData.clear(); }
 					}
 				}
 		}
@@ -211,13 +354,10 @@ namespace Jimara {
 		// We lock observers to make sure no signals come in while initializing the state:
 		std::unique_lock<std::mutex> lock(m_observerLock);
 		
-		// Create initial import theads:
-		size_t importThreadCount = Math::Max(configuration.importThreadCount, size_t(1u));
-		auto createImportThreads = [&]() {
-			for (size_t i = 0; i < importThreadCount; i++)
-				m_importThreads.push_back(std::thread([](FileSystemDatabase* self) { self->ImportThread(); }, this));
-		};
-		createImportThreads();
+		// Create import theads:
+		const size_t importThreadCount = Math::Max(configuration.importThreadCount, size_t(1u));
+		for (size_t i = 0; i < importThreadCount; i++)
+			m_importThreads.push_back(std::thread([](FileSystemDatabase* self) { self->ImportThread(); }, this));
 
 		// Schedule all pre-existing files for scan:
 		size_t totalFileCount = 0;
@@ -227,41 +367,41 @@ namespace Jimara {
 			return true;
 			});
 		
-		// To make sure all pre-existing files are loaded when the application starts, we wait for the import queue to get empty:
+		// To make sure all pre-existing files are loaded when the application starts, we wait for the import queue to get empty;
+		// Import threads notify m_importProcessed after each file and may only re-queue a file before that, so once both the queue is empty 
+		// and there are no active imports, initial scan is complete:
+		size_t lastReportedCount = ~size_t(0u);
 		while (true) {
-			while (true) {
-				size_t numProcessed = 0;
-				{
-					std::unique_lock<std::mutex> lock(m_importQueueLock);
-					if (m_importQueue.empty()) break;
-					else numProcessed = (m_importQueue.size() < totalFileCount) ? (totalFileCount - m_importQueue.size()) : 0;
-				}
-				configuration.reportImportProgress(numProcessed, totalFileCount);
-				std::this_thread::sleep_for(std::chrono::microseconds(1));
-			}
-
-			// Temporarily kill the import threads 
+			size_t numProcessed = 0;
+			bool done = false;
 			{
-				{
-					std::unique_lock<std::mutex> lock(m_importQueueLock);
-					m_dead = true;
-					m_importAvaliable.notify_all();
-				}
-				for (size_t i = 0; i < m_importThreads.size(); i++)
-					m_importThreads[i].join();
-				m_importThreads.clear();
-				m_dead = false;
+				std::unique_lock<std::mutex> lock(m_importQueueLock);
+				auto processedCount = [&]() -> size_t {
+					const size_t pendingCount = m_importQueue.size() + m_activeImportCount;
+					return (pendingCount < totalFileCount) ? (totalFileCount - pendingCount) : 0;
+				};
+				auto importsDone = [&]() { return m_importQueue.empty() && m_activeImportCount <= 0u; };
+				while ((!importsDone()) && processedCount() == lastReportedCount)
+					m_importProcessed.wait(lock);
+				numProcessed = processedCount();
+				done = importsDone();
 			}
+			if (done) break;
+			configuration.reportImportProgress(numProcessed, totalFileCount);
+			lastReportedCount = numProcessed;
+		}
+		configuration.reportImportProgress(totalFileCount, totalFileCount);
 
-			if (m_importQueue.empty()) {
-				configuration.reportImportProgress(totalFileCount, totalFileCount);
-				break;
+		// Cooked data of the assets that no longer exist and the temporary files from interrupted writes are no longer needed:
+		if (m_context->cookedAssetCacheDirectory.has_value()) {
+			std::unordered_set<std::string> prefixes;
+			{
+				std::unique_lock<std::mutex> pathLock(m_pathReaderLock);
+				for (auto it = m_pathReaders.begin(); it != m_pathReaders.end(); ++it)
+					prefixes.insert(FileSystemDatabase_CookedDataPrefix(it->first));
 			}
-			else createImportThreads();
+			FileSystemDatabase_RemoveCookedData(m_context->cookedAssetCacheDirectory.value(), prefixes, true, startTime);
 		}
-
-		// Recreate import theads:
-		createImportThreads();
 	}
 
 	FileSystemDatabase::~FileSystemDatabase() {
@@ -278,36 +418,52 @@ namespace Jimara {
 			m_context->owner = nullptr;
 		}
 
-		// Store previous import data:
+		// Store import index:
 		if (m_previousImportDataCache.has_value()) {
-			nlohmann::json previousImportData = nlohmann::json::object();
-			for (auto it = m_previousImportData.begin(); it != m_previousImportData.end(); ++it) {
-				std::error_code err;
-				if (!std::filesystem::exists(it->first, err))
-					continue;
-				if (err)
-					continue;
-				auto& entry = previousImportData[it->first];
-				entry["lastModifiedDate"] = it->second.lastModifiedDate;
-				entry["previousImportData"] = it->second.previousImportData;
+			std::vector<uint8_t> newData;
+			{
+				std::vector<std::map<std::string, FileImportRecord>::const_iterator> entries;
+				for (auto it = m_importIndex.begin(); it != m_importIndex.end(); ++it) {
+					std::error_code err;
+					if (!std::filesystem::exists(it->first, err))
+						continue;
+					if (err)
+						continue;
+					entries.push_back(it);
+				}
+				FileSystemDatabase_ImportIndexWriter writer = { newData };
+				for (size_t i = 0u; i < sizeof(FileSystemDatabase_ImportIndexMagic); i++)
+					writer.Value(FileSystemDatabase_ImportIndexMagic[i]);
+				writer.Value(FileSystemDatabase_ImportIndexVersion);
+				writer.Value(FileSystemDatabase_ImportIndexEndiannessTag);
+				writer.Value(static_cast<uint64_t>(entries.size()));
+				for (size_t i = 0u; i < entries.size(); i++) {
+					const FileImportRecord& record = entries[i]->second;
+					writer.String(entries[i]->first);
+					writer.Value(record.fileSize);
+					writer.Value(record.lastModifiedDate);
+					writer.Value(record.contentHash.xxHash);
+					writer.Value(record.contentHash.seededHash);
+					writer.Value(record.importerVersion);
+					writer.String(record.previousImportData);
+				}
 			}
-			const std::string prevData = [&]() -> std::string {
+			const bool changed = [&]() -> bool {
 				std::error_code err;
 				if (!std::filesystem::exists(m_previousImportDataCache.value(), err))
-					return "";
+					return true;
 				else if (err)
-					return "";
-				const Reference<OS::MMappedFile> metadataMapping = OS::MMappedFile::Create(m_previousImportDataCache.value());
-				if (metadataMapping == nullptr)
-					return "";
-				const MemoryBlock block = *metadataMapping;
-				return std::string(std::string_view(reinterpret_cast<const char*>(block.Data()), block.Size()));
+					return true;
+				const Reference<OS::MMappedFile> indexMapping = OS::MMappedFile::Create(m_previousImportDataCache.value());
+				if (indexMapping == nullptr)
+					return true;
+				const MemoryBlock block = *indexMapping;
+				return block.Size() != newData.size() || std::memcmp(block.Data(), newData.data(), newData.size()) != 0;
 				}();
-			const std::string newData = previousImportData.dump(1, '\t');
-			if (newData != prevData) {
-				std::ofstream stream((const std::filesystem::path&)m_previousImportDataCache.value());
+			if (changed) {
+				std::ofstream stream((const std::filesystem::path&)m_previousImportDataCache.value(), std::ios::binary);
 				if (stream.is_open()) {
-					stream << newData;
+					stream.write(reinterpret_cast<const char*>(newData.data()), newData.size());
 					stream.close();
 				}
 			}
@@ -322,6 +478,7 @@ namespace Jimara {
 		if (it == m_assetCollection.infoByGUID.end()) return nullptr;
 		else {
 			Reference<Asset> asset = it->second->m_asset;
+			AttachToResidencyCache(asset);
 			return asset;
 		}
 	}
@@ -452,6 +609,7 @@ namespace Jimara {
 				fileInfo = std::move(m_importQueue.front());
 				m_importQueue.pop();
 				m_queuedPaths.erase(fileInfo.filePath);
+				m_activeImportCount++;
 			}
 
 			Reference<OS::MMappedFile> memoryMapping = OS::MMappedFile::Create(fileInfo.filePath); // No logger needed; File may not be readable and it's perfectly valid..
@@ -464,10 +622,14 @@ namespace Jimara {
 						QueueFile(std::move(fileInfo));
 				}
 				std::this_thread::sleep_for(std::chrono::milliseconds(1));
-				continue;
 			}
+			else ImportFile(fileInfo, *memoryMapping);
 
-			ImportFile(fileInfo);
+			{
+				std::unique_lock<std::mutex> lock(m_importQueueLock);
+				m_activeImportCount--;
+				m_importProcessed.notify_all();
+			}
 		}
 	}
 
@@ -476,14 +638,18 @@ namespace Jimara {
 			return filePath.native() + metadataExtension.native();
 		}
 
-		inline static void StoreMetadata(const Serialization::SerializedObject& serializedObject, OS::Logger* logger, const OS::Path& metadataPath, nlohmann::json* lastMetadata) {
-			bool error = false;
-			nlohmann::json metadata = Serialization::SerializeToJson(serializedObject, logger, error,
+		inline static nlohmann::json SerializeMetadata(const Serialization::SerializedObject& serializedObject, OS::Logger* logger, bool& error) {
+			return Serialization::SerializeToJson(serializedObject, logger, error,
 				[&](const Serialization::SerializedObject&, bool& error) {
-					logger->Error("FileSystemDatabase::StoreMetadata - Metadata files are not expected to contain any object pointers! <SerializeToJson>");
+					logger->Error("FileSystemDatabase::SerializeMetadata - Metadata files are not expected to contain any object pointers! <SerializeToJson>");
 					error = true;
 					return nlohmann::json();
 				});
+		}
+
+		inline static void StoreMetadata(const Serialization::SerializedObject& serializedObject, OS::Logger* logger, const OS::Path& metadataPath, nlohmann::json* lastMetadata) {
+			bool error = false;
+			nlohmann::json metadata = SerializeMetadata(serializedObject, logger, error);
 			if (error) {
 				logger->Error("FileSystemDatabase::StoreMetadata - Failed to serialize asset importer! (Metadata Path: '", metadataPath, "')");
 			}
@@ -499,7 +665,7 @@ namespace Jimara {
 		}
 	}
 
-	void FileSystemDatabase::ImportFile(const AssetFileInfo& fileInfo) {
+	void FileSystemDatabase::ImportFile(const AssetFileInfo& fileInfo, const MemoryBlock& fileContent) {
 		// If there are no serializers, we don't care about this file...
 		if (fileInfo.serializers.size() <= 0) return;
 		Reference<PathLock> pathLockInstance = m_pathLockCache.LockFor(fileInfo.filePath);
@@ -517,6 +683,56 @@ namespace Jimara {
 			}
 		}
 
+		// File size, last modified date and content hash (hashing is skipped if the size and the date match the index):
+		const uint64_t fileSize = static_cast<uint64_t>(fileContent.Size());
+		std::error_code fsError;
+		const auto lastModifiedDate = std::filesystem::last_write_time(fileInfo.filePath, fsError);
+		const uint64_t lastModified = fsError ? 0u :
+			static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(lastModifiedDate.time_since_epoch()).count());
+		const ContentHash::Digest contentHash = [&]() -> ContentHash::Digest {
+			if (!fsError) {
+				std::unique_lock<std::mutex> lock(m_importIndexLock);
+				auto it = m_importIndex.find(fileInfo.filePath);
+				if (it != m_importIndex.end() && it->second.fileSize == fileSize && it->second.lastModifiedDate == lastModified)
+					return it->second.contentHash;
+			}
+			return ContentHash::DigestOf(fileContent);
+		}();
+
+		// Retrieves stored reader information if there exists one:
+		auto getStoredReaderInfo = [&]() -> Reference<AssetReaderInfo> {
+			std::unique_lock<std::mutex> lock(m_pathReaderLock);
+			PathReaderInfo::const_iterator it = m_pathReaders.find(fileInfo.filePath);
+			if (it == m_pathReaders.end()) return nullptr;
+			else {
+				Reference<AssetReaderInfo> readerInfo = it->second;
+				return readerInfo;
+			}
+		};
+
+		// If neither the content, nor the metadata have changed since the last successful import (file got touched or saved as-is), there's nothing to do
+		// (this only applies to the files imported during this session; on startup there is no stored reader and Import() always runs):
+		{
+			const Reference<AssetReaderInfo> storedInfo = getStoredReaderInfo();
+			auto isUpToDate = [&]() -> bool {
+				if (storedInfo == nullptr || storedInfo->reader == nullptr || storedInfo->serializer == nullptr) return false;
+				else if (storedInfo->fileSize != fileSize || storedInfo->contentHash != contentHash) return false;
+				else if (storedInfo->importerVersion != storedInfo->serializer->ImporterVersion()) return false;
+				else if (std::find(fileInfo.serializers.begin(), fileInfo.serializers.end(), storedInfo->serializer) == fileInfo.serializers.end()) return false;
+				bool error = false;
+				const nlohmann::json currentMetadata = SerializeMetadata(storedInfo->serializer->Serialize(storedInfo->reader), m_assetDirectoryObserver->Log(), error);
+				return (!error) && currentMetadata == metadataJson;
+			};
+			if (isUpToDate()) {
+				// Remember the new date, so that the next check does not have to hash the file again:
+				std::unique_lock<std::mutex> lock(m_importIndexLock);
+				auto it = m_importIndex.find(fileInfo.filePath);
+				if (it != m_importIndex.end() && it->second.contentHash == contentHash && it->second.fileSize == fileSize)
+					it->second.lastModifiedDate = lastModified;
+				return;
+			}
+		}
+
 		// Creates a reader, given a serializer:
 		auto createReader = [&](AssetImporter::Serializer* serializer) -> Reference<AssetImporter> {
 			Reference<AssetImporter> reader = serializer->CreateReader();
@@ -545,7 +761,7 @@ namespace Jimara {
 
 		// Tries to import asset, given a reader:
 		std::vector<AssetImporter::AssetInfo> assets;
-		auto importAssets = [&](AssetImporter* reader) -> bool {
+		auto importAssets = [&](AssetImporter* reader, uint32_t importerVersion) -> bool {
 			{
 				std::unique_lock<std::mutex> lock(reader->m_pathLock);
 				reader->m_path = fileInfo.filePath;
@@ -554,55 +770,43 @@ namespace Jimara {
 			void (*recordAsset)(std::vector<AssetImporter::AssetInfo>*, const AssetImporter::AssetInfo&) =
 				[](std::vector<AssetImporter::AssetInfo>* assets, const AssetImporter::AssetInfo& asset) { if (asset.asset != nullptr) assets->push_back(asset); };
 
-			// Get last modified time:
-			std::error_code fsError;
-			const auto lastModifiedDate = std::filesystem::last_write_time(fileInfo.filePath, fsError);
-			const uint64_t lastModified = fsError ? 0u :
-				static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(lastModifiedDate.time_since_epoch()).count());
-
-			// Get previous import data if still valid:
+			// Get previous import data if still valid (content is the same; date does not matter):
 			{
 				reader->m_previousImportData = "";
-				std::unique_lock<std::mutex> lock(m_previousImportDataLock);
-				auto it = m_previousImportData.find(fileInfo.filePath);
-				if (it != m_previousImportData.end()) {
-					if ((!fsError) && lastModified == it->second.lastModifiedDate)
+				std::unique_lock<std::mutex> lock(m_importIndexLock);
+				auto it = m_importIndex.find(fileInfo.filePath);
+				if (it != m_importIndex.end()) {
+					if (it->second.fileSize == fileSize && it->second.contentHash == contentHash && it->second.importerVersion == importerVersion)
 						reader->m_previousImportData = it->second.previousImportData;
-					m_previousImportData.erase(it);
+					m_importIndex.erase(it);
 				}
 			}
 
 			// Get assets:
 			const bool rv = reader->Import(Callback<const AssetImporter::AssetInfo&>(recordAsset, &assets));
 
-			// Store latest import data if load is successful:
-			if (rv && reader->m_previousImportData.length() > 0u) {
-				std::unique_lock<std::mutex> lock(m_previousImportDataLock);
-				PreviousFileImportData data = {};
-				data.lastModifiedDate = lastModified;
-				data.previousImportData = reader->m_previousImportData;
-				m_previousImportData[fileInfo.filePath] = data;
+			// Store the index entry and the latest import data if load is successful:
+			if (rv) {
+				std::unique_lock<std::mutex> lock(m_importIndexLock);
+				FileImportRecord record = {};
+				record.fileSize = fileSize;
+				record.lastModifiedDate = lastModified;
+				record.contentHash = contentHash;
+				record.importerVersion = importerVersion;
+				record.previousImportData = reader->m_previousImportData;
+				m_importIndex[fileInfo.filePath] = std::move(record);
 			}
 
 			return rv;
 		};
 
-		// Retrieves stored reader information if there exists one:
-		auto getStoredReaderInfo = [&]() -> Reference<AssetReaderInfo> {
-			std::unique_lock<std::mutex> lock(m_pathReaderLock);
-			PathReaderInfo::const_iterator it = m_pathReaders.find(fileInfo.filePath);
-			if (it == m_pathReaders.end()) return nullptr;
-			else {
-				Reference<AssetReaderInfo> readerInfo = it->second;
-				return readerInfo;
-			}
-		};
-
 		// Updates reader information:
 		auto updateReaderInfo = [&](AssetReaderInfo* info) -> bool {
 			if (info == nullptr) return false;
 			else if (info->reader == nullptr) return false;
-			else if (!importAssets(info->reader)) return false;
+			else if (info->serializer == nullptr) return false;
+			const uint32_t importerVersion = info->serializer->ImporterVersion();
+			if (!importAssets(info->reader, importerVersion)) return false;
 			std::unique_lock<std::mutex> pathLock(m_pathReaderLock);
 			{
 				PathReaderInfo::const_iterator it = m_pathReaders.find(fileInfo.filePath);
@@ -636,6 +840,9 @@ namespace Jimara {
 			}
 
 			info->assets = std::move(assets);
+			info->fileSize = fileSize;
+			info->contentHash = contentHash;
+			info->importerVersion = importerVersion;
 			
 			// Store/Overwrite the meta file:
 			StoreMetadata(info->serializer->Serialize(info->reader), m_assetDirectoryObserver->Log(), metadataPath, &metadataJson);
@@ -689,12 +896,25 @@ namespace Jimara {
 			for (size_t i = 0; i < info->assets.size(); i++)
 				m_assetCollection.AssetSourceFileRenamed(info->assets[i].asset);
 		}
+		// Move the import index entry:
+		{
+			std::unique_lock<std::mutex> lock(m_importIndexLock);
+			auto it = m_importIndex.find(oldPath);
+			if (it != m_importIndex.end()) {
+				FileImportRecord record = std::move(it->second);
+				m_importIndex.erase(it);
+				m_importIndex[newPath] = std::move(record);
+			}
+		}
 		// Rename metadata:
 		{
 			std::error_code error;
 			std::filesystem::remove(MetadataPath(oldPath, m_metadataExtension), error);
 			StoreMetadata(info->serializer->Serialize(info->reader), m_assetDirectoryObserver->Log(), MetadataPath(newPath, m_metadataExtension), nullptr);
 		}
+		// Cooked file names depend on the path, so the old ones will never be used again:
+		if (m_context->cookedAssetCacheDirectory.has_value())
+			FileSystemDatabase_RemoveCookedData(m_context->cookedAssetCacheDirectory.value(), { FileSystemDatabase_CookedDataPrefix(oldPath) }, false, std::nullopt);
 	}
 
 	void FileSystemDatabase::FileErased(const OS::Path& path) {
@@ -718,6 +938,10 @@ namespace Jimara {
 			std::error_code error;
 			std::filesystem::remove(MetadataPath(path, m_metadataExtension), error);
 		}
+
+		// Remove cooked data:
+		if (m_context->cookedAssetCacheDirectory.has_value())
+			FileSystemDatabase_RemoveCookedData(m_context->cookedAssetCacheDirectory.value(), { FileSystemDatabase_CookedDataPrefix(path) }, false, std::nullopt);
 	}
 
 	void FileSystemDatabase::OnFileSystemChanged(const OS::DirectoryChangeObserver::FileChangeInfo& info) {
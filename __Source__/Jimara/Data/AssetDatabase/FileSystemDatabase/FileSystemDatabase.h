@@ -3,6 +3,7 @@
 #include "../../ShaderLibrary.h"
 #include "../../Serialization/ItemSerializers.h"
 #include "../../../Core/Helpers.h"
+#include "../../../Core/Memory/ContentHash.h"
 #include "../../../Graphics/GraphicsDevice.h"
 #include "../../../Physics/PhysicsInstance.h"
 #include "../../../Audio/AudioDevice.h"
@@ -72,6 +73,17 @@ namespace Jimara {
 			/// <summary> Logger </summary>
 			OS::Logger* Log()const;
 
+			/// <summary>
+			/// Path for persistent importer-specific binary data, derived from the asset file ("cooked" data; survives restarts)
+			/// <para/> Path depends on AssetFilePath(), so it changes if the file gets moved; 
+			///		importers are expected to validate the content of the cooked file themselves (content hash and such).
+			/// <para/> Cooked files of erased and moved assets get deleted by the database, alongside the ones left behind by the previous sessions
+			///		(files with '.tmp' extension from interrupted writes included).
+			/// </summary>
+			/// <param name="extension"> Extension of the cooked file (lets a single importer keep more than one cooked file per asset) </param>
+			/// <returns> Cooked file path, if FileSystemDatabase was created with CreateArgs::cookedAssetCacheDirectory; empty otherwise </returns>
+			std::optional<OS::Path> CookedDataPath(const OS::Path& extension)const;
+
 			/// <summary>
 			/// Finds an asset within the owner database
 			/// </summary>
@@ -98,10 +110,20 @@ namespace Jimara {
 				/// </summary>
 				/// <param name="extension"> File extension to ignore </param>
 				void Unregister(const OS::Path& extension);
+
+				/// <summary>
+				/// Version of the importer output
+				/// <para/> While running, FileSystemDatabase skips re-importing files, whose content and metadata did not change since the last import
+				///		(file got touched or saved as-is); it also discards PreviousImportData if the version differs, so this has to be incremented whenever
+				///		the importer starts producing different assets from the same file.
+				/// <para/> Note: Assets only exist in memory, so on startup every file still goes through Import() once; 
+				///		only PreviousImportData survives the restart (through the import index) and lets the importers take their fast paths.
+				/// </summary>
+				inline virtual uint32_t ImporterVersion()const { return 0u; }
 			};
 
 		protected:
-			// Arbitrary data from the previous Import() call (may be randomly cleared; always cleared when last modified date is changed; only safe to use inside Import() method)
+			// Arbitrary data from the previous Import() call (may be randomly cleared; always cleared when file content or ImporterVersion() changes; only safe to use inside Import() method)
 			inline std::string& PreviousImportData() { return m_previousImportData; }
 
 		private:
@@ -157,9 +179,21 @@ namespace Jimara {
 			/// <summary> Asset directory to listen to and find resources within </summary>
 			OS::Path assetDirectory;
 
-			/// <summary> Path to the cache for PreviousImportData entries (Optional; loaded on strartup; updated during destruction) </summary>
+			/// <summary> 
+			/// Path to the binary import index (Optional; loaded on strartup; updated during destruction)
+			/// <para/> Index stores size, last modified date, content digest (unseeded and seeded xxHash64), importer version and PreviousImportData per file,
+			///		so that the importers can reuse their previous results if the file content did not actually change
+			///		(every file is still imported on startup, since the assets themselves are not persisted).
+			/// </summary>
 			std::optional<OS::Path> previousImportDataCache;
 
+			/// <summary> 
+			/// Directory for the persistent cooked asset data (Optional; see AssetImporter::CookedDataPath) 
+			/// <para/> Cooked files are stored in a subdirectory, named after the hash of the absolute asset directory path, so the directory can be shared;
+			///		the subdirectory is owned by the database: after the initial scan, files within it that do not belong to any of the imported assets get deleted.
+			/// </summary>
+			std::optional<OS::Path> cookedAssetCacheDirectory;
+
 			/// <summary> Limit on the import thead count (at least one will be created) </summary>
 			size_t importThreadCount = std::thread::hardware_concurrency();
 
@@ -423,6 +457,9 @@ namespace Jimara {
 			// Audio device
 			Reference<Audio::AudioDevice> audioDevice = nullptr;
 
+			// Directory for cooked asset data ([CreateArgs::cookedAssetCacheDirectory]/[asset directory hash])
+			std::optional<OS::Path> cookedAssetCacheDirectory;
+
 			// Lock for owner
 			mutable SpinLock ownerLock;
 
@@ -508,6 +545,9 @@ namespace Jimara {
 			Reference<AssetImporter::Serializer> serializer;
 			Reference<AssetImporter> reader;
 			std::vector<AssetImporter::AssetInfo> assets;
+			uint64_t fileSize = 0u;
+			ContentHash::Digest contentHash;
+			uint32_t importerVersion = 0u;
 		};
 
 		// Path to current AssetReaderInfo mapping
@@ -523,19 +563,28 @@ namespace Jimara {
 		typedef std::unordered_set<OS::Path> QueuedPaths;
 		QueuedPaths m_queuedPaths;
 		
-		// Lock and condition for m_importQueue and m_queuedPaths
+		// Number of files, currently being imported by the import threads
+		size_t m_activeImportCount = 0u;
+
+		// Lock and condition for m_importQueue, m_queuedPaths and m_activeImportCount
 		std::mutex m_importQueueLock;
 		std::condition_variable m_importAvaliable;
 		std::atomic<bool> m_dead = false;
 
-		// 'PreviousImportData' storage
-		struct PreviousFileImportData {
+		// Notified each time an import thread finishes processing a file
+		std::condition_variable m_importProcessed;
+
+		// Import index ('PreviousImportData' storage and the content hashes)
+		struct FileImportRecord {
+			uint64_t fileSize = 0u;
 			uint64_t lastModifiedDate = 0u;
+			ContentHash::Digest contentHash;
+			uint32_t importerVersion = 0u;
 			std::string previousImportData;
 		};
-		std::map<std::string, PreviousFileImportData> m_previousImportData;
+		std::map<std::string, FileImportRecord> m_importIndex;
 		const std::optional<OS::Path> m_previousImportDataCache;
-		std::mutex m_previousImportDataLock;
+		std::mutex m_importIndexLock;
 
 		// Invoked each time the asset database internals change
 		mutable EventInstance<DatabaseChangeInfo> m_onDatabaseChanged;
@@ -548,7 +597,7 @@ namespace Jimara {
 		void ImportThread();
 
 		// (Re)Imports the file
-		void ImportFile(const AssetFileInfo& fileInfo);
+		void ImportFile(const AssetFileInfo& fileInfo, const MemoryBlock& fileContent);
 
 		// Queues file parsing
 		void QueueFile(AssetFileInfo&& fileInfo);
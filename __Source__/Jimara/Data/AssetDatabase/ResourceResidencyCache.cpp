@@ -0,0 +1,285 @@
+#include "ResourceResidencyCache.h"
+
+
+namespace Jimara {
+	namespace {
+		struct ResourceResidencyCache_EvictedResource {
+			Reference<Asset> asset;
+			Reference<Resource> resource;
+		};
+
+		struct ResourceResidencyCache_DeferredReleases {
+			size_t resourceLockDepth = 0u;
+			std::vector<ResourceResidencyCache_EvictedResource> resources;
+		};
+
+		static thread_local ResourceResidencyCache_DeferredReleases ResourceResidencyCache_deferredReleases;
+	}
+
+	struct ResourceResidencyCache::Helpers {
+		// Releases evicted resource (unloads it, if the cache was the last one holding it)
+		inline static void Release(Asset* asset, Reference<Resource>& resource) {
+			{
+				const ResourceLockScope resourceLockScope;
+				std::unique_lock<std::mutex> lock(asset->m_resourceLock);
+				// Nobody else holds a reference and, without the lock, nobody can acquire a new one, so this is the same as Resource::OnOutOfScope():
+				if (resource->RefCount() == 1u && asset->m_resource == resource) {
+					asset->m_resource = nullptr;
+					{
+						std::unique_lock<SpinLock> assetLock(resource->m_assetLock);
+						if (resource->m_asset == asset)
+							resource->m_asset = nullptr;
+					}
+					asset->UnloadResourceObject(resource);
+					resource = nullptr;
+				}
+			}
+			// Resource is still in use; Resource::OnOutOfScope() will take care of it once it's released:
+			resource = nullptr;
+		}
+
+		// Evicted resources (released on destruction, unless some asset resource lock is held by the thread)
+		struct EvictedResources : public std::vector<ResourceResidencyCache_EvictedResource> {
+			inline void Add(Asset* asset, const Reference<Resource>& resource) {
+				push_back({ asset, resource });
+			}
+
+			inline ~EvictedResources() {
+				ResourceResidencyCache_DeferredReleases& deferred = ResourceResidencyCache_deferredReleases;
+				for (size_t i = 0u; i < size(); i++) {
+					ResourceResidencyCache_EvictedResource& evicted = operator[](i);
+					if (deferred.resourceLockDepth > 0u)
+						deferred.resources.push_back(evicted);
+					else Release(evicted.asset, evicted.resource);
+				}
+			}
+		};
+
+		inline static size_t EstimateSize(const ResourceResidencyCache* self, const Resource* resource) {
+			for (size_t i = self->m_sizeEstimates.size(); i > 0u; i--) {
+				const std::pair<TypeId, SizeEstimateFn>& estimate = self->m_sizeEstimates[i - 1u];
+				if (estimate.first.CheckType(resource))
+					return estimate.second(resource);
+			}
+			return self->m_defaultSizeEstimate;
+		}
+
+		inline static AssetInfo& GetInfo(ResourceResidencyCache* self, Asset* asset) {
+			AssetInfo& info = self->m_assets[asset];
+			if (info.asset == nullptr) {
+				info.asset = asset;
+				asset->m_residencyCache = self;
+			}
+			return info;
+		}
+
+		inline static Reference<Resource> RemoveRetained(ResourceResidencyCache* self, AssetInfo& info) {
+			const Reference<Resource> resource = info.retained;
+			if (resource == nullptr) return nullptr;
+			self->m_evictionOrder.erase(std::make_tuple(info.priority, info.lastRelease, info.asset.operator->()));
+			self->m_stats.residentCount--;
+			self->m_stats.residentBytes -= info.retainedSize;
+			info.retainedSize = 0u;
+			info.retained = nullptr;
+			return resource;
+		}
+
+		inline static void Retain(ResourceResidencyCache* self, AssetInfo& info, Resource* resource, size_t size) {
+			info.retained = resource;
+			info.retainedSize = size;
+			info.lastRelease = (++self->m_releaseCounter);
+			self->m_evictionOrder.insert(std::make_tuple(info.priority, info.lastRelease, info.asset.operator->()));
+			self->m_stats.residentCount++;
+			self->m_stats.residentBytes += size;
+		}
+
+		inline static void Evict(ResourceResidencyCache* self, size_t targetBytes, EvictedResources& evicted) {
+			while (self->m_stats.residentBytes > targetBytes && (!self->m_evictionOrder.empty())) {
+				AssetInfo& info = self->m_assets[std::get<2>(*self->m_evictionOrder.begin())];
+				evicted.Add(info.asset, RemoveRetained(self, info));
+				self->m_stats.evictions++;
+			}
+		}
+	};
+
+	ResourceResidencyCache::ResourceLockScope::ResourceLockScope() {
+		ResourceResidencyCache_deferredReleases.resourceLockDepth++;
+	}
+
+	ResourceResidencyCache::ResourceLockScope::~ResourceLockScope() {
+		ResourceResidencyCache_DeferredReleases& deferred = ResourceResidencyCache_deferredReleases;
+		deferred.resourceLockDepth--;
+		if (deferred.resourceLockDepth > 0u) return;
+		// Releasing may trigger more evictions, so we keep going till there's nothing left:
+		while (!deferred.resources.empty()) {
+			std::vector<ResourceResidencyCache_EvictedResource> resources;
+			std::swap(resources, deferred.resources);
+			for (size_t i = 0u; i < resources.size(); i++)
+				Helpers::Release(resources[i].asset, resources[i].resource);
+		}
+	}
+
+	ResourceResidencyCache::ResourceResidencyCache(size_t memoryBudget) : m_memoryBudget(memoryBudget) {}
+
+	ResourceResidencyCache::~ResourceResidencyCache() {
+		// Detach from the assets (under their resource locks, so that nothing can be mid-RetainReleasedResource):
+		for (auto it = m_assets.begin(); it != m_assets.end(); ++it) {
+			Asset* asset = it->first;
+			std::unique_lock<std::mutex> lock(asset->m_resourceLock);
+			ResourceResidencyCache* self = this;
+			asset->m_residencyCache.compare_exchange_strong(self, nullptr);
+		}
+
+		// Release resources (Resource::OnOutOfScope will no longer see the cache):
+		Helpers::EvictedResources released;
+		for (auto it = m_assets.begin(); it != m_assets.end(); ++it) {
+			if (it->second.retained != nullptr)
+				released.Add(it->first, it->second.retained);
+			if (it->second.pinned != nullptr)
+				released.Add(it->first, it->second.pinned);
+		}
+		m_evictionOrder.clear();
+		m_assets.clear();
+	}
+
+	size_t ResourceResidencyCache::MemoryBudget()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_memoryBudget;
+	}
+
+	void ResourceResidencyCache::SetMemoryBudget(size_t memoryBudget) {
+		Helpers::EvictedResources evicted;
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_memoryBudget = memoryBudget;
+		Helpers::Evict(this, m_memoryBudget, evicted);
+	}
+
+	void ResourceResidencyCache::SetSizeEstimate(const TypeId& resourceType, const SizeEstimateFn& estimate) {
+		std::unique_lock<std::mutex> lock(m_lock);
+		for (size_t i = 0u; i < m_sizeEstimates.size(); i++)
+			if (m_sizeEstimates[i].first == resourceType) {
+				m_sizeEstimates.erase(m_sizeEstimates.begin() + i);
+				break;
+			}
+		m_sizeEstimates.push_back(std::make_pair(resourceType, estimate));
+	}
+
+	size_t ResourceResidencyCache::DefaultSizeEstimate()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_defaultSizeEstimate;
+	}
+
+	void ResourceResidencyCache::SetDefaultSizeEstimate(size_t bytes) {
+		std::unique_lock<std::mutex> lock(m_lock);
+		m_defaultSizeEstimate = bytes;
+	}
+
+	void ResourceResidencyCache::Attach(Asset* asset) {
+		if (asset == nullptr || asset->m_residencyCache.load() == this) return;
+		std::unique_lock<std::mutex> lock(m_lock);
+		Helpers::GetInfo(this, asset);
+		asset->m_residencyCache = this;
+	}
+
+	void ResourceResidencyCache::SetPriority(Asset* asset, int priority) {
+		if (asset == nullptr) return;
+		std::unique_lock<std::mutex> lock(m_lock);
+		AssetInfo& info = Helpers::GetInfo(this, asset);
+		if (info.priority == priority) return;
+		if (info.retained != nullptr) {
+			m_evictionOrder.erase(std::make_tuple(info.priority, info.lastRelease, asset));
+			m_evictionOrder.insert(std::make_tuple(priority, info.lastRelease, asset));
+		}
+		info.priority = priority;
+	}
+
+	bool ResourceResidencyCache::Prefetch(Asset* asset, int priority, const Callback<Asset::LoadInfo>& reportProgress) {
+		if (asset == nullptr) return false;
+		SetPriority(asset, priority);
+		// Resource will be retained by the cache once the reference goes out of scope:
+		const Reference<Resource> resource = asset->LoadResource(reportProgress);
+		return resource != nullptr;
+	}
+
+	Reference<Resource> ResourceResidencyCache::Pin(Asset* asset, const Callback<Asset::LoadInfo>& reportProgress) {
+		if (asset == nullptr) return nullptr;
+		Attach(asset);
+		const Reference<Resource> resource = asset->LoadResource(reportProgress);
+		if (resource == nullptr) return nullptr;
+		std::unique_lock<std::mutex> lock(m_lock);
+		AssetInfo& info = Helpers::GetInfo(this, asset);
+		info.pinCount++;
+		if (info.pinned == nullptr) {
+			info.pinned = resource;
+			info.pinnedSize = Helpers::EstimateSize(this, resource);
+			m_stats.pinnedCount++;
+			m_stats.pinnedBytes += info.pinnedSize;
+		}
+		return resource;
+	}
+
+	void ResourceResidencyCache::Unpin(Asset* asset) {
+		if (asset == nullptr) return;
+		Helpers::EvictedResources released;
+		std::unique_lock<std::mutex> lock(m_lock);
+		const auto it = m_assets.find(asset);
+		if (it == m_assets.end() || it->second.pinCount <= 0u) return;
+		AssetInfo& info = it->second;
+		info.pinCount--;
+		if (info.pinCount > 0u) return;
+		const Reference<Resource> pinned = info.pinned;
+		info.pinned = nullptr;
+		m_stats.pinnedCount--;
+		m_stats.pinnedBytes -= info.pinnedSize;
+		info.pinnedSize = 0u;
+
+		// If the pin was the last reference, the resource becomes an ordinary retained one right away (otherwise, it will, once released):
+		if (pinned->RefCount() == 1u && info.retained == nullptr) {
+			const size_t size = Helpers::EstimateSize(this, pinned);
+			if (size <= m_memoryBudget) {
+				Helpers::Retain(this, info, pinned, size);
+				Helpers::Evict(this, m_memoryBudget, released);
+				return;
+			}
+		}
+		released.Add(asset, pinned);
+	}
+
+	void ResourceResidencyCache::Clear() {
+		Helpers::EvictedResources evicted;
+		std::unique_lock<std::mutex> lock(m_lock);
+		Helpers::Evict(this, 0u, evicted);
+	}
+
+	ResourceResidencyCache::Statistics ResourceResidencyCache::Stats()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_stats;
+	}
+
+	bool ResourceResidencyCache::RetainReleasedResource(Asset* asset, Resource* resource) {
+		Helpers::EvictedResources evicted;
+		std::unique_lock<std::mutex> lock(m_lock);
+		const auto it = m_assets.find(asset);
+		if (it == m_assets.end()) return false;
+		AssetInfo& info = it->second;
+		if (info.retained != nullptr) return false;
+		const size_t size = Helpers::EstimateSize(this, resource);
+		if (size > m_memoryBudget) return false;
+		Helpers::Retain(this, info, resource, size);
+		Helpers::Evict(this, m_memoryBudget, evicted);
+		return true;
+	}
+
+	void ResourceResidencyCache::OnLoadRequested(Asset* asset, bool loaded) {
+		// Caller holds a reference, so dropping ours here can not cause Resource::OnOutOfScope:
+		Reference<Resource> released;
+		std::unique_lock<std::mutex> lock(m_lock);
+		const auto it = m_assets.find(asset);
+		if (it == m_assets.end()) return;
+		if (loaded) m_stats.misses++;
+		else if (it->second.retained != nullptr) {
+			released = Helpers::RemoveRetained(this, it->second);
+			m_stats.hits++;
+		}
+	}
+}
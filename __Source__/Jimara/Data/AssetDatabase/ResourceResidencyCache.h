@@ -0,0 +1,187 @@
+#pragma once
+#include "AssetDatabase.h"
+#include "../../Core/Function.h"
+#include <unordered_map>
+#include <vector>
+#include <tuple>
+#include <set>
+
+
+namespace Jimara {
+	/// <summary>
+	/// Opt-in cache, that keeps recently released Resources loaded, as long as they fit in a memory budget
+	/// <para /> By default, a Resource gets unloaded as soon as the last Reference to it goes out of scope;
+	///		for any asset attached to a residency cache, the cache takes over the last reference instead,
+	///		so that the next Asset::LoadResource() call simply gets the same resource back (a 'hit');
+	/// <para /> Once the estimated size of the retained resources exceeds the budget, resources are evicted
+	///		in the order of ascending priority and, within the same priority, least recently released first;
+	/// <para /> Notes:
+	///		<para /> 0. Assets get attached through Attach(), Prefetch(), Pin() or automatically,
+	///			by any AssetDatabase with the cache set via AssetDatabase::SetResidencyCache() when they are returned by FindAsset();
+	///		<para /> 1. Resources that are still in use are never counted towards the budget, unless pinned;
+	///		<para /> 2. Sizes are estimates, provided by SetSizeEstimate() per resource type (DefaultSizeEstimate() is used for the rest).
+	/// </summary>
+	class JIMARA_API ResourceResidencyCache : public virtual Object {
+	public:
+		/// <summary>
+		/// Constructor
+		/// </summary>
+		/// <param name="memoryBudget"> Maximal total estimated size of the retained (released and unpinned) resources in bytes </param>
+		ResourceResidencyCache(size_t memoryBudget);
+
+		/// <summary> Virtual destructor (detaches from all assets and releases retained resources) </summary>
+		virtual ~ResourceResidencyCache();
+
+		/// <summary> Maximal total estimated size of the retained resources in bytes </summary>
+		size_t MemoryBudget()const;
+
+		/// <summary>
+		/// Sets memory budget (evicts retained resources, if they no longer fit)
+		/// </summary>
+		/// <param name="memoryBudget"> Maximal total estimated size of the retained resources in bytes </param>
+		void SetMemoryBudget(size_t memoryBudget);
+
+		/// <summary> Size estimate function (receives a resource and returns estimated memory usage in bytes) </summary>
+		typedef Function<size_t, const Resource*> SizeEstimateFn;
+
+		/// <summary>
+		/// Sets size estimate function for given resource type
+		/// <para /> Note: If several estimates match the resource, the one set last takes precedence.
+		/// </summary>
+		/// <param name="resourceType"> Resource type (applies to derived types as well) </param>
+		/// <param name="estimate"> Size estimate function </param>
+		void SetSizeEstimate(const TypeId& resourceType, const SizeEstimateFn& estimate);
+
+		/// <summary> Size estimate for the resources without a type-specific estimate function </summary>
+		size_t DefaultSizeEstimate()const;
+
+		/// <summary>
+		/// Sets size estimate for the resources without a type-specific estimate function
+		/// </summary>
+		/// <param name="bytes"> Size estimate in bytes </param>
+		void SetDefaultSizeEstimate(size_t bytes);
+
+		/// <summary>
+		/// Attaches asset to the cache (from now on, it's resource will be retained when released)
+		/// <para /> Note: An asset can be attached to a single cache at a time; last one wins.
+		/// </summary>
+		/// <param name="asset"> Asset to attach </param>
+		void Attach(Asset* asset);
+
+		/// <summary>
+		/// Sets eviction priority of an asset (resources with lower priority get evicted first; default is 0)
+		/// <para /> Note: Attaches asset to the cache if it is not already attached.
+		/// </summary>
+		/// <param name="asset"> Asset </param>
+		/// <param name="priority"> Eviction priority </param>
+		void SetPriority(Asset* asset, int priority);
+
+		/// <summary>
+		/// Attaches the asset, sets the priority and loads the resource, so that it ends up retained by the cache
+		/// <para /> Useful for warming up the cache during level loading.
+		/// </summary>
+		/// <param name="asset"> Asset to prefetch </param>
+		/// <param name="priority"> Eviction priority </param>
+		/// <param name="reportProgress"> Load progress callback </param>
+		/// <returns> True, if the resource got loaded successfully </returns>
+		bool Prefetch(Asset* asset, int priority = 0, const Callback<Asset::LoadInfo>& reportProgress = Callback(Unused<Asset::LoadInfo>));
+
+		/// <summary>
+		/// Loads the resource and keeps it loaded (regardless of the budget) till the matching Unpin() call
+		/// <para /> Note: Pin() calls are counted; resource stays pinned till the number of Unpin() calls matches.
+		/// </summary>
+		/// <param name="asset"> Asset to pin </param>
+		/// <param name="reportProgress"> Load progress callback </param>
+		/// <returns> Pinned resource (nullptr, if failed to load) </returns>
+		Reference<Resource> Pin(Asset* asset, const Callback<Asset::LoadInfo>& reportProgress = Callback(Unused<Asset::LoadInfo>));
+
+		/// <summary>
+		/// Undoes a Pin() call (once unpinned and released, resource becomes an ordinary retained one)
+		/// </summary>
+		/// <param name="asset"> Asset to unpin </param>
+		void Unpin(Asset* asset);
+
+		/// <summary> Evicts all retained resources (pinned ones stay loaded) </summary>
+		void Clear();
+
+		/// <summary> Cache statistics </summary>
+		struct JIMARA_API Statistics {
+			/// <summary> Number of Asset::LoadResource() calls, that got their resource from the cache </summary>
+			size_t hits = 0u;
+
+			/// <summary> Number of Asset::LoadResource() calls for the attached assets, that had to actually load the resource </summary>
+			size_t misses = 0u;
+
+			/// <summary> Number of retained resources, evicted because of the budget (or Clear() calls) </summary>
+			size_t evictions = 0u;
+
+			/// <summary> Number of currently retained (released and unpinned) resources </summary>
+			size_t residentCount = 0u;
+
+			/// <summary> Total estimated size of the retained resources </summary>
+			size_t residentBytes = 0u;
+
+			/// <summary> Number of pinned resources </summary>
+			size_t pinnedCount = 0u;
+
+			/// <summary> Total estimated size of the pinned resources (not counted towards the budget) </summary>
+			size_t pinnedBytes = 0u;
+		};
+
+		/// <summary> Current statistics </summary>
+		Statistics Stats()const;
+
+	private:
+		// Lock for everything below
+		mutable std::mutex m_lock;
+
+		// Budget
+		size_t m_memoryBudget;
+
+		// Size estimates
+		size_t m_defaultSizeEstimate = 0u;
+		std::vector<std::pair<TypeId, SizeEstimateFn>> m_sizeEstimates;
+
+		// Per-asset state
+		struct AssetInfo {
+			Reference<Asset> asset;
+			int priority = 0;
+			uint64_t lastRelease = 0u;
+			Reference<Resource> retained;
+			size_t retainedSize = 0u;
+			size_t pinCount = 0u;
+			Reference<Resource> pinned;
+			size_t pinnedSize = 0u;
+		};
+		std::unordered_map<Asset*, AssetInfo> m_assets;
+
+		// Retained assets in eviction order (priority, lastRelease, asset)
+		std::set<std::tuple<int, uint64_t, Asset*>> m_evictionOrder;
+		uint64_t m_releaseCounter = 0u;
+
+		// Statistics
+		Statistics m_stats;
+
+		// Asset resource locks have to be acquired within this scope;
+		// Evicted resources are unloaded under their asset's resource lock, so that Asset::LoadResource() can not resurrect them mid-way;
+		// To avoid lock-order inversions with dependent asset loads, that does not happen till the thread leaves the outermost scope.
+		class JIMARA_API ResourceLockScope {
+		public:
+			ResourceLockScope();
+			~ResourceLockScope();
+		};
+
+		// Invoked by Resource::OnOutOfScope() under the asset's resource lock (returns true if the resource got retained)
+		bool RetainReleasedResource(Asset* asset, Resource* resource);
+
+		// Invoked by Asset::LoadResource() under the asset's resource lock (loaded tells if the resource had to be loaded)
+		void OnLoadRequested(Asset* asset, bool loaded);
+
+		// Asset and Resource invoke the hooks above
+		friend class Asset;
+		friend class Resource;
+
+		// Actual implementation resides in here
+		struct Helpers;
+	};
+}
@@ -0,0 +1,74 @@
+#include "ComponentHierarchyInstancePool.h"
+
+
+namespace Jimara {
+	namespace {
+		// Parentless holder: it is not a part of the RootObject() hierarchy, so the pooled instances are neither serialized with the scene, nor shown by the editor
+		// (SceneContext still destroys it during cleanup, just like any other parentless component)
+		class ComponentHierarchyInstancePool_Holder : public virtual Component {
+		public:
+			inline ComponentHierarchyInstancePool_Holder(SceneContext* context) : Component(context, "ComponentHierarchyInstancePool") {}
+		};
+	}
+
+	Reference<ComponentHierarchyInstancePool> ComponentHierarchyInstancePool::Create(
+		ComponentHierarchySpowner* spowner, Scene::LogicContext* context, size_t prewarmCount) {
+		if (context == nullptr) return nullptr;
+		else if (spowner == nullptr) {
+			context->Log()->Error("ComponentHierarchyInstancePool::Create - Spowner not provided!");
+			return nullptr;
+		}
+		Reference<Component> holder;
+		{
+			std::unique_lock<std::recursive_mutex> lock(context->UpdateLock());
+			holder = Object::Instantiate<ComponentHierarchyInstancePool_Holder>(context);
+			holder->SetEnabled(false);
+		}
+		const Reference<ComponentHierarchyInstancePool> pool = new ComponentHierarchyInstancePool(spowner, holder);
+		pool->ReleaseRef();
+		pool->Prewarm(prewarmCount);
+		return pool;
+	}
+
+	ComponentHierarchyInstancePool::ComponentHierarchyInstancePool(ComponentHierarchySpowner* spowner, Component* holder)
+		: m_spowner(spowner), m_holder(holder) {}
+
+	ComponentHierarchyInstancePool::~ComponentHierarchyInstancePool() {
+		std::unique_lock<std::recursive_mutex> lock(m_holder->Context()->UpdateLock());
+		if (!m_holder->Destroyed())
+			m_holder->Destroy();
+	}
+
+	size_t ComponentHierarchyInstancePool::ReadyCount()const {
+		std::unique_lock<std::recursive_mutex> lock(m_holder->Context()->UpdateLock());
+		return m_holder->Destroyed() ? 0u : m_holder->ChildCount();
+	}
+
+	size_t ComponentHierarchyInstancePool::Prewarm(size_t count) {
+		std::unique_lock<std::recursive_mutex> lock(m_holder->Context()->UpdateLock());
+		if (m_holder->Destroyed()) return 0u;
+		while (m_holder->ChildCount() < count) {
+			const Reference<Component> instance = m_spowner->SpownHierarchy(m_holder);
+			if (instance == nullptr) {
+				m_holder->Context()->Log()->Error("ComponentHierarchyInstancePool::Prewarm - Spowner failed to create an instance!");
+				break;
+			}
+			else if (instance->Parent() != m_holder)
+				instance->SetParent(m_holder);
+		}
+		return m_holder->ChildCount();
+	}
+
+	Reference<Component> ComponentHierarchyInstancePool::Spown(Component* parent) {
+		if (parent == nullptr || parent->Destroyed()) return nullptr;
+		std::unique_lock<std::recursive_mutex> lock(parent->Context()->UpdateLock());
+		if (parent->Context() == m_holder->Context() && (!m_holder->Destroyed())) {
+			if (m_holder->ChildCount() > 0u) {
+				const Reference<Component> instance = m_holder->GetChild(m_holder->ChildCount() - 1u);
+				instance->SetParent(parent);
+				return instance;
+			}
+		}
+		return m_spowner->SpownHierarchy(parent);
+	}
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include "ComponentHierarchySpowner.h"
+
+
+namespace Jimara {
+	/// <summary>
+	/// Pool of pre-spowned component subtrees, that can be handed out without doing the spowning work on the spot
+	/// <para/> Instances are kept under a disabled parentless holder component (outside the context's RootObject hierarchy),
+	///		so they do not receive any updates and do not get serialized with the scene until they get attached to the real parent by Spown();
+	/// <para/> Typical usage is to Prewarm() the pool during level loading and Spown() from the update thread afterwards;
+	///		once the pool runs dry, Spown() simply falls back to ComponentHierarchySpowner::SpownHierarchy().
+	/// </summary>
+	class JIMARA_API ComponentHierarchyInstancePool : public virtual Object {
+	public:
+		/// <summary>
+		/// Creates a pool
+		/// </summary>
+		/// <param name="spowner"> Spowner, the pooled instances are created with </param>
+		/// <param name="context"> Scene context, the instances will live in </param>
+		/// <param name="prewarmCount"> Number of instances to spown right away </param>
+		/// <returns> New pool (nullptr if spowner or context is nullptr) </returns>
+		static Reference<ComponentHierarchyInstancePool> Create(ComponentHierarchySpowner* spowner, Scene::LogicContext* context, size_t prewarmCount = 0u);
+
+		/// <summary> Virtual destructor (destroys instances that were never handed out) </summary>
+		virtual ~ComponentHierarchyInstancePool();
+
+		/// <summary> Spowner, the pooled instances are created with </summary>
+		inline ComponentHierarchySpowner* Spowner()const { return m_spowner; }
+
+		/// <summary> Number of instances, ready to be handed out </summary>
+		size_t ReadyCount()const;
+
+		/// <summary>
+		/// Spowns instances till the pool contains at least count of them
+		/// <para/> Note: Locks the context update lock for the duration of the call.
+		/// </summary>
+		/// <param name="count"> Desired number of ready instances </param>
+		/// <returns> Number of ready instances after the call (can be less than count if the spowner fails) </returns>
+		size_t Prewarm(size_t count);
+
+		/// <summary>
+		/// Takes an instance from the pool and attaches it to the parent
+		/// (or spowns a new one through the spowner if the pool is empty or parent resides in a different context)
+		/// <para/> Note: Locks the context update lock for the duration of the call.
+		/// </summary>
+		/// <param name="parent"> Parent component for the subtree </param>
+		/// <returns> "Root-level" component of the subtree (or nullptr if failed) </returns>
+		Reference<Component> Spown(Component* parent);
+
+	private:
+		// Spowner
+		const Reference<ComponentHierarchySpowner> m_spowner;
+
+		// Disabled component, the pooled instances are parented to
+		const Reference<Component> m_holder;
+
+		// Constructor
+		ComponentHierarchyInstancePool(ComponentHierarchySpowner* spowner, Component* holder);
+	};
+}
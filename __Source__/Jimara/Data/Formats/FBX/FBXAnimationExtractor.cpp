@@ -1,5 +1,6 @@
 #include "FBXAnimationExtractor.h"
 #include "../../../Components/Transform.h"
+#include "../../../Core/Systems/ParallelFor.h"
 #include <math.h> 
 
 
@@ -188,13 +189,32 @@ namespace Jimara {
 			, Function<TransformInfo, FBXUid> getNodeById
 			, Function<const FBXNode*, const FBXNode*> getNodeParent
 			, Callback<FBXAnimation*> onAnimationFound) {
+			std::vector<const FBXObjectIndex::NodeWithConnections*> layers;
 			for (size_t nodeId = 0; nodeId < objectIndex.ObjectCount(); nodeId++) {
 				const FBXObjectIndex::NodeWithConnections& node = objectIndex.ObjectNode(nodeId);
-				if (!IsAnimationLayer(node)) continue;
-				Reference<FBXAnimation> animation = ExtractLayer(node, logger, rootScale, rootAxisWrangle, getNodeById, getNodeParent);
-				if (animation == nullptr) return false;
-				else onAnimationFound(animation);
+				if (IsAnimationLayer(node)) layers.push_back(&node);
 			}
+
+			// Layers do not depend on each other, so we extract them in parallel (this extractor serves the first thread and the rest get their own buffers):
+			std::vector<Reference<FBXAnimation>> animations(layers.size());
+			const size_t threadCount = ParallelHelpers::ThreadCount(layers.size(), 1u, std::thread::hardware_concurrency());
+			std::vector<FBXAnimationExtractor> extractors(threadCount - 1u);
+			std::atomic<size_t> nextLayer = 0u;
+			std::atomic<bool> failed = false;
+			ThreadBlock threadBlock;
+			ParallelHelpers::Execute(threadBlock, threadCount, [&](ThreadBlock::ThreadInfo info) {
+				FBXAnimationExtractor& extractor = (info.threadId <= 0u) ? (*this) : extractors[info.threadId - 1u];
+				while (!failed.load()) {
+					const size_t layerId = nextLayer.fetch_add(1u);
+					if (layerId >= layers.size()) break;
+					animations[layerId] = extractor.ExtractLayer(*layers[layerId], logger, rootScale, rootAxisWrangle, getNodeById, getNodeParent);
+					if (animations[layerId] == nullptr) failed = true;
+				}
+				});
+			if (failed.load()) return false;
+
+			for (size_t i = 0; i < animations.size(); i++)
+				onAnimationFound(animations[i]);
 			return true;
 		}
 
@@ -1,5 +1,6 @@
 #include "FBXAssetImporter.h"
 #include "FBXData.h"
+#include "FBXCookedData.h"
 #include "../../Serialization/Helpers/SerializerMacros.h"
 #include "../../ComponentHierarchySpowner.h"
 #include "../../../Components/GraphicsObjects/MeshRenderer.h"
@@ -29,6 +30,12 @@ namespace std {
 namespace Jimara {
 	namespace FBXHelpers {
 		namespace {
+			// Loads FBXData through the cooked data cache (source gets parsed only if the cooked file is missing or stale)
+			inline static Reference<FBXData> LoadFBXData(const FileSystemDatabase::AssetImporter* importer) {
+				static const OS::Path cookedExtension = ".jfbx";
+				return FBXCookedData::Load(importer->AssetFilePath(), importer->CookedDataPath(cookedExtension), importer->Log());
+			}
+
 			struct FBXDataCache : public virtual ObjectCache<PathAndRevision>::StoredObject {
 				std::vector<FBXMesh> meshes;
 				std::vector<FBXSkinnedMesh> skinnedMeshes;
@@ -38,10 +45,10 @@ namespace Jimara {
 				class Cache : public virtual ObjectCache<PathAndRevision> {
 				public:
 					inline static Reference<FBXDataCache> For(
-						const PathAndRevision& pathAndRevision, OS::Logger* logger, const Callback<FBXData*>& onLoaded) {
+						const FileSystemDatabase::AssetImporter* importer, size_t revision, const Callback<FBXData*>& onLoaded) {
 						static Cache cache;
-						return cache.GetCachedOrCreate(pathAndRevision, [&]() -> Reference<FBXDataCache> {
-							Reference<FBXData> data = FBXData::Extract(pathAndRevision.path, logger);
+						return cache.GetCachedOrCreate(PathAndRevision{ importer->AssetFilePath(), revision }, [&]() -> Reference<FBXDataCache> {
+							Reference<FBXData> data = LoadFBXData(importer);
 							onLoaded(data);
 							if (data == nullptr) 
 								return nullptr;
@@ -93,14 +100,15 @@ namespace Jimara {
 			protected:
 				virtual Reference<ResourceReferenceType>* ResourceReference(FBXObject* object)const = 0;
 
+				inline virtual void OnResourceLoaded(ResourceReferenceType*)const {}
+
 				virtual Reference<Type> LoadItem() final override {
 					auto failed = [&]() {
 						m_targetObject = nullptr;
 						m_dataCache = nullptr;
 						return nullptr;
 					};
-					m_dataCache = FBXDataCache::Cache::For(
-						PathAndRevision{ m_importer->AssetFilePath(), m_revision }, m_importer->Log(), Callback<FBXData*>(Unused<FBXData*>));
+					m_dataCache = FBXDataCache::Cache::For(m_importer, m_revision, Callback<FBXData*>(Unused<FBXData*>));
 					if (m_dataCache == nullptr) return failed();
 					else {
 						typedef typename decltype(m_dataCache->uidToObject)::const_iterator FBXIdIterator;
@@ -123,7 +131,8 @@ namespace Jimara {
 					Reference<ResourceReferenceType> result;
 					std::swap(*resourceReference, result);
 					if (result == nullptr) return failed();
-					else return result;
+					OnResourceLoaded(result);
+					return result;
 				}
 
 				inline virtual void UnloadItem(Type* resource) final override {
@@ -219,9 +228,21 @@ namespace Jimara {
 #pragma warning(default: 4250)
 
 			class FBXAnimationAsset : public virtual FBXAsset<AnimationClip> {
+			private:
+				const BakedAnimationClip::CompressionSettings m_compression;
+
 			public:
-				inline FBXAnimationAsset(const GUID& guid, FileSystemDatabase::AssetImporter* importer, size_t revision, FBXUid fbxId)
-					: Asset(guid), FBXAsset<AnimationClip>(importer, revision, fbxId) {}
+				inline FBXAnimationAsset(const GUID& guid, FileSystemDatabase::AssetImporter* importer, size_t revision, FBXUid fbxId,
+					const BakedAnimationClip::CompressionSettings& compression)
+					: Asset(guid), FBXAsset<AnimationClip>(importer, revision, fbxId), m_compression(compression) {}
+
+			protected:
+				inline virtual void OnResourceLoaded(AnimationClip* clip)const final override {
+					// SetCompression() does not dirty a freshly loaded clip, so the data only gets baked once:
+					clip->SetCompression(m_compression);
+					// Bake on load, so that the Animator does not have to do it on the first Bind():
+					clip->Baked();
+				}
 			protected:
 				inline virtual Reference<AnimationClip>* ResourceReference(FBXObject* object)const final override {
 					FBXAnimation* fbxAnimation = dynamic_cast<FBXAnimation*>(object);
@@ -406,10 +427,9 @@ namespace Jimara {
 							data = d;
 							dataLoadAttempted = true;
 						};
-						dataCache = FBXDataCache::Cache::For(
-							PathAndRevision{ m_importer->AssetFilePath(), m_revision }, m_importer->Log(), Callback<FBXData*>::FromCall(&onLoaded));
+						dataCache = FBXDataCache::Cache::For(m_importer, m_revision, Callback<FBXData*>::FromCall(&onLoaded));
 						if (!dataLoadAttempted) 
-							data = FBXData::Extract(m_importer->AssetFilePath(), m_importer->Log());
+							data = LoadFBXData(m_importer);
 						if (data == nullptr) {
 							m_importer->Log()->Error("FBXHierarchyAsset::LoadItem - Failed to load FBX file '(", m_importer->AssetFilePath(), ")'!");
 							return nullptr;
@@ -443,7 +463,7 @@ namespace Jimara {
 					static const std::string alreadyLoadedState = "Imported";
 					const size_t revision = m_revision.fetch_add(1);
 					if (PreviousImportData() != alreadyLoadedState) {
-						Reference<FBXData> data = FBXData::Extract(AssetFilePath(), Log());
+						Reference<FBXData> data = LoadFBXData(this);
 						if (data == nullptr)
 							return false;
 						else PreviousImportData() = alreadyLoadedState;
@@ -591,7 +611,7 @@ namespace Jimara {
 					// Report Animation assets:
 					for (auto it = m_animationGUIDs.begin(); it != m_animationGUIDs.end(); ++it) {
 						const Reference<FBXAnimationAsset> animationAsset =
-							Object::Instantiate<FBXAnimationAsset>(it->second.guid, this, revision, it->second.fbxUid);
+							Object::Instantiate<FBXAnimationAsset>(it->second.guid, this, revision, it->second.fbxUid, m_animationCompression);
 						{
 							AssetInfo info;
 							info.asset = animationAsset;
@@ -635,6 +655,7 @@ namespace Jimara {
 				FBXUidToGUID m_triMeshGUIDs;
 				FBXUidToGUID m_collisionMeshGUIDs;
 				FBXUidToAnimationInfo m_animationGUIDs;
+				BakedAnimationClip::CompressionSettings m_animationCompression;
 
 				friend class FBXImporterSerializer;
 
@@ -780,6 +801,16 @@ namespace Jimara {
 							Object::Instantiate<FBXImporter::FBXUidToAnimationInfoSerializer>("Animations");
 						recordElement(animationGUIDSerializer->Serialize(importer->m_animationGUIDs));
 					}
+					{
+						static const auto serializer = Serialization::DefaultSerializer<float>::Create(
+							"Animation Value Error", "Maximal error for compressed position/scale/generic animation tracks (0 means no compression)");
+						recordElement(serializer->Serialize(importer->m_animationCompression.valueError));
+					}
+					{
+						static const auto serializer = Serialization::DefaultSerializer<float>::Create(
+							"Animation Angle Error", "Maximal error for compressed rotation animation tracks in degrees (0 means no compression)");
+						recordElement(serializer->Serialize(importer->m_animationCompression.angleError));
+					}
 				}
 
 				inline static FBXImporterSerializer* Instance() {
@@ -1,7 +1,12 @@
 #include "FBXContent.h"
 #include "../../../OS/IO/MMappedFile.h"
+#include "../../../Core/Collections/ThreadPool.h"
+#include <condition_variable>
+#include <algorithm>
 #include <cstring>
 #include <vector>
+#include <memory>
+#include <deque>
 #include <zlib.h>
 
 namespace Jimara {
@@ -343,8 +348,253 @@ namespace Jimara {
 		static const uint8_t PropertyTypeCode_RAW_BINARY = static_cast<uint8_t>('R');
 
 		static const Endian FBX_BINARY_ENDIAN = Endian::LITTLE;
+
+		// Converts little-endian array elements to native representation in-place (booleans get normalized to 0/1 as well):
+		inline static void ArrayDataToNative(FBXContent::PropertyType type, uint8_t* data, size_t count, size_t unitSize) {
+			if (type == FBXContent::PropertyType::BOOLEAN_ARR) {
+				for (size_t i = 0; i < count; i++)
+					data[i] = (data[i] != 0) ? 1 : 0;
+			}
+			else if (NativeEndian() != FBX_BINARY_ENDIAN)
+				for (size_t i = 0; i < count; i++)
+					std::reverse(data + (i * unitSize), data + ((i + 1) * unitSize));
+		}
 	}
 
+	/// <summary>
+	/// Queue of zlib-compressed array properties, waiting to be inflated
+	/// <para/> Parser only reserves space for the array values inside the content buffers and records the job;
+	///		Jobs for large arrays start getting processed on worker threads right away (into their own scratch buffers, since content buffers may still reallocate),
+	///		while the rest are inflated directly into the content buffers in parallel once the node tree is complete.
+	/// <para/> Worker threads come from a single lazily created pool, shared by all concurrent decoders.
+	/// </summary>
+	struct FBXContent::DeferredArrayInflation {
+		// Arrays, at least this large (uncompressed), trigger worker threads as soon as they are encountered
+		static const size_t ASYNC_INFLATION_MIN_SIZE = (1u << 16u);
+
+		// Upper limit on the shared worker thread count
+		static const size_t MAX_WORKER_THREADS = 8u;
+
+		// Number of the shared worker threads (0 on single-core systems; everything is inflated by Finish() there)
+		inline static size_t WorkerThreadCount() {
+			static const size_t threadCount = std::min(static_cast<size_t>(std::max(std::thread::hardware_concurrency(), 1u)) - 1u, MAX_WORKER_THREADS);
+			return threadCount;
+		}
+
+		// Shared worker pool (created on first use; intentionally never destroyed, since the threads are idle outside decoding 
+		// and joining them during static destruction is not safe on all platforms)
+		inline static ThreadPool* SharedWorkers() {
+			static ThreadPool* const pool = (WorkerThreadCount() > 0u) ? new ThreadPool(WorkerThreadCount()) : nullptr;
+			return pool;
+		}
+
+		// Shared pool may start the worker tasks after the decoding is over, so they only reach the queue through a ticket, invalidated by the destructor
+		struct WorkerTicket : public virtual Object {
+			std::mutex lock;
+			DeferredArrayInflation* queue = nullptr;
+		};
+
+		// Compressed array
+		struct Job {
+			enum class Result : uint8_t { PENDING, INFLATED, TOO_LARGE, ZLIB_ERROR, SIZE_MISMATCH };
+
+			char key = '\0';
+			PropertyType type = PropertyType::PROPERTY_TYPE_COUNT;
+			const uint8_t* compressedData = nullptr;
+			size_t compressedSize = 0u;
+			size_t valueOffset = 0u;
+			size_t valueCount = 0u;
+			size_t unitSize = 0u;
+
+			// Location inside the content buffers (set once the buffers stop reallocating; jobs claimed before that are inflated into the scratch buffer)
+			uint8_t* destination = nullptr;
+			std::vector<uint8_t> scratch;
+			Result result = Result::PENDING;
+		};
+
+		// Target content
+		FBXContent* const content;
+
+		// Lock for the queue state
+		std::mutex lock;
+
+		// Notified when the last active job finishes or a worker task exits
+		std::condition_variable jobFinished;
+
+		// Recorded jobs (deque does not invalidate element references on push_back)
+		std::deque<Job> jobs;
+
+		// Index of the first unclaimed job
+		size_t nextJob = 0u;
+
+		// Number of jobs, claimed, but not yet finished
+		size_t activeJobs = 0u;
+
+		// Number of worker tasks, scheduled or running
+		size_t runningWorkers = 0u;
+
+		// Set if the decoding failed and the pending jobs should be ignored
+		bool abandoned = false;
+
+		// Number of worker tasks, currently running Drain()
+		size_t activeWorkers = 0u;
+
+		// Ticket for the worker tasks
+		const Reference<WorkerTicket> ticket = Object::Instantiate<WorkerTicket>();
+
+		inline DeferredArrayInflation(FBXContent* target) : content(target) {
+			ticket->queue = this;
+		}
+
+		inline ~DeferredArrayInflation() {
+			{
+				std::unique_lock<std::mutex> ticketGuard(ticket->lock);
+				ticket->queue = nullptr;
+			}
+			std::unique_lock<std::mutex> guard(lock);
+			abandoned = true;
+			while (activeWorkers > 0u)
+				jobFinished.wait(guard);
+		}
+
+		// Location of the job's values inside the content buffers
+		inline uint8_t* Destination(const Job& job)const {
+			switch (job.type) {
+			case PropertyType::BOOLEAN_ARR: return content->m_rawBuffer.data() + job.valueOffset;
+			case PropertyType::INT_32_ARR: return reinterpret_cast<uint8_t*>(content->m_int32Buffer.data() + job.valueOffset);
+			case PropertyType::INT_64_ARR: return reinterpret_cast<uint8_t*>(content->m_int64Buffer.data() + job.valueOffset);
+			case PropertyType::FLOAT_32_ARR: return reinterpret_cast<uint8_t*>(content->m_float32Buffer.data() + job.valueOffset);
+			case PropertyType::FLOAT_64_ARR: return reinterpret_cast<uint8_t*>(content->m_float64Buffer.data() + job.valueOffset);
+			default: return nullptr;
+			}
+		}
+
+		// Schedules up to count worker tasks (lock has to be held by the caller; a single decoder never schedules more tasks than there are shared threads)
+		inline void ScheduleWorkers(size_t count) {
+			ThreadPool* const workers = SharedWorkers();
+			if (workers == nullptr) return;
+			while (count > 0u && runningWorkers < WorkerThreadCount()) {
+				runningWorkers++;
+				count--;
+				workers->Schedule(Callback<Object*>(&DeferredArrayInflation::Drain), ticket);
+			}
+		}
+
+		// Records a compressed array (space for the values should already be reserved inside the content buffers)
+		inline void Enqueue(char key, PropertyType type, size_t valueOffset, size_t valueCount, size_t unitSize, const uint8_t* compressedData, size_t compressedSize) {
+			if (valueCount <= 0u) return;
+			std::unique_lock<std::mutex> guard(lock);
+			Job& job = jobs.emplace_back();
+			job.key = key;
+			job.type = type;
+			job.compressedData = compressedData;
+			job.compressedSize = compressedSize;
+			job.valueOffset = valueOffset;
+			job.valueCount = valueCount;
+			job.unitSize = unitSize;
+			if ((job.valueCount * unitSize) >= ASYNC_INFLATION_MIN_SIZE)
+				ScheduleWorkers(1u);
+		}
+
+		// Claims and inflates the next job (returns false if there's nothing left to claim)
+		inline bool InflateNext(bool isWorker) {
+			Job* job;
+			uint8_t* target;
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				if (abandoned || nextJob >= jobs.size()) {
+					if (isWorker) runningWorkers--;
+					return false;
+				}
+				job = &jobs[nextJob];
+				nextJob++;
+				activeJobs++;
+				target = job->destination;
+			}
+			
+			const size_t uncompressedSize = job->valueCount * job->unitSize;
+			if (target == nullptr) {
+				job->scratch.resize(uncompressedSize);
+				target = job->scratch.data();
+			}
+			
+			job->result = [&]() {
+				uLongf uncompressedLength = static_cast<uLongf>(uncompressedSize);
+				if (uncompressedLength != uncompressedSize)
+					return Job::Result::TOO_LARGE;
+				if (uncompress(target, &uncompressedLength, job->compressedData, static_cast<uLong>(job->compressedSize)) != Z_OK)
+					return Job::Result::ZLIB_ERROR;
+				if (uncompressedLength != uncompressedSize)
+					return Job::Result::SIZE_MISMATCH;
+				ArrayDataToNative(job->type, target, job->valueCount, job->unitSize);
+				return Job::Result::INFLATED;
+			}();
+			
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				activeJobs--;
+				if (activeJobs <= 0u)
+					jobFinished.notify_all();
+			}
+			return true;
+		}
+
+		// Worker task
+		inline static void Drain(Object* ticketPtr) {
+			WorkerTicket* const ticket = dynamic_cast<WorkerTicket*>(ticketPtr);
+			DeferredArrayInflation* self;
+			{
+				std::unique_lock<std::mutex> ticketGuard(ticket->lock);
+				self = ticket->queue;
+				if (self == nullptr) return;
+				std::unique_lock<std::mutex> guard(self->lock);
+				self->activeWorkers++;
+			}
+			while (self->InflateNext(true)) {}
+			std::unique_lock<std::mutex> guard(self->lock);
+			self->activeWorkers--;
+			self->jobFinished.notify_all();
+		}
+
+		// Inflates all remaining jobs and waits for the active ones (invoked once the node tree is fully parsed and the content buffers are final)
+		inline bool Finish(OS::Logger* logger) {
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				size_t pendingSize = 0u;
+				for (size_t i = nextJob; i < jobs.size(); i++) {
+					Job& job = jobs[i];
+					job.destination = Destination(job);
+					pendingSize += job.valueCount * job.unitSize;
+				}
+				const size_t pendingJobs = (jobs.size() - nextJob);
+				if (pendingJobs > 1u && pendingSize >= ASYNC_INFLATION_MIN_SIZE)
+					ScheduleWorkers(pendingJobs - 1u);
+			}
+			while (InflateNext(false)) {}
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				while (activeJobs > 0u)
+					jobFinished.wait(guard);
+			}
+			
+			auto error = [&](const Job& job, const char* message) {
+				if (logger != nullptr) 
+					logger->Error("FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", job.key, "']: ", message);
+				return false;
+			};
+			for (size_t i = 0; i < jobs.size(); i++) {
+				const Job& job = jobs[i];
+				if (job.result == Job::Result::TOO_LARGE) return error(job, "Data too large to decompress!");
+				else if (job.result == Job::Result::ZLIB_ERROR) return error(job, "Zlib failed to decompress data!");
+				else if (job.result == Job::Result::SIZE_MISMATCH) return error(job, "Uncompressed data size mismatch!");
+				else if (job.result != Job::Result::INFLATED) return error(job, "Internal error: array was not inflated!");
+				else if (job.destination == nullptr)
+					std::memcpy(Destination(job), job.scratch.data(), job.scratch.size());
+			}
+			return true;
+		}
+	};
+
 	Reference<FBXContent> FBXContent::Decode(const MemoryBlock block, OS::Logger* logger) {
 		static auto logError = [](OS::Logger* logger, auto... msg) -> bool {
 			if (logger != nullptr) logger->Error(msg...);
@@ -356,6 +606,7 @@ namespace Jimara {
 		auto warning = [&](auto... msg) { if (logger != nullptr) logger->Warning(msg...); };
 
 		const Reference<FBXContent> content = Object::Instantiate<FBXContent>();
+		DeferredArrayInflation inflation(content);
 
 		auto parseBinary = [&]() -> bool {
 			// Header is already parsed if we reached this point:
@@ -403,13 +654,13 @@ namespace Jimara {
 				const char typeCode = block.Get<char>(ptr, FBX_BINARY_ENDIAN);
 
 				// Parse functions:
-				typedef bool(*ParsePropertyValueFn)(char, Property&, FBXContent*, const MemoryBlock&, size_t&, OS::Logger*);
+				typedef bool(*ParsePropertyValueFn)(char, Property&, FBXContent*, const MemoryBlock&, size_t&, OS::Logger*, DeferredArrayInflation*);
 				static const ParsePropertyValueFn* const PARSE_FUNCTIONS = []() -> const ParsePropertyValueFn* {
 					static const size_t MAX_CHAR = sizeof(char) << 8;
 					static ParsePropertyValueFn functions[MAX_CHAR];
 
 					// Unknown type code:
-					const ParsePropertyValueFn unknownTypeCode = [](char key, Property&, FBXContent*, const MemoryBlock&, size_t&, OS::Logger* logger) -> bool {
+					const ParsePropertyValueFn unknownTypeCode = [](char key, Property&, FBXContent*, const MemoryBlock&, size_t&, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey not recognized <", static_cast<uint32_t>(key), "/'", key, "'>!");
 					};
 					for (size_t i = 0; i < MAX_CHAR; i++) functions[i] = unknownTypeCode;
@@ -427,136 +678,103 @@ namespace Jimara {
 							return true;
 					};
 
-					// Multi value read:
-					static const auto readArray = [](char key, Property& prop, const MemoryBlock& block, size_t& ptr, OS::Logger* logger,
-						size_t unitSize, PropertyType propertyType, size_t valueOffset, auto pushFn) -> bool {
+					// Multi value read (compressed arrays only get their space reserved here and are inflated later; see DeferredArrayInflation):
+					static const auto readArray = [](char key, Property& prop, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation,
+						size_t unitSize, PropertyType propertyType, auto& buffer) -> bool {
 							if ((ptr + (sizeof(uint32_t) * 3)) > block.Size())
 								return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on array header!");
 							prop.m_type = propertyType;
-							prop.m_valueOffset = valueOffset;
+							prop.m_valueOffset = buffer.size();
 							prop.m_valueCount = static_cast<size_t>(block.Get<uint32_t>(ptr, FBX_BINARY_ENDIAN));
 							const size_t encoding = static_cast<size_t>(block.Get<uint32_t>(ptr, FBX_BINARY_ENDIAN));
 							const size_t compressedLength = static_cast<size_t>(block.Get<uint32_t>(ptr, FBX_BINARY_ENDIAN));
-							MemoryBlock dataBlock(nullptr, 0, nullptr);
+							const uint8_t* const data = static_cast<const uint8_t*>(block.Data()) + ptr;
 							if (encoding == 0) {
 								const size_t arrayByteCount = unitSize * prop.m_valueCount;
 								if ((ptr + arrayByteCount) > block.Size())
 									return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on array data!");
-								dataBlock = MemoryBlock(static_cast<const char*>(block.Data()) + ptr, arrayByteCount, nullptr);
+								buffer.resize(prop.m_valueOffset + prop.m_valueCount);
+								if (arrayByteCount > 0u) {
+									uint8_t* const values = reinterpret_cast<uint8_t*>(buffer.data() + prop.m_valueOffset);
+									std::memcpy(values, data, arrayByteCount);
+									ArrayDataToNative(propertyType, values, prop.m_valueCount, unitSize);
+								}
 								ptr += arrayByteCount;
 							}
 							else if (encoding == 1) {
-								static thread_local std::vector<uint8_t> compressedBuffer;
-								if (compressedBuffer.size() < compressedLength)
-									compressedBuffer.resize(compressedLength);
-								
-								static thread_local std::vector<uint8_t> uncompressedBuffer;
-								const size_t uncompressedSize = prop.m_valueCount * unitSize;
-								if (uncompressedBuffer.size() < uncompressedSize)
-									uncompressedBuffer.resize(uncompressedSize);
-
 								if ((ptr + compressedLength) > block.Size())
 									return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow with zip-compressed data!");
-								for (size_t i = 0; i < compressedLength; i++)
-									compressedBuffer[i] = block.Get<uint8_t>(ptr, FBX_BINARY_ENDIAN);
-
-								uLongf uncompressedLength = static_cast<uLongf>(uncompressedSize);
-								if (uncompressedLength != uncompressedSize)
-									return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Data too large to decompress!");
-								if (uncompress(uncompressedBuffer.data(), &uncompressedLength, compressedBuffer.data(), static_cast<uLong>(compressedLength)) != Z_OK)
-									return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Zlib failed to decompress data!");
-								if (uncompressedLength != uncompressedSize)
-									return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Uncompressed data size mismatch!");
-								dataBlock = MemoryBlock(uncompressedBuffer.data(), uncompressedSize, nullptr);
+								buffer.resize(prop.m_valueOffset + prop.m_valueCount);
+								inflation->Enqueue(key, propertyType, prop.m_valueOffset, prop.m_valueCount, unitSize, data, compressedLength);
+								ptr += compressedLength;
 							}
 							else return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Unsupported array encoding<", encoding, ">!");
-							pushFn(dataBlock, 0, prop.m_valueCount);
 							return true;
 					};
 
 					// Boolean:
-					functions[PropertyTypeCode_BOOLEAN] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_BOOLEAN] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(uint8_t), PropertyType::BOOLEAN, content->m_rawBuffer.size(),
 							[&]() { content->m_rawBuffer.push_back(static_cast<bool>(block.Get<uint8_t>(ptr, FBX_BINARY_ENDIAN))); });
 					};
 
 					// Boolean array:
-					functions[PropertyTypeCode_BOOLEAN_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
-						return readArray(key, prop, block, ptr, logger, sizeof(uint8_t), PropertyType::BOOLEAN_ARR, content->m_rawBuffer.size(),
-							[&](MemoryBlock dataBlock, size_t dataPtr, size_t count) {
-								for (size_t i = 0; i < count; i++)
-									content->m_rawBuffer.push_back(static_cast<bool>(dataBlock.Get<uint8_t>(dataPtr, FBX_BINARY_ENDIAN)));
-							});
+					functions[PropertyTypeCode_BOOLEAN_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation) -> bool {
+						return readArray(key, prop, block, ptr, logger, inflation, sizeof(uint8_t), PropertyType::BOOLEAN_ARR, content->m_rawBuffer);
 					};
 
 					// 16 bit integer:
-					functions[PropertyTypeCode_INT_16] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_INT_16] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(int16_t), PropertyType::INT_16, content->m_int16Buffer.size(),
 							[&]() { content->m_int16Buffer.push_back(block.Get<int16_t>(ptr, FBX_BINARY_ENDIAN)); });
 					};
 
 					// 32 bit integer:
-					functions[PropertyTypeCode_INT_32] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_INT_32] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(int32_t), PropertyType::INT_32, content->m_int32Buffer.size(),
 							[&]() { content->m_int32Buffer.push_back(block.Get<int32_t>(ptr, FBX_BINARY_ENDIAN)); });
 					};
 
 					// 32 bit integer array:
-					functions[PropertyTypeCode_INT_32_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
-						return readArray(key, prop, block, ptr, logger, sizeof(int32_t), PropertyType::INT_32_ARR, content->m_int32Buffer.size(),
-							[&](MemoryBlock dataBlock, size_t dataPtr, size_t count) {
-								for (size_t i = 0; i < count; i++)
-									content->m_int32Buffer.push_back(dataBlock.Get<int32_t>(dataPtr, FBX_BINARY_ENDIAN));
-							});
+					functions[PropertyTypeCode_INT_32_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation) -> bool {
+						return readArray(key, prop, block, ptr, logger, inflation, sizeof(int32_t), PropertyType::INT_32_ARR, content->m_int32Buffer);
 					};
 
 					// 64 bit integer:
-					functions[PropertyTypeCode_INT_64] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_INT_64] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(int64_t), PropertyType::INT_64, content->m_int64Buffer.size(),
 							[&]() { content->m_int64Buffer.push_back(block.Get<int64_t>(ptr, FBX_BINARY_ENDIAN)); });
 					};
 
 					// 64 bit integer array:
-					functions[PropertyTypeCode_INT_64_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
-						return readArray(key, prop, block, ptr, logger, sizeof(int64_t), PropertyType::INT_64_ARR, content->m_int64Buffer.size(),
-							[&](MemoryBlock dataBlock, size_t dataPtr, size_t count) {
-								for (size_t i = 0; i < count; i++)
-									content->m_int64Buffer.push_back(dataBlock.Get<int64_t>(dataPtr, FBX_BINARY_ENDIAN));
-							});
+					functions[PropertyTypeCode_INT_64_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation) -> bool {
+						return readArray(key, prop, block, ptr, logger, inflation, sizeof(int64_t), PropertyType::INT_64_ARR, content->m_int64Buffer);
 					};
 
 					// 32 bit floating point:
-					functions[PropertyTypeCode_FLOAT_32] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_FLOAT_32] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(float), PropertyType::FLOAT_32, content->m_float32Buffer.size(),
 							[&]() { content->m_float32Buffer.push_back(block.Get<float>(ptr, FBX_BINARY_ENDIAN)); });
 					};
 
 					// 32 bit floating point array:
-					functions[PropertyTypeCode_FLOAT_32_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
-						return readArray(key, prop, block, ptr, logger, sizeof(float), PropertyType::FLOAT_32_ARR, content->m_float32Buffer.size(),
-							[&](MemoryBlock dataBlock, size_t dataPtr, size_t count) {
-								for (size_t i = 0; i < count; i++)
-									content->m_float32Buffer.push_back(dataBlock.Get<float>(dataPtr, FBX_BINARY_ENDIAN));
-							});
+					functions[PropertyTypeCode_FLOAT_32_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation) -> bool {
+						return readArray(key, prop, block, ptr, logger, inflation, sizeof(float), PropertyType::FLOAT_32_ARR, content->m_float32Buffer);
 					};
 
 					// 64 bit floating point:
-					functions[PropertyTypeCode_FLOAT_64] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_FLOAT_64] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						return readSingle(key, prop, block, ptr, logger, sizeof(double), PropertyType::FLOAT_64, content->m_float64Buffer.size(),
 							[&]() { content->m_float64Buffer.push_back(block.Get<double>(ptr, FBX_BINARY_ENDIAN)); });
 					};
 
 					// 64 bit floating point array:
-					functions[PropertyTypeCode_FLOAT_64_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
-						return readArray(key, prop, block, ptr, logger, sizeof(double), PropertyType::FLOAT_64_ARR, content->m_float64Buffer.size(),
-							[&](MemoryBlock dataBlock, size_t dataPtr, size_t count) {
-								for (size_t i = 0; i < count; i++)
-									content->m_float64Buffer.push_back(dataBlock.Get<double>(dataPtr, FBX_BINARY_ENDIAN));
-							});
+					functions[PropertyTypeCode_FLOAT_64_ARR] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation* inflation) -> bool {
+						return readArray(key, prop, block, ptr, logger, inflation, sizeof(double), PropertyType::FLOAT_64_ARR, content->m_float64Buffer);
 					};
 
 					// String:
-					functions[PropertyTypeCode_STRING] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_STRING] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						if ((ptr + sizeof(uint32_t)) > block.Size())
 							return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on string Length!");
 						prop.m_type = PropertyType::STRING;
@@ -564,14 +782,15 @@ namespace Jimara {
 						prop.m_valueCount = static_cast<size_t>(block.Get<uint32_t>(ptr, FBX_BINARY_ENDIAN));
 						if ((ptr + prop.m_valueCount) > block.Size())
 							return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on string Data!");
-						for (size_t i = 0; i < prop.m_valueCount; i++)
-							content->m_stringBuffer.push_back(block.Get<char>(ptr, FBX_BINARY_ENDIAN));
+						const char* const text = static_cast<const char*>(block.Data()) + ptr;
+						content->m_stringBuffer.insert(content->m_stringBuffer.end(), text, text + prop.m_valueCount);
 						content->m_stringBuffer.push_back('\0');
+						ptr += prop.m_valueCount;
 						return true;
 					};
 
 					// Raw data:
-					functions[PropertyTypeCode_RAW_BINARY] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger) -> bool {
+					functions[PropertyTypeCode_RAW_BINARY] = [](char key, Property& prop, FBXContent* content, const MemoryBlock& block, size_t& ptr, OS::Logger* logger, DeferredArrayInflation*) -> bool {
 						if ((ptr + sizeof(uint32_t)) > block.Size())
 							return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on raw data Length!");
 						prop.m_type = PropertyType::RAW_BINARY;
@@ -579,8 +798,9 @@ namespace Jimara {
 						prop.m_valueCount = static_cast<size_t>(block.Get<uint32_t>(ptr, FBX_BINARY_ENDIAN));
 						if ((ptr + prop.m_valueCount) > block.Size())
 							return logError(logger, "FBXContent::Decode::parseBinary::parsePropertyRecord - TypeKey['", key, "']: Buffer overflow on raw binary Data!");
-						for (size_t i = 0; i < prop.m_valueCount; i++)
-							content->m_rawBuffer.push_back(block.Get<uint8_t>(ptr, FBX_BINARY_ENDIAN));
+						const uint8_t* const data = static_cast<const uint8_t*>(block.Data()) + ptr;
+						content->m_rawBuffer.insert(content->m_rawBuffer.end(), data, data + prop.m_valueCount);
+						ptr += prop.m_valueCount;
 						return true;
 					};
 
@@ -588,7 +808,7 @@ namespace Jimara {
 				}();
 				Property prop;
 				prop.m_content = content;
-				if (PARSE_FUNCTIONS[static_cast<uint8_t>(typeCode)](typeCode, prop, content, block, ptr, logger)) {
+				if (PARSE_FUNCTIONS[static_cast<uint8_t>(typeCode)](typeCode, prop, content, block, ptr, logger, &inflation)) {
 					content->m_properties.push_back(prop);
 					return true;
 				}
@@ -746,7 +966,7 @@ namespace Jimara {
 		};
 
 		if (block.Size() >= FbxBinaryHeaderSize() && (memcmp(FBX_BINARY_HEADER, block.Data(), FbxBinaryHeaderSize())) == 0) {
-			if (parseBinary()) return content;
+			if (parseBinary() && inflation.Finish(logger)) return content;
 			else return nullptr;
 		}
 		else {
@@ -390,6 +390,8 @@ namespace Jimara {
 
 		/// <summary>
 		/// Extracts serialized node tree from a memory block, containing content form an FBX file 
+		/// <para/> Zlib-compressed array properties are not inflated in-line; large ones get decompressed on worker threads
+		///		while the rest of the node tree is still being parsed and the remaining ones are inflated in parallel once the tree is complete.
 		/// </summary>
 		/// <param name="block"> Memory block (could be something like a memory-mapped FBX file) </param>
 		/// <param name="logger"> Logger for error/warning reporting </param>
@@ -445,6 +447,9 @@ namespace Jimara {
 		// Node property buffer (individual allocations per node would be costly for the performance, so we have one here)
 		std::vector<Property> m_properties;
 
+		// Deferred decompression of array properties (defined in the translation unit)
+		struct DeferredArrayInflation;
+
 		// Copy/Move Construction/Assignment is blocked to prevent data corruption
 		inline FBXContent(const FBXContent&) = delete;
 		inline FBXContent& operator=(const FBXContent&) = delete;
@@ -0,0 +1,668 @@
+#include "FBXCookedData.h"
+#include "../../../Components/Transform.h"
+#include "../../../Core/Memory/ContentHash.h"
+#include <unordered_map>
+#include <filesystem>
+#include <fstream>
+#include <cstring>
+#include <sstream>
+#include <random>
+#include <thread>
+
+
+namespace Jimara {
+	namespace FBXHelpers {
+		struct FBXCookedData::Helpers {
+			static const constexpr char MAGIC[8] = { 'J', 'F', 'B', 'X', 'C', 'O', 'O', 'K' };
+			static const constexpr uint32_t NO_PARENT = ~uint32_t(0u);
+			static const constexpr char TEMPORARY_EXTENSION[] = ".tmp";
+
+			enum class TrackKind : uint8_t {
+				TRIPLE_FLOAT_COMBINE = 0,
+				EULER_ANGLES = 1,
+				ROTATED_EULER_ANGLES = 2
+			};
+
+			enum class BezierFlags : uint8_t {
+				INDEPENDENT_HANDLES = 1,
+				INTERPOLATE_CONSTANT = 2,
+				INTERPOLATE_CONSTANT_NEXT = 4
+			};
+
+			typedef TimelineCurve<float, BezierNode<float>> BezierCurve;
+
+			struct Header {
+				char magic[sizeof(MAGIC)] = {};
+				uint32_t version = 0u;
+				uint32_t endianness = 0u;
+				uint64_t contentHash = 0u;
+				uint64_t sourceSize = 0u;
+				uint64_t payloadSize = 0u;
+			};
+
+			inline static uint32_t EndiannessTag() { return static_cast<uint32_t>(NativeEndian()) + 1u; }
+
+			class Writer {
+			private:
+				std::vector<uint8_t>& m_buffer;
+
+			public:
+				inline Writer(std::vector<uint8_t>& buffer) : m_buffer(buffer) {}
+
+				inline size_t Size()const { return m_buffer.size(); }
+
+				inline void Bytes(const void* data, size_t size) {
+					const size_t offset = m_buffer.size();
+					m_buffer.resize(offset + size);
+					if (size > 0u)
+						std::memcpy(m_buffer.data() + offset, data, size);
+				}
+
+				template<typename Type>
+				inline void Value(const Type& value) { Bytes(&value, sizeof(Type)); }
+
+				inline void Count(size_t count) { Value(static_cast<uint32_t>(count)); }
+
+				inline void String(const std::string_view& value) {
+					Count(value.size());
+					Bytes(value.data(), value.size());
+				}
+
+				inline void Vec3(const Vector3& value) {
+					Value(value.x);
+					Value(value.y);
+					Value(value.z);
+				}
+
+				inline void Mat4(const Matrix4& value) {
+					for (size_t i = 0u; i < 4u; i++)
+						for (size_t j = 0u; j < 4u; j++)
+							Value(value[static_cast<Matrix4::length_type>(i)][static_cast<Matrix4::length_type>(j)]);
+				}
+			};
+
+			class Reader {
+			private:
+				const uint8_t* const m_data;
+				const size_t m_size;
+				size_t m_offset = 0u;
+				bool m_ok = true;
+
+			public:
+				inline Reader(const void* data, size_t size) : m_data(reinterpret_cast<const uint8_t*>(data)), m_size(size) {}
+
+				inline bool Ok()const { return m_ok; }
+
+				inline bool AtEnd()const { return m_offset == m_size; }
+
+				inline const uint8_t* Bytes(size_t size) {
+					if (!m_ok || (m_size - m_offset) < size) {
+						m_ok = false;
+						return nullptr;
+					}
+					const uint8_t* ptr = m_data + m_offset;
+					m_offset += size;
+					return ptr;
+				}
+
+				template<typename Type>
+				inline Type Value() {
+					Type value = {};
+					const uint8_t* ptr = Bytes(sizeof(Type));
+					if (ptr != nullptr)
+						std::memcpy(&value, ptr, sizeof(Type));
+					return value;
+				}
+
+				// Element count, with the guarantee that at least minElementSize bytes per element are left in the buffer
+				inline size_t Count(size_t minElementSize) {
+					const size_t count = static_cast<size_t>(Value<uint32_t>());
+					if (m_ok && ((m_size - m_offset) / Math::Max(minElementSize, size_t(1u))) < count)
+						m_ok = false;
+					return m_ok ? count : size_t(0u);
+				}
+
+				inline std::string_view String() {
+					const size_t length = Count(1u);
+					const uint8_t* ptr = Bytes(length);
+					return (ptr == nullptr) ? std::string_view() : std::string_view(reinterpret_cast<const char*>(ptr), length);
+				}
+
+				inline Vector3 Vec3() {
+					const float x = Value<float>();
+					const float y = Value<float>();
+					const float z = Value<float>();
+					return Vector3(x, y, z);
+				}
+
+				inline Matrix4 Mat4() {
+					Matrix4 result;
+					for (size_t i = 0u; i < 4u; i++)
+						for (size_t j = 0u; j < 4u; j++)
+							result[static_cast<Matrix4::length_type>(i)][static_cast<Matrix4::length_type>(j)] = Value<float>();
+					return result;
+				}
+			};
+
+
+			inline static void CookMesh(const FBXMesh* fbxMesh, Writer& writer) {
+				const FBXSkinnedMesh* fbxSkinnedMesh = dynamic_cast<const FBXSkinnedMesh*>(fbxMesh);
+				const SkinnedPolyMesh* skinnedMesh = (fbxSkinnedMesh == nullptr) ? nullptr : fbxSkinnedMesh->SkinnedMesh();
+				writer.Value<uint8_t>(skinnedMesh != nullptr ? 1u : 0u);
+				writer.Value(fbxMesh->uid);
+
+				PolyMesh::Reader reader(fbxMesh->mesh);
+				writer.String(reader.Name());
+				writer.Count(reader.VertCount());
+				for (uint32_t i = 0u; i < reader.VertCount(); i++) {
+					const MeshVertex& vertex = reader.Vert(i);
+					writer.Vec3(vertex.position);
+					writer.Vec3(vertex.normal);
+					writer.Value(vertex.uv.x);
+					writer.Value(vertex.uv.y);
+				}
+				writer.Count(reader.FaceCount());
+				for (uint32_t i = 0u; i < reader.FaceCount(); i++) {
+					const PolygonFace& face = reader.Face(i);
+					writer.Count(face.Size());
+					writer.Bytes(face.Data(), sizeof(uint32_t) * face.Size());
+				}
+
+				if (skinnedMesh == nullptr)
+					return;
+				writer.Value<uint8_t>(fbxSkinnedMesh->rootBoneId.has_value() ? 1u : 0u);
+				writer.Value<FBXUid>(fbxSkinnedMesh->rootBoneId.has_value() ? fbxSkinnedMesh->rootBoneId.value() : FBXUid(0));
+				writer.Count(fbxSkinnedMesh->boneIds.size());
+				writer.Bytes(fbxSkinnedMesh->boneIds.data(), sizeof(FBXUid) * fbxSkinnedMesh->boneIds.size());
+
+				SkinnedPolyMesh::Reader skinReader(skinnedMesh);
+				writer.Count(skinReader.BoneCount());
+				for (uint32_t i = 0u; i < skinReader.BoneCount(); i++)
+					writer.Mat4(skinReader.BoneData(i));
+				for (uint32_t i = 0u; i < skinReader.VertCount(); i++) {
+					const uint32_t weightCount = skinReader.WeightCount(i);
+					writer.Count(weightCount);
+					for (uint32_t j = 0u; j < weightCount; j++) {
+						const SkinnedPolyMesh::BoneWeight& weight = skinReader.Weight(i, j);
+						writer.Value(weight.boneIndex);
+						writer.Value(weight.boneWeight);
+					}
+				}
+			}
+
+			inline static bool RestoreGeometry(Reader& reader, const PolyMesh::Writer& writer) {
+				const uint32_t vertexCount = static_cast<uint32_t>(reader.Count(sizeof(float) * 8u));
+				for (uint32_t i = 0u; i < vertexCount; i++) {
+					MeshVertex vertex;
+					vertex.position = reader.Vec3();
+					vertex.normal = reader.Vec3();
+					vertex.uv.x = reader.Value<float>();
+					vertex.uv.y = reader.Value<float>();
+					writer.AddVert(vertex);
+				}
+				const size_t faceCount = reader.Count(sizeof(uint32_t));
+				for (size_t i = 0u; i < faceCount; i++) {
+					const size_t indexCount = reader.Count(sizeof(uint32_t));
+					const uint8_t* indices = reader.Bytes(sizeof(uint32_t) * indexCount);
+					if (indices == nullptr)
+						return false;
+					PolygonFace face;
+					face.Resize(indexCount);
+					std::memcpy(face.Data(), indices, sizeof(uint32_t) * indexCount);
+					for (size_t j = 0u; j < indexCount; j++)
+						if (face[j] >= vertexCount)
+							return false;
+					writer.AddFace(std::move(face));
+				}
+				return reader.Ok();
+			}
+
+			inline static bool RestoreSkin(Reader& reader, FBXSkinnedMesh* fbxMesh, SkinnedPolyMesh::Writer& writer) {
+				const bool hasRootBone = (reader.Value<uint8_t>() != 0u);
+				const FBXUid rootBoneId = reader.Value<FBXUid>();
+				fbxMesh->rootBoneId = hasRootBone ? std::optional<FBXUid>(rootBoneId) : std::optional<FBXUid>();
+				fbxMesh->boneIds.resize(reader.Count(sizeof(FBXUid)));
+				{
+					const uint8_t* boneIds = reader.Bytes(sizeof(FBXUid) * fbxMesh->boneIds.size());
+					if (boneIds == nullptr)
+						return false;
+					std::memcpy(fbxMesh->boneIds.data(), boneIds, sizeof(FBXUid) * fbxMesh->boneIds.size());
+				}
+
+				const size_t boneCount = reader.Count(sizeof(float) * 16u);
+				for (size_t i = 0u; i < boneCount; i++)
+					writer.AddBone(reader.Mat4());
+				for (uint32_t i = 0u; i < writer.VertCount(); i++) {
+					const size_t weightCount = reader.Count(sizeof(uint32_t) + sizeof(float));
+					for (size_t j = 0u; j < weightCount; j++) {
+						const uint32_t boneIndex = reader.Value<uint32_t>();
+						const float boneWeight = reader.Value<float>();
+						// Weight() does not validate the bone index and out of range indices would break the skinning buffers later on:
+						if (boneIndex >= boneCount || (!reader.Ok()))
+							return false;
+						writer.Weight(i, boneIndex) = boneWeight;
+					}
+				}
+				return reader.Ok();
+			}
+
+			inline static Reference<FBXMesh> RestoreMesh(Reader& reader) {
+				const bool skinned = (reader.Value<uint8_t>() != 0u);
+				const FBXUid uid = reader.Value<FBXUid>();
+				const std::string_view name = reader.String();
+				if (!reader.Ok())
+					return nullptr;
+
+				if (skinned) {
+					const Reference<FBXSkinnedMesh> fbxMesh = Object::Instantiate<FBXSkinnedMesh>();
+					fbxMesh->uid = uid;
+					fbxMesh->mesh = Object::Instantiate<SkinnedPolyMesh>(name);
+					// Skinned writer has to be the one adding vertices, since it tracks per-vertex weights:
+					SkinnedPolyMesh::Writer writer(fbxMesh->SkinnedMesh());
+					if (!RestoreGeometry(reader, writer)) 
+						return nullptr;
+					else if (!RestoreSkin(reader, fbxMesh, writer))
+						return nullptr;
+					else return fbxMesh;
+				}
+				else {
+					const Reference<FBXMesh> fbxMesh = Object::Instantiate<FBXMesh>();
+					fbxMesh->uid = uid;
+					fbxMesh->mesh = Object::Instantiate<PolyMesh>(name);
+					PolyMesh::Writer writer(fbxMesh->mesh);
+					if (!RestoreGeometry(reader, writer))
+						return nullptr;
+					else return fbxMesh;
+				}
+			}
+
+
+			inline static bool CookNodes(const FBXData* data, Writer& writer, OS::Logger* logger) {
+				std::unordered_map<const FBXMesh*, uint32_t> meshIndex;
+				for (size_t i = 0u; i < data->MeshCount(); i++)
+					meshIndex[data->GetMesh(i)] = static_cast<uint32_t>(i);
+
+				std::vector<std::pair<const FBXNode*, uint32_t>> nodes;
+				nodes.push_back(std::make_pair(data->RootNode(), NO_PARENT));
+				for (size_t i = 0u; i < nodes.size(); i++) {
+					const FBXNode* node = nodes[i].first;
+					for (size_t j = 0u; j < node->children.size(); j++)
+						nodes.push_back(std::make_pair(node->children[j].operator->(), static_cast<uint32_t>(i)));
+				}
+
+				writer.Count(nodes.size());
+				for (size_t i = 0u; i < nodes.size(); i++) {
+					const FBXNode* node = nodes[i].first;
+					writer.Value(node->uid);
+					writer.Value(nodes[i].second);
+					writer.String(node->name);
+					writer.Vec3(node->position);
+					writer.Vec3(node->rotation);
+					writer.Vec3(node->scale);
+					writer.Count(node->meshes.Size());
+					for (size_t j = 0u; j < node->meshes.Size(); j++) {
+						const auto it = meshIndex.find(node->meshes[j]);
+						if (it == meshIndex.end()) {
+							if (logger != nullptr)
+								logger->Warning("FBXCookedData::Helpers::CookNodes - Node '", node->name, "' references an unlisted mesh!");
+							return false;
+						}
+						writer.Value(it->second);
+					}
+				}
+				return true;
+			}
+
+			inline static bool RestoreNodes(Reader& reader, FBXData* data) {
+				const size_t nodeCount = reader.Count(sizeof(FBXUid) + sizeof(uint32_t));
+				if (nodeCount <= 0u)
+					return false;
+				std::vector<Reference<FBXNode>> nodes;
+				for (size_t i = 0u; i < nodeCount; i++) {
+					const Reference<FBXNode> node = Object::Instantiate<FBXNode>();
+					node->uid = reader.Value<FBXUid>();
+					const uint32_t parent = reader.Value<uint32_t>();
+					node->name = reader.String();
+					node->position = reader.Vec3();
+					node->rotation = reader.Vec3();
+					node->scale = reader.Vec3();
+					const size_t meshCount = reader.Count(sizeof(uint32_t));
+					for (size_t j = 0u; j < meshCount; j++) {
+						const uint32_t meshId = reader.Value<uint32_t>();
+						if (meshId >= data->m_meshes.size())
+							return false;
+						node->meshes.Push(data->m_meshes[meshId]);
+					}
+					if (!reader.Ok())
+						return false;
+					else if ((i == 0u) != (parent == NO_PARENT))
+						return false;
+					else if (i > 0u) {
+						if (parent >= i)
+							return false;
+						nodes[parent]->children.push_back(node);
+					}
+					nodes.push_back(node);
+				}
+				data->m_rootNode = nodes[0u];
+				return true;
+			}
+
+
+			inline static bool CookCurve(const ParametricCurve<float, float>* curve, Writer& writer) {
+				const BezierCurve* timeline = dynamic_cast<const BezierCurve*>(curve);
+				if (timeline == nullptr)
+					return false;
+				writer.Count(timeline->size());
+				for (BezierCurve::const_iterator it = timeline->begin(); it != timeline->end(); ++it) {
+					const BezierNode<float>& node = it->second;
+					const BezierNode<float>::ConstantInterpolation constant = node.InterpolateConstant();
+					writer.Value(it->first);
+					writer.Value(node.Value());
+					writer.Value(node.PrevHandle());
+					writer.Value(node.NextHandle());
+					writer.Value<uint8_t>(
+						(node.IndependentHandles() ? static_cast<uint8_t>(BezierFlags::INDEPENDENT_HANDLES) : uint8_t(0u)) |
+						(constant.active ? static_cast<uint8_t>(BezierFlags::INTERPOLATE_CONSTANT) : uint8_t(0u)) |
+						(constant.next ? static_cast<uint8_t>(BezierFlags::INTERPOLATE_CONSTANT_NEXT) : uint8_t(0u)));
+				}
+				return true;
+			}
+
+			inline static Reference<BezierCurve> RestoreCurve(Reader& reader) {
+				const Reference<BezierCurve> curve = Object::Instantiate<BezierCurve>();
+				const size_t nodeCount = reader.Count(sizeof(float) * 4u + sizeof(uint8_t));
+				for (size_t i = 0u; i < nodeCount; i++) {
+					const float time = reader.Value<float>();
+					const float value = reader.Value<float>();
+					const float prevHandle = reader.Value<float>();
+					const float nextHandle = reader.Value<float>();
+					const uint8_t flags = reader.Value<uint8_t>();
+					BezierNode<float> node(value, prevHandle, nextHandle);
+					node.IndependentHandles() = ((flags & static_cast<uint8_t>(BezierFlags::INDEPENDENT_HANDLES)) != 0u);
+					node.InterpolateConstant() = BezierNode<float>::ConstantInterpolation(
+						(flags & static_cast<uint8_t>(BezierFlags::INTERPOLATE_CONSTANT)) != 0u,
+						(flags & static_cast<uint8_t>(BezierFlags::INTERPOLATE_CONSTANT_NEXT)) != 0u);
+					curve->insert(std::make_pair(time, node));
+				}
+				return reader.Ok() ? curve : nullptr;
+			}
+
+			inline static bool CookAnimation(const FBXAnimation* animation, Writer& writer, OS::Logger* logger) {
+				const AnimationClip* clip = animation->clip;
+				if (clip == nullptr)
+					return false;
+				writer.Value(animation->uid);
+				writer.String(clip->Name());
+				writer.Value(clip->Duration());
+				writer.Count(clip->TrackCount());
+				for (size_t i = 0u; i < clip->TrackCount(); i++) {
+					const AnimationClip::Track* track = clip->GetTrack(i);
+					const AnimationClip::TripleFloatCombine* vec3Track = dynamic_cast<const AnimationClip::TripleFloatCombine*>(track);
+					const AnimationClip::EulerAngleTrack* eulerTrack = dynamic_cast<const AnimationClip::EulerAngleTrack*>(track);
+					const AnimationClip::RotatedEulerAngleTrack* rotatedTrack = dynamic_cast<const AnimationClip::RotatedEulerAngleTrack*>(track);
+					if (vec3Track == nullptr) {
+						if (logger != nullptr)
+							logger->Warning("FBXCookedData::Helpers::CookAnimation - Unsupported track type in '", clip->Name(), "'!");
+						return false;
+					}
+					if (rotatedTrack != nullptr) {
+						writer.Value(TrackKind::ROTATED_EULER_ANGLES);
+						writer.Value(rotatedTrack->Mode());
+						writer.Mat4(rotatedTrack->Rotation());
+					}
+					else if (eulerTrack != nullptr) {
+						writer.Value(TrackKind::EULER_ANGLES);
+						writer.Value(eulerTrack->Mode());
+					}
+					else writer.Value(TrackKind::TRIPLE_FLOAT_COMBINE);
+					writer.String(track->TargetField());
+					writer.Count(track->BindingCount());
+					for (size_t j = 0u; j < track->BindingCount(); j++) {
+						writer.String(track->BindingName(j));
+						writer.String(track->BindingType(j).Name());
+					}
+					if ((!CookCurve(vec3Track->X(), writer)) || (!CookCurve(vec3Track->Y(), writer)) || (!CookCurve(vec3Track->Z(), writer))) {
+						if (logger != nullptr)
+							logger->Warning("FBXCookedData::Helpers::CookAnimation - Unsupported curve type in '", clip->Name(), "'!");
+						return false;
+					}
+				}
+				return true;
+			}
+
+			inline static Reference<FBXAnimation> RestoreAnimation(Reader& reader) {
+				const Reference<FBXAnimation> animation = Object::Instantiate<FBXAnimation>();
+				animation->uid = reader.Value<FBXUid>();
+				animation->clip = Object::Instantiate<AnimationClip>(reader.String());
+				AnimationClip::Writer writer(animation->clip);
+				writer.SetDuration(reader.Value<float>());
+				const size_t trackCount = reader.Count(sizeof(TrackKind));
+				for (size_t i = 0u; i < trackCount; i++) {
+					AnimationClip::TripleFloatCombine* track = nullptr;
+					const TrackKind kind = reader.Value<TrackKind>();
+					if (kind == TrackKind::ROTATED_EULER_ANGLES) {
+						const AnimationClip::EulerAngleTrack::EvaluationMode mode = reader.Value<AnimationClip::EulerAngleTrack::EvaluationMode>();
+						const Matrix4 rotation = reader.Mat4();
+						if (mode >= AnimationClip::EulerAngleTrack::EvaluationMode::MODE_COUNT)
+							return nullptr;
+						track = writer.AddTrack<AnimationClip::RotatedEulerAngleTrack>(nullptr, nullptr, nullptr, mode, rotation);
+					}
+					else if (kind == TrackKind::EULER_ANGLES) {
+						const AnimationClip::EulerAngleTrack::EvaluationMode mode = reader.Value<AnimationClip::EulerAngleTrack::EvaluationMode>();
+						if (mode >= AnimationClip::EulerAngleTrack::EvaluationMode::MODE_COUNT)
+							return nullptr;
+						track = writer.AddTrack<AnimationClip::EulerAngleTrack>(nullptr, nullptr, nullptr, mode);
+					}
+					else if (kind == TrackKind::TRIPLE_FLOAT_COMBINE)
+						track = writer.AddTrack<AnimationClip::TripleFloatCombine>();
+					else return nullptr;
+
+					writer.SetTrackTargetField(track->Index(), reader.String());
+					const size_t bindingCount = reader.Count(sizeof(uint32_t) * 2u);
+					for (size_t j = 0u; j < bindingCount; j++) {
+						const std::string_view name = reader.String();
+						const std::string_view typeName = reader.String();
+						// Transform is all the FBX extractor binds to, so we do not need the type registry for it:
+						TypeId type = TypeId::Of<Transform>();
+						if (typeName != type.Name() && (!TypeId::Find(typeName, type)))
+							return nullptr;
+						writer.AddTrackBinding(track->Index(), name, type);
+					}
+					track->X() = RestoreCurve(reader);
+					track->Y() = RestoreCurve(reader);
+					track->Z() = RestoreCurve(reader);
+					if (track->X() == nullptr || track->Y() == nullptr || track->Z() == nullptr)
+						return nullptr;
+				}
+				return reader.Ok() ? animation : nullptr;
+			}
+
+			// Each write goes to its own temporary file (process token, thread and a counter make the name unique), so that concurrent cooks never interleave:
+			inline static OS::Path TemporaryPath(const OS::Path& cookedPath) {
+				static const uint64_t processToken = []() -> uint64_t {
+					std::random_device device;
+					return (static_cast<uint64_t>(device()) << 32u) ^ static_cast<uint64_t>(device());
+				}();
+				static std::atomic<uint64_t> counter = 0u;
+				std::stringstream stream;
+				stream << '.' << std::hex << processToken
+					<< '.' << std::hash<std::thread::id>()(std::this_thread::get_id())
+					<< '.' << counter.fetch_add(1u) << TEMPORARY_EXTENSION;
+				return OS::Path(cookedPath.native() + OS::Path(stream.str()).native());
+			}
+		};
+
+		FBXCookedData::SourceKey FBXCookedData::Key(const MemoryBlock& sourceContent) {
+			SourceKey key;
+			key.contentHash = ContentHash::XXHash64(sourceContent);
+			key.sourceSize = static_cast<uint64_t>(sourceContent.Size());
+			return key;
+		}
+
+		bool FBXCookedData::Cook(const FBXData* data, const SourceKey& sourceKey, std::vector<uint8_t>& result, OS::Logger* logger) {
+			if (data == nullptr) {
+				if (logger != nullptr) logger->Error("FBXCookedData::Cook - NULL data provided! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+				return false;
+			}
+			const size_t initialSize = result.size();
+			auto fail = [&]() {
+				result.resize(initialSize);
+				return false;
+			};
+
+			Helpers::Writer writer(result);
+			Helpers::Header header;
+			std::memcpy(header.magic, Helpers::MAGIC, sizeof(Helpers::MAGIC));
+			header.version = Version();
+			header.endianness = Helpers::EndiannessTag();
+			header.contentHash = sourceKey.contentHash;
+			header.sourceSize = sourceKey.sourceSize;
+			writer.Value(header);
+			const size_t payloadStart = writer.Size();
+
+			{
+				const FBXData::FBXGlobalSettings& settings = data->Settings();
+				writer.Vec3(settings.forwardAxis);
+				writer.Vec3(settings.upAxis);
+				writer.Vec3(settings.coordAxis);
+				writer.Value(settings.unitScale);
+			}
+
+			writer.Count(data->MeshCount());
+			for (size_t i = 0u; i < data->MeshCount(); i++) {
+				const FBXMesh* mesh = data->GetMesh(i);
+				if (mesh == nullptr || mesh->mesh == nullptr)
+					return fail();
+				Helpers::CookMesh(mesh, writer);
+			}
+
+			if (!Helpers::CookNodes(data, writer, logger))
+				return fail();
+
+			writer.Count(data->AnimationCount());
+			for (size_t i = 0u; i < data->AnimationCount(); i++)
+				if (!Helpers::CookAnimation(data->GetAnimation(i), writer, logger))
+					return fail();
+
+			header.payloadSize = static_cast<uint64_t>(writer.Size() - payloadStart);
+			std::memcpy(result.data() + initialSize, &header, sizeof(Helpers::Header));
+			return true;
+		}
+
+		bool FBXCookedData::Cook(const FBXData* data, const SourceKey& sourceKey, const OS::Path& cookedPath, OS::Logger* logger) {
+			std::vector<uint8_t> buffer;
+			if (!Cook(data, sourceKey, buffer, logger))
+				return false;
+
+			const OS::Path tmpPath = Helpers::TemporaryPath(cookedPath);
+			std::error_code error;
+			if (cookedPath.has_parent_path())
+				std::filesystem::create_directories(cookedPath.parent_path(), error);
+			{
+				std::ofstream stream((const std::filesystem::path&)tmpPath, std::ios::binary | std::ios::trunc);
+				if (!stream.is_open()) {
+					if (logger != nullptr) logger->Warning("FBXCookedData::Cook - Failed to open '", tmpPath, "' for writing!");
+					return false;
+				}
+				stream.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+				if (!stream.good()) {
+					stream.close();
+					std::filesystem::remove(tmpPath, error);
+					if (logger != nullptr) logger->Warning("FBXCookedData::Cook - Failed to write '", tmpPath, "'!");
+					return false;
+				}
+			}
+			std::filesystem::rename(tmpPath, cookedPath, error);
+			if (error) {
+				std::filesystem::remove(tmpPath, error);
+				if (logger != nullptr) logger->Warning("FBXCookedData::Cook - Failed to move cooked data to '", cookedPath, "'!");
+				return false;
+			}
+			return true;
+		}
+
+		Reference<FBXData> FBXCookedData::Restore(const MemoryBlock& block, const SourceKey& sourceKey, OS::Logger* logger) {
+			if (block.Size() < sizeof(Helpers::Header))
+				return nullptr;
+			Helpers::Header header;
+			std::memcpy(&header, block.Data(), sizeof(Helpers::Header));
+			if (std::memcmp(header.magic, Helpers::MAGIC, sizeof(Helpers::MAGIC)) != 0 ||
+				header.version != Version() ||
+				header.endianness != Helpers::EndiannessTag() ||
+				header.contentHash != sourceKey.contentHash ||
+				header.sourceSize != sourceKey.sourceSize ||
+				header.payloadSize != static_cast<uint64_t>(block.Size() - sizeof(Helpers::Header)))
+				return nullptr;
+
+			auto corrupted = [&]() -> Reference<FBXData> {
+				if (logger != nullptr) logger->Warning("FBXCookedData::Restore - Cooked data corrupted! Source will be re-imported.");
+				return nullptr;
+			};
+
+			Helpers::Reader reader(reinterpret_cast<const uint8_t*>(block.Data()) + sizeof(Helpers::Header), block.Size() - sizeof(Helpers::Header));
+			const Reference<FBXData> result = Object::Instantiate<FBXData>();
+			{
+				result->m_globalSettings.forwardAxis = reader.Vec3();
+				result->m_globalSettings.upAxis = reader.Vec3();
+				result->m_globalSettings.coordAxis = reader.Vec3();
+				result->m_globalSettings.unitScale = reader.Value<float>();
+			}
+
+			const size_t meshCount = reader.Count(sizeof(uint8_t) + sizeof(FBXUid));
+			for (size_t i = 0u; i < meshCount; i++) {
+				const Reference<FBXMesh> mesh = Helpers::RestoreMesh(reader);
+				if (mesh == nullptr)
+					return corrupted();
+				result->m_meshes.push_back(mesh);
+			}
+
+			if (!Helpers::RestoreNodes(reader, result))
+				return corrupted();
+
+			const size_t animationCount = reader.Count(sizeof(FBXUid));
+			for (size_t i = 0u; i < animationCount; i++) {
+				const Reference<FBXAnimation> animation = Helpers::RestoreAnimation(reader);
+				if (animation == nullptr)
+					return corrupted();
+				result->m_animations.push_back(animation);
+			}
+
+			if ((!reader.Ok()) || (!reader.AtEnd()))
+				return corrupted();
+			return result;
+		}
+
+		Reference<FBXData> FBXCookedData::Load(const OS::Path& sourcePath, const std::optional<OS::Path>& cookedPath, OS::Logger* logger) {
+			if (!cookedPath.has_value())
+				return FBXData::Extract(sourcePath, logger);
+
+			const Reference<OS::MMappedFile> sourceMapping = OS::MMappedFile::Create(sourcePath, logger);
+			if (sourceMapping == nullptr) {
+				if (logger != nullptr) logger->Error("FBXCookedData::Load - Failed to mmap file: '", sourcePath, "'! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+				return nullptr;
+			}
+			const MemoryBlock sourceBlock = *sourceMapping;
+			const SourceKey sourceKey = Key(sourceBlock);
+
+			// Cooked file is mapped without caching, since it may be overwritten right after:
+			{
+				std::error_code error;
+				const bool cookedFileExists = std::filesystem::exists(cookedPath.value(), error);
+				if (cookedFileExists && (!error)) {
+					const Reference<OS::MMappedFile> cookedMapping = OS::MMappedFile::Create(cookedPath.value(), logger, false);
+					if (cookedMapping != nullptr) {
+						const Reference<FBXData> cooked = Restore(*cookedMapping, sourceKey, logger);
+						if (cooked != nullptr)
+							return cooked;
+					}
+				}
+			}
+
+			const Reference<FBXData> data = FBXData::Extract(sourceBlock, logger);
+			if (data != nullptr)
+				Cook(data, sourceKey, cookedPath.value(), logger);
+			return data;
+		}
+	}
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include "FBXData.h"
+#include "../../../OS/IO/MMappedFile.h"
+#include <optional>
+
+
+namespace Jimara {
+	namespace FBXHelpers {
+		/// <summary>
+		/// Persistent binary representation of the extracted FBXData ("cooked" FBX content).
+		/// <para/> Cooked data stores meshes, skinning data, transform hierarchy and animation clips in their final form,
+		///		so that restoring them does not involve parsing, inflating or converting anything from the source FBX file.
+		/// <para/> Each blob is keyed by the content hash and the size of the source file and by the cooked format version;
+		///		any mismatch is treated as a cache miss, so stale blobs are simply ignored and overwritten.
+		/// </summary>
+		class JIMARA_API FBXCookedData {
+		public:
+			/// <summary>
+			/// Cooked format version
+			/// (has to be incremented whenever the binary layout or the output of FBXData::Extract changes, invalidating all previously cooked blobs)
+			/// </summary>
+			inline static constexpr uint32_t Version() { return 2u; }
+
+			/// <summary> Key of the cooked data (identifies the source file content) </summary>
+			struct JIMARA_API SourceKey {
+				/// <summary> xxHash64 of the source file content </summary>
+				uint64_t contentHash = 0u;
+
+				/// <summary> Size of the source file (in bytes) </summary>
+				uint64_t sourceSize = 0u;
+
+				/// <summary> Compares keys </summary>
+				inline bool operator==(const SourceKey& other)const { return contentHash == other.contentHash && sourceSize == other.sourceSize; }
+
+				/// <summary> Compares keys </summary>
+				inline bool operator!=(const SourceKey& other)const { return !((*this) == other); }
+			};
+
+			/// <summary>
+			/// Calculates the key for the cooked data (stable across runs and platforms)
+			/// </summary>
+			/// <param name="sourceContent"> Content of the source FBX file </param>
+			/// <returns> Source key </returns>
+			static SourceKey Key(const MemoryBlock& sourceContent);
+
+			/// <summary>
+			/// Serializes FBXData
+			/// </summary>
+			/// <param name="data"> Extracted FBX data </param>
+			/// <param name="sourceKey"> Key of the source file (see Key()) </param>
+			/// <param name="result"> Cooked data will be appended to this buffer </param>
+			/// <param name="logger"> Logger for error reporting </param>
+			/// <returns> True, if data is fully representable in cooked form and got serialized </returns>
+			static bool Cook(const FBXData* data, const SourceKey& sourceKey, std::vector<uint8_t>& result, OS::Logger* logger);
+
+			/// <summary>
+			/// Serializes FBXData and stores it in a file
+			/// <para/> Data is written to a uniquely named temporary file first and then moved to the final location,
+			///		so that partially written files never get picked up and concurrent writers never share a temporary file.
+			/// </summary>
+			/// <param name="data"> Extracted FBX data </param>
+			/// <param name="sourceKey"> Key of the source file (see Key()) </param>
+			/// <param name="cookedPath"> Cooked file path </param>
+			/// <param name="logger"> Logger for error reporting </param>
+			/// <returns> True, if the file got written successfully </returns>
+			static bool Cook(const FBXData* data, const SourceKey& sourceKey, const OS::Path& cookedPath, OS::Logger* logger);
+
+			/// <summary>
+			/// Restores FBXData from the cooked blob
+			/// </summary>
+			/// <param name="block"> Cooked data (normally, a memory-mapped cooked file) </param>
+			/// <param name="sourceKey"> Expected key of the source file (see Key()) </param>
+			/// <param name="logger"> Logger for error reporting (key/version mismatch is expected and is not reported as an error) </param>
+			/// <returns> Restored data if the blob is valid and up to date, nullptr otherwise </returns>
+			static Reference<FBXData> Restore(const MemoryBlock& block, const SourceKey& sourceKey, OS::Logger* logger);
+
+			/// <summary>
+			/// Loads FBXData, preferring the cooked file if it is up to date
+			/// <para/> If the cooked file is missing or stale, the source gets extracted and the cooked file is (re)written.
+			/// </summary>
+			/// <param name="sourcePath"> Source FBX file path </param>
+			/// <param name="cookedPath"> Cooked file path (if not provided, this is the same as FBXData::Extract(sourcePath, logger)) </param>
+			/// <param name="logger"> Logger for error reporting </param>
+			/// <returns> Extracted data if successful, nullptr if something went wrong </returns>
+			static Reference<FBXData> Load(const OS::Path& sourcePath, const std::optional<OS::Path>& cookedPath, OS::Logger* logger);
+
+		private:
+			// Serialization helpers are defined in the translation unit
+			struct Helpers;
+		};
+	}
+}
@@ -4,6 +4,7 @@
 #include "FBXMeshExtractor.h"
 #include "FBXAnimationExtractor.h"
 #include "../../../OS/IO/MMappedFile.h"
+#include "../../../Core/Systems/ParallelFor.h"
 #include <stddef.h>
 #include <unordered_map>
 #include <map>
@@ -572,9 +573,9 @@ namespace Jimara {
 		if (!objectIndex.Build(sourceContent->RootNode(), logger)) return nullptr;
 
 		// Parse Objects (Incomplete...):
-		FBXHelpers::FBXMeshExtractor meshExtractor;
 		std::unordered_map<int64_t, size_t> transformIndex;
 		std::vector<std::pair<Reference<FBXNode>, size_t>> transforms;
+		std::vector<const FBXHelpers::FBXObjectIndex::NodeWithConnections*> meshNodes;
 
 		for (size_t i = 0; i < objectIndex.ObjectCount(); i++) {
 			const FBXHelpers::FBXObjectIndex::NodeWithConnections& objectNode = objectIndex.ObjectNode(i);
@@ -629,15 +630,13 @@ namespace Jimara {
 				return true;
 			};
 
-			// Reads a Mesh:
+			// Reads a Mesh (actual extraction happens later, in parallel):
 			auto readMesh = [&]() -> bool {
 				if (objectNode.node.SubClass() != "Mesh") {
 					warning("FBXData::Extract::readMesh - subClassProperty<'", objectNode.node.SubClass(), "'> is not 'Mesh'!; Ignoring the node...");
 					return true;
 				}
-				const Reference<FBXMesh> mesh = meshExtractor.ExtractMesh(objectNode, logger);
-				if (mesh == nullptr) return false;
-				result->m_meshes.push_back(mesh);
+				meshNodes.push_back(&objectNode);
 				return true;
 			};
 
@@ -649,6 +648,27 @@ namespace Jimara {
 			if (!success) return nullptr;
 		}
 
+		// Extract meshes (those are independent from each other, so each thread gets its own extractor and claims meshes one by one):
+		{
+			std::vector<Reference<FBXMesh>> meshes(meshNodes.size());
+			const size_t threadCount = ParallelHelpers::ThreadCount(meshNodes.size(), 1u, std::thread::hardware_concurrency());
+			std::vector<FBXHelpers::FBXMeshExtractor> meshExtractors(threadCount);
+			std::atomic<size_t> nextMesh = 0u;
+			std::atomic<bool> failed = false;
+			ThreadBlock threadBlock;
+			ParallelHelpers::Execute(threadBlock, threadCount, [&](ThreadBlock::ThreadInfo info) {
+				FBXHelpers::FBXMeshExtractor& meshExtractor = meshExtractors[info.threadId];
+				while (!failed.load()) {
+					const size_t meshId = nextMesh.fetch_add(1u);
+					if (meshId >= meshNodes.size()) break;
+					meshes[meshId] = meshExtractor.ExtractMesh(*meshNodes[meshId], logger);
+					if (meshes[meshId] == nullptr) failed = true;
+				}
+				});
+			if (failed.load()) return nullptr;
+			result->m_meshes = std::move(meshes);
+		}
+
 
 		// Finds parent transform indices for object with given index:
 		auto findParentTransforms = [&](size_t nodeId, auto onFound) {
@@ -6,6 +6,8 @@
 
 
 namespace Jimara {
+	namespace FBXHelpers { class FBXCookedData; }
+
 	/// <summary>
 	/// Actual data, stored inside an FBX file
 	/// </summary>
@@ -84,5 +86,8 @@ namespace Jimara {
 
 		// Animations from the FBX file
 		std::vector<Reference<FBXAnimation>> m_animations;
+
+		// Cooked data restores the internals directly
+		friend class FBXHelpers::FBXCookedData;
 	};
 }
@@ -69,7 +69,7 @@ namespace Jimara {
 			}
 		}
 
-		inline static Reference<Importer> Get(MaterialFileAsset* asset) {
+		inline static Reference<Importer> Get(const MaterialFileAsset* asset) {
 			std::unique_lock<SpinLock> importerLock(asset->m_importerLock);
 			Reference<Importer> importer = asset->m_importer;
 			return importer;
@@ -126,6 +126,14 @@ namespace Jimara {
 	namespace {
 		static const Reference<const GUID::Serializer> GUID_SERIALIZER = Object::Instantiate<GUID::Serializer>(
 			"MaterialFileAsset_ReferencedResourceId", "Resource ID, referenced by Material");
+
+		inline static bool ReadReferencedResourceId(const nlohmann::json& objectJson, OS::Logger* log, GUID& guid) {
+			return Serialization::DeserializeFromJson(GUID_SERIALIZER->Serialize(guid), objectJson, log,
+				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
+					if (log != nullptr) log->Error("MaterialFileAsset::ReadReferencedResourceId - GUID Serializer not expected to reference Object pointers!");
+					return false;
+				});
+		}
 	}
 
 	Reference<Material> MaterialFileAsset::LoadItem() {
@@ -170,6 +178,30 @@ namespace Jimara {
 			->GetFields(Callback<Serialization::SerializedObject>::FromCall(&processField), resource);
 	}
 
+	void MaterialFileAsset::GetDependencies(const Callback<const GUID&>& reportDependency)const {
+		const Reference<Importer> importer = Importer::Get(this);
+		if (importer == nullptr)
+			return;
+
+		nlohmann::json json;
+		if (!LoadMaterialFileJson(importer->AssetFilePath(), importer->Log(), json)) return;
+
+		// Property layout depends on the shader, so the json is read into a scratch material; references are only reported, not loaded:
+		const Material::Serializer* serializer = importer->ShaderLibrary()->LitShaders()->MaterialSerializer();
+		const Reference<Material> material = Object::Instantiate<Material>(
+			importer->GraphicsDevice(), importer->BindlessBuffers(), importer->BindlessSamplers());
+		OS::Logger* log = importer->Log();
+		const bool success = Serialization::DeserializeFromJson(serializer->Serialize(material), json, log,
+			[&](const Serialization::SerializedObject&, const nlohmann::json& objectJson) -> bool {
+				GUID guid = {};
+				if (!ReadReferencedResourceId(objectJson, log, guid)) return false;
+				if (guid != GUID{}) reportDependency(guid);
+				return true;
+			});
+		if (!success)
+			log->Warning("MaterialFileAsset::GetDependencies - Failed to read material data! (dependencies may be incomplete)");
+	}
+
 	void MaterialFileAsset::Store(Material* resource) {
 		const Reference<Importer> importer = Importer::Get(this);
 		if (importer == nullptr) 
@@ -237,11 +269,7 @@ namespace Jimara {
 					return (referencedResource != nullptr && referencedResource->HasAsset()) ? referencedResource->GetAsset()->Guid() : GUID{};
 				}();
 				GUID guid = initialGUID;
-				if (!Serialization::DeserializeFromJson(GUID_SERIALIZER->Serialize(guid), objectJson, log,
-					[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
-						if (log != nullptr) log->Error("MaterialFileAsset::DeserializeFromJson - GUID Serializer not expected to reference Object pointers!");
-						return false;
-					})) return false;
+				if (!ReadReferencedResourceId(objectJson, log, guid)) return false;
 				if (initialGUID != guid) {
 					const Reference<Asset> referencedAsset = database->FindAsset(guid);
 					const Reference<Resource> referencedResource = (referencedAsset == nullptr) ? nullptr : referencedAsset->LoadResource();
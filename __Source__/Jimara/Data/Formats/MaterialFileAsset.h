@@ -43,6 +43,12 @@ namespace Jimara {
 		/// <param name="resource"> Resource, previously loaded with LoadItem() </param>
 		virtual void ReloadExternalDependencies(Material* resource) override;
 
+		/// <summary>
+		/// Reports the resources (textures and alike), referenced by the material file
+		/// </summary>
+		/// <param name="reportDependency"> Each dependency GUID will be reported through this callback </param>
+		virtual void GetDependencies(const Callback<const GUID&>& reportDependency)const override;
+
 		/// <summary>
 		/// Stores material data to the file
 		/// </summary>
@@ -79,7 +85,7 @@ namespace Jimara {
 		class Importer;
 
 		// Lock for importer reference
-		SpinLock m_importerLock;
+		mutable SpinLock m_importerLock;
 
 		// Importer reference (Alive only while the FileSystemDB is alive and file exists; beyond that, Load/Store operations will fail miserably)
 		Importer* m_importer;
@@ -2,31 +2,71 @@
 #include "../AssetDatabase/FileSystemDatabase/FileSystemDatabase.h"
 #include "../Serialization/Helpers/ComponentHierarchySerializer.h"
 #include "../Serialization/Helpers/SerializeToJson.h"
+#include "../Serialization/Helpers/SerializeToBinary.h"
+#include "../Serialization/Helpers/ComponentHierarchyInstantiationPlan.h"
+#include "../Serialization/Helpers/SerializerMacros.h"
 #include "../../OS/IO/MMappedFile.h"
 #include <fstream>
+#include <memory>
 
 
 namespace Jimara {
-	inline static bool LoadSceneFileJson(const OS::Path& path, OS::Logger* log, nlohmann::json& json) {
-		const Reference<OS::MMappedFile> memoryMapping = OS::MMappedFile::Create(path, log);
-		if (memoryMapping == nullptr) {
-			log->Error("SceneFileAsset::LoadSceneFileJson - Failed to map file: \"", path, "\"!");
-			return false;
-		}
-		try {
+	namespace {
+		/// <summary> Scene file content (binary data is kept as-is and is read directly by DeserializeFromBinary, json gets parsed on load) </summary>
+		struct SceneFileData {
+			/// <summary> Parsed json (used if binary is nullptr) </summary>
+			nlohmann::json json;
+
+			/// <summary> Binary file content (immutable and shared between snapshots, so taking one is just a reference count bump) </summary>
+			std::shared_ptr<const std::vector<uint8_t>> binary;
+		};
+
+		inline static bool LoadSceneFileData(const OS::Path& path, OS::Logger* log, SceneFileData& data) {
+			const Reference<OS::MMappedFile> memoryMapping = OS::MMappedFile::Create(path, log);
+			if (memoryMapping == nullptr) {
+				log->Error("SceneFileAsset::LoadSceneFileData - Failed to map file: \"", path, "\"!");
+				return false;
+			}
 			MemoryBlock block(*memoryMapping);
-			json = nlohmann::json::parse(std::string_view(reinterpret_cast<const char*>(block.Data()), block.Size()));
-			return true;
+			if (Serialization::IsSerializedBinary(block)) {
+				// Bytes are copied out of the mapping, so that the file stays writable while the resource is alive:
+				const uint8_t* bytes = reinterpret_cast<const uint8_t*>(block.Data());
+				data.json = {};
+				data.binary = std::make_shared<const std::vector<uint8_t>>(bytes, bytes + block.Size());
+				return true;
+			}
+			try {
+				data.json = nlohmann::json::parse(std::string_view(reinterpret_cast<const char*>(block.Data()), block.Size()));
+				data.binary = nullptr;
+				return true;
+			}
+			catch (nlohmann::json::parse_error& err) {
+				log->Error("SceneFileAsset::LoadSceneFileData - Could not parse file: \"", path, "\"! [Error: <", err.what(), ">]");
+				return false;
+			}
 		}
-		catch (nlohmann::json::parse_error& err) {
-			log->Error("SceneFileAsset::LoadSceneFileJson - Could not parse file: \"", path, "\"! [Error: <", err.what(), ">]");
-			return false;
+
+		inline static bool DeserializeSceneFileData(
+			ComponentHierarchySerializerInput& input, const SceneFileData& data, OS::Logger* log, const std::string_view& caller) {
+			const Serialization::SerializedObject serializedObject = ComponentHierarchySerializer::Instance()->Serialize(input);
+			if (data.binary != nullptr)
+				return Serialization::DeserializeFromBinary(serializedObject, MemoryBlock(data.binary->data(), data.binary->size(), nullptr), log,
+					[&](const Serialization::SerializedObject&, const GUID&) -> bool {
+						log->Error(caller, " - ComponentHierarchySerializer is not expected to have object references!");
+						return false;
+					});
+			else return Serialization::DeserializeFromJson(serializedObject, data.json, log,
+				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
+					log->Error(caller, " - ComponentHierarchySerializer is not expected to have object references!");
+					return false;
+				});
 		}
 	}
 
 	class SceneFileAsset::Importer : public virtual FileSystemDatabase::AssetImporter {
 	private:
 		GUID m_guid = GUID::Generate();
+		StorageFormat m_storageFormat = StorageFormat::SAME_AS_SOURCE;
 		std::mutex m_assetLock;
 		Reference<SceneFileAsset> m_asset;
 
@@ -53,8 +93,8 @@ namespace Jimara {
 				InvalidateAsset(true);
 			static const std::string alreadyLoadedState = "Imported";
 			if (PreviousImportData() != alreadyLoadedState) {
-				nlohmann::json json;
-				if (!LoadSceneFileJson(AssetFilePath(), Log(), json)) 
+				SceneFileData data;
+				if (!LoadSceneFileData(AssetFilePath(), Log(), data)) 
 					return false;
 				else PreviousImportData() = alreadyLoadedState;
 			}
@@ -67,7 +107,9 @@ namespace Jimara {
 			}
 		}
 
-		inline static Reference<Importer> Get(SceneFileAsset* asset) {
+		inline StorageFormat TargetStorageFormat()const { return m_storageFormat; }
+
+		inline static Reference<Importer> Get(const SceneFileAsset* asset) {
 			std::unique_lock<SpinLock> importerLock(asset->m_importerLock);
 			Reference<Importer> importer = asset->m_importer;
 			return importer;
@@ -98,6 +140,13 @@ namespace Jimara {
 				static const Reference<const GUID::Serializer> serializer = Object::Instantiate<GUID::Serializer>("GUID", "GUID of the [sub]scene file");
 				recordElement(serializer->Serialize(importer->m_guid));
 			}
+			JIMARA_SERIALIZE_FIELDS(importer, recordElement) {
+				JIMARA_SERIALIZE_FIELD(importer->m_storageFormat, "Storage Format", "Format, the scene file gets saved in",
+					Object::Instantiate<Serialization::EnumAttribute<std::underlying_type_t<StorageFormat>>>(false,
+						"SAME_AS_SOURCE", StorageFormat::SAME_AS_SOURCE,
+						"JSON", StorageFormat::JSON,
+						"BINARY", StorageFormat::BINARY));
+			};
 		}
 
 		inline static Serializer* Instance() {
@@ -133,7 +182,14 @@ namespace Jimara {
 			mutable std::mutex dataLock;
 			mutable std::shared_mutex resourceLock;
 			std::vector<Reference<Resource>> preloadedResources;
-			nlohmann::json sceneJson;
+			SceneFileData sceneData;
+			size_t sceneDataRevision = 0u;
+
+			// Plan, compiled from the first spowned hierarchy (valid only for the sceneDataRevision and the asset database it was compiled with;
+			// database is identified by it's IdentityToken(), so that the plan does not keep it alive and never matches a new database at the same address):
+			Reference<const ComponentHierarchyInstantiationPlan> instantiationPlan;
+			size_t instantiationPlanRevision = 0u;
+			Reference<const Object> instantiationPlanDatabase;
 
 			inline void UpdatePreloadedResources(const std::vector<Reference<Resource>>& newList) {
 				std::vector<Reference<Resource>> newResources;
@@ -164,6 +220,30 @@ namespace Jimara {
 			inline virtual Reference<Component> SpownHierarchy(Component* parent) final override {
 				if (parent == nullptr) return nullptr;
 
+				// If we've already spowned the hierarchy once, we can simply replay the compiled plan:
+				const AssetDatabase* database = parent->Context()->AssetDB();
+				const Object* databaseToken = (database == nullptr) ? nullptr : database->IdentityToken();
+				{
+					const Reference<const ComponentHierarchyInstantiationPlan> plan = [&]() -> Reference<const ComponentHierarchyInstantiationPlan> {
+						std::unique_lock<std::mutex> snapshotLock(dataLock);
+						if (instantiationPlanRevision != sceneDataRevision || instantiationPlanDatabase != databaseToken) return nullptr;
+						else return instantiationPlan;
+					}();
+					if (plan != nullptr) {
+						const Reference<Component> root = plan->Instantiate(parent);
+						if (root != nullptr) return root;
+					}
+				}
+
+				// Otherwise, we need a snapshot of the scene data to deserialize:
+				size_t revision = 0u;
+				const SceneFileData snapshot = [&]() {
+					std::unique_lock<std::mutex> snapshotLock(dataLock);
+					revision = sceneDataRevision;
+					SceneFileData rv = sceneData;
+					return rv;
+				}();
+
 				ComponentHierarchySerializerInput input;
 				
 				input.rootComponent = nullptr;
@@ -176,26 +256,24 @@ namespace Jimara {
 						data->first->rootComponent = Object::Instantiate<Component>(data->second);
 					}, &onResourcesLoadedData);
 				
-				std::pair<ComponentHierarchySerializerInput*, const std::string*> onSerializationFinishedData(&input, &name);
+				// Plan gets compiled while we're still holding the update lock, before anything had a chance to modify the hierarchy:
+				struct OnSerializationFinishedData {
+					ComponentHierarchySerializerInput* input = nullptr;
+					const std::string* name = nullptr;
+					Reference<const ComponentHierarchyInstantiationPlan> plan;
+				} onSerializationFinishedData;
+				onSerializationFinishedData.input = &input;
+				onSerializationFinishedData.name = &name;
 				typedef void(*OnSerializationFinishedCallback)(decltype(onSerializationFinishedData)*);
 				input.onSerializationFinished = Callback(
 					(OnSerializationFinishedCallback)[](decltype(onSerializationFinishedData)* data) {
-						if (data->first->rootComponent != nullptr)
-							data->first->rootComponent->Name() = *data->second;
+						if (data->input->rootComponent == nullptr) return;
+						data->input->rootComponent->Name() = *data->name;
+						data->plan = ComponentHierarchyInstantiationPlan::Compile(data->input->rootComponent);
 					}, &onSerializationFinishedData);
 
-				const nlohmann::json snapshot = [&]() {
-					std::unique_lock<std::mutex> snapshotLock(dataLock);
-					nlohmann::json rv = sceneJson;
-					return rv;
-				}();
-
-				if (!Serialization::DeserializeFromJson(ComponentHierarchySerializer::Instance()->Serialize(input), snapshot, parent->Context()->Log(),
-					[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
-						parent->Context()->Log()->Error(
-							"SceneFileAsset::SceneFileAssetResource::SpownHierarchy - ComponentHierarchySerializer is not expected to have object references!");
-						return false;
-					}))
+				const bool deserialized = DeserializeSceneFileData(input, snapshot, parent->Context()->Log(), "SceneFileAsset::SceneFileAssetResource::SpownHierarchy");
+				if (!deserialized)
 					parent->Context()->Log()->Error("SceneFileAsset::SceneFileAssetResource::SpownHierarchy - Failed to deserialize Hierarchy! (Spowned data may be incomplete)");
 				else if (input.rootComponent == nullptr)
 					parent->Context()->Log()->Error("SceneFileAsset::SceneFileAssetResource::SpownHierarchy - Failed to create Hierarchy!");
@@ -203,26 +281,58 @@ namespace Jimara {
 				{
 					std::unique_lock<std::mutex> snapshotLock(dataLock);
 					UpdatePreloadedResources(std::move(input.resources));
+					if (deserialized && onSerializationFinishedData.plan != nullptr && sceneDataRevision == revision) {
+						instantiationPlan = onSerializationFinishedData.plan;
+						instantiationPlanRevision = revision;
+						instantiationPlanDatabase = databaseToken;
+					}
 				}
 
 				return input.rootComponent;
 			}
 
 			virtual void StoreHierarchyData(Component* parent) final override {
-				nlohmann::json snapshot;
+				SceneFileData snapshot;
 				ComponentHierarchySerializerInput input;
 
-				if (parent == nullptr)
-					snapshot = {};
+				// Hierarchy data is stored in the format, requested by the importer (or the one the scene file came in):
+				const bool storeBinary = [&]() {
+					const SceneFileAsset* asset = dynamic_cast<const SceneFileAsset*>(GetAsset());
+					const SceneFileAsset::StorageFormat format = (asset == nullptr) 
+						? SceneFileAsset::StorageFormat::SAME_AS_SOURCE : asset->TargetStorageFormat();
+					if (format != SceneFileAsset::StorageFormat::SAME_AS_SOURCE)
+						return format == SceneFileAsset::StorageFormat::BINARY;
+					std::unique_lock<std::mutex> snapshotLock(dataLock);
+					return sceneData.binary != nullptr;
+				}();
+
+				if (parent == nullptr) {
+					bool error = false;
+					if (storeBinary)
+						snapshot.binary = std::make_shared<const std::vector<uint8_t>>(Serialization::SerializeToBinary(
+							ComponentHierarchySerializer::Instance()->Serialize(input), nullptr, error,
+							[&](const Serialization::SerializedObject&, bool&) -> GUID { return {}; }));
+					else snapshot.json = {};
+				}
 				else {
 					input.rootComponent = parent;
 					bool error = false;
-					snapshot = Serialization::SerializeToJson(
+					auto onObjectReference = [&](bool& error) {
+						parent->Context()->Log()->Error(
+							"SceneFileAsset::SceneFileAssetResource::StoreHierarchyData - ComponentHierarchySerializer is not expected to have any Component references!");
+						error = true;
+					};
+					if (storeBinary)
+						snapshot.binary = std::make_shared<const std::vector<uint8_t>>(Serialization::SerializeToBinary(
+							ComponentHierarchySerializer::Instance()->Serialize(input), parent->Context()->Log(), error,
+							[&](const Serialization::SerializedObject&, bool& error) -> GUID {
+								onObjectReference(error);
+								return {};
+							}));
+					else snapshot.json = Serialization::SerializeToJson(
 						ComponentHierarchySerializer::Instance()->Serialize(input), parent->Context()->Log(), error,
 						[&](const Serialization::SerializedObject&, bool& error) -> nlohmann::json {
-							parent->Context()->Log()->Error(
-								"SceneFileAsset::SceneFileAssetResource::StoreHierarchyData - ComponentHierarchySerializer is not expected to have any Component references!");
-							error = true;
+							onObjectReference(error);
 							return {};
 						});
 					if (error) {
@@ -234,7 +344,10 @@ namespace Jimara {
 				{
 					std::unique_lock<std::mutex> snapshotLock(dataLock);
 					UpdatePreloadedResources(input.resources);
-					sceneJson = std::move(snapshot);
+					sceneData = std::move(snapshot);
+					sceneDataRevision++;
+					instantiationPlan = nullptr;
+					instantiationPlanDatabase = nullptr;
 				}
 			}
 		};
@@ -245,8 +358,8 @@ namespace Jimara {
 		if (importer == nullptr) return nullptr;
 
 		const OS::Path path = importer->AssetFilePath();
-		nlohmann::json json;
-		if (!LoadSceneFileJson(path, importer->Log(), json)) return nullptr;
+		SceneFileData data;
+		if (!LoadSceneFileData(path, importer->Log(), data)) return nullptr;
 
 		// Preload resources:
 		ComponentHierarchySerializerInput input;
@@ -254,22 +367,37 @@ namespace Jimara {
 			input.assetDatabase = m_importer;
 			auto lambda = [&](const Asset::LoadInfo& info) { ReportProgress(info); };
 			input.reportProgress = Callback<Asset::LoadInfo>::FromCall(&lambda);
-			if (!Serialization::DeserializeFromJson(ComponentHierarchySerializer::Instance()->Serialize(input), json, importer->Log(),
-				[&](const Serialization::SerializedObject&, const nlohmann::json&) -> bool {
-					importer->Log()->Error(
-						"SceneFileAsset::LoadItem - ComponentHierarchySerializer is not expected to have object references!");
-					return false;
-				}))
+			if (!DeserializeSceneFileData(input, data, importer->Log(), "SceneFileAsset::LoadItem"))
 				importer->Log()->Error("SceneFileAsset::LoadItem - Failed to preload assets!");
 		}
 
 		const std::string name = OS::Path(path.stem());
 		Reference<SceneFileAssetResource> resource = Object::Instantiate<SceneFileAssetResource>(name);
 		resource->UpdatePreloadedResources(input.resources);
-		resource->sceneJson = std::move(json);
+		resource->sceneData = std::move(data);
 		return resource;
 	}
 
+	void SceneFileAsset::GetDependencies(const Callback<const GUID&>& reportDependency)const {
+		const Reference<Importer> importer = Importer::Get(this);
+		if (importer == nullptr) return;
+
+		// If the scene is loaded, it's data may have been modified since it was last stored, so that is preferred over the file:
+		SceneFileData data;
+		const Reference<SceneFileAssetResource> resource = GetLoadedAs<SceneFileAssetResource>();
+		if (resource != nullptr) {
+			std::unique_lock<std::mutex> lock(resource->dataLock);
+			data = resource->sceneData;
+		}
+		else if (!LoadSceneFileData(importer->AssetFilePath(), importer->Log(), data)) return;
+
+		// With no root component, context or database, the serializer only restores the resource GUIDs and stops:
+		ComponentHierarchySerializerInput input;
+		input.reportResourceId = reportDependency;
+		if (!DeserializeSceneFileData(input, data, importer->Log(), "SceneFileAsset::GetDependencies"))
+			importer->Log()->Warning("SceneFileAsset::GetDependencies - Failed to read resource list! (dependencies may be incomplete)");
+	}
+
 	void SceneFileAsset::Store(EditableComponentHierarchySpowner* resource) {
 		const Reference<const Importer> importer = Importer::Get(this);
 		if (importer == nullptr) return;
@@ -280,19 +408,31 @@ namespace Jimara {
 			return;
 		}
 
+		const std::shared_ptr<const std::vector<uint8_t>> binary = [&]() {
+			std::unique_lock<std::mutex> lock(sceneResource->dataLock);
+			return sceneResource->sceneData.binary;
+		}();
+
 		const OS::Path assetPath = importer->AssetFilePath();
-		std::ofstream fileStream((const std::filesystem::path&)assetPath);
+		std::ofstream fileStream((const std::filesystem::path&)assetPath, (binary != nullptr) ? (std::ios::out | std::ios::binary) : std::ios::out);
 		if ((!fileStream.is_open()) || (fileStream.bad())) {
 			importer->Log()->Error("SceneFileAsset::Store - Could not open \"", assetPath, "\" for writing!");
 			return;
 		}
-		{
+		if (binary != nullptr)
+			fileStream.write(reinterpret_cast<const char*>(binary->data()), binary->size());
+		else {
 			std::unique_lock<std::mutex> lock(sceneResource->dataLock);
-			fileStream << sceneResource->sceneJson.dump(1, '\t') << std::endl;
+			fileStream << sceneResource->sceneData.json.dump(1, '\t') << std::endl;
 		}
 		fileStream.close();
 	}
 
+	SceneFileAsset::StorageFormat SceneFileAsset::TargetStorageFormat()const {
+		const Reference<const Importer> importer = Importer::Get(this);
+		return (importer == nullptr) ? StorageFormat::SAME_AS_SOURCE : importer->TargetStorageFormat();
+	}
+
 	SceneFileAsset::SceneFileAsset(const GUID& guid, Importer* importer) 
 		: Asset(guid), m_importer(importer) {}
 }
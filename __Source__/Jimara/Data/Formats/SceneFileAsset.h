@@ -35,6 +35,31 @@ namespace Jimara {
 		/// <summary> Scene files do have external dependencies </summary>
 		inline virtual bool HasRecursiveDependencies()const final override { return true; }
 
+		/// <summary>
+		/// Reports the resources, referenced by the scene (parsed from the file, or from the loaded scene data, if the resource is alive)
+		/// </summary>
+		/// <param name="reportDependency"> Each dependency GUID will be reported through this callback </param>
+		virtual void GetDependencies(const Callback<const GUID&>& reportDependency)const override;
+
+		/// <summary> Format, the scene file is stored in </summary>
+		enum class StorageFormat : uint8_t {
+			/// <summary> Whatever format the scene file has been loaded from (default) </summary>
+			SAME_AS_SOURCE = 0u,
+
+			/// <summary> Human-readable json </summary>
+			JSON = 1u,
+
+			/// <summary> Binary SerializedObject format (considerably faster to load; see SerializeToBinary.h) </summary>
+			BINARY = 2u
+		};
+
+		/// <summary>
+		/// Format, the scene will be saved in by the next Store() call
+		/// <para/> Configured through the "Storage Format" field of the importer metadata; 
+		///		that's how a json scene gets converted to binary (or back) - change the field and save the scene.
+		/// </summary>
+		StorageFormat TargetStorageFormat()const;
+
 	protected:
 		/// <summary>
 		/// Loads scene tree data from the file
@@ -53,7 +78,7 @@ namespace Jimara {
 		class Importer;
 
 		// Lock for importer reference
-		SpinLock m_importerLock;
+		mutable SpinLock m_importerLock;
 
 		// Importer reference (Alive only while the FileSystemDB is alive and file exists; beyond that, Load/Store operations will fail miserably)
 		Importer* m_importer;
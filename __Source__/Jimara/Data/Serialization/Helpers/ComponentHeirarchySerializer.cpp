@@ -456,6 +456,8 @@ namespace Jimara {
 		{
 			// Collect resources:
 			recordElement(ResourceCollection::Serializer::Instance()->Serialize(resources));
+			for (size_t i = 0; i < resources.guids.size(); i++)
+				input->reportResourceId(resources.guids[i]);
 			Reference<AssetDatabase> database = (context == nullptr) ? input->assetDatabase : Reference<AssetDatabase>(context->AssetDB());
 			resources.CollectResources(input, database);
 		}
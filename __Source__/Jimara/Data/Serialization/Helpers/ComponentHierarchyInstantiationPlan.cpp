@@ -0,0 +1,352 @@
+#include "ComponentHierarchyInstantiationPlan.h"
+#include "../../AssetDatabase/AssetDatabase.h"
+#include <unordered_map>
+#include <cstring>
+
+
+namespace Jimara {
+	struct ComponentHierarchyInstantiationPlan::Data {
+		// Single component within the plan (stored in depth-first preorder)
+		struct Node {
+			Reference<const ComponentFactory> factory;
+			size_t childCount = 0u;
+			size_t firstField = 0u;
+			size_t fieldCount = 0u;
+		};
+
+		// How FieldRecord::value should be interpreted for OBJECT_REFERENCE_VALUE fields
+		enum class ReferenceKind : uint8_t {
+			NONE = 0,
+			COMPONENT_INDEX = 1,
+			OBJECT = 2
+		};
+
+		// Single recorded field (SERIALIZER_LIST entries are followed by their own fields, subtreeSize of them)
+		struct FieldRecord {
+			Reference<const Serialization::ItemSerializer> serializer;
+			Serialization::ItemSerializer::Type type = Serialization::ItemSerializer::Type::SERIALIZER_TYPE_COUNT;
+			ReferenceKind referenceKind = ReferenceKind::NONE;
+			size_t name = 0u;
+			size_t value = 0u;
+			size_t subtreeSize = 0u;
+		};
+
+		// Factory set is kept alive to make sure the factories do not go out of scope
+		Reference<const ComponentFactory::Set> factories;
+
+		// Components and fields
+		std::vector<Node> nodes;
+		std::vector<FieldRecord> fields;
+
+		// Value storage (plain values are stored as raw bytes)
+		std::vector<uint8_t> valueData;
+		std::vector<std::string> strings;
+		std::vector<std::wstring> wideStrings;
+		std::vector<Reference<Object>> references;
+	};
+
+	struct ComponentHierarchyInstantiationPlan::Helpers {
+		typedef Serialization::ItemSerializer::Type Type;
+
+		// State, used during Compile() call
+		struct Compiler {
+			Data& data;
+			std::unordered_map<Component*, size_t> componentIndex;
+			std::unordered_map<std::string, size_t> nameIndex;
+
+			inline size_t NameId(const std::string& name) {
+				const auto it = nameIndex.find(name);
+				if (it != nameIndex.end()) return it->second;
+				const size_t id = data.strings.size();
+				data.strings.push_back(name);
+				nameIndex[name] = id;
+				return id;
+			}
+		};
+
+		template<typename ValueType>
+		inline static void RecordValue(Compiler& compiler, const Serialization::SerializedObject& object, Data::FieldRecord& record) {
+			const ValueType value = object.operator ValueType();
+			record.value = compiler.data.valueData.size();
+			compiler.data.valueData.resize(record.value + sizeof(ValueType));
+			std::memcpy(compiler.data.valueData.data() + record.value, &value, sizeof(ValueType));
+		}
+
+		template<typename ValueType>
+		inline static void ApplyValue(const Data& data, const Serialization::SerializedObject& object, const Data::FieldRecord& record) {
+			ValueType value;
+			std::memcpy(&value, data.valueData.data() + record.value, sizeof(ValueType));
+			object = value;
+		}
+
+		inline static void RecordObjectReference(Compiler& compiler, const Serialization::SerializedObject& object, Data::FieldRecord& record) {
+			const Reference<Object> value = object.GetObjectValue();
+			if (value == nullptr) return;
+			{
+				Component* component = dynamic_cast<Component*>(value.operator->());
+				if (component != nullptr) {
+					const auto it = compiler.componentIndex.find(component);
+					if (it != compiler.componentIndex.end()) {
+						record.referenceKind = Data::ReferenceKind::COMPONENT_INDEX;
+						record.value = it->second;
+						return;
+					}
+				}
+			}
+			{
+				Resource* resource = dynamic_cast<Resource*>(value.operator->());
+				if ((resource != nullptr && resource->HasAsset()) || dynamic_cast<Asset*>(value.operator->()) != nullptr) {
+					record.referenceKind = Data::ReferenceKind::OBJECT;
+					record.value = compiler.data.references.size();
+					compiler.data.references.push_back(value);
+				}
+			}
+		}
+
+		inline static void ApplyObjectReference(
+			const Data& data, const std::vector<Reference<Component>>& components,
+			const Serialization::SerializedObject& object, const Data::FieldRecord& record) {
+			const Serialization::ObjectReferenceSerializer* serializer = object.As<Serialization::ObjectReferenceSerializer>();
+			if (serializer == nullptr) return;
+			Object* value =
+				(record.referenceKind == Data::ReferenceKind::COMPONENT_INDEX) ? static_cast<Object*>(components[record.value].operator->()) :
+				(record.referenceKind == Data::ReferenceKind::OBJECT) ? data.references[record.value].operator->() : nullptr;
+			if (value != nullptr && (!serializer->ReferencedValueType().CheckType(value))) return;
+			serializer->SetObjectValue(value, object.TargetAddr());
+		}
+
+		typedef void(*RecordValueFn)(Compiler&, const Serialization::SerializedObject&, Data::FieldRecord&);
+		typedef void(*ApplyValueFn)(const Data&, const Serialization::SerializedObject&, const Data::FieldRecord&);
+		struct ValueFunctions {
+			RecordValueFn record = nullptr;
+			ApplyValueFn apply = nullptr;
+		};
+
+		inline static const ValueFunctions* VALUE_FUNCTIONS() {
+			static const ValueFunctions* const functions = []() -> const ValueFunctions* {
+				const constexpr size_t TYPE_COUNT = static_cast<size_t>(Type::SERIALIZER_TYPE_COUNT);
+				static ValueFunctions table[TYPE_COUNT];
+
+				static const RecordValueFn recordNothing = [](Compiler&, const Serialization::SerializedObject&, Data::FieldRecord&) {};
+				static const ApplyValueFn applyNothing = [](const Data&, const Serialization::SerializedObject&, const Data::FieldRecord&) {};
+				for (size_t i = 0; i < TYPE_COUNT; i++)
+					table[i] = ValueFunctions{ recordNothing, applyNothing };
+
+#define JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(type, valueType) \
+				table[static_cast<size_t>(Type::type)] = ValueFunctions{ RecordValue<valueType>, ApplyValue<valueType> }
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(BOOL_VALUE, bool);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(CHAR_VALUE, char);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(SCHAR_VALUE, signed char);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(UCHAR_VALUE, unsigned char);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(WCHAR_VALUE, wchar_t);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(SHORT_VALUE, short);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(USHORT_VALUE, unsigned short);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(INT_VALUE, int);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(UINT_VALUE, unsigned int);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(LONG_VALUE, long);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(ULONG_VALUE, unsigned long);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(LONG_LONG_VALUE, long long);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(ULONG_LONG_VALUE, unsigned long long);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(FLOAT_VALUE, float);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(DOUBLE_VALUE, double);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(VECTOR2_VALUE, Vector2);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(VECTOR3_VALUE, Vector3);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(VECTOR4_VALUE, Vector4);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(MATRIX2_VALUE, Matrix2);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(MATRIX3_VALUE, Matrix3);
+				JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE(MATRIX4_VALUE, Matrix4);
+#undef JIMARA_INSTANTIATION_PLAN_PLAIN_VALUE
+
+				table[static_cast<size_t>(Type::STRING_VIEW_VALUE)] = ValueFunctions{
+					[](Compiler& compiler, const Serialization::SerializedObject& object, Data::FieldRecord& record) {
+						record.value = compiler.data.strings.size();
+						compiler.data.strings.push_back(std::string(object.operator std::string_view()));
+					},
+					[](const Data& data, const Serialization::SerializedObject& object, const Data::FieldRecord& record) {
+						object = std::string_view(data.strings[record.value]);
+					} };
+				table[static_cast<size_t>(Type::WSTRING_VIEW_VALUE)] = ValueFunctions{
+					[](Compiler& compiler, const Serialization::SerializedObject& object, Data::FieldRecord& record) {
+						record.value = compiler.data.wideStrings.size();
+						compiler.data.wideStrings.push_back(std::wstring(object.operator std::wstring_view()));
+					},
+					[](const Data& data, const Serialization::SerializedObject& object, const Data::FieldRecord& record) {
+						object = std::wstring_view(data.wideStrings[record.value]);
+					} };
+				table[static_cast<size_t>(Type::OBJECT_REFERENCE_VALUE)].record = RecordObjectReference;
+				return table;
+			}();
+			return functions;
+		}
+
+		inline static void RecordFields(Compiler& compiler, const Serialization::SerializedObject& object) {
+			object.GetFields([&](const Serialization::SerializedObject& field) {
+				const Serialization::ItemSerializer* serializer = field.Serializer();
+				if (serializer == nullptr) return;
+				const size_t recordIndex = compiler.data.fields.size();
+				{
+					Data::FieldRecord record;
+					record.serializer = serializer;
+					record.type = serializer->GetType();
+					record.name = compiler.NameId(serializer->TargetName());
+					compiler.data.fields.push_back(record);
+				}
+				if (compiler.data.fields[recordIndex].type == Type::SERIALIZER_LIST) {
+					RecordFields(compiler, field);
+					compiler.data.fields[recordIndex].subtreeSize = (compiler.data.fields.size() - recordIndex - 1u);
+				}
+				else if (compiler.data.fields[recordIndex].type < Type::SERIALIZER_TYPE_COUNT) {
+					Data::FieldRecord record = compiler.data.fields[recordIndex];
+					VALUE_FUNCTIONS()[static_cast<size_t>(record.type)].record(compiler, field, record);
+					compiler.data.fields[recordIndex] = record;
+				}
+			});
+		}
+
+		inline static void CollectComponents(Compiler& compiler, Component* component, std::vector<Component*>& components) {
+			compiler.componentIndex[component] = components.size();
+			components.push_back(component);
+			Data::Node node;
+			node.factory = compiler.data.factories->FindFactory(component);
+			if (node.factory == nullptr)
+				node.factory = TypeId::Of<Component>().FindAttributeOfType<ComponentFactory>();
+			node.childCount = component->ChildCount();
+			compiler.data.nodes.push_back(node);
+			for (size_t i = 0; i < component->ChildCount(); i++)
+				CollectComponents(compiler, component->GetChild(i), components);
+		}
+
+		inline static void ApplyFields(
+			const Data& data, const std::vector<Reference<Component>>& components,
+			const Serialization::SerializedObject& object, size_t first, size_t end) {
+			auto nextRecord = [&](size_t index) { return index + 1u + data.fields[index].subtreeSize; };
+
+			// Fields are normally reported in the same order as during Compile(), so we just move the cursor forward;
+			// If they are not, we fall back to a linear search and start tracking the consumed records:
+			size_t cursor = first;
+			std::vector<bool> consumed;
+
+			object.GetFields([&](const Serialization::SerializedObject& field) {
+				const Serialization::ItemSerializer* serializer = field.Serializer();
+				if (serializer == nullptr) return;
+				auto matches = [&](size_t index) {
+					if (consumed.size() > 0u && consumed[index - first]) return false;
+					const Data::FieldRecord& record = data.fields[index];
+					return record.serializer == serializer || (record.type == serializer->GetType() && data.strings[record.name] == serializer->TargetName());
+				};
+
+				size_t match = end;
+				if (cursor < end && matches(cursor))
+					match = cursor;
+				else {
+					for (size_t i = first; i < end; i = nextRecord(i))
+						if (matches(i)) {
+							match = i;
+							break;
+						}
+					if (match >= end) return;
+					if (consumed.size() <= 0u) {
+						consumed.resize(end - first, false);
+						for (size_t i = first; i < cursor; i = nextRecord(i))
+							consumed[i - first] = true;
+					}
+				}
+				if (consumed.size() > 0u)
+					consumed[match - first] = true;
+				cursor = nextRecord(match);
+
+				const Data::FieldRecord& record = data.fields[match];
+				if (record.type != serializer->GetType()) return;
+				else if (record.type == Type::SERIALIZER_LIST)
+					ApplyFields(data, components, field, match + 1u, nextRecord(match));
+				else if (record.type == Type::OBJECT_REFERENCE_VALUE)
+					ApplyObjectReference(data, components, field, record);
+				else if (record.type < Type::SERIALIZER_TYPE_COUNT)
+					VALUE_FUNCTIONS()[static_cast<size_t>(record.type)].apply(data, field, record);
+			});
+		}
+
+		inline static void CreateComponents(
+			const Data& data, Component* parent, Component* existing, size_t& nodeIndex, std::vector<Reference<Component>>& components) {
+			const Data::Node& node = data.nodes[nodeIndex];
+			Reference<Component> component;
+			if (existing != nullptr && data.factories->FindFactory(existing) == node.factory.operator->())
+				component = existing;
+			else {
+				component = node.factory->CreateInstance(parent);
+				if (component == nullptr) {
+					parent->Context()->Log()->Error(
+						"ComponentHierarchyInstantiationPlan::Helpers::CreateComponents - Failed to create component of type: ", node.factory->InstanceType().Name(), "!");
+					component = Object::Instantiate<Component>(parent, "Component");
+				}
+				if (existing != nullptr) {
+					const size_t childIndex = existing->IndexInParent();
+					while (existing->ChildCount() > 0)
+						existing->GetChild(0)->SetParent(component);
+					existing->Destroy();
+					component->SetIndexInParent(childIndex);
+				}
+			}
+			components[nodeIndex] = component;
+			nodeIndex++;
+
+			// Children may already be created by the component's constructor; we reuse those if the types match:
+			const size_t initialChildCount = component->ChildCount();
+			for (size_t i = 0; i < node.childCount; i++)
+				CreateComponents(data, component, (i < initialChildCount && i < component->ChildCount()) ? component->GetChild(i) : nullptr, nodeIndex, components);
+			for (size_t i = component->ChildCount(); i > node.childCount; i--)
+				component->GetChild(i - 1u)->Destroy();
+		}
+	};
+
+	Reference<ComponentHierarchyInstantiationPlan> ComponentHierarchyInstantiationPlan::Compile(Component* root) {
+		if (root == nullptr || root->Destroyed()) return nullptr;
+		std::unique_ptr<Data> data = std::make_unique<Data>();
+		data->factories = ComponentFactory::All();
+		Helpers::Compiler compiler{ *data };
+
+		std::vector<Component*> components;
+		Helpers::CollectComponents(compiler, root, components);
+
+		static const Serialization::Serializable::Serializer serializer("Component Serializer");
+		for (size_t i = 0; i < components.size(); i++) {
+			Data::Node& node = data->nodes[i];
+			node.firstField = data->fields.size();
+			Helpers::RecordFields(compiler, serializer.Serialize(components[i]));
+			node.fieldCount = (data->fields.size() - node.firstField);
+		}
+
+		const Reference<ComponentHierarchyInstantiationPlan> plan = new ComponentHierarchyInstantiationPlan(std::move(data));
+		plan->ReleaseRef();
+		return plan;
+	}
+
+	ComponentHierarchyInstantiationPlan::ComponentHierarchyInstantiationPlan(std::unique_ptr<Data>&& data)
+		: m_data(std::move(data)) {}
+
+	ComponentHierarchyInstantiationPlan::~ComponentHierarchyInstantiationPlan() {}
+
+	size_t ComponentHierarchyInstantiationPlan::ComponentCount()const {
+		return m_data->nodes.size();
+	}
+
+	Reference<Component> ComponentHierarchyInstantiationPlan::Instantiate(Component* parent)const {
+		if (parent == nullptr || parent->Destroyed() || m_data->nodes.size() <= 0u) return nullptr;
+		std::unique_lock<std::recursive_mutex> lock(parent->Context()->UpdateLock());
+
+		// Create components:
+		std::vector<Reference<Component>> components(m_data->nodes.size());
+		size_t nodeIndex = 0u;
+		Helpers::CreateComponents(*m_data, parent, nullptr, nodeIndex, components);
+
+		// Apply fields (after the whole tree exists, so that internal references can be resolved):
+		static const Serialization::Serializable::Serializer serializer("Component Serializer");
+		for (size_t i = 0; i < components.size(); i++) {
+			Component* component = components[i];
+			if (component == nullptr || component->Destroyed()) continue;
+			const Data::Node& node = m_data->nodes[i];
+			Helpers::ApplyFields(*m_data, components, serializer.Serialize(component), node.firstField, node.firstField + node.fieldCount);
+		}
+		return components[0];
+	}
+}
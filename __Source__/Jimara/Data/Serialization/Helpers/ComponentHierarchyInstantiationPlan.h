@@ -0,0 +1,56 @@
+#pragma once
+#include "../../../Components/Component.h"
+
+
+namespace Jimara {
+	/// <summary>
+	/// Flat, "pre-compiled" representation of a component hierarchy, that can be replayed to spown copies of it quickly
+	/// <para/> Plan is captured from a live subtree and stores:
+	///		<para/> 0. Component factories in the depth-first order of the ComponentHierarchySerializer, alongside the child counts;
+	///		<para/> 1. Per-component field values in the order the component serializers report them;
+	///		<para/> 2. Object references as indices within the hierarchy or as already resolved Resource/Asset references.
+	/// <para/> Instantiate() simply creates the components through the factories and feeds the recorded values to their serializers;
+	///		there is no type-name lookup, no GUID resolution and no resource loading involved.
+	/// <para/> Notes:
+	///		<para/> 0. Field values are matched to the serializers by identity (static serializers) or by name and type,
+	///			so the components are free to report fields conditionally, just like they would with the json/binary serialization;
+	///		<para/> 1. Objects outside the hierarchy, that are neither Resources with assets nor Assets, are not captured (same as with ComponentHierarchySerializer);
+	///		<para/> 2. The plan keeps the referenced Resources/Assets alive.
+	/// </summary>
+	class JIMARA_API ComponentHierarchyInstantiationPlan : public virtual Object {
+	public:
+		/// <summary>
+		/// Captures the plan from a component subtree
+		/// <para/> Note: Update lock of the root component's context should be held by the caller
+		///		(normally, this is invoked right after the subtree gets deserialized, before any update could have changed it's state).
+		/// </summary>
+		/// <param name="root"> Root of the subtree </param>
+		/// <returns> New plan (nullptr if root is nullptr or destroyed) </returns>
+		static Reference<ComponentHierarchyInstantiationPlan> Compile(Component* root);
+
+		/// <summary> Virtual destructor </summary>
+		virtual ~ComponentHierarchyInstantiationPlan();
+
+		/// <summary> Number of components within the plan </summary>
+		size_t ComponentCount()const;
+
+		/// <summary>
+		/// Creates a new copy of the captured hierarchy
+		/// <para/> Note: Locks parent's context update lock for the duration of the call.
+		/// </summary>
+		/// <param name="parent"> Parent component for the new subtree </param>
+		/// <returns> Root of the new subtree (nullptr if parent is nullptr or destroyed) </returns>
+		Reference<Component> Instantiate(Component* parent)const;
+
+	private:
+		// Underlying data
+		struct Data;
+		const std::unique_ptr<Data> m_data;
+
+		// Constructor
+		ComponentHierarchyInstantiationPlan(std::unique_ptr<Data>&& data);
+
+		// Actual implementation resides in here
+		struct Helpers;
+	};
+}
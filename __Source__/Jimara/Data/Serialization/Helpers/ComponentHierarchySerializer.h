@@ -112,6 +112,12 @@ namespace Jimara {
 		/// </summary>
 		Callback<> onResourcesLoaded = Callback(Unused<>);
 
+		/// <summary>
+		/// Invoked for each resource GUID, recorded or restored during Resource collection step (before the resources get loaded)
+		/// <para /> Note: Useful for discovering asset dependencies without loading anything (leave rootComponent, context and assetDatabase as nullptr for that).
+		/// </summary>
+		Callback<const GUID&> reportResourceId = Callback(Unused<const GUID&>);
+
 		/// <summary>
 		/// Invoked after serialization is done
 		/// <para /> Note: Only benefit of ever using this one is that it's invoked while the serializer is still holding the update lock and, 
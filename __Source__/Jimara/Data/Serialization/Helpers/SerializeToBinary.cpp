@@ -0,0 +1,672 @@
+#include "SerializeToBinary.h"
+#include "../../../Core/Helpers.h"
+#include <unordered_map>
+#include <string_view>
+#include <type_traits>
+#include <cstring>
+#include <deque>
+
+
+namespace Jimara {
+	namespace Serialization {
+		namespace {
+			static const constexpr char BINARY_MAGIC[] = { 'J', 'I', 'M', 'A', 'R', 'A', 'S', 'B' };
+			static const constexpr uint32_t BINARY_VERSION = 1u;
+			static const constexpr uint32_t BINARY_ENDIANNESS = 0x01020304u;
+			static const constexpr size_t MAX_INDEX = static_cast<size_t>(~uint32_t(0u));
+
+			// File header (sections follow in the same order as the counts, each one starting at an 8-byte boundary)
+			struct BinaryHeader {
+				char magic[sizeof(BINARY_MAGIC)];
+				uint32_t version;
+				uint32_t endianness;
+				uint32_t stringCount;
+				uint32_t guidCount;
+				uint32_t nodeCount;
+				uint32_t fieldCount;
+				uint64_t stringDataSize;
+				uint64_t floatCount;
+			};
+			static_assert(sizeof(BinaryHeader) == 48u);
+
+			// Value kinds (numbers are stored in the widest type of the same category, vectors and matrices as float ranges)
+			enum class NodeKind : uint8_t {
+				NONE = 0,
+				BOOL = 1,
+				SIGNED = 2,
+				UNSIGNED = 3,
+				REAL = 4,
+				FLOAT_ARRAY = 5,
+				STRING = 6,
+				WSTRING = 7,
+				LIST = 8,
+				GUID_VALUE = 9,
+				OBJECT_REFERENCE = 10
+			};
+
+			// Single serialized value;
+			// value is the number itself for BOOL/SIGNED/UNSIGNED/REAL, first float index for FLOAT_ARRAY, string index for STRING/WSTRING,
+			// first field index for LIST and GUID index for GUID_VALUE/OBJECT_REFERENCE; count is the number of floats/fields.
+			struct BinaryNode {
+				NodeKind kind;
+				uint8_t padding[3];
+				uint32_t count;
+				uint64_t value;
+			};
+			static_assert(sizeof(BinaryNode) == 16u);
+
+			// Named entry of a LIST node (index is the occurence index of the same name within the list, just like "name[index]" keys in json)
+			struct BinaryField {
+				uint32_t name;
+				uint32_t index;
+				uint32_t node;
+			};
+			static_assert(sizeof(BinaryField) == 12u);
+
+			inline static constexpr size_t AlignedSize(size_t size) { return (size + 7u) & ~size_t(7u); }
+
+			// Section offsets, derived from the header
+			struct BinaryLayout {
+				size_t stringOffsets = 0u;
+				size_t stringData = 0u;
+				size_t guids = 0u;
+				size_t nodes = 0u;
+				size_t fields = 0u;
+				size_t floats = 0u;
+				size_t totalSize = 0u;
+
+				inline BinaryLayout(const BinaryHeader& header) {
+					stringOffsets = AlignedSize(sizeof(BinaryHeader));
+					stringData = AlignedSize(stringOffsets + sizeof(uint32_t) * (static_cast<size_t>(header.stringCount) + 1u));
+					guids = AlignedSize(stringData + static_cast<size_t>(header.stringDataSize));
+					nodes = AlignedSize(guids + sizeof(GUID) * static_cast<size_t>(header.guidCount));
+					fields = AlignedSize(nodes + sizeof(BinaryNode) * static_cast<size_t>(header.nodeCount));
+					floats = AlignedSize(fields + sizeof(BinaryField) * static_cast<size_t>(header.fieldCount));
+					totalSize = floats + sizeof(float) * static_cast<size_t>(header.floatCount);
+				}
+			};
+
+			inline static uint64_t DoubleBits(double value) {
+				uint64_t bits;
+				std::memcpy(&bits, &value, sizeof(bits));
+				return bits;
+			}
+
+			inline static double BitsToDouble(uint64_t bits) {
+				double value;
+				std::memcpy(&value, &bits, sizeof(value));
+				return value;
+			}
+
+
+
+			class BinaryWriter {
+			public:
+				inline BinaryWriter(OS::Logger* log, bool& err, const Function<GUID, const SerializedObject&, bool&>& objectPtr)
+					: logger(log), error(err), serializerObjectPtr(objectPtr) {}
+
+				inline uint32_t Write(const SerializedObject& object) {
+					const uint32_t nodeId = static_cast<uint32_t>(nodes.size());
+					nodes.push_back(BinaryNode{});
+					BinaryNode node = {};
+					const ItemSerializer* serializer = object.Serializer();
+					if (serializer == nullptr) {
+						if (logger != nullptr)
+							logger->Error("SerializeToBinary - Null serializer provided!");
+						error = true;
+					}
+					else {
+						const ItemSerializer::Type type = serializer->GetType();
+						if (type < ItemSerializer::Type::OBJECT_REFERENCE_VALUE)
+							VALUE_WRITERS()[static_cast<size_t>(type)](*this, object, node);
+						else if (type == ItemSerializer::Type::OBJECT_REFERENCE_VALUE) {
+							node.kind = NodeKind::OBJECT_REFERENCE;
+							node.value = GuidId(serializerObjectPtr(object, error));
+						}
+						else if (type == ItemSerializer::Type::SERIALIZER_LIST) {
+							if (object.TargetAddr() != nullptr && object.As<GUID::Serializer>() != nullptr) {
+								node.kind = NodeKind::GUID_VALUE;
+								node.value = GuidId(*static_cast<const GUID*>(object.TargetAddr()));
+							}
+							else WriteList(object, node);
+						}
+						else {
+							if (logger != nullptr)
+								logger->Error("SerializeToBinary - Serializer type out of bounds!", static_cast<size_t>(type), "!");
+							error = true;
+						}
+					}
+					nodes[nodeId] = node;
+					return nodeId;
+				}
+
+				inline std::vector<uint8_t> Finish() {
+					size_t stringDataSize = 0u;
+					for (size_t i = 0; i < strings.size(); i++)
+						stringDataSize += strings[i].size() + 1u;
+					if (strings.size() >= MAX_INDEX || guids.size() >= MAX_INDEX || nodes.size() >= MAX_INDEX || fields.size() >= MAX_INDEX || stringDataSize >= MAX_INDEX) {
+						if (logger != nullptr)
+							logger->Error("SerializeToBinary - Serialized data too large!");
+						error = true;
+					}
+					if (error) return {};
+
+					BinaryHeader header = {};
+					std::memcpy(header.magic, BINARY_MAGIC, sizeof(BINARY_MAGIC));
+					header.version = BINARY_VERSION;
+					header.endianness = BINARY_ENDIANNESS;
+					header.stringCount = static_cast<uint32_t>(strings.size());
+					header.guidCount = static_cast<uint32_t>(guids.size());
+					header.nodeCount = static_cast<uint32_t>(nodes.size());
+					header.fieldCount = static_cast<uint32_t>(fields.size());
+					header.stringDataSize = static_cast<uint64_t>(stringDataSize);
+					header.floatCount = static_cast<uint64_t>(floats.size());
+					const BinaryLayout layout(header);
+
+					std::vector<uint8_t> result(layout.totalSize, uint8_t(0u));
+					std::memcpy(result.data(), &header, sizeof(header));
+					{
+						uint32_t offset = 0u;
+						for (size_t i = 0; i < strings.size(); i++) {
+							std::memcpy(result.data() + layout.stringOffsets + sizeof(uint32_t) * i, &offset, sizeof(uint32_t));
+							std::memcpy(result.data() + layout.stringData + offset, strings[i].data(), strings[i].size());
+							offset += static_cast<uint32_t>(strings[i].size() + 1u);
+						}
+						std::memcpy(result.data() + layout.stringOffsets + sizeof(uint32_t) * strings.size(), &offset, sizeof(uint32_t));
+					}
+					auto copySection = [&](size_t offset, const auto& data) {
+						if (!data.empty())
+							std::memcpy(result.data() + offset, data.data(), sizeof(data[0]) * data.size());
+					};
+					copySection(layout.guids, guids);
+					copySection(layout.nodes, nodes);
+					copySection(layout.fields, fields);
+					copySection(layout.floats, floats);
+					return result;
+				}
+
+			private:
+				OS::Logger* const logger;
+				bool& error;
+				const Function<GUID, const SerializedObject&, bool&>& serializerObjectPtr;
+
+				// String table (deque keeps the views inside stringIds valid)
+				std::deque<std::string> strings;
+				std::unordered_map<std::string_view, uint32_t> stringIds;
+
+				// GUID table
+				std::vector<GUID> guids;
+				std::unordered_map<GUID, uint32_t> guidIds;
+
+				// Nodes, fields and vector/matrix components
+				std::vector<BinaryNode> nodes;
+				std::vector<BinaryField> fields;
+				std::vector<float> floats;
+
+				// Fields of the lists that are still being written (fields of a single list have to be contiguous, but nested lists are written first)
+				std::vector<BinaryField> pendingFields;
+
+				inline uint32_t StringId(const std::string_view& text) {
+					const auto it = stringIds.find(text);
+					if (it != stringIds.end()) return it->second;
+					const uint32_t id = static_cast<uint32_t>(strings.size());
+					strings.push_back(std::string(text));
+					stringIds[strings.back()] = id;
+					return id;
+				}
+
+				inline uint32_t GuidId(const GUID& guid) {
+					const auto it = guidIds.find(guid);
+					if (it != guidIds.end()) return it->second;
+					const uint32_t id = static_cast<uint32_t>(guids.size());
+					guids.push_back(guid);
+					guidIds[guid] = id;
+					return id;
+				}
+
+				inline void WriteList(const SerializedObject& object, BinaryNode& node) {
+					const size_t firstPendingField = pendingFields.size();
+					std::vector<std::pair<uint32_t, uint32_t>> nameCounts;
+					object.GetFields([&](const SerializedObject& field) {
+						if (field.Serializer() == nullptr) {
+							if (logger != nullptr)
+								logger->Warning("SerializeToBinary - Got a field with null-serializer!");
+							return;
+						}
+						BinaryField entry = {};
+						entry.name = StringId(field.Serializer()->TargetName());
+						entry.index = [&]() -> uint32_t {
+							for (size_t i = 0; i < nameCounts.size(); i++)
+								if (nameCounts[i].first == entry.name)
+									return (++nameCounts[i].second);
+							nameCounts.push_back(std::make_pair(entry.name, 0u));
+							return 0u;
+						}();
+						entry.node = Write(field);
+						pendingFields.push_back(entry);
+						});
+					node.kind = NodeKind::LIST;
+					node.value = static_cast<uint64_t>(fields.size());
+					node.count = static_cast<uint32_t>(pendingFields.size() - firstPendingField);
+					fields.insert(fields.end(), pendingFields.begin() + firstPendingField, pendingFields.end());
+					pendingFields.resize(firstPendingField);
+				}
+
+				template<typename ValueType>
+				inline static void WriteNumber(BinaryWriter&, const SerializedObject& object, BinaryNode& node) {
+					const ValueType value = object.operator ValueType();
+					if (std::is_floating_point_v<ValueType>) {
+						node.kind = NodeKind::REAL;
+						node.value = DoubleBits(static_cast<double>(value));
+					}
+					else if (std::is_signed_v<ValueType>) {
+						node.kind = NodeKind::SIGNED;
+						node.value = static_cast<uint64_t>(static_cast<int64_t>(value));
+					}
+					else {
+						node.kind = NodeKind::UNSIGNED;
+						node.value = static_cast<uint64_t>(value);
+					}
+				}
+
+				template<typename VectorType, size_t Dimensions>
+				inline static void WriteVector(BinaryWriter& writer, const SerializedObject& object, BinaryNode& node) {
+					const VectorType v = object.operator VectorType();
+					node.kind = NodeKind::FLOAT_ARRAY;
+					node.value = static_cast<uint64_t>(writer.floats.size());
+					node.count = static_cast<uint32_t>(Dimensions);
+					for (typename VectorType::length_type i = 0; i < Dimensions; i++)
+						writer.floats.push_back(v[i]);
+				}
+
+				template<typename MatrixType, size_t MatrixDimm>
+				inline static void WriteMatrix(BinaryWriter& writer, const SerializedObject& object, BinaryNode& node) {
+					const MatrixType m = object.operator MatrixType();
+					node.kind = NodeKind::FLOAT_ARRAY;
+					node.value = static_cast<uint64_t>(writer.floats.size());
+					node.count = static_cast<uint32_t>(MatrixDimm * MatrixDimm);
+					for (typename MatrixType::length_type i = 0; i < MatrixDimm; i++)
+						for (typename MatrixType::length_type j = 0; j < MatrixDimm; j++)
+							writer.floats.push_back(m[i][j]);
+				}
+
+				typedef void(*WriteValueFn)(BinaryWriter&, const SerializedObject&, BinaryNode&);
+				inline static const WriteValueFn* VALUE_WRITERS() {
+					static const WriteValueFn* const writers = []() -> const WriteValueFn* {
+						const constexpr size_t TYPE_COUNT = static_cast<size_t>(ItemSerializer::Type::SERIALIZER_TYPE_COUNT);
+						static WriteValueFn functions[TYPE_COUNT];
+
+						static const WriteValueFn unsupportedType = [](BinaryWriter& writer, const SerializedObject& object, BinaryNode&) {
+							if (writer.logger != nullptr)
+								writer.logger->Error("SerializeToBinary - Unsupported ItemSerializer type: ", static_cast<size_t>(object.Serializer()->GetType()), "!");
+							writer.error = true;
+						};
+						for (size_t i = 0; i < TYPE_COUNT; i++)
+							functions[i] = unsupportedType;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::BOOL_VALUE)] = [](BinaryWriter&, const SerializedObject& object, BinaryNode& node) {
+							node.kind = NodeKind::BOOL;
+							node.value = object.operator bool() ? 1u : 0u;
+						};
+						functions[static_cast<size_t>(ItemSerializer::Type::CHAR_VALUE)] = WriteNumber<char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::SCHAR_VALUE)] = WriteNumber<signed char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::UCHAR_VALUE)] = WriteNumber<unsigned char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::WCHAR_VALUE)] = WriteNumber<wchar_t>;
+						functions[static_cast<size_t>(ItemSerializer::Type::SHORT_VALUE)] = WriteNumber<short>;
+						functions[static_cast<size_t>(ItemSerializer::Type::USHORT_VALUE)] = WriteNumber<unsigned short>;
+						functions[static_cast<size_t>(ItemSerializer::Type::INT_VALUE)] = WriteNumber<int>;
+						functions[static_cast<size_t>(ItemSerializer::Type::UINT_VALUE)] = WriteNumber<unsigned int>;
+						functions[static_cast<size_t>(ItemSerializer::Type::LONG_VALUE)] = WriteNumber<long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::ULONG_VALUE)] = WriteNumber<unsigned long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::LONG_LONG_VALUE)] = WriteNumber<long long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::ULONG_LONG_VALUE)] = WriteNumber<unsigned long long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::FLOAT_VALUE)] = WriteNumber<float>;
+						functions[static_cast<size_t>(ItemSerializer::Type::DOUBLE_VALUE)] = WriteNumber<double>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR2_VALUE)] = WriteVector<Vector2, 2>;
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR3_VALUE)] = WriteVector<Vector3, 3>;
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR4_VALUE)] = WriteVector<Vector4, 4>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX2_VALUE)] = WriteMatrix<Matrix2, 2>;
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX3_VALUE)] = WriteMatrix<Matrix3, 3>;
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX4_VALUE)] = WriteMatrix<Matrix4, 4>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::STRING_VIEW_VALUE)] = [](BinaryWriter& writer, const SerializedObject& object, BinaryNode& node) {
+							node.kind = NodeKind::STRING;
+							node.value = writer.StringId(object.operator std::string_view());
+						};
+						functions[static_cast<size_t>(ItemSerializer::Type::WSTRING_VIEW_VALUE)] = [](BinaryWriter& writer, const SerializedObject& object, BinaryNode& node) {
+							node.kind = NodeKind::WSTRING;
+							node.value = writer.StringId(Convert<std::string>(object.operator std::wstring_view()));
+						};
+
+						return functions;
+					}();
+					return writers;
+				}
+			};
+
+
+
+			class BinaryReader {
+			public:
+				inline BinaryReader(OS::Logger* log, const Function<bool, const SerializedObject&, const GUID&>& objectPtr)
+					: logger(log), deserializerObjectPtr(objectPtr) {}
+
+				inline bool Initialize(const MemoryBlock& data) {
+					auto error = [&](const auto&... message) {
+						if (logger != nullptr) logger->Error("DeserializeFromBinary - ", message...);
+						return false;
+					};
+
+					if (!IsSerializedBinary(data) || data.Size() < sizeof(BinaryHeader))
+						return error("Data is not in binary serialization format!");
+
+					// Sections are accessed in-place, so the data has to be aligned:
+					const uint8_t* bytes = static_cast<const uint8_t*>(data.Data());
+					if ((reinterpret_cast<uintptr_t>(bytes) % alignof(uint64_t)) != 0u) {
+						alignedCopy.resize((data.Size() + sizeof(uint64_t) - 1u) / sizeof(uint64_t));
+						std::memcpy(alignedCopy.data(), bytes, data.Size());
+						bytes = reinterpret_cast<const uint8_t*>(alignedCopy.data());
+					}
+
+					BinaryHeader header;
+					std::memcpy(&header, bytes, sizeof(BinaryHeader));
+					if (header.version != BINARY_VERSION)
+						return error("Unsupported version(", header.version, ")!");
+					if (header.endianness != BINARY_ENDIANNESS)
+						return error("Data was stored on a machine with a different byte order!");
+					if (header.stringDataSize > data.Size() || header.floatCount > data.Size())
+						return error("Section sizes exceed data size!");
+					const BinaryLayout layout(header);
+					if (layout.totalSize > data.Size())
+						return error("Section sizes exceed data size!");
+					if (header.nodeCount <= 0u)
+						return error("Root node missing!");
+
+					stringOffsets = reinterpret_cast<const uint32_t*>(bytes + layout.stringOffsets);
+					stringData = reinterpret_cast<const char*>(bytes + layout.stringData);
+					guids = reinterpret_cast<const GUID*>(bytes + layout.guids);
+					nodes = reinterpret_cast<const BinaryNode*>(bytes + layout.nodes);
+					fields = reinterpret_cast<const BinaryField*>(bytes + layout.fields);
+					floats = reinterpret_cast<const float*>(bytes + layout.floats);
+					stringCount = header.stringCount;
+					guidCount = header.guidCount;
+					nodeCount = header.nodeCount;
+					fieldCount = header.fieldCount;
+					floatCount = static_cast<size_t>(header.floatCount);
+
+					// Each string has to be null-terminated and within bounds:
+					if (stringOffsets[0u] != 0u || stringOffsets[stringCount] != header.stringDataSize)
+						return error("String table corrupted!");
+					for (size_t i = 0; i < stringCount; i++)
+						if (stringOffsets[i + 1u] <= stringOffsets[i] || stringOffsets[i + 1u] > header.stringDataSize || stringData[stringOffsets[i + 1u] - 1u] != '\0')
+							return error("String table corrupted!");
+					return true;
+				}
+
+				inline bool Read(const SerializedObject& object, uint32_t nodeId)const {
+					const ItemSerializer* serializer = object.Serializer();
+					if (serializer == nullptr) {
+						if (logger != nullptr)
+							logger->Error("DeserializeFromBinary - Null serializer provided!");
+						return false;
+					}
+					const BinaryNode& node = nodes[nodeId];
+					const ItemSerializer::Type type = serializer->GetType();
+					if (type < ItemSerializer::Type::OBJECT_REFERENCE_VALUE)
+						return VALUE_READERS()[static_cast<size_t>(type)](*this, object, node);
+					else if (type == ItemSerializer::Type::OBJECT_REFERENCE_VALUE) {
+						if (node.kind != NodeKind::OBJECT_REFERENCE) return true; // Leave default values; no warnings required...
+						else if (node.value >= guidCount) return Corrupted();
+						else return deserializerObjectPtr(object, guids[node.value]);
+					}
+					else if (type == ItemSerializer::Type::SERIALIZER_LIST) {
+						if (node.kind == NodeKind::GUID_VALUE) {
+							if (node.value >= guidCount) return Corrupted();
+							else if (object.TargetAddr() != nullptr && object.As<GUID::Serializer>() != nullptr)
+								(*static_cast<GUID*>(object.TargetAddr())) = guids[node.value];
+							return true;
+						}
+						else if (node.kind != NodeKind::LIST) return true; // Leave default values; no warnings required...
+						else return ReadList(object, nodeId, node);
+					}
+					else {
+						if (logger != nullptr)
+							logger->Error("DeserializeFromBinary - Serializer type out of bounds!", static_cast<size_t>(type), "!");
+						return false;
+					}
+				}
+
+			private:
+				OS::Logger* const logger;
+				const Function<bool, const SerializedObject&, const GUID&>& deserializerObjectPtr;
+
+				// Sections
+				std::vector<uint64_t> alignedCopy;
+				const uint32_t* stringOffsets = nullptr;
+				const char* stringData = nullptr;
+				const GUID* guids = nullptr;
+				const BinaryNode* nodes = nullptr;
+				const BinaryField* fields = nullptr;
+				const float* floats = nullptr;
+				size_t stringCount = 0u;
+				size_t guidCount = 0u;
+				size_t nodeCount = 0u;
+				size_t fieldCount = 0u;
+				size_t floatCount = 0u;
+
+				inline bool Corrupted()const {
+					if (logger != nullptr)
+						logger->Error("DeserializeFromBinary - Data corrupted!");
+					return false;
+				}
+
+				inline std::string_view String(uint64_t id)const {
+					return std::string_view(stringData + stringOffsets[id], static_cast<size_t>(stringOffsets[id + 1u] - stringOffsets[id] - 1u));
+				}
+
+				inline bool ReadList(const SerializedObject& object, uint32_t nodeId, const BinaryNode& node)const {
+					if (node.value > fieldCount || (fieldCount - node.value) < node.count)
+						return Corrupted();
+					const BinaryField* const listFields = fields + node.value;
+					const size_t listSize = node.count;
+
+					// Fields are normally requested in the same order they were stored, so we look for the next one right after the last match first:
+					size_t cursor = 0u;
+					auto findField = [&](auto matches) -> const BinaryField* {
+						if (cursor < listSize && matches(listFields[cursor]))
+							return listFields + (cursor++);
+						for (size_t i = 0u; i < listSize; i++)
+							if (matches(listFields[i])) {
+								cursor = i + 1u;
+								return listFields + i;
+							}
+						return nullptr;
+					};
+
+					bool success = true;
+					std::vector<std::pair<uint32_t, uint32_t>> nameCounts;
+					object.GetFields([&](const SerializedObject& field) {
+						if (field.Serializer() == nullptr) {
+							if (logger != nullptr)
+								logger->Warning("DeserializeFromBinary - Got a field with null-serializer!");
+							return;
+						}
+
+						// Find the name in string table:
+						const std::string_view baseName = field.Serializer()->TargetName();
+						const BinaryField* const named = findField([&](const BinaryField& entry) {
+							return entry.name < stringCount && String(entry.name) == baseName;
+							});
+						if (named == nullptr) return; // Leave default values; no warnings required...
+						const uint32_t nameId = named->name;
+
+						// Find the entry with the same occurence index:
+						const uint32_t index = [&]() -> uint32_t {
+							for (size_t i = 0; i < nameCounts.size(); i++)
+								if (nameCounts[i].first == nameId)
+									return (++nameCounts[i].second);
+							nameCounts.push_back(std::make_pair(nameId, 0u));
+							return 0u;
+						}();
+						const BinaryField* const entry = (named->index == index) ? named : findField([&](const BinaryField& candidate) {
+							return candidate.name == nameId && candidate.index == index;
+							});
+						if (entry == nullptr) return; // Leave default values; no warnings required...
+
+						// Nested nodes always come after their parents, so corrupted data can not send us into a cycle:
+						if (entry->node <= nodeId || entry->node >= nodeCount)
+							success = Corrupted();
+						else if (!Read(field, entry->node))
+							success = false;
+						});
+					return success;
+				}
+
+				template<typename ValueType>
+				inline static bool GetNumber(const BinaryNode& node, ValueType& value) {
+					if (node.kind == NodeKind::BOOL) value = static_cast<ValueType>(node.value != 0u);
+					else if (node.kind == NodeKind::SIGNED) value = static_cast<ValueType>(static_cast<int64_t>(node.value));
+					else if (node.kind == NodeKind::UNSIGNED) value = static_cast<ValueType>(node.value);
+					else if (node.kind == NodeKind::REAL) value = static_cast<ValueType>(BitsToDouble(node.value));
+					else return false;
+					return true;
+				}
+
+				template<typename ValueType>
+				inline static bool ReadNumber(const BinaryReader&, const SerializedObject& object, const BinaryNode& node) {
+					ValueType value;
+					if (GetNumber(node, value))
+						object = value;
+					return true;
+				}
+
+				inline bool GetFloats(const BinaryNode& node, const float*& values)const {
+					if (node.value > floatCount || (floatCount - node.value) < node.count)
+						return Corrupted();
+					values = floats + node.value;
+					return true;
+				}
+
+				template<typename VectorType, size_t Dimensions>
+				inline static bool ReadVector(const BinaryReader& reader, const SerializedObject& object, const BinaryNode& node) {
+					if (node.kind == NodeKind::FLOAT_ARRAY) {
+						const float* values;
+						if (!reader.GetFloats(node, values)) return false;
+						VectorType v(0.0f);
+						for (typename VectorType::length_type i = 0; i < Dimensions && static_cast<uint32_t>(i) < node.count; i++)
+							v[i] = values[i];
+						object = v;
+					}
+					else {
+						float f;
+						if (GetNumber(node, f))
+							object = VectorType(f);
+					}
+					return true;
+				}
+
+				template<typename MatrixType, size_t MatrixDimm>
+				inline static bool ReadMatrix(const BinaryReader& reader, const SerializedObject& object, const BinaryNode& node) {
+					if (node.kind == NodeKind::FLOAT_ARRAY) {
+						const float* values;
+						if (!reader.GetFloats(node, values)) return false;
+						MatrixType value(0.0f);
+						size_t idx = 0;
+						for (typename MatrixType::length_type i = 0; i < MatrixDimm; i++)
+							for (typename MatrixType::length_type j = 0; j < MatrixDimm; j++) {
+								if (node.count <= idx) break;
+								value[i][j] = values[idx];
+								idx++;
+							}
+						object = value;
+					}
+					else {
+						float value;
+						if (GetNumber(node, value))
+							object = MatrixType(value);
+					}
+					return true;
+				}
+
+				typedef bool(*ReadValueFn)(const BinaryReader&, const SerializedObject&, const BinaryNode&);
+				inline static const ReadValueFn* VALUE_READERS() {
+					static const ReadValueFn* const readers = []() -> const ReadValueFn* {
+						const constexpr size_t TYPE_COUNT = static_cast<size_t>(ItemSerializer::Type::SERIALIZER_TYPE_COUNT);
+						static ReadValueFn functions[TYPE_COUNT];
+
+						static const ReadValueFn unsupportedType = [](const BinaryReader& reader, const SerializedObject& object, const BinaryNode&) -> bool {
+							if (reader.logger != nullptr)
+								reader.logger->Error("DeserializeFromBinary - Unsupported ItemSerializer type: ", static_cast<size_t>(object.Serializer()->GetType()), "!");
+							return false;
+						};
+						for (size_t i = 0; i < TYPE_COUNT; i++)
+							functions[i] = unsupportedType;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::BOOL_VALUE)] = ReadNumber<bool>;
+						functions[static_cast<size_t>(ItemSerializer::Type::CHAR_VALUE)] = ReadNumber<char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::SCHAR_VALUE)] = ReadNumber<signed char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::UCHAR_VALUE)] = ReadNumber<unsigned char>;
+						functions[static_cast<size_t>(ItemSerializer::Type::WCHAR_VALUE)] = ReadNumber<wchar_t>;
+						functions[static_cast<size_t>(ItemSerializer::Type::SHORT_VALUE)] = ReadNumber<short>;
+						functions[static_cast<size_t>(ItemSerializer::Type::USHORT_VALUE)] = ReadNumber<unsigned short>;
+						functions[static_cast<size_t>(ItemSerializer::Type::INT_VALUE)] = ReadNumber<int>;
+						functions[static_cast<size_t>(ItemSerializer::Type::UINT_VALUE)] = ReadNumber<unsigned int>;
+						functions[static_cast<size_t>(ItemSerializer::Type::LONG_VALUE)] = ReadNumber<long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::ULONG_VALUE)] = ReadNumber<unsigned long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::LONG_LONG_VALUE)] = ReadNumber<long long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::ULONG_LONG_VALUE)] = ReadNumber<unsigned long long>;
+						functions[static_cast<size_t>(ItemSerializer::Type::FLOAT_VALUE)] = ReadNumber<float>;
+						functions[static_cast<size_t>(ItemSerializer::Type::DOUBLE_VALUE)] = ReadNumber<double>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR2_VALUE)] = ReadVector<Vector2, 2>;
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR3_VALUE)] = ReadVector<Vector3, 3>;
+						functions[static_cast<size_t>(ItemSerializer::Type::VECTOR4_VALUE)] = ReadVector<Vector4, 4>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX2_VALUE)] = ReadMatrix<Matrix2, 2>;
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX3_VALUE)] = ReadMatrix<Matrix3, 3>;
+						functions[static_cast<size_t>(ItemSerializer::Type::MATRIX4_VALUE)] = ReadMatrix<Matrix4, 4>;
+
+						functions[static_cast<size_t>(ItemSerializer::Type::STRING_VIEW_VALUE)] = [](const BinaryReader& reader, const SerializedObject& object, const BinaryNode& node) -> bool {
+							if (node.kind != NodeKind::STRING && node.kind != NodeKind::WSTRING) return true;
+							else if (node.value >= reader.stringCount) return reader.Corrupted();
+							object = reader.String(node.value);
+							return true;
+						};
+						functions[static_cast<size_t>(ItemSerializer::Type::WSTRING_VIEW_VALUE)] = [](const BinaryReader& reader, const SerializedObject& object, const BinaryNode& node) -> bool {
+							if (node.kind != NodeKind::STRING && node.kind != NodeKind::WSTRING) return true;
+							else if (node.value >= reader.stringCount) return reader.Corrupted();
+							std::wstring text;
+							try { text = Convert<std::wstring>(reader.String(node.value)); }
+							catch (const std::exception&) { return reader.Corrupted(); }
+							object = std::wstring_view(text);
+							return true;
+						};
+
+						return functions;
+					}();
+					return readers;
+				}
+			};
+		}
+
+		bool IsSerializedBinary(const MemoryBlock& data) {
+			return data.Size() >= sizeof(BINARY_MAGIC) && std::memcmp(data.Data(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) == 0;
+		}
+
+		std::vector<uint8_t> SerializeToBinary(const SerializedObject& object, OS::Logger* logger, bool& error,
+			const Function<GUID, const SerializedObject&, bool&>& serializerObjectPtr) {
+			BinaryWriter writer(logger, error, serializerObjectPtr);
+			writer.Write(object);
+			return writer.Finish();
+		}
+
+		bool DeserializeFromBinary(const SerializedObject& object, const MemoryBlock& data, OS::Logger* logger,
+			const Function<bool, const SerializedObject&, const GUID&>& deserializerObjectPtr) {
+			BinaryReader reader(logger, deserializerObjectPtr);
+			if (!reader.Initialize(data)) return false;
+			else return reader.Read(object, 0u);
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#pragma once
+#include "../ItemSerializers.h"
+#include "../../GUID.h"
+#include "../../../Core/Memory/MemoryBlock.h"
+#include "../../../OS/Logging/Logger.h"
+#include <vector>
+
+
+namespace Jimara {
+	namespace Serialization {
+		/// <summary>
+		/// Checks if the memory block starts with the header of the binary format, produced by SerializeToBinary
+		/// <para/> Useful for telling binary files apart from json-s when both formats are allowed to share the same extension.
+		/// </summary>
+		/// <param name="data"> File content or any other serialized data </param>
+		/// <returns> True, if data has a binary serialization header (does not validate the rest of the content) </returns>
+		JIMARA_API bool IsSerializedBinary(const MemoryBlock& data);
+
+		/// <summary>
+		/// Stores serialized data from a SerializedObject in a compact binary format
+		/// <para/> Binary data consists of a header, a string table (field names and string values, each stored once),
+		///		a GUID table, a node table, a field table and a float array for vector and matrix components;
+		///		Fields are matched by name and occurence index, just like in SerializeToJson, so the data survives the same kinds of schema changes.
+		/// <para/> Data is stored in the native byte order and is only readable on machines with the same endianness.
+		/// </summary>
+		/// <param name="object"> Serialized object </param>
+		/// <param name="logger"> Logger for error/warning reporting </param>
+		/// <param name="error"> If error occures, this flag will be set accordingly </param>
+		/// <param name="serializerObjectPtr">
+		///		SerializeToBinary is not responsible for interpreting ValueSerializer of any other valid ptr type;
+		///		this function should provide a GUID (or some other unique 'handle' value, stored as a GUID) for it
+		///		(arguments are: SerializedObject of the object pointer and error)
+		/// </param>
+		/// <returns> Serialized data (empty if error occures) </returns>
+		JIMARA_API std::vector<uint8_t> SerializeToBinary(const SerializedObject& object, OS::Logger* logger, bool& error,
+			const Function<GUID, const SerializedObject&, bool&>& serializerObjectPtr);
+
+		/// <summary>
+		/// Stores serialized data from a SerializedObject in a compact binary format
+		/// </summary>
+		/// <typeparam name="ObjectPtrSerializeCallback">
+		///		Anything that can be called as a function with (const SerializedObject&, bool&) as arguments as long as it returns a GUID
+		/// </typeparam>
+		/// <param name="object"> Serialized object </param>
+		/// <param name="logger"> Logger for error/warning reporting </param>
+		/// <param name="error"> If error occures, this flag will be set accordingly </param>
+		/// <param name="serializerObjectCallback">
+		///		SerializeToBinary is not responsible for interpreting ValueSerializer of any other valid ptr type; this function will be used to fill in the details;
+		///		(arguments are: SerializedObject of the object pointer and error)
+		/// </param>
+		/// <returns> Serialized data (empty if error occures) </returns>
+		template<typename ObjectPtrSerializeCallback>
+		std::vector<uint8_t> SerializeToBinary(const SerializedObject& object, OS::Logger* logger, bool& error,
+			const ObjectPtrSerializeCallback& serializerObjectCallback) {
+			GUID(*callback)(const ObjectPtrSerializeCallback*, const SerializedObject&, bool&) =
+				[](const ObjectPtrSerializeCallback* call, const SerializedObject& obj, bool& err) -> GUID {
+				return (*call)(obj, err);
+			};
+			return SerializeToBinary(object, logger, error, Function<GUID, const SerializedObject&, bool&>(callback, &serializerObjectCallback));
+		}
+
+		/// <summary>
+		/// Extracts serialized data from a binary blob, created by SerializeToBinary, into a SerializedObject
+		/// <para/> Values are read directly from the provided memory (no intermediate tree is created), so data can come straight from a memory-mapped file.
+		/// </summary>
+		/// <param name="object"> Serialized object </param>
+		/// <param name="data"> Binary data </param>
+		/// <param name="logger"> Logger for error/warning reporting </param>
+		/// <param name="deserializerObjectPtr">
+		///		DeserializeFromBinary is not responsible for interpreting ValueSerializer of any other valid ptr type; this function will be used to fill in the details;
+		///		(arguments are: SerializedObject of the object pointer and the GUID, returned by the serializerObjectPtr during the corresponding SerializeToBinary() call)
+		/// </param>
+		/// <returns> True, if the data is valid and no error occured (including the one form deserializerObjectPtr call) </returns>
+		JIMARA_API bool DeserializeFromBinary(const SerializedObject& object, const MemoryBlock& data, OS::Logger* logger,
+			const Function<bool, const SerializedObject&, const GUID&>& deserializerObjectPtr);
+
+		/// <summary>
+		/// Extracts serialized data from a binary blob, created by SerializeToBinary, into a SerializedObject
+		/// </summary>
+		/// <typeparam name="ObjectPtrDeserializeCallback">
+		///		Anything that can be called as a function with (const SerializedObject&, const GUID&) as arguments as long as it returnes a boolean value
+		/// </typeparam>
+		/// <param name="object"> Serialized object </param>
+		/// <param name="data"> Binary data </param>
+		/// <param name="logger"> Logger for error/warning reporting </param>
+		/// <param name="deserializerObjectPtr">
+		///		DeserializeFromBinary is not responsible for interpreting ValueSerializer of any other valid ptr type; this function will be used to fill in the details;
+		///		(arguments are: SerializedObject of the object pointer and the GUID, returned by the serializerObjectPtr during the corresponding SerializeToBinary() call)
+		/// </param>
+		/// <returns> True, if the data is valid and no error occured (including the one form deserializerObjectPtr call) </returns>
+		template<typename ObjectPtrDeserializeCallback>
+		bool DeserializeFromBinary(const SerializedObject& object, const MemoryBlock& data, OS::Logger* logger,
+			const ObjectPtrDeserializeCallback& deserializerObjectPtr) {
+			bool(*callback)(const ObjectPtrDeserializeCallback*, const SerializedObject&, const GUID&) =
+				[](const ObjectPtrDeserializeCallback* call, const SerializedObject& obj, const GUID& guid) {
+				return (*call)(obj, guid);
+			};
+			return DeserializeFromBinary(object, data, logger, Function<bool, const SerializedObject&, const GUID&>(callback, &deserializerObjectPtr));
+		}
+	}
+}
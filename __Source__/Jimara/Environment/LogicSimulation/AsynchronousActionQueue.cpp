@@ -70,9 +70,14 @@ namespace Jimara {
 			}
 
 			inline virtual void Schedule(const Callback<Object*>& callback, Object* userData) final override {
+				TrySchedule(callback, userData);
+			}
+
+			inline virtual bool TrySchedule(const Callback<Object*>& callback, Object* userData) final override {
 				const Reference<Data> data = m_dataRef->GetData();
-				if (data != nullptr)
-					data->Schedule(callback, userData);
+				if (data == nullptr) return false;
+				data->Schedule(callback, userData);
+				return true;
 			}
 		};
 #pragma warning(default: 4250)
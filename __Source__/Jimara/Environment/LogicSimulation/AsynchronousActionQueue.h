@@ -23,6 +23,16 @@ namespace Jimara {
 		/// <summary> Virtual destructor </summary>
 		virtual ~AsynchronousActionQueue();
 
+		/// <summary>
+		/// Schedules a callback to be executed on the queue, reporting if that was possible
+		/// <para/> Note: Once the context's data objects get cleared, the worker threads are gone and the actions are silently dropped by Schedule();
+		///		this call lets the users who wait for the actions to notice that and handle the failure.
+		/// </summary>
+		/// <param name="callback"> Callback to invoke as the action </param>
+		/// <param name="userData"> Arbitrary object, that will be kept alive till the action is queued and passed as an argument during execution </param>
+		/// <returns> True, if the action got scheduled </returns>
+		virtual bool TrySchedule(const Callback<Object*>& callback, Object* userData) = 0;
+
 	private:
 		// Constructor is private; actual concrete implementation is hidden
 		AsynchronousActionQueue();
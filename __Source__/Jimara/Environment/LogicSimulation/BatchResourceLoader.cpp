@@ -0,0 +1,414 @@
+#include "BatchResourceLoader.h"
+
+
+namespace Jimara {
+	struct BatchResourceLoader::Helpers {
+		// Forwards per-asset load progress to the loader
+		struct ProgressReporter {
+			BatchResourceLoader* self = nullptr;
+			size_t index = 0u;
+
+			inline void Report(Asset::LoadInfo info) {
+				const float fraction = Math::Min(Math::Max(info.Fraction(), 0.0f), 1.0f);
+				Progress progress;
+				{
+					std::unique_lock<std::mutex> lock(self->m_lock);
+					AssetNode& node = self->m_nodes[index];
+					if (node.finished || fraction <= node.progress) return;
+					self->m_progressSum += (fraction - node.progress);
+					node.progress = fraction;
+					progress = GetProgress(self);
+				}
+				self->m_reportProgress(progress);
+			}
+		};
+
+		// Progress snapshot (has to be invoked under the lock)
+		inline static Progress GetProgress(const BatchResourceLoader* self) {
+			Progress progress;
+			progress.totalAssets = self->m_discovered ? self->m_nodes.size() : size_t(0u);
+			progress.finishedAssets = self->m_finishedCount;
+			progress.failedAssets = self->m_failedCount;
+			progress.fraction = (!self->m_discovered) ? 0.0f : (progress.totalAssets > 0u)
+				? Math::Min(self->m_progressSum / static_cast<float>(progress.totalAssets), 1.0f) : 1.0f;
+			return progress;
+		}
+
+		// Finds or creates a node for given GUID
+		inline static size_t GetNode(BatchResourceLoader* self, AssetDatabase* database, const GUID& guid, std::vector<size_t>& discovered) {
+			{
+				const auto it = self->m_nodeIndex.find(guid);
+				if (it != self->m_nodeIndex.end()) return it->second;
+			}
+			const size_t index = self->m_nodes.size();
+			self->m_nodeIndex[guid] = index;
+			self->m_nodes.push_back({});
+			AssetNode& node = self->m_nodes.back();
+			node.guid = guid;
+			node.asset = (database != nullptr) ? database->FindAsset(guid) : nullptr;
+			if (node.asset == nullptr)
+				self->m_context->Log()->Warning("BatchResourceLoader::Load - Asset not found: ", guid, "! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+			discovered.push_back(index);
+			return index;
+		}
+
+		// Creates nodes for the requests and their dependencies (recursively)
+		inline static void DiscoverAssets(BatchResourceLoader* self, AssetDatabase* database, const Request* requests, size_t requestCount) {
+			std::vector<size_t> discovered;
+			if (requests != nullptr) for (size_t i = 0u; i < requestCount; i++) {
+				const Request& request = requests[i];
+				const size_t nodeCount = self->m_nodes.size();
+				const size_t index = GetNode(self, database, request.guid, discovered);
+				AssetNode& node = self->m_nodes[index];
+				node.priority = (index >= nodeCount) ? request.priority : Math::Max(node.priority, request.priority);
+			}
+
+			std::vector<GUID> dependencies;
+			for (size_t i = 0u; i < discovered.size(); i++) {
+				const size_t index = discovered[i];
+				const Reference<Asset> asset = self->m_nodes[index].asset;
+				if (asset == nullptr) continue;
+				dependencies.clear();
+				{
+					void(*report)(std::vector<GUID>*, const GUID&) = [](std::vector<GUID>* list, const GUID& guid) { list->push_back(guid); };
+					asset->GetDependencies(Callback<const GUID&>(report, &dependencies));
+				}
+				for (size_t j = 0u; j < dependencies.size(); j++) {
+					const GUID& guid = dependencies[j];
+					if (guid == self->m_nodes[index].guid) continue;
+					const size_t dependency = GetNode(self, database, guid, discovered);
+					std::vector<size_t>& nodeDependencies = self->m_nodes[index].dependencies;
+					if (std::find(nodeDependencies.begin(), nodeDependencies.end(), dependency) == nodeDependencies.end())
+						nodeDependencies.push_back(dependency);
+				}
+			}
+		}
+
+		// Drops back-edges of the dependency graph, so that the cyclic dependencies can not block the batch
+		inline static void BreakCycles(BatchResourceLoader* self) {
+			enum class State : uint8_t { UNVISITED, ON_STACK, DONE };
+			std::vector<State> states(self->m_nodes.size(), State::UNVISITED);
+			std::vector<std::pair<size_t, size_t>> stack;
+			for (size_t root = 0u; root < self->m_nodes.size(); root++) {
+				if (states[root] != State::UNVISITED) continue;
+				states[root] = State::ON_STACK;
+				stack.push_back(std::make_pair(root, size_t(0u)));
+				while (!stack.empty()) {
+					std::pair<size_t, size_t>& entry = stack.back();
+					AssetNode& node = self->m_nodes[entry.first];
+					if (entry.second >= node.dependencies.size()) {
+						states[entry.first] = State::DONE;
+						stack.pop_back();
+						continue;
+					}
+					const size_t dependency = node.dependencies[entry.second];
+					if (states[dependency] == State::ON_STACK) {
+						self->m_context->Log()->Warning("BatchResourceLoader::Load - Circular dependency detected between ",
+							node.guid, " and ", self->m_nodes[dependency].guid, "; ordering will be ignored for the pair! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+						node.dependencies.erase(node.dependencies.begin() + entry.second);
+						continue;
+					}
+					entry.second++;
+					if (states[dependency] == State::UNVISITED) {
+						states[dependency] = State::ON_STACK;
+						stack.push_back(std::make_pair(dependency, size_t(0u)));
+					}
+				}
+			}
+		}
+
+		// Fills dependents, pending counts and priorities and collects the initially ready nodes
+		inline static void BuildGraph(BatchResourceLoader* self) {
+			std::vector<size_t> stack;
+			for (size_t i = 0u; i < self->m_nodes.size(); i++) {
+				AssetNode& node = self->m_nodes[i];
+				node.pendingDependencies = node.dependencies.size();
+				for (size_t j = 0u; j < node.dependencies.size(); j++)
+					self->m_nodes[node.dependencies[j]].dependents.push_back(i);
+				stack.push_back(i);
+			}
+
+			// Dependencies inherit the highest priority of their dependents:
+			while (!stack.empty()) {
+				const AssetNode& node = self->m_nodes[stack.back()];
+				stack.pop_back();
+				for (size_t j = 0u; j < node.dependencies.size(); j++) {
+					AssetNode& dependency = self->m_nodes[node.dependencies[j]];
+					if (dependency.priority >= node.priority) continue;
+					dependency.priority = node.priority;
+					stack.push_back(node.dependencies[j]);
+				}
+			}
+
+			// Assets with undeclared recursive dependencies wait for the independent ones:
+			for (size_t i = 0u; i < self->m_nodes.size(); i++) {
+				AssetNode& node = self->m_nodes[i];
+				node.independent = (node.asset == nullptr || (!node.asset->HasRecursiveDependencies()));
+				if (node.independent)
+					self->m_independentNodesLeft++;
+				else if (node.dependencies.empty())
+					self->m_heldBackNodes.push_back(i);
+			}
+			for (size_t i = 0u; i < self->m_nodes.size(); i++) {
+				const AssetNode& node = self->m_nodes[i];
+				if (node.pendingDependencies > 0u) continue;
+				if (node.independent || self->m_independentNodesLeft <= 0u || (!node.dependencies.empty()))
+					self->m_readyNodes.insert(std::make_pair(-node.priority, i));
+			}
+			if (self->m_independentNodesLeft <= 0u)
+				self->m_heldBackNodes.clear();
+		}
+
+		// Schedules given number of load tasks (each task picks the highest priority ready node, once executed)
+		inline static void ScheduleLoads(BatchResourceLoader* self, size_t count) {
+			static const auto action = [](Object* selfPtr) {
+				BatchResourceLoader* const self = dynamic_cast<BatchResourceLoader*>(selfPtr);
+				assert(self != nullptr);
+				LoadNext(self);
+			};
+			for (size_t i = 0u; i < count; i++)
+				if (!self->m_queue->TrySchedule(Callback<Object*>::FromCall(&action), self)) {
+					// Queue is gone (context is being destroyed); nothing left will ever load, so we fail the rest to let Wait() return:
+					self->m_context->Log()->Error("BatchResourceLoader::ScheduleLoads - Failed to schedule load tasks! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+					Progress progress;
+					bool finished;
+					{
+						std::unique_lock<std::mutex> lock(self->m_lock);
+						SkipPendingNodes(self, true);
+						progress = GetProgress(self);
+						finished = CheckFinished(self);
+					}
+					self->m_reportProgress(progress);
+					if (finished)
+						ReportFinished(self);
+					return;
+				}
+		}
+
+		// Marks all nodes that have not started loading as finished (has to be invoked under the lock)
+		inline static void SkipPendingNodes(BatchResourceLoader* self, bool failed) {
+			self->m_readyNodes.clear();
+			self->m_heldBackNodes.clear();
+			for (size_t i = 0u; i < self->m_nodes.size(); i++) {
+				AssetNode& node = self->m_nodes[i];
+				if (node.started || node.finished) continue;
+				node.finished = true;
+				self->m_finishedCount++;
+				if (failed)
+					self->m_failedCount++;
+				self->m_progressSum += (1.0f - node.progress);
+				node.progress = 1.0f;
+			}
+		}
+
+		// Loads the highest priority ready asset
+		inline static void LoadNext(BatchResourceLoader* self) {
+			size_t index;
+			Reference<Asset> asset;
+			{
+				std::unique_lock<std::mutex> lock(self->m_lock);
+				if (self->m_readyNodes.empty()) return;
+				index = self->m_readyNodes.begin()->second;
+				self->m_readyNodes.erase(self->m_readyNodes.begin());
+				AssetNode& node = self->m_nodes[index];
+				node.started = true;
+				asset = node.asset;
+			}
+			Reference<Resource> resource;
+			if (asset != nullptr) {
+				ProgressReporter reporter;
+				reporter.self = self;
+				reporter.index = index;
+				resource = asset->LoadResource(Callback<Asset::LoadInfo>(&ProgressReporter::Report, reporter));
+				if (resource == nullptr)
+					self->m_context->Log()->Error("BatchResourceLoader::LoadNext - Failed to load resource for ", asset->Guid(), "! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+			}
+			OnNodeFinished(self, index, resource);
+		}
+
+		// Stores the result and releases the dependents
+		inline static void OnNodeFinished(BatchResourceLoader* self, size_t index, Resource* resource) {
+			size_t readyCount = 0u;
+			Progress progress;
+			bool finished;
+			{
+				std::unique_lock<std::mutex> lock(self->m_lock);
+				AssetNode& node = self->m_nodes[index];
+				node.resource = resource;
+				if (!node.finished) {
+					node.finished = true;
+					self->m_finishedCount++;
+				}
+				self->m_progressSum += (1.0f - node.progress);
+				node.progress = 1.0f;
+				if (resource == nullptr)
+					self->m_failedCount++;
+
+				auto makeReady = [&](size_t readyIndex) {
+					const AssetNode& readyNode = self->m_nodes[readyIndex];
+					if (readyNode.finished || readyNode.started) return;
+					self->m_readyNodes.insert(std::make_pair(-readyNode.priority, readyIndex));
+					readyCount++;
+				};
+				if (!self->m_canceled) {
+					for (size_t i = 0u; i < node.dependents.size(); i++) {
+						AssetNode& dependent = self->m_nodes[node.dependents[i]];
+						dependent.pendingDependencies--;
+						if (dependent.pendingDependencies <= 0u)
+							makeReady(node.dependents[i]);
+					}
+					if (node.independent && self->m_independentNodesLeft > 0u) {
+						self->m_independentNodesLeft--;
+						if (self->m_independentNodesLeft <= 0u) {
+							for (size_t i = 0u; i < self->m_heldBackNodes.size(); i++)
+								makeReady(self->m_heldBackNodes[i]);
+							self->m_heldBackNodes.clear();
+						}
+					}
+				}
+				progress = GetProgress(self);
+				finished = CheckFinished(self);
+			}
+			ScheduleLoads(self, readyCount);
+			self->m_reportProgress(progress);
+			if (finished)
+				ReportFinished(self);
+		}
+
+		// Marks the batch as finished if all nodes are done (has to be invoked under the lock; returns true only once)
+		inline static bool CheckFinished(BatchResourceLoader* self) {
+			if (self->m_finished || (!self->m_discovered) || self->m_finishedCount < self->m_nodes.size()) return false;
+			self->m_finished = true;
+			self->m_finishedCondition.notify_all();
+			return true;
+		}
+
+		// First task of the batch: discovers the assets and their dependencies, builds the graph and schedules the loads
+		inline static void Discover(Object* selfPtr) {
+			BatchResourceLoader* const self = dynamic_cast<BatchResourceLoader*>(selfPtr);
+			assert(self != nullptr);
+			bool canceled;
+			{
+				std::unique_lock<std::mutex> lock(self->m_lock);
+				canceled = self->m_canceled;
+			}
+
+			// Asset lookups and GetDependencies() calls may take a while, so the graph is built without the lock 
+			// (nothing else touches the nodes till m_discovered is set):
+			if (!canceled) {
+				DiscoverAssets(self, self->m_database, self->m_requests.data(), self->m_requests.size());
+				BreakCycles(self);
+				BuildGraph(self);
+			}
+
+			size_t readyCount;
+			Progress progress;
+			bool finished;
+			{
+				std::unique_lock<std::mutex> lock(self->m_lock);
+				self->m_requests.clear();
+				self->m_database = nullptr;
+				self->m_discovered = true;
+				if (self->m_canceled)
+					SkipPendingNodes(self, false);
+				readyCount = self->m_readyNodes.size();
+				progress = GetProgress(self);
+				finished = CheckFinished(self);
+			}
+			ScheduleLoads(self, readyCount);
+			self->m_reportProgress(progress);
+			if (finished)
+				ReportFinished(self);
+		}
+
+		// Invokes onFinished callback through ExecuteAfterUpdate queue
+		inline static void ReportFinished(BatchResourceLoader* self) {
+			static const auto action = [](Object* selfPtr) {
+				BatchResourceLoader* const self = dynamic_cast<BatchResourceLoader*>(selfPtr);
+				assert(self != nullptr);
+				self->m_onFinished(self);
+			};
+			self->m_context->ExecuteAfterUpdate(Callback<Object*>::FromCall(&action), self);
+		}
+	};
+
+	Reference<BatchResourceLoader> BatchResourceLoader::Load(
+		SceneContext* context, const Request* requests, size_t requestCount,
+		const Callback<BatchResourceLoader*>& onFinished, const Callback<const Progress&>& reportProgress,
+		AssetDatabase* database) {
+		if (context == nullptr)
+			return nullptr;
+		const Reference<AsynchronousActionQueue> queue = AsynchronousActionQueue::GetFor(context);
+		if (queue == nullptr) {
+			context->Log()->Error("BatchResourceLoader::Load - Failed to get AsynchronousActionQueue! [File: ", __FILE__, "; Line: ", __LINE__, "]");
+			return nullptr;
+		}
+		if (database == nullptr)
+			database = context->AssetDB();
+
+		const Reference<BatchResourceLoader> loader = new BatchResourceLoader(context, queue, onFinished, reportProgress);
+		loader->ReleaseRef();
+		loader->m_database = database;
+		if (requests != nullptr)
+			loader->m_requests.assign(requests, requests + requestCount);
+
+		// Dependency discovery may be slow for large batches, so it's the first task on the queue instead of being done by the caller
+		// (if the queue is already gone, discovery runs right here and the scheduling failure of the loads fails the batch):
+		if (!queue->TrySchedule(Callback<Object*>(Helpers::Discover), loader))
+			Helpers::Discover(loader);
+		return loader;
+	}
+
+	BatchResourceLoader::BatchResourceLoader(SceneContext* context, AsynchronousActionQueue* queue,
+		const Callback<BatchResourceLoader*>& onFinished, const Callback<const Progress&>& reportProgress)
+		: m_context(context), m_queue(queue), m_onFinished(onFinished), m_reportProgress(reportProgress) {}
+
+	BatchResourceLoader::~BatchResourceLoader() {}
+
+	BatchResourceLoader::Progress BatchResourceLoader::CurrentProgress()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return Helpers::GetProgress(this);
+	}
+
+	void BatchResourceLoader::Cancel() {
+		Progress progress;
+		bool finished;
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			if (m_canceled || m_finished) return;
+			m_canceled = true;
+			// Before the discovery is done, the nodes belong to the discovery task, which will skip them on its own:
+			if (m_discovered)
+				Helpers::SkipPendingNodes(this, false);
+			progress = Helpers::GetProgress(this);
+			finished = Helpers::CheckFinished(this);
+		}
+		m_reportProgress(progress);
+		if (finished)
+			Helpers::ReportFinished(this);
+	}
+
+	bool BatchResourceLoader::Canceled()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_canceled;
+	}
+
+	bool BatchResourceLoader::Finished()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		return m_finished;
+	}
+
+	void BatchResourceLoader::Wait()const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		while (!m_finished)
+			m_finishedCondition.wait(lock);
+	}
+
+	Reference<Resource> BatchResourceLoader::GetResource(const GUID& guid)const {
+		std::unique_lock<std::mutex> lock(m_lock);
+		if (!m_discovered) return nullptr;
+		const auto it = m_nodeIndex.find(guid);
+		if (it == m_nodeIndex.end()) return nullptr;
+		return m_nodes[it->second].resource;
+	}
+}
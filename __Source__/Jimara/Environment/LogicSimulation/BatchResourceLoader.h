@@ -0,0 +1,184 @@
+#pragma once
+#include "AsynchronousActionQueue.h"
+#include <condition_variable>
+#include <unordered_map>
+#include <algorithm>
+#include <set>
+
+
+namespace Jimara {
+	/// <summary>
+	/// Loads a batch of assets asynchronously, on the context's AsynchronousActionQueue
+	/// <para/> Notes:
+	/// <para/>		0. Dependencies, reported through Asset::GetDependencies() are discovered recursively (by the first task of the batch, so Load() returns right away),
+	///				become a part of the batch and get loaded before the assets that depend on them;
+	/// <para/>		1. Independent assets are loaded in parallel;
+	///				assets with Asset::HasRecursiveDependencies() and no reported dependencies are held back
+	///				till the independent assets get loaded, so that their LoadResource() calls mostly find the dependencies ready;
+	/// <para/>		2. Assets with higher priority get loaded first (dependencies inherit the highest priority of their dependents);
+	/// <para/>		3. Loader keeps the loaded resources alive for as long as it exists;
+	/// <para/>		4. onFinished callback is always invoked through ExecuteAfterUpdate queue (even if the batch is empty or gets canceled).
+	/// </summary>
+	class JIMARA_API BatchResourceLoader : public virtual Object {
+	public:
+		/// <summary> Single asset request </summary>
+		struct JIMARA_API Request {
+			/// <summary> Asset identifier </summary>
+			GUID guid = {};
+
+			/// <summary> Load priority (higher priority assets are loaded first) </summary>
+			int priority = 0;
+		};
+
+		/// <summary> Aggregated load progress </summary>
+		struct JIMARA_API Progress {
+			/// <summary> Number of assets within the batch (including discovered dependencies; 0 till the discovery task is done) </summary>
+			size_t totalAssets = 0u;
+
+			/// <summary> Number of assets, that have been loaded, failed to load or got canceled </summary>
+			size_t finishedAssets = 0u;
+
+			/// <summary> Number of assets, that could not be found, failed to load or could not be scheduled (if the action queue goes out of scope) </summary>
+			size_t failedAssets = 0u;
+
+			/// <summary> Overall progress in [0.0f; 1.0f] range (includes partial progress of the assets being loaded) </summary>
+			float fraction = 0.0f;
+		};
+
+		/// <summary>
+		/// Starts loading a batch of assets
+		/// </summary>
+		/// <param name="context"> Scene context (can not be nullptr!) </param>
+		/// <param name="requests"> Requested assets </param>
+		/// <param name="requestCount"> Number of requests </param>
+		/// <param name="onFinished"> Callback, invoked within ExecuteAfterUpdate queue once all assets are loaded (or the batch is canceled) </param>
+		/// <param name="reportProgress"> [Optional] Progress handler (invoked from the loading threads, so it has to be thread-safe) </param>
+		/// <param name="database"> [Optional] Database to find the assets in (context's AssetDB() if nullptr) </param>
+		/// <returns> Batch loader (nullptr if context is nullptr or the action queue is unavailable) </returns>
+		static Reference<BatchResourceLoader> Load(
+			SceneContext* context, const Request* requests, size_t requestCount,
+			const Callback<BatchResourceLoader*>& onFinished = Callback(Unused<BatchResourceLoader*>),
+			const Callback<const Progress&>& reportProgress = Callback(Unused<const Progress&>),
+			AssetDatabase* database = nullptr);
+
+		/// <summary>
+		/// Starts loading a batch of assets
+		/// </summary>
+		/// <param name="context"> Scene context (can not be nullptr!) </param>
+		/// <param name="requests"> Requested assets </param>
+		/// <param name="onFinished"> Callback, invoked within ExecuteAfterUpdate queue once all assets are loaded (or the batch is canceled) </param>
+		/// <param name="reportProgress"> [Optional] Progress handler (invoked from the loading threads, so it has to be thread-safe) </param>
+		/// <param name="database"> [Optional] Database to find the assets in (context's AssetDB() if nullptr) </param>
+		/// <returns> Batch loader (nullptr if context is nullptr or the action queue is unavailable) </returns>
+		inline static Reference<BatchResourceLoader> Load(
+			SceneContext* context, const std::vector<Request>& requests,
+			const Callback<BatchResourceLoader*>& onFinished = Callback(Unused<BatchResourceLoader*>),
+			const Callback<const Progress&>& reportProgress = Callback(Unused<const Progress&>),
+			AssetDatabase* database = nullptr) {
+			return Load(context, requests.data(), requests.size(), onFinished, reportProgress, database);
+		}
+
+		/// <summary> Virtual destructor </summary>
+		virtual ~BatchResourceLoader();
+
+		/// <summary> Current progress </summary>
+		Progress CurrentProgress()const;
+
+		/// <summary>
+		/// Cancels the batch
+		/// <para/> Note: Assets that are already being loaded will finish loading; the rest will be skipped and count as finished (not failed).
+		/// </summary>
+		void Cancel();
+
+		/// <summary> True, if Cancel() has been invoked </summary>
+		bool Canceled()const;
+
+		/// <summary> True, once all assets are loaded, failed to load or got canceled </summary>
+		bool Finished()const;
+
+		/// <summary>
+		/// Blocks the caller till Finished()
+		/// <para/> Note: onFinished callback may still be pending after this call, since it's invoked within ExecuteAfterUpdate queue.
+		/// </summary>
+		void Wait()const;
+
+		/// <summary>
+		/// Loaded resource
+		/// </summary>
+		/// <param name="guid"> Asset identifier (requested or discovered as a dependency) </param>
+		/// <returns> Resource (nullptr, if not part of the batch, not yet loaded or failed to load) </returns>
+		Reference<Resource> GetResource(const GUID& guid)const;
+
+		/// <summary>
+		/// Loaded resource
+		/// </summary>
+		/// <typeparam name="ResourceType"> Type of the resource </typeparam>
+		/// <param name="guid"> Asset identifier (requested or discovered as a dependency) </param>
+		/// <returns> Resource (nullptr, if not part of the batch, not yet loaded, failed to load or is not of the correct type) </returns>
+		template<typename ResourceType>
+		inline Reference<ResourceType> GetResource(const GUID& guid)const {
+			const Reference<Resource> resource = GetResource(guid);
+			return resource;
+		}
+
+	private:
+		// Context
+		const Reference<SceneContext> m_context;
+
+		// Action queue, the assets are loaded on
+		const Reference<AsynchronousActionQueue> m_queue;
+
+		// Completion and progress callbacks
+		const Callback<BatchResourceLoader*> m_onFinished;
+		const Callback<const Progress&> m_reportProgress;
+
+		// Lock for the state below
+		mutable std::mutex m_lock;
+
+		// Notified, once the batch is finished
+		mutable std::condition_variable m_finishedCondition;
+
+		// Requests and the database, waiting for the discovery task (cleared once the discovery is done; node graph below is only valid once m_discovered is set)
+		std::vector<Request> m_requests;
+		Reference<AssetDatabase> m_database;
+		bool m_discovered = false;
+
+		// Asset within the batch
+		struct AssetNode {
+			GUID guid = {};
+			Reference<Asset> asset;
+			int priority = 0;
+			bool independent = false;
+			size_t pendingDependencies = 0u;
+			std::vector<size_t> dependencies;
+			std::vector<size_t> dependents;
+			bool started = false;
+			bool finished = false;
+			float progress = 0.0f;
+			Reference<Resource> resource;
+		};
+		std::vector<AssetNode> m_nodes;
+		std::unordered_map<GUID, size_t> m_nodeIndex;
+
+		// Nodes, ready to be loaded, ordered by (-priority, index)
+		std::set<std::pair<int, size_t>> m_readyNodes;
+
+		// Nodes with recursive dependencies, waiting for the independent ones to be loaded
+		std::vector<size_t> m_heldBackNodes;
+		size_t m_independentNodesLeft = 0u;
+
+		// Progress state
+		size_t m_finishedCount = 0u;
+		size_t m_failedCount = 0u;
+		float m_progressSum = 0.0f;
+		bool m_canceled = false;
+		bool m_finished = false;
+
+		// Constructor is private
+		BatchResourceLoader(SceneContext* context, AsynchronousActionQueue* queue,
+			const Callback<BatchResourceLoader*>& onFinished, const Callback<const Progress&>& reportProgress);
+
+		// Actual implementation resides in here
+		struct Helpers;
+	};
+}
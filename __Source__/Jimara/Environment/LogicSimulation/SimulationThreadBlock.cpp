@@ -9,7 +9,7 @@ namespace Jimara {
 #pragma warning(disable: 4250)
 		class Instance : public virtual SimulationThreadBlock, public virtual ObjectCache<Reference<const Object>>::StoredObject {
 		public:
-			inline Instance() {}
+			inline Instance() : ThreadBlock(ThreadBlock::WaitMode::ADAPTIVE) {}
 			inline virtual ~Instance() {}
 		};
 #pragma warning(default: 4250)
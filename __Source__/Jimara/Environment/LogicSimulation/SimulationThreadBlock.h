@@ -1,5 +1,6 @@
 #pragma once
 #include "../Scene/Logic/LogicContext.h"
+#include "../../Core/Systems/ParallelFor.h"
 
 
 namespace Jimara {
@@ -12,7 +13,13 @@ namespace Jimara {
 		inline virtual ~SimulationThreadBlock() {}
 
 		/// <summary> Max thread count that is 'recommended' </summary>
-		inline size_t DefaultThreadCount()const { return m_defaultThreadCount; }
+		inline size_t DefaultThreadCount()const { return m_defaultThreadCount.load(); }
+
+		/// <summary>
+		/// Sets 'recommended' max thread count (ei the thread budget of the scene's simulation jobs)
+		/// </summary>
+		/// <param name="threadCount"> Thread count (0 will be treated as 1) </param>
+		inline void SetDefaultThreadCount(size_t threadCount) { m_defaultThreadCount = Math::Max(threadCount, size_t(1u)); }
 
 		/// <summary>
 		/// Gets shared instance of a SynchronousThreadBlock
@@ -21,9 +28,57 @@ namespace Jimara {
 		/// <returns> Shared instance </returns>
 		static Reference<SimulationThreadBlock> GetFor(SceneContext* context);
 
+		/// <summary>
+		/// Invokes fn(i) for each i in [first, last) on this block (see Jimara::ParallelFor for details)
+		/// </summary>
+		/// <typeparam name="Fn"> Callable, taking size_t index as an argument </typeparam>
+		/// <param name="first"> First index </param>
+		/// <param name="last"> End of the index range (exclusive) </param>
+		/// <param name="grainSize"> Minimal number of indices per chunk </param>
+		/// <param name="fn"> Function to invoke for each index </param>
+		/// <returns> False, if the block was busy and everything ran on the calling thread, true otherwise </returns>
+		template<typename Fn>
+		inline bool ParallelFor(size_t first, size_t last, size_t grainSize, const Fn& fn) {
+			return Jimara::ParallelFor(*this, DefaultThreadCount(), first, last, grainSize, fn);
+		}
+
+		/// <summary>
+		/// Reduces [first, last) index range to a single value on this block (see Jimara::ParallelReduce for details)
+		/// </summary>
+		/// <typeparam name="ValueType"> Reduction result type </typeparam>
+		/// <typeparam name="AccumulateFn"> Callable, taking (ValueType& accumulator, size_t index) as arguments </typeparam>
+		/// <typeparam name="CombineFn"> Callable, taking (const ValueType& a, const ValueType& b) as arguments and returning combined ValueType </typeparam>
+		/// <param name="first"> First index </param>
+		/// <param name="last"> End of the index range (exclusive) </param>
+		/// <param name="grainSize"> Number of indices per chunk </param>
+		/// <param name="identity"> Initial value of each partial result </param>
+		/// <param name="accumulate"> Accumulates an index into partial result </param>
+		/// <param name="combine"> Combines two partial results </param>
+		/// <returns> Reduction result </returns>
+		template<typename ValueType, typename AccumulateFn, typename CombineFn>
+		inline ValueType ParallelReduce(size_t first, size_t last, size_t grainSize,
+			const ValueType& identity, const AccumulateFn& accumulate, const CombineFn& combine) {
+			return Jimara::ParallelReduce(*this, DefaultThreadCount(), first, last, grainSize, identity, accumulate, combine);
+		}
+
+		/// <summary>
+		/// Sorts a random access range on this block (see Jimara::ParallelSort for details)
+		/// </summary>
+		/// <typeparam name="IteratorType"> Random access iterator type </typeparam>
+		/// <typeparam name="CompareFn"> Comparator (same as the one std::sort expects) </typeparam>
+		/// <param name="first"> Range start </param>
+		/// <param name="last"> Range end </param>
+		/// <param name="grainSize"> Minimal number of elements per chunk </param>
+		/// <param name="compare"> Comparator </param>
+		/// <returns> False, if the block was busy and some of the work ran on the calling thread, true otherwise </returns>
+		template<typename IteratorType, typename CompareFn>
+		inline bool ParallelSort(IteratorType first, IteratorType last, size_t grainSize, const CompareFn& compare) {
+			return Jimara::ParallelSort(*this, DefaultThreadCount(), first, last, grainSize, compare);
+		}
+
 	private:
 		// Max thread count that is 'recommended'
-		const size_t m_defaultThreadCount = Math::Max(std::thread::hardware_concurrency() / 2u, 1u);
+		std::atomic<size_t> m_defaultThreadCount = Math::Max(std::thread::hardware_concurrency() / 2u, 1u);
 
 		// Constructor can only be called by GetFor() implementation
 		inline SimulationThreadBlock() {}
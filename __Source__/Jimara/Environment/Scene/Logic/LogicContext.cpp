@@ -1,8 +1,15 @@
 #include "LogicContext.h"
+#include "../../LogicSimulation/SimulationThreadBlock.h"
 #include "../../../OS/Input/NoInput.h"
 #include "../../../Data/AssetDatabase/AssetSet.h"
+#include <algorithm>
 
 namespace Jimara {
+	namespace {
+		// Context, parallel-safe UpdatingComponent::Update() of which is running on the current thread
+		static thread_local const SceneContext* t_parallelUpdateContext = nullptr;
+	}
+
 	Reference<Component> SceneContext::RootObject()const {
 		Reference<Data> data = m_data;
 		if (data == nullptr) return nullptr;
@@ -16,6 +23,16 @@ namespace Jimara {
 		data->postUpdateActions.Schedule(callback, userData);
 	}
 
+	void SceneContext::ExecuteDeferred(const Callback<Object*>& callback, Object* userData) {
+		if (t_parallelUpdateContext != this) {
+			callback(userData);
+			return;
+		}
+		Reference<Data> data = m_data;
+		if (data == nullptr) return;
+		data->deferredActions.Schedule(callback, userData);
+	}
+
 	void SceneContext::StoreDataObject(const Object* object) {
 		if (object == nullptr) return;
 		Reference<Data> data = m_data;
@@ -69,8 +86,19 @@ namespace Jimara {
 		// __TODO__: Maybe add in some more steps? (asynchronous update job, for example or some other bullcrap)
 	}
 
+	bool SceneContext::InParallelUpdate()const {
+		return t_parallelUpdateContext == this;
+	}
+
 	void SceneContext::ComponentCreated(Component* component) {
 		if (component == nullptr) return;
+		if (t_parallelUpdateContext == this) {
+			// Main update thread holds the update lock, so we can not wait for it; this will be handled at the end of the parallel phase:
+			typedef void(*DeferredFn)(SceneContext*, Object*);
+			static const DeferredFn deferred = [](SceneContext* self, Object* comp) { self->ComponentCreated(dynamic_cast<Component*>(comp)); };
+			ExecuteDeferred(Callback<Object*>(deferred, this), component);
+			return;
+		}
 		std::unique_lock<std::recursive_mutex> updateLock(m_updateLock);
 		Reference<Data> data = m_data;
 		if (data == nullptr) return;
@@ -78,6 +106,12 @@ namespace Jimara {
 	}
 	void SceneContext::ComponentDestroyed(Component* component) {
 		if (component == nullptr) return;
+		if (t_parallelUpdateContext == this) {
+			typedef void(*DeferredFn)(SceneContext*, Object*);
+			static const DeferredFn deferred = [](SceneContext* self, Object* comp) { self->ComponentDestroyed(dynamic_cast<Component*>(comp)); };
+			ExecuteDeferred(Callback<Object*>(deferred, this), component);
+			return;
+		}
 		std::unique_lock<std::recursive_mutex> updateLock(m_updateLock);
 		Reference<Data> data = m_data;
 		if (data == nullptr) return;
@@ -85,33 +119,51 @@ namespace Jimara {
 	}
 	void SceneContext::ComponentStateDirty(Component* component, bool parentHierarchyChanged) {
 		if (component == nullptr) return;
+		if (t_parallelUpdateContext == this) {
+			typedef void(*DeferredFn)(SceneContext*, Object*);
+			static const DeferredFn stateDirty = [](SceneContext* self, Object* comp) { self->ComponentStateDirty(dynamic_cast<Component*>(comp), false); };
+			static const DeferredFn parentDirty = [](SceneContext* self, Object* comp) { self->ComponentStateDirty(dynamic_cast<Component*>(comp), true); };
+			ExecuteDeferred(Callback<Object*>(parentHierarchyChanged ? parentDirty : stateDirty, this), component);
+			return;
+		}
 		std::unique_lock<std::recursive_mutex> updateLock(m_updateLock);
 		Reference<Data> data = m_data;
-		if (data == nullptr) return;
-		if (data->allComponents.Contains(component)) {
-			static const auto forHierarchy = [](Component* ptr, const auto& process) {
-				using ProcessType = decltype(process);
-				struct HierarchyIterator {
-					inline static void MapHierarchy(Component* comp, const ProcessType& proc) {
-						proc(comp);
-						Component** it = comp->m_children.data();
-						Component** const end = it + comp->m_children.size();
-						while (it < end) {
-							MapHierarchy(*it, proc);
-							it++;
-						}
+		static const auto forHierarchy = [](Component* ptr, const auto& process) {
+			using ProcessType = decltype(process);
+			struct HierarchyIterator {
+				inline static void MapHierarchy(Component* comp, const ProcessType& proc) {
+					proc(comp);
+					Component** it = comp->m_children.data();
+					Component** const end = it + comp->m_children.size();
+					while (it < end) {
+						MapHierarchy(*it, proc);
+						it++;
 					}
-				};
-				HierarchyIterator::MapHierarchy(ptr, process);
+				}
 			};
+			HierarchyIterator::MapHierarchy(ptr, process);
+		};
+
+		// Refresh cached ActiveInHierarchy() state (parents are visited before children, so their state is already up to date):
+		const Component* const rootObject = (data == nullptr) ? nullptr : data->rootObject.operator->();
+		auto refreshActiveState = [&](Component* comp) {
+			const Component* parent = comp->m_parent;
+			const bool active = (comp == rootObject) || (comp->Enabled() && (parent == nullptr ||
+				(parent->m_flags.load() & static_cast<uint8_t>(Component::Flags::ACTIVE_IN_HIERARCHY)) != 0u));
+			if (active) comp->m_flags |= static_cast<uint8_t>(Component::Flags::ACTIVE_IN_HIERARCHY);
+			else comp->m_flags &= static_cast<uint8_t>(~static_cast<uint8_t>(Component::Flags::ACTIVE_IN_HIERARCHY));
+		};
+
+		if (data != nullptr && data->allComponents.Contains(component))
 			forHierarchy(component, [&](Component* comp) {
+				refreshActiveState(comp);
 				if (comp->ActiveInHierarchy())
 					data->enabledComponents.ScheduleAdd(comp);
 				else data->enabledComponents.ScheduleRemove(comp);
 				if (parentHierarchyChanged)
 					data->dirtyParentChains.insert(comp);
 				});
-		}
+		else forHierarchy(component, refreshActiveState);
 	}
 
 
@@ -272,7 +324,10 @@ namespace Jimara {
 			}
 			{
 				UpdatingComponent* updater = dynamic_cast<UpdatingComponent*>(component);
-				if (updater != nullptr) updatingComponents.Add(updater);
+				if (updater != nullptr) {
+					updatingComponents.Add(updater);
+					updateQueueDirty = true;
+				}
 			}
 			if (component != nullptr) {
 				component->OnComponentEnabled();
@@ -290,7 +345,10 @@ namespace Jimara {
 			}
 			{
 				UpdatingComponent* updater = dynamic_cast<UpdatingComponent*>(component);
-				if (updater != nullptr) updatingComponents.Remove(updater);
+				if (updater != nullptr) {
+					updatingComponents.Remove(updater);
+					updateQueueDirty = true;
+				}
 			}
 			if (component != nullptr && allComponents.Contains(component) && (!component->Destroyed()))
 				component->OnComponentDisabled();
@@ -333,13 +391,70 @@ namespace Jimara {
 	}
 
 	void SceneContext::Data::UpdateUpdatingComponents() {
-		const Reference<UpdatingComponent>* ptr = updatingComponents.Data();
-		const Reference<UpdatingComponent>* const end = ptr + updatingComponents.Size();
-		while (ptr < end) {
-			UpdatingComponent* component = (*ptr);
-			if (component->ActiveInHierarchy())
+		// Sort components by update order and split them into serial and parallel phases:
+		if (updateQueueDirty) {
+			struct QueueEntry {
+				UpdatingComponent* component = nullptr;
+				int order = 0;
+				bool parallel = false;
+			};
+			static thread_local std::vector<QueueEntry> entries;
+			entries.clear();
+			const Reference<UpdatingComponent>* const components = updatingComponents.Data();
+			for (size_t i = 0u; i < updatingComponents.Size(); i++) {
+				QueueEntry entry = {};
+				entry.component = components[i];
+				entry.order = entry.component->UpdateOrder();
+				entry.parallel = entry.component->ParallelUpdateSafe();
+				entries.push_back(entry);
+			}
+			std::stable_sort(entries.begin(), entries.end(), [](const QueueEntry& a, const QueueEntry& b) {
+				return (a.order < b.order) || (a.order == b.order && (!a.parallel) && b.parallel);
+				});
+			updateQueue.clear();
+			updatePhases.clear();
+			for (size_t i = 0u; i < entries.size(); i++) {
+				const QueueEntry& entry = entries[i];
+				if (i <= 0u || entries[i - 1u].order != entry.order || entries[i - 1u].parallel != entry.parallel) {
+					UpdatePhase phase = {};
+					phase.start = i;
+					phase.parallel = entry.parallel;
+					updatePhases.push_back(phase);
+				}
+				updateQueue.push_back(entry.component);
+				updatePhases.back().end = (i + 1u);
+			}
+			entries.clear();
+			updateQueueDirty = false;
+		}
+
+		// Execute update phases:
+		for (size_t phaseId = 0u; phaseId < updatePhases.size(); phaseId++) {
+			const UpdatePhase& phase = updatePhases[phaseId];
+			if (!phase.parallel) {
+				for (size_t i = phase.start; i < phase.end; i++) {
+					UpdatingComponent* component = updateQueue[i];
+					if (component->ActiveInHierarchy())
+						component->Update();
+				}
+				continue;
+			}
+
+			if (parallelUpdateBlock == nullptr)
+				parallelUpdateBlock = SimulationThreadBlock::GetFor(context);
+			SimulationThreadBlock* threadBlock = dynamic_cast<SimulationThreadBlock*>(parallelUpdateBlock.operator->());
+			static const constexpr size_t minComponentsPerThread = 4u;
+			threadBlock->ParallelFor(phase.start, phase.end, minComponentsPerThread, [&](size_t index) {
+				UpdatingComponent* component = updateQueue[index];
+				if (!component->ActiveInHierarchy()) return;
+				const SceneContext* const lastContext = t_parallelUpdateContext;
+				t_parallelUpdateContext = context;
 				component->Update();
-			ptr++;
+				t_parallelUpdateContext = lastContext;
+				});
+
+			// Apply structural changes, made during the parallel phase:
+			deferredActions.Flush();
 		}
 	}
 }
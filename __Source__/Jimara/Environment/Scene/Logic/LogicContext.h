@@ -80,6 +80,24 @@ namespace Jimara {
 			/// <summary> Updates component </summary>
 			virtual void Update() = 0;
 
+			/// <summary>
+			/// If true, Update() may be invoked concurrently with other parallel-safe components on the SimulationThreadBlock
+			/// <para/> Notes:
+			/// <para/>		0. Parallel-safe Update() should only modify the state of the component itself (and it's own sub-hierarchy);
+			/// <para/>		1. Component::SetParent(), SetIndexInParent() and Destroy() calls (including the construction of the components with a parent) 
+			///				are automatically deferred till the end of the parallel phase; Other structural changes should be made through ExecuteDeferred();
+			/// <para/>		2. Value is read each time the update queue gets rebuilt (whenever any UpdatingComponent gets enabled or disabled).
+			/// </summary>
+			inline virtual bool ParallelUpdateSafe()const { return false; }
+
+			/// <summary>
+			/// Update order (components with lower values get updated first);
+			/// <para/> Notes:
+			/// <para/>		0. Components with the same update order are updated in two phases: serial ones first, followed by the parallel-safe ones;
+			/// <para/>		1. Value is read each time the update queue gets rebuilt (whenever any UpdatingComponent gets enabled or disabled).
+			/// </summary>
+			inline virtual int UpdateOrder()const { return 0; }
+
 		private:
 			// Only the Logic context is allowed to invoke Update() method
 			friend class SceneContext;
@@ -117,6 +135,32 @@ namespace Jimara {
 			ExecuteAfterUpdate(Callback<Object*>(callback), userData);
 		}
 
+		/// <summary>
+		/// Executes a structural change (component creation, destruction, reparenting and alike) in a way that is safe for parallel updates
+		/// <para/> Notes:
+		/// <para/>		0. If invoked from within a parallel-safe UpdatingComponent::Update(), the callback is queued and 
+		///				executed on the main update thread at the end of the parallel phase (ordering is preserved);
+		/// <para/>		1. Otherwise, the callback is executed immediately.
+		/// </summary>
+		/// <param name="callback"> Callback to execute </param>
+		/// <param name="userData"> Arbitrary object to keep alive while the callback is queued (it will be passed back as the callback's argument) </param>
+		void ExecuteDeferred(const Callback<Object*>& callback, Object* userData = nullptr);
+
+		/// <summary>
+		/// Executes a structural change (component creation, destruction, reparenting and alike) in a way that is safe for parallel updates
+		/// <para/> Notes:
+		/// <para/>		0. If invoked from within a parallel-safe UpdatingComponent::Update(), the callback is queued and 
+		///				executed on the main update thread at the end of the parallel phase (ordering is preserved);
+		/// <para/>		1. Otherwise, the callback is executed immediately.
+		/// </summary>
+		/// <typeparam name="CallbackType"> Arbitrary function that can be directly passed to the Callback<Object*>'s constructor </typeparam>
+		/// <param name="callback"> Callback to execute </param>
+		/// <param name="userData"> Arbitrary object to keep alive while the callback is queued (it will be passed back as the callback's argument) </param>
+		template<typename CallbackType>
+		inline void ExecuteDeferred(const CallbackType& callback, Object* userData = nullptr) {
+			ExecuteDeferred(Callback<Object*>(callback), userData);
+		}
+
 		/// <summary>
 		/// Stores arbitrary object as a part of the scene data
 		/// Note: This is mostly useful to keep references alive, since there's no way to get the objects stored here.
@@ -196,6 +240,9 @@ namespace Jimara {
 		// Invoked by each component when it gets enabled, disabled or it's parent changed
 		void ComponentStateDirty(Component* component, bool parentHierarchyChanged);
 
+		// True, if invoked from within a parallel-safe UpdatingComponent::Update() of this context
+		bool InParallelUpdate()const;
+
 		// Invoked when scene goes out of scope
 		void Cleanup();
 
@@ -227,6 +274,17 @@ namespace Jimara {
 			DelayedObjectSet<Component> enabledComponents;
 			ObjectSet<UpdatingComponent> updatingComponents;
 
+			struct UpdatePhase {
+				size_t start = 0u;
+				size_t end = 0u;
+				bool parallel = false;
+			};
+			std::vector<Reference<UpdatingComponent>> updateQueue;
+			std::vector<UpdatePhase> updatePhases;
+			bool updateQueueDirty = true;
+			Reference<Object> parallelUpdateBlock;
+			SynchronousActionQueue<> deferredActions;
+
 			std::unordered_set<Reference<Component>> dirtyParentChains;
 
 			SynchronousActionQueue<> postUpdateActions;
@@ -141,7 +141,8 @@ namespace Jimara {
 			databaseCreateArgs.physicsInstance = physicsAPI;
 			databaseCreateArgs.audioDevice = audioDevice;
 			databaseCreateArgs.assetDirectory = OS::Path(args.assetDirectory);
-			databaseCreateArgs.previousImportDataCache = OS::Path("JimaraDatabaseCache.json");
+			databaseCreateArgs.previousImportDataCache = OS::Path("JimaraDatabaseCache.bin");
+			databaseCreateArgs.cookedAssetCacheDirectory = OS::Path("JimaraCookedAssets/");
 		}
 		const Reference<FileSystemDatabase> assetDatabase = FileSystemDatabase::Create(databaseCreateArgs);
 		if (assetDatabase == nullptr)
@@ -6,6 +6,7 @@
 #include <map>
 #include <algorithm>
 #include <optional>
+#include <functional>
 #include <type_traits>
 
 
@@ -140,5 +141,349 @@ namespace Jimara {
 
 			return {};
 		}
+
+		/// <summary>
+		/// Outcome of PathfindingContext::FindPath
+		/// </summary>
+		enum class PathfindingStatus : uint8_t {
+			/// <summary> Path to the destination was found </summary>
+			FOUND = 0u,
+
+			/// <summary> Destination is not reachable from the start node </summary>
+			NOT_FOUND = 1u,
+
+			/// <summary> Search ran out of the node budget or was terminated early (path may contain a partial result, if requested) </summary>
+			INTERRUPTED = 2u
+		};
+
+		/// <summary>
+		/// Search settings for PathfindingContext::FindPath
+		/// </summary>
+		struct PathfindingSettings {
+			/// <summary> Maximal number of node expansions before the search gets interrupted </summary>
+			size_t maxExpandedNodes = ~size_t(0u);
+
+			/// <summary> 
+			/// If true, an interrupted search will output the path to the expanded node with the lowest heuristic value 
+			/// (ei the one that is the closest to the destination) 
+			/// </summary>
+			bool allowPartialPath = false;
+		};
+
+		/// <summary>
+		/// Reusable A* search state
+		/// <para/> Unlike AStar(), nodes are stored in a flat array and looked up through an open-addressing hash table,
+		/// the open list is a binary heap and all buffers retain their capacity between the searches, 
+		/// so keeping a context per thread/agent makes repeated searches allocation-free after the warm-up.
+		/// <para/> Edge costs, heuristic values and distances from the start node are cached per node for the duration of a search 
+		/// and the distances stay queryable till the next FindPath() call.
+		/// <para/> Note: The context is not thread-safe; use separate instances for concurrent searches.
+		/// </summary>
+		/// <typeparam name="GraphNode"> Graph node index/pointer/representation (has to be hashable with NodeHash and comparable with NodeEquals) </typeparam>
+		/// <typeparam name="DistanceT"> Distance type (anything that supports addition, comparizons and has a 'zero' value) </typeparam>
+		/// <typeparam name="NodeHash"> GraphNode hasher </typeparam>
+		/// <typeparam name="NodeEquals"> GraphNode equality check </typeparam>
+		template<typename GraphNode, typename DistanceT = float, typename NodeHash = std::hash<GraphNode>, typename NodeEquals = std::equal_to<GraphNode>>
+		class PathfindingContext {
+		public:
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="hash"> Node hasher </param>
+			/// <param name="equals"> Node equality check </param>
+			inline PathfindingContext(const NodeHash& hash = NodeHash(), const NodeEquals& equals = NodeEquals())
+				: m_hash(hash), m_equals(equals) {}
+
+			/// <summary>
+			/// Searches for the shortest path between two nodes
+			/// </summary>
+			/// <typeparam name="HeuristicFn"> A callable, that receives GraphNode as an argument and returns heuristic minimal distance value </typeparam>
+			/// <typeparam name="IterateNeighborsFn">
+			/// A callable, that receives GraphNode and another callable as arguments 
+			/// and expects that callable to be invoked with each (GraphNode neighborNode, DistanceT distanceToNeighbor) as arguments
+			/// </typeparam>
+			/// <typeparam name="TerminateFn"> 
+			/// A callable, that receives (GraphNode node, DistanceT distanceSoFar) before each node expansion and returns true to interrupt the search 
+			/// </typeparam>
+			/// <param name="start"> Start node </param>
+			/// <param name="end"> Destination/End node </param>
+			/// <param name="heuristic"> Heuristic function </param>
+			/// <param name="getNeighbors"> Callback for collecting neighbor information (invoked at most once per node) </param>
+			/// <param name="shouldTerminate"> Early termination check </param>
+			/// <param name="path"> Resulting sequence of nodes from start to end will be stored here (previous content is discarded) </param>
+			/// <param name="settings"> Search settings </param>
+			/// <returns> Search status </returns>
+			template<typename HeuristicFn, typename IterateNeighborsFn, typename TerminateFn>
+			inline PathfindingStatus FindPath(
+				const GraphNode& start, const GraphNode& end,
+				const HeuristicFn& heuristic, const IterateNeighborsFn& getNeighbors, const TerminateFn& shouldTerminate,
+				std::vector<GraphNode>& path, const PathfindingSettings& settings) {
+				path.clear();
+				BeginSearch();
+				m_endNode = NO_ID;
+
+				// Create start node:
+				{
+					bool inserted;
+					const size_t startId = FindOrInsert(start, heuristic, inserted);
+					NodeData& startData = m_nodes[startId];
+					startData.distanceSoFar = static_cast<DistanceT>(0);
+					startData.reached = true;
+					m_heap.push_back(HeapEntry{ startData.heuristic, startData.distanceSoFar, startId });
+				}
+
+				size_t expandedNodeCount = 0u;
+				size_t bestNode = NO_ID;
+				bool interrupted = false;
+				while (!m_heap.empty()) {
+					std::pop_heap(m_heap.begin(), m_heap.end(), HeapEntry::Compare);
+					const HeapEntry entry = m_heap.back();
+					m_heap.pop_back();
+
+					// Skip stale entries:
+					if (m_nodes[entry.nodeId].distanceSoFar < entry.distanceSoFar)
+						continue;
+
+					// Check if we reached destination:
+					if (m_equals(m_nodes[entry.nodeId].node, end)) {
+						m_endNode = entry.nodeId;
+						StorePath(entry.nodeId, path);
+						return PathfindingStatus::FOUND;
+					}
+
+					// Check budget and early termination:
+					if (expandedNodeCount >= settings.maxExpandedNodes || shouldTerminate(m_nodes[entry.nodeId].node, entry.distanceSoFar)) {
+						interrupted = true;
+						break;
+					}
+					expandedNodeCount++;
+					if (bestNode == NO_ID || m_nodes[entry.nodeId].heuristic < m_nodes[bestNode].heuristic)
+						bestNode = entry.nodeId;
+
+					// Collect neighbors (node references may get invalidated by insertions):
+					if (m_nodes[entry.nodeId].firstNeighborId == NO_ID) {
+						const size_t firstNeighborId = m_neighbors.size();
+						const GraphNode node = m_nodes[entry.nodeId].node;
+						auto inspectNeighbor = [&](const GraphNode& neighbor, DistanceT distance) {
+							bool inserted;
+							const size_t neighborId = FindOrInsert(neighbor, heuristic, inserted);
+							m_neighbors.push_back(NeighborInfo{ neighborId, Math::Max(distance, static_cast<DistanceT>(0)) });
+						};
+						getNeighbors(node, inspectNeighbor);
+						m_nodes[entry.nodeId].firstNeighborId = firstNeighborId;
+						m_nodes[entry.nodeId].neighborCount = (m_neighbors.size() - firstNeighborId);
+					}
+
+					// Relax neighbor distances:
+					const NeighborInfo* neighborPtr = m_neighbors.data() + m_nodes[entry.nodeId].firstNeighborId;
+					const NeighborInfo* const neighborEnd = neighborPtr + m_nodes[entry.nodeId].neighborCount;
+					for (; neighborPtr < neighborEnd; neighborPtr++) {
+						NodeData& neighbor = m_nodes[neighborPtr->nodeId];
+						const DistanceT distanceSoFar = entry.distanceSoFar + neighborPtr->distance;
+						if (neighbor.reached && (!(distanceSoFar < neighbor.distanceSoFar)))
+							continue;
+						neighbor.distanceSoFar = distanceSoFar;
+						neighbor.prevNodeId = entry.nodeId;
+						neighbor.reached = true;
+						m_heap.push_back(HeapEntry{ distanceSoFar + neighbor.heuristic, distanceSoFar, neighborPtr->nodeId });
+						std::push_heap(m_heap.begin(), m_heap.end(), HeapEntry::Compare);
+					}
+				}
+
+				if (interrupted && settings.allowPartialPath && bestNode != NO_ID)
+					StorePath(bestNode, path);
+				return interrupted ? PathfindingStatus::INTERRUPTED : PathfindingStatus::NOT_FOUND;
+			}
+
+			/// <summary>
+			/// Searches for the shortest path between two nodes (without early termination checks)
+			/// </summary>
+			/// <typeparam name="HeuristicFn"> A callable, that receives GraphNode as an argument and returns heuristic minimal distance value </typeparam>
+			/// <typeparam name="IterateNeighborsFn"> Neighbor iterator (same as the one in AStar()) </typeparam>
+			/// <param name="start"> Start node </param>
+			/// <param name="end"> Destination/End node </param>
+			/// <param name="heuristic"> Heuristic function </param>
+			/// <param name="getNeighbors"> Callback for collecting neighbor information (invoked at most once per node) </param>
+			/// <param name="path"> Resulting sequence of nodes from start to end will be stored here (previous content is discarded) </param>
+			/// <param name="settings"> Search settings </param>
+			/// <returns> Search status </returns>
+			template<typename HeuristicFn, typename IterateNeighborsFn>
+			inline PathfindingStatus FindPath(
+				const GraphNode& start, const GraphNode& end,
+				const HeuristicFn& heuristic, const IterateNeighborsFn& getNeighbors,
+				std::vector<GraphNode>& path, const PathfindingSettings& settings = PathfindingSettings()) {
+				return FindPath(start, end, heuristic, getNeighbors, [](const GraphNode&, const DistanceT&) { return false; }, path, settings);
+			}
+
+			/// <summary> Cost of the path, found during the last search (only valid if the last FindPath() call succeeded) </summary>
+			inline DistanceT PathCost()const { 
+				return (m_endNode == NO_ID) ? static_cast<DistanceT>(0) : m_nodes[m_endNode].distanceSoFar; 
+			}
+
+			/// <summary>
+			/// Retrieves the cost of reaching a node from the start of the last search
+			/// <para/> Note: Only the expanded nodes are guaranteed to have optimal costs; the remaining ones report the best cost found so far.
+			/// </summary>
+			/// <param name="node"> Graph node </param>
+			/// <param name="distance"> Distance will be stored here, if the node was reached </param>
+			/// <returns> True, if the node was reached during the last search </returns>
+			inline bool TryGetDistance(const GraphNode& node, DistanceT& distance)const {
+				const size_t nodeId = Find(node);
+				if (nodeId == NO_ID || (!m_nodes[nodeId].reached))
+					return false;
+				distance = m_nodes[nodeId].distanceSoFar;
+				return true;
+			}
+
+			/// <summary> Number of the nodes discovered during the last search </summary>
+			inline size_t DiscoveredNodeCount()const { return m_nodes.size(); }
+
+			/// <summary> Releases all memory, retained by the context </summary>
+			inline void Clear() {
+				m_nodes = {};
+				m_slots = {};
+				m_heap = {};
+				m_neighbors = {};
+				m_generation = 1u;
+				m_endNode = NO_ID;
+			}
+
+		private:
+			// Invalid index
+			static const constexpr size_t NO_ID = ~size_t(0u);
+
+			// Per-node search state
+			struct NodeData {
+				GraphNode node = {};
+				DistanceT heuristic = {};
+				DistanceT distanceSoFar = {};
+				size_t prevNodeId = NO_ID;
+				size_t firstNeighborId = NO_ID;
+				size_t neighborCount = 0u;
+				bool reached = false;
+			};
+
+			// Open list entry
+			struct HeapEntry {
+				DistanceT minDistance = {};
+				DistanceT distanceSoFar = {};
+				size_t nodeId = NO_ID;
+
+				// std heap functions keep the 'largest' element on top, so the comparizon is inverted
+				// (on ties, nodes further from the start go first, since those tend to be closer to the destination)
+				inline static bool Compare(const HeapEntry& a, const HeapEntry& b) {
+					return (b.minDistance < a.minDistance) || ((!(a.minDistance < b.minDistance)) && (a.distanceSoFar < b.distanceSoFar));
+				}
+			};
+
+			// Cached neighbor edge
+			struct NeighborInfo {
+				size_t nodeId = NO_ID;
+				DistanceT distance = {};
+			};
+
+			// Hash table slot (valid only if generation matches m_generation)
+			struct Slot {
+				size_t nodeId = NO_ID;
+				uint32_t generation = 0u;
+			};
+
+			// Hasher and comparator
+			NodeHash m_hash;
+			NodeEquals m_equals;
+
+			// Node storage, hash table, open list and neighbor edges
+			std::vector<NodeData> m_nodes;
+			std::vector<Slot> m_slots;
+			std::vector<HeapEntry> m_heap;
+			std::vector<NeighborInfo> m_neighbors;
+
+			// Current search generation (slots from the previous generations count as empty, so the table does not have to be cleared)
+			uint32_t m_generation = 1u;
+
+			// End node from the last successful search
+			size_t m_endNode = NO_ID;
+
+			inline void BeginSearch() {
+				m_nodes.clear();
+				m_heap.clear();
+				m_neighbors.clear();
+				m_generation++;
+				if (m_generation == 0u) {
+					for (size_t i = 0u; i < m_slots.size(); i++)
+						m_slots[i] = Slot();
+					m_generation = 1u;
+				}
+			}
+
+			inline size_t SlotIndex(const GraphNode& node)const {
+				// Fibonacci hashing spreads out the sequential values many std::hash implementations pass through:
+				const uint64_t hash = static_cast<uint64_t>(m_hash(node)) * uint64_t(11400714819323198485ull);
+				return static_cast<size_t>(hash >> 32u) & (m_slots.size() - 1u);
+			}
+
+			inline size_t Find(const GraphNode& node)const {
+				if (m_slots.empty())
+					return NO_ID;
+				const size_t mask = (m_slots.size() - 1u);
+				for (size_t slotId = SlotIndex(node); true; slotId = ((slotId + 1u) & mask)) {
+					const Slot& slot = m_slots[slotId];
+					if (slot.generation != m_generation)
+						return NO_ID;
+					else if (m_equals(m_nodes[slot.nodeId].node, node))
+						return slot.nodeId;
+				}
+			}
+
+			inline void Rehash(size_t slotCount) {
+				m_slots.clear();
+				m_slots.resize(slotCount);
+				const size_t mask = (m_slots.size() - 1u);
+				for (size_t nodeId = 0u; nodeId < m_nodes.size(); nodeId++) {
+					size_t slotId = SlotIndex(m_nodes[nodeId].node);
+					while (m_slots[slotId].generation == m_generation)
+						slotId = ((slotId + 1u) & mask);
+					m_slots[slotId].nodeId = nodeId;
+					m_slots[slotId].generation = m_generation;
+				}
+			}
+
+			template<typename HeuristicFn>
+			inline size_t FindOrInsert(const GraphNode& node, const HeuristicFn& heuristic, bool& inserted) {
+				// Keep load factor at or below 0.5:
+				if (((m_nodes.size() + 1u) << 1u) > m_slots.size())
+					Rehash(Math::Max(m_slots.size() << 1u, size_t(64u)));
+				const size_t mask = (m_slots.size() - 1u);
+				for (size_t slotId = SlotIndex(node); true; slotId = ((slotId + 1u) & mask)) {
+					Slot& slot = m_slots[slotId];
+					if (slot.generation != m_generation) {
+						slot.nodeId = m_nodes.size();
+						slot.generation = m_generation;
+						NodeData data = {};
+						data.node = node;
+						data.heuristic = Math::Max(static_cast<DistanceT>(heuristic(node)), static_cast<DistanceT>(0));
+						m_nodes.push_back(data);
+						inserted = true;
+						return slot.nodeId;
+					}
+					else if (m_equals(m_nodes[slot.nodeId].node, node)) {
+						inserted = false;
+						return slot.nodeId;
+					}
+				}
+			}
+
+			inline void StorePath(size_t nodeId, std::vector<GraphNode>& path)const {
+				for (; nodeId != NO_ID; nodeId = m_nodes[nodeId].prevNodeId) {
+					path.push_back(m_nodes[nodeId].node);
+					if (path.size() > m_nodes.size()) {
+						assert(false);
+						path.clear();
+						return;
+					}
+				}
+				std::reverse(path.begin(), path.end());
+			}
+		};
 	}
 }
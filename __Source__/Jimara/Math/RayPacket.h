@@ -0,0 +1,118 @@
+#pragma once
+#include "Intersections.h"
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define JIMARA_RAY_PACKET_SSE
+#include <emmintrin.h>
+#endif
+
+
+namespace Jimara {
+	namespace Math {
+		/// <summary>
+		/// A packet of up to RayPacket::WIDTH rays, stored in SoA layout for SIMD (SSE, whenever available) bounding box tests
+		/// <para/> Bounding box tests are bit-exact with Math::CastPreInversed, so packet traversal visits the same nodes as the scalar ray would.
+		/// </summary>
+		struct RayPacket final {
+			/// <summary> Maximal number of rays within a packet </summary>
+			static const constexpr uint32_t WIDTH = 4u;
+
+			/// <summary> Bitmask of all rays within a full packet </summary>
+			static const constexpr uint32_t FULL_MASK = (1u << WIDTH) - 1u;
+
+			/// <summary> Ray origins (x, y and z components) </summary>
+			alignas(16) float origin[3u][WIDTH] = {};
+
+			/// <summary> 1.0f / ray.direction (x, y and z components) </summary>
+			alignas(16) float inverseDirection[3u][WIDTH] = {};
+
+			/// <summary> Bitmasks of the rays with negative direction components (per axis; direction.x/y/z &lt; 0.0f) </summary>
+			uint32_t negativeMask[3u] = { 0u, 0u, 0u };
+
+			/// <summary> Bitmask of valid rays </summary>
+			uint32_t validMask = 0u;
+
+			/// <summary> Constructor (empty packet) </summary>
+			inline RayPacket() {}
+
+			/// <summary>
+			/// Constructor
+			/// </summary>
+			/// <param name="origins"> Ray origins </param>
+			/// <param name="directions"> Ray directions </param>
+			/// <param name="count"> Number of rays (anything beyond WIDTH is ignored; missing lanes will be masked-out) </param>
+			inline RayPacket(const Vector3* origins, const Vector3* directions, size_t count) {
+				count = Math::Min(count, size_t(WIDTH));
+				for (size_t i = 0u; i < count; i++) {
+					const Vector3 inverseDir = 1.0f / directions[i];
+					origin[0u][i] = origins[i].x;
+					origin[1u][i] = origins[i].y;
+					origin[2u][i] = origins[i].z;
+					inverseDirection[0u][i] = inverseDir.x;
+					inverseDirection[1u][i] = inverseDir.y;
+					inverseDirection[2u][i] = inverseDir.z;
+					if (directions[i].x < 0.0f) negativeMask[0u] |= (1u << i);
+					if (directions[i].y < 0.0f) negativeMask[1u] |= (1u << i);
+					if (directions[i].z < 0.0f) negativeMask[2u] |= (1u << i);
+				}
+				validMask = (1u << count) - 1u;
+			}
+
+			/// <summary>
+			/// Checks if all valid rays go in the same octant (ei signs of the direction components match)
+			/// <para/> Packet traversal of ordered hierarchies is only worth it for coherent packets; the rest should fall back to scalar casts.
+			/// </summary>
+			/// <returns> True, if the rays are coherent </returns>
+			inline bool Coherent()const {
+				for (size_t axis = 0u; axis < 3u; axis++)
+					if (negativeMask[axis] != 0u && negativeMask[axis] != validMask)
+						return false;
+				return true;
+			}
+
+			/// <summary>
+			/// Raycast distances to an axis aligned bounding box for all rays within the packet (same as Math::CastPreInversed per ray)
+			/// </summary>
+			/// <param name="bbox"> Bounding box </param>
+			/// <param name="distances"> Per-ray distances will be stored here (values for the rays that miss are undefined) </param>
+			/// <returns> Bitmask of rays that hit the bounding box (ei the ones that have finite distances) </returns>
+			inline uint32_t CastPreInversed(const AABB& bbox, float* distances)const {
+#ifdef JIMARA_RAY_PACKET_SSE
+				__m128 mn, mx;
+				{
+					const __m128 o = _mm_load_ps(origin[0u]);
+					const __m128 inv = _mm_load_ps(inverseDirection[0u]);
+					const __m128 ds = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bbox.start.x), o), inv);
+					const __m128 de = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(bbox.end.x), o), inv);
+					mn = _mm_min_ps(ds, de);
+					mx = _mm_max_ps(ds, de);
+				}
+				auto slab = [&](size_t axis, float start, float end) {
+					const __m128 o = _mm_load_ps(origin[axis]);
+					const __m128 inv = _mm_load_ps(inverseDirection[axis]);
+					const __m128 ds = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(start), o), inv);
+					const __m128 de = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(end), o), inv);
+					mn = _mm_max_ps(mn, _mm_min_ps(ds, de));
+					mx = _mm_min_ps(mx, _mm_max_ps(ds, de));
+				};
+				slab(1u, bbox.start.y, bbox.end.y);
+				slab(2u, bbox.start.z, bbox.end.z);
+				_mm_storeu_ps(distances, mn);
+				const __m128 miss = _mm_cmpgt_ps(mn, _mm_add_ps(mx, _mm_set1_ps(INTERSECTION_EPSILON)));
+				const __m128 finite = _mm_cmplt_ps(
+					_mm_andnot_ps(_mm_set1_ps(-0.0f), mn), _mm_set1_ps(std::numeric_limits<float>::infinity()));
+				return static_cast<uint32_t>(_mm_movemask_ps(_mm_andnot_ps(miss, finite))) & validMask;
+#else
+				uint32_t hitMask = 0u;
+				for (uint32_t i = 0u; i < WIDTH; i++) {
+					distances[i] = Math::CastPreInversed(bbox,
+						Vector3(origin[0u][i], origin[1u][i], origin[2u][i]),
+						Vector3(inverseDirection[0u][i], inverseDirection[1u][i], inverseDirection[2u][i]));
+					if (std::isfinite(distances[i]))
+						hitMask |= (1u << i);
+				}
+				return hitMask & validMask;
+#endif
+			}
+		};
+	}
+}